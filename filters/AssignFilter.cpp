@@ -188,6 +188,64 @@ bool AssignFilter::processOne(PointRef& point)
 }
 
 
+// Assignments don't depend on other points, so each one can be applied to
+// the whole batch before moving to the next while producing the same result
+// as processOne().
+void AssignFilter::processBatch(StreamPointTable& table,
+    const std::vector<uint8_t>& active, point_count_t count)
+{
+    PointRef point(table, 0);
+
+    m_mask.assign(active.begin(), active.begin() + count);
+    const DimRange& cond = m_args->m_condition;
+    if (cond.m_id != Dimension::Id::Unknown)
+    {
+        for (PointId idx = 0; idx < count; ++idx)
+        {
+            if (!m_mask[idx])
+                continue;
+            point.setPointId(idx);
+            m_mask[idx] = cond.valuePasses(point.getFieldAs<double>(cond.m_id));
+        }
+    }
+
+    for (AssignRange& r : m_args->m_assignments)
+        for (PointId idx = 0; idx < count; ++idx)
+        {
+            if (!m_mask[idx])
+                continue;
+            point.setPointId(idx);
+            if (r.valuePasses(point.getFieldAs<double>(r.m_id)))
+                point.setField(r.m_id, r.m_value);
+        }
+
+    if (m_args->m_statements.empty())
+        return;
+
+    m_ids.clear();
+    for (PointId idx = 0; idx < count; ++idx)
+        if (m_mask[idx])
+            m_ids.push_back(idx);
+    m_passes.resize(m_ids.size());
+    m_values.resize(m_ids.size());
+    for (expr::AssignStatement& expr : m_args->m_statements)
+    {
+        Dimension::Id id = expr.identExpr().eval();
+        expr.conditionalExpr().eval(point, m_ids.data(), m_ids.size(),
+            m_passes.data());
+        expr.valueExpr().eval(point, m_ids.data(), m_ids.size(),
+            m_values.data());
+        for (size_t i = 0; i < m_ids.size(); ++i)
+        {
+            if (!m_passes[i])
+                continue;
+            point.setPointId(m_ids[i]);
+            point.setField(id, m_values[i]);
+        }
+    }
+}
+
+
 void AssignFilter::filter(PointView& view)
 {
     PointRef point(view, 0);
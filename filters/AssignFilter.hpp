@@ -54,12 +54,18 @@ private:
     virtual void addArgs(ProgramArgs& args);
     virtual void prepared(PointTableRef table);
     virtual bool processOne(PointRef& point);
+    virtual void processBatch(StreamPointTable& table,
+        const std::vector<uint8_t>& active, point_count_t count);
     virtual void filter(PointView& view);
 
     AssignFilter& operator=(const AssignFilter&) = delete;
     AssignFilter(const AssignFilter&) = delete;
 
     std::unique_ptr<AssignArgs> m_args;
+    std::vector<uint8_t> m_mask;
+    std::vector<PointId> m_ids;
+    std::vector<uint8_t> m_passes;
+    std::vector<double> m_values;
 };
 
 } // namespace pdal
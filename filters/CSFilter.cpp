@@ -82,6 +82,7 @@ struct CSArgs
     StringList m_returns;
     bool m_debug;
     std::string m_dir;
+    int m_threads;
 };
 
 CSFilter::CSFilter() : m_args(new CSArgs)
@@ -110,6 +111,8 @@ void CSFilter::addArgs(ProgramArgs& args)
              {"last", "only"});
     args.add("debug", "Enable debugging output and use the dir argument", m_args->m_debug, false);
     args.add("dir", "Optional output directory for debugging", m_args->m_dir);
+    args.add("threads", "Number of threads used to run the simulation",
+        m_args->m_threads, 1);
 }
 
 void CSFilter::addDimensions(PointLayoutPtr layout)
@@ -117,6 +120,12 @@ void CSFilter::addDimensions(PointLayoutPtr layout)
     layout->registerDim(Id::Classification);
 }
 
+void CSFilter::initialize()
+{
+    if (m_args->m_threads < 1)
+        throwError("Option 'threads' must be at least 1.");
+}
+
 void CSFilter::ready(PointTableRef table)
 {
     if (m_args->m_dir.empty())
@@ -220,16 +229,6 @@ PointViewSet CSFilter::run(PointViewPtr view)
     if (!firstView->size())
         throwError("No returns to process.");
 
-    csf::PointCloud csfPC;
-    for (PointRef point : *firstView)
-    {
-        csf::Point p;
-        p.x = point.getFieldAs<double>(Id::X);
-        p.y = point.getFieldAs<double>(Id::Y);
-        p.z = point.getFieldAs<double>(Id::Z);
-        csfPC.push_back(p);
-    }
-
     CSF c(0);
     c.params.bSloopSmooth = m_args->m_smooth;
     c.params.time_step = m_args->m_step;
@@ -240,9 +239,10 @@ PointViewSet CSFilter::run(PointViewPtr view)
     c.params.interations = m_args->m_iterations;
     c.params.debug = m_args->m_debug;
     c.params.m_dir = m_args->m_dir;
+    c.params.threads = m_args->m_threads;
     std::vector<int> groundIdx, offGroundIdx;
     c.setLog(log());
-    c.setPointCloud(csfPC);
+    c.setPointCloud(*firstView);
     try
     {
         c.do_filtering(groundIdx, offGroundIdx, true);
@@ -38,7 +38,7 @@
 #include <pdal/util/ProgramArgs.hpp>
 #include <pdal/private/gdal/Raster.hpp>
 
-#include <array>
+#include <algorithm>
 
 namespace pdal
 {
@@ -136,11 +136,16 @@ void ColorizationFilter::addArgs(ProgramArgs& args)
 {
     args.add("raster", "Raster filename", m_rasterFilename);
     args.add("dimensions", "Dimensions to use for colorization", m_dimSpec);
+    args.add("cache_size", "Size of the raster block cache in megabytes",
+        m_cacheSize, (uint64_t)(gdal::Raster::DefaultCacheSize >> 20));
 }
 
 
 void ColorizationFilter::initialize()
 {
+    if (m_cacheSize < 1)
+        throwError("Option 'cache_size' must be at least 1.");
+
     m_raster.reset(new gdal::Raster(m_rasterFilename));
     auto bandTypes = m_raster->getPDALDimensionTypes();
     m_raster->close();
@@ -178,36 +183,24 @@ void ColorizationFilter::addDimensions(PointLayoutPtr layout)
 
 void ColorizationFilter::ready(PointTableRef table)
 {
-    using namespace gdal;
-
     m_raster.reset(new gdal::Raster(m_rasterFilename));
-
-    GDALError error = m_raster->open();
-    if (error != GDALError::None)
-    {
-        if (error == GDALError::NoTransform ||
-            error == GDALError::NotInvertible)
-        {
-            log()->get(LogLevel::Warning) << getName() << ": " <<
-                m_raster->errorMsg() << std::endl;
-        }
-        else
-        {
-            throwError(m_raster->errorMsg());
-        }
-    }
+    if (m_raster->openForSampling(m_cacheSize << 20, 0, log()) !=
+            gdal::GDALError::None)
+        throwError(m_raster->errorMsg());
 }
 
 
 bool ColorizationFilter::processOne(PointRef& point)
 {
     static std::vector<double> data;
-    static std::array<double, 2> pix;
 
     double x = point.getFieldAs<double>(Dimension::Id::X);
     double y = point.getFieldAs<double>(Dimension::Id::Y);
 
-    if (m_raster->read(x, y, data, pix) == gdal::GDALError::None)
+    gdal::GDALError error = m_raster->read(x, y, data);
+    if (error != gdal::GDALError::None && error != gdal::GDALError::NoData)
+        throwError(m_raster->errorMsg());
+    if (error == gdal::GDALError::None)
     {
         int i(0);
         for (auto bi = m_bands.begin(); bi != m_bands.end(); ++bi)
@@ -226,12 +219,16 @@ bool ColorizationFilter::processOne(PointRef& point)
 
 void ColorizationFilter::filter(PointView& view)
 {
-    PointRef point = view.point(0);
-    for (PointId idx = 0; idx < view.size(); ++idx)
-    {
-        point.setPointId(idx);
-        processOne(point);
-    }
+    size_t numBands = (size_t)m_raster->bandCount();
+    gdal::GDALError error = m_raster->sampleView(view, nullptr,
+        [&](PointId idx, const double *values)
+        {
+            for (size_t b = 0; b < m_bands.size() && b < numBands; ++b)
+                view.setField(m_bands[b].m_dim, idx,
+                    values[b] * m_bands[b].m_scale);
+        });
+    if (error != gdal::GDALError::None)
+        throwError(m_raster->errorMsg());
 }
 
 } // namespace pdal
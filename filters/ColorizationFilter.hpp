@@ -86,6 +86,7 @@ private:
     StringList m_dimSpec;
     std::string m_rasterFilename;
     std::vector<BandInfo> m_bands;
+    uint64_t m_cacheSize;
 
     std::unique_ptr<gdal::Raster> m_raster;
 };
@@ -71,6 +71,8 @@ private:
     virtual void addDimensions(PointLayoutPtr layout);
     virtual void addArgs(ProgramArgs &args);
     virtual void filter(PointView &view);
+    virtual bool viewParallelSafe() const
+        { return true; }
     virtual void prepared(PointTableRef table);
 
     void setDimensionality(PointView &view, const PointId &id, const KD3Index &kid);
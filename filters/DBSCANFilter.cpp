@@ -38,7 +38,13 @@
 #include "DBSCANFilter.hpp"
 
 #include <pdal/KDIndex.hpp>
+#include <pdal/private/Parallel.hpp>
 
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <numeric>
 #include <string>
 #include <unordered_set>
 
@@ -69,6 +75,10 @@ void DBSCANFilter::addArgs(ProgramArgs& args)
     args.add("eps", "Epsilon", m_eps, 1.0);
     args.add("dimensions", "Dimensions to cluster", m_dimStringList,
              {"X", "Y", "Z"});
+    args.add("algorithm", "Clustering algorithm ('classic' or 'grid')",
+             m_algorithm, "classic");
+    args.add("threads", "Number of threads used by the 'grid' algorithm",
+             m_threads, 1);
 }
 
 void DBSCANFilter::addDimensions(PointLayoutPtr layout)
@@ -76,6 +86,12 @@ void DBSCANFilter::addDimensions(PointLayoutPtr layout)
     layout->registerDim(Id::ClusterID);
 }
 
+void DBSCANFilter::initialize()
+{
+    if (m_threads < 1)
+        throwError("Option 'threads' must be at least 1.");
+}
+
 void DBSCANFilter::prepared(PointTableRef table)
 {
     const PointLayoutPtr layout(table.layout());
@@ -92,9 +108,22 @@ void DBSCANFilter::prepared(PointTableRef table)
             m_dimIdList.push_back(id);
         }
     }
+
+    if (m_algorithm != "classic" && m_algorithm != "grid")
+        throwError("Option 'algorithm' must be either 'classic' or 'grid'.");
+    if (m_algorithm == "grid" && m_eps <= 0)
+        throwError("Option 'eps' must be greater than 0.");
 }
 
 void DBSCANFilter::filter(PointView& view)
+{
+    if (m_algorithm == "grid")
+        grid(view);
+    else
+        classic(view);
+}
+
+void DBSCANFilter::classic(PointView& view)
 {
     // Construct KDFlexIndex for radius search.
     KDFlexIndex kdfi(view, m_dimIdList);
@@ -171,4 +200,227 @@ void DBSCANFilter::filter(PointView& view)
     }
 }
 
+// Grid-based DBSCAN.  Points are sorted into cells 'eps' on a side, so the
+// neighbors of a point are all in its own cell or an adjacent one.  Core
+// points are found by counting neighbors in the adjacent cells, clusters are
+// formed by joining core points within 'eps' of each other with a
+// union-find, and each border point joins the lowest-numbered cluster with a
+// core point within 'eps'.  Clusters are numbered in the order of their
+// lowest-numbered core point, which gives the same result as the classic
+// algorithm without storing the neighbors of every point.
+void DBSCANFilter::grid(PointView& view)
+{
+    const size_t dims = m_dimIdList.size();
+    const size_t n = view.size();
+    const double eps2 = m_eps * m_eps;
+
+    // Sort the points by cell.  'order' maps a position in the sorted
+    // list to the point's ID.
+    std::vector<PointId> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::vector<int64_t> pointKeys(n * dims);
+    for (PointId idx = 0; idx < n; ++idx)
+        for (size_t d = 0; d < dims; ++d)
+            pointKeys[idx * dims + d] = (int64_t)std::floor(
+                view.getFieldAs<double>(m_dimIdList[d], idx) / m_eps);
+    auto keyLess = [dims](const int64_t *a, const int64_t *b)
+    {
+        return std::lexicographical_compare(a, a + dims, b, b + dims);
+    };
+    std::sort(order.begin(), order.end(),
+        [&pointKeys, &keyLess, dims](PointId a, PointId b)
+        { return keyLess(&pointKeys[a * dims], &pointKeys[b * dims]); });
+
+    // Copy the coordinates in sorted order and find the start of each cell.
+    std::vector<double> coords(n * dims);
+    std::vector<size_t> cellStart;
+    std::vector<int64_t> cellKeys;
+    for (size_t pos = 0; pos < n; ++pos)
+    {
+        const int64_t *key = &pointKeys[order[pos] * dims];
+        if (pos == 0 ||
+            !std::equal(key, key + dims, &pointKeys[order[pos - 1] * dims]))
+        {
+            cellStart.push_back(pos);
+            cellKeys.insert(cellKeys.end(), key, key + dims);
+        }
+        for (size_t d = 0; d < dims; ++d)
+            coords[pos * dims + d] =
+                view.getFieldAs<double>(m_dimIdList[d], order[pos]);
+    }
+    cellStart.push_back(n);
+    std::vector<int64_t>().swap(pointKeys);
+    const size_t numCells = cellStart.size() - 1;
+
+    auto findCell = [&](const int64_t *key)
+    {
+        size_t lo = 0;
+        size_t hi = numCells;
+        while (lo < hi)
+        {
+            size_t mid = (lo + hi) / 2;
+            if (keyLess(&cellKeys[mid * dims], key))
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        if (lo < numCells && std::equal(key, key + dims, &cellKeys[lo * dims]))
+            return lo;
+        return numCells;
+    };
+
+    // Find the cells adjacent to (and including) cell 'c'.
+    size_t numOffsets = 1;
+    for (size_t d = 0; d < dims; ++d)
+        numOffsets *= 3;
+    auto neighborCells = [&](size_t c, std::vector<size_t>& cells)
+    {
+        std::vector<int64_t> key(dims);
+        cells.clear();
+        for (size_t offset = 0; offset < numOffsets; ++offset)
+        {
+            size_t o = offset;
+            for (size_t d = 0; d < dims; ++d)
+            {
+                key[d] = cellKeys[c * dims + d] + (int64_t)(o % 3) - 1;
+                o /= 3;
+            }
+            size_t neighbor = findCell(key.data());
+            if (neighbor != numCells)
+                cells.push_back(neighbor);
+        }
+    };
+
+    auto close = [&](size_t a, size_t b)
+    {
+        double dist = 0;
+        for (size_t d = 0; d < dims; ++d)
+        {
+            double diff = coords[a * dims + d] - coords[b * dims + d];
+            dist += diff * diff;
+        }
+        return dist < eps2;
+    };
+
+    // Run 'work' for every cell.  Threads take blocks of cells as they
+    // finish so that dense areas don't hold up the others.
+    auto forEachCell = [this, numCells](
+        const std::function<void(size_t, std::vector<size_t>&)>& work)
+    {
+        parallelFor(numCells, m_threads, [&work](size_t begin, size_t end)
+        {
+            std::vector<size_t> neighbors;
+            for (size_t c = begin; c < end; ++c)
+                work(c, neighbors);
+        }, 256);
+    };
+
+    // Find core points.  A point is its own neighbor, as with a radius
+    // search.
+    std::vector<char> core(n, 0);
+    forEachCell([&](size_t c, std::vector<size_t>& neighbors)
+    {
+        neighborCells(c, neighbors);
+        for (size_t p = cellStart[c]; p < cellStart[c + 1]; ++p)
+        {
+            point_count_t count = 0;
+            for (size_t nc : neighbors)
+            {
+                for (size_t q = cellStart[nc];
+                        q < cellStart[nc + 1] && count < m_minPoints; ++q)
+                    if (close(p, q))
+                        count++;
+                if (count >= m_minPoints)
+                    break;
+            }
+            core[p] = (count >= m_minPoints);
+        }
+    });
+
+    // Join core points within 'eps' of each other.
+    std::vector<size_t> parent(n);
+    std::iota(parent.begin(), parent.end(), 0);
+    auto find = [&parent](size_t p)
+    {
+        while (parent[p] != p)
+        {
+            parent[p] = parent[parent[p]];
+            p = parent[p];
+        }
+        return p;
+    };
+
+    std::vector<size_t> neighbors;
+    for (size_t c = 0; c < numCells; ++c)
+    {
+        neighborCells(c, neighbors);
+        for (size_t p = cellStart[c]; p < cellStart[c + 1]; ++p)
+        {
+            if (!core[p])
+                continue;
+            for (size_t nc : neighbors)
+            {
+                // Each pair of cells is only checked once.
+                if (nc < c)
+                    continue;
+                size_t q = (nc == c) ? p + 1 : cellStart[nc];
+                for (; q < cellStart[nc + 1]; ++q)
+                {
+                    if (!core[q])
+                        continue;
+                    size_t rp = find(p);
+                    size_t rq = find(q);
+                    if (rp != rq && close(p, q))
+                        parent[(std::max)(rp, rq)] = (std::min)(rp, rq);
+                }
+            }
+        }
+    }
+
+    // Number the clusters in the order of their lowest point ID.
+    std::vector<PointId> firstId(n, (std::numeric_limits<PointId>::max)());
+    for (size_t p = 0; p < n; ++p)
+        if (core[p])
+        {
+            size_t r = find(p);
+            firstId[r] = (std::min)(firstId[r], order[p]);
+        }
+    std::vector<size_t> roots;
+    for (size_t p = 0; p < n; ++p)
+        if (core[p] && parent[p] == p)
+            roots.push_back(p);
+    std::sort(roots.begin(), roots.end(), [&firstId](size_t a, size_t b)
+        { return firstId[a] < firstId[b]; });
+    std::vector<PointId>().swap(firstId);
+
+    std::vector<int64_t> labels(n, -1);
+    for (size_t i = 0; i < roots.size(); ++i)
+        labels[roots[i]] = (int64_t)i;
+    for (size_t p = 0; p < n; ++p)
+        if (core[p])
+            labels[p] = labels[find(p)];
+
+    // Border points take the lowest label of the core points near them.
+    // Points that aren't near any core point are noise.
+    forEachCell([&](size_t c, std::vector<size_t>& neighbors)
+    {
+        neighborCells(c, neighbors);
+        for (size_t p = cellStart[c]; p < cellStart[c + 1]; ++p)
+        {
+            if (core[p])
+                continue;
+            int64_t label = -1;
+            for (size_t nc : neighbors)
+                for (size_t q = cellStart[nc]; q < cellStart[nc + 1]; ++q)
+                    if (core[q] && (label < 0 || labels[q] < label) &&
+                            close(p, q))
+                        label = labels[q];
+            labels[p] = label;
+        }
+    });
+
+    for (size_t pos = 0; pos < n; ++pos)
+        view.setField(Id::ClusterID, order[pos], labels[pos]);
+}
+
 } // namespace pdal
@@ -58,11 +58,17 @@ private:
     double m_eps;
     StringList m_dimStringList;
     Dimension::IdList m_dimIdList;
+    std::string m_algorithm;
+    int m_threads;
 
     virtual void addArgs(ProgramArgs& args);
     virtual void addDimensions(PointLayoutPtr layout);
+    virtual void initialize();
     virtual void prepared(PointTableRef table);
     virtual void filter(PointView& view);
+
+    void classic(PointView& view);
+    void grid(PointView& view);
 };
 
 } // namespace pdal
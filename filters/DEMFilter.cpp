@@ -34,6 +34,7 @@
 
 #include "DEMFilter.hpp"
 
+#include <algorithm>
 #include <string>
 #include <vector>
 
@@ -59,6 +60,7 @@ struct DEMArgs
     DimRange m_range;
     std::string m_raster;
     int32_t m_band;
+    uint64_t m_cacheSize;
 };
 
 
@@ -83,13 +85,16 @@ void DEMFilter::addArgs(ProgramArgs& args)
     args.add("limits", "Dimension limits for filtering", m_args->m_range).setPositional();
     args.add("raster", "GDAL-readable raster to use for DEM", m_args->m_raster).setPositional();
     args.add("band", "Band number to filter (count from 1)", m_args->m_band, 1);
-
+    args.add("cache_size", "Size of the raster block cache in megabytes",
+        m_args->m_cacheSize, (uint64_t)(gdal::Raster::DefaultCacheSize >> 20));
 }
 
 void DEMFilter::ready(PointTableRef table)
 {
     m_raster.reset(new gdal::Raster(m_args->m_raster));
-    m_raster->open();
+    if (m_raster->openForSampling(m_args->m_cacheSize << 20, m_args->m_band,
+            log()) != gdal::GDALError::None)
+        throwError(m_raster->errorMsg());
 }
 
 
@@ -102,6 +107,8 @@ void DEMFilter::prepared(PointTableRef table)
             "'in input PointView.");
     if (m_args->m_band <= 0)
         throwError("Band must be greater than 0");
+    if (m_args->m_cacheSize < 1)
+        throwError("Option 'cache_size' must be at least 1.");
 
 }
 
@@ -109,27 +116,28 @@ void DEMFilter::prepared(PointTableRef table)
 bool DEMFilter::processOne(PointRef& point)
 {
     static std::vector<double> data;
-    static std::array<double, 2> pix;
 
     double x = point.getFieldAs<double>(Dimension::Id::X);
     double y = point.getFieldAs<double>(Dimension::Id::Y);
     double z = point.getFieldAs<double>(m_args->m_dim);
 
-    bool passes(false);
-
-    if (m_raster->read(x, y, data, pix) == gdal::GDALError::None)
-    {
-        double v = data[m_args->m_band-1];
-        double lb = v - m_args->m_range.m_lower_bound;
-        double ub = v + m_args->m_range.m_upper_bound;
+    gdal::GDALError error = m_raster->read(x, y, data);
+    if (error == gdal::GDALError::NoData)
+        return false;
+    if (error != gdal::GDALError::None)
+        throwError(m_raster->errorMsg());
+    return passes(z, data[m_args->m_band - 1]);
+}
 
 
-        if ( z >= lb && z <= ub)
-            passes = true;
-    }
-    return passes;
+bool DEMFilter::passes(double z, double v) const
+{
+    double lb = v - m_args->m_range.m_lower_bound;
+    double ub = v + m_args->m_range.m_upper_bound;
+    return z >= lb && z <= ub;
 }
 
+
 PointViewSet DEMFilter::run(PointViewPtr inView)
 {
     PointViewSet viewSet;
@@ -137,13 +145,16 @@ PointViewSet DEMFilter::run(PointViewPtr inView)
         return viewSet;
 
     PointViewPtr outView = inView->makeNew();
-
-    for (PointId i = 0; i < inView->size(); ++i)
-    {
-        PointRef point = inView->point(i);
-        if (processOne(point))
-            outView->appendPoint(*inView, i);
-    }
+    size_t band = (size_t)m_args->m_band - 1;
+    gdal::GDALError error = m_raster->sampleView(*inView, nullptr,
+        [&](PointId idx, const double *values)
+        {
+            double z = inView->getFieldAs<double>(m_args->m_dim, idx);
+            if (passes(z, values[band]))
+                outView->appendPoint(*inView, idx);
+        });
+    if (error != gdal::GDALError::None)
+        throwError(m_raster->errorMsg());
 
     viewSet.insert(outView);
     return viewSet;
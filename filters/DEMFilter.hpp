@@ -71,6 +71,8 @@ private:
     virtual PointViewSet run(PointViewPtr view);
     virtual bool processOne(PointRef& point);
 
+    bool passes(double z, double v) const;
+
     DEMFilter& operator=(const DEMFilter&); // not implemented
     DEMFilter(const DEMFilter&); // not implemented
 };
@@ -61,6 +61,8 @@ private:
     virtual void addArgs(ProgramArgs& args);
     virtual void prepared(PointTableRef table);
     virtual void filter(PointView& view);
+    virtual bool viewParallelSafe() const
+        { return true; }
 };
 
 } // namespace pdal
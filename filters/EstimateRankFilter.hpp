@@ -61,6 +61,8 @@ private:
     virtual void addDimensions(PointLayoutPtr layout);
     virtual void addArgs(ProgramArgs& args);
     virtual void filter(PointView& view);
+    virtual bool viewParallelSafe() const
+        { return true; }
 };
 
 } // namespace pdal
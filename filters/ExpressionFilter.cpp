@@ -40,9 +40,11 @@
 
 
 
+#include <algorithm>
 #include <cctype>
 #include <limits>
 #include <map>
+#include <numeric>
 #include <string>
 #include <vector>
 
@@ -130,18 +132,26 @@ PointViewSet ExpressionFilter::run(PointViewPtr inView)
         views.push_back(outView);
     }
 
-    // eval our expression across each point for each view.
+    // eval our expression across each block of points for each view.
     // TODO: make this threaded
-    for (PointRef point : *inView)
+    const point_count_t BlockSize = 4096;
+    PointRef point(*inView, 0);
+    std::vector<PointId> ids;
+    std::vector<uint8_t> status(BlockSize);
+    for (PointId start = 0; start < inView->size(); start += BlockSize)
     {
+        PointId end = (std::min)(inView->size(), start + BlockSize);
+        ids.resize(end - start);
+        std::iota(ids.begin(), ids.end(), start);
         for (size_t i = 0; i < views.size(); i++)
         {
             auto& view = views[i];
             auto& expr = m_args->m_expressions[i];
 
-            bool status = expr.eval(point);
-            if (status)
-                view->appendPoint(*inView.get(), point.pointId());
+            expr.eval(point, ids.data(), ids.size(), status.data());
+            for (size_t j = 0; j < ids.size(); ++j)
+                if (status[j])
+                    view->appendPoint(*inView.get(), ids[j]);
         }
     }
 
@@ -33,12 +33,16 @@
 
 #include <pdal/KDIndex.hpp>
 #include <pdal/private/MathUtils.hpp>
+#include <pdal/private/Parallel.hpp>
 
 #include "private/delaunator.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
 #include <string>
 #include <vector>
-#include <cmath>
 
 namespace pdal
 {
@@ -97,6 +101,100 @@ double delaunay_interp_ground(double x0, double y0, PointViewPtr gView,
     return gView->getFieldAs<double>(Id::Z, ids[0]);
 }
 
+// Delaunay triangulation of all the ground points.  The triangle containing
+// a point is found by walking across the triangulation from a triangle
+// that touches a nearby ground point.
+class GroundSurface
+{
+public:
+    GroundSurface(PointView& gView) : m_vertexTri(gView.size(),
+        delaunator::INVALID_INDEX)
+    {
+        using namespace pdal::Dimension;
+
+        m_coords.reserve(gView.size() * 2);
+        m_z.reserve(gView.size());
+        for (PointId i = 0; i < gView.size(); ++i)
+        {
+            m_coords.push_back(gView.getFieldAs<double>(Id::X, i));
+            m_coords.push_back(gView.getFieldAs<double>(Id::Y, i));
+            m_z.push_back(gView.getFieldAs<double>(Id::Z, i));
+        }
+        m_triangulation.reset(new delaunator::Delaunator(m_coords));
+
+        const std::vector<size_t>& triangles(m_triangulation->triangles);
+        for (size_t e = 0; e < triangles.size(); ++e)
+            if (m_vertexTri[triangles[e]] == delaunator::INVALID_INDEX)
+                m_vertexTri[triangles[e]] = e / 3;
+    }
+
+    // Interpolate the ground height at (x0, y0), starting the search at a
+    // triangle touching ground point 'start'.  Returns infinity if the
+    // point is outside of the triangulation.
+    double interpolate(double x0, double y0, PointId start) const
+    {
+        const std::vector<size_t>& triangles(m_triangulation->triangles);
+        const std::vector<size_t>& halfedges(m_triangulation->halfedges);
+
+        if (triangles.empty())
+            return std::numeric_limits<double>::infinity();
+        size_t t = m_vertexTri[start];
+        if (t == delaunator::INVALID_INDEX)
+            t = 0;
+
+        // Step across any edge that has the point on its far side.  In a
+        // Delaunay triangulation this always reaches the containing
+        // triangle, but limit the steps in case of numerical trouble.
+        size_t numTriangles = triangles.size() / 3;
+        for (size_t step = 0; step <= numTriangles; ++step)
+        {
+            size_t next = delaunator::INVALID_INDEX;
+            for (size_t k = 0; k < 3; ++k)
+            {
+                size_t e = 3 * t + k;
+                size_t a = triangles[e];
+                size_t b = triangles[3 * t + (k + 1) % 3];
+                size_t c = triangles[3 * t + (k + 2) % 3];
+                if (side(a, b, x0, y0) * side(a, b, x(c), y(c)) < 0)
+                {
+                    next = e;
+                    break;
+                }
+            }
+            if (next == delaunator::INVALID_INDEX)
+            {
+                size_t a = triangles[3 * t];
+                size_t b = triangles[3 * t + 1];
+                size_t c = triangles[3 * t + 2];
+                return math::barycentricInterpolation(x(a), y(a), m_z[a],
+                    x(b), y(b), m_z[b], x(c), y(c), m_z[c], x0, y0);
+            }
+            if (halfedges[next] == delaunator::INVALID_INDEX)
+                break;
+            t = halfedges[next] / 3;
+        }
+        return std::numeric_limits<double>::infinity();
+    }
+
+private:
+    double x(size_t i) const
+        { return m_coords[2 * i]; }
+    double y(size_t i) const
+        { return m_coords[2 * i + 1]; }
+
+    // Positive if (px, py) is to the left of the line from a to b, negative
+    // if it's to the right.
+    double side(size_t a, size_t b, double px, double py) const
+    {
+        return (x(b) - x(a)) * (py - y(a)) - (y(b) - y(a)) * (px - x(a));
+    }
+
+    std::vector<double> m_coords;
+    std::vector<double> m_z;
+    std::unique_ptr<delaunator::Delaunator> m_triangulation;
+    std::vector<size_t> m_vertexTri;
+};
+
 } // unnamed namespace
 
 
@@ -127,6 +225,18 @@ void HagDelaunayFilter::addArgs(ProgramArgs& args)
     args.add("allow_extrapolation", "Allow extrapolation for points "
         "outside of the local triangulations. [Default: true].",
         m_allowExtrapolation, true);
+    args.add("triangulation", "Triangulate the 'count' ground points "
+        "nearest each point ('local') or all ground points once ('global')",
+        m_triangulation, "local");
+    args.add("threads", "Number of threads used to run this filter",
+        m_threads, 1);
+}
+
+
+void HagDelaunayFilter::initialize()
+{
+    if (m_threads < 1)
+        throwError("Option 'threads' must be at least 1.");
 }
 
 
@@ -140,6 +250,9 @@ void HagDelaunayFilter::prepared(PointTableRef table)
 {
     if (m_count < 3)
         throwError("Option 'count' must be at least 3.");
+    if (m_triangulation != "local" && m_triangulation != "global")
+        throwError("Option 'triangulation' must be either 'local' or "
+            "'global'.");
 
     const PointLayoutPtr layout(table.layout());
     if (!layout->hasDim(Dimension::Id::Classification))
@@ -175,59 +288,94 @@ void HagDelaunayFilter::filter(PointView& view)
             "points classified as ground.\n";
 
     // Build the 2D KD-tree.
-    const KD2Index& kdi = gView->build2dIndex();
+    const KD2Index& kdi = gView->build2dIndex(m_threads);
 
-    // Find Z difference between non-ground points and the nearest
-    // neighbor (2D) in the ground view or between non-ground points and the
-    // locally-computed surface (Delaunay triangultion of the neighborhood).
-    for (PointId i = 0; i < ngView->size(); ++i)
+    std::unique_ptr<GroundSurface> surface;
+    if (m_triangulation == "global" && gView->size())
     {
-        PointRef point = ngView->point(i);
-
-        // Non-ground view point for which we're trying to calc HAG
-        double x0 = point.getFieldAs<double>(Id::X);
-        double y0 = point.getFieldAs<double>(Id::Y);
-        double z0 = point.getFieldAs<double>(Id::Z);
-
-        PointIdList ids(m_count);
-        std::vector<double> sqr_dists(m_count);
-        kdi.knnSearch(x0, y0, m_count, &ids, &sqr_dists);
-
-        // Closest ground point.
-        double x = gView->getFieldAs<double>(Id::X, ids[0]);
-        double y = gView->getFieldAs<double>(Id::Y, ids[0]);
-        double z = gView->getFieldAs<double>(Id::Z, ids[0]);
-
-        double z1;
-        // If the close ground point is at the same X/Y as the non-ground
-        // point, we're done.  Also, if there's only one ground point, we
-        // just use that.
-        if ((x0 == x && y0 == y) || ids.size() == 1)
+        try
         {
-            z1 = z;
+            surface.reset(new GroundSurface(*gView));
         }
-        // If the non-ground point is outside the bounds of all the
-        // ground points and we're not doing extrapolation, just return
-        // its current Z, which will give a HAG of 0.
-        else if (!gBounds.contains(x0, y0) && !m_allowExtrapolation)
+        // In degenerate cases (all ground points are collinear), there is
+        // no triangulation and the nearest ground point is used.
+        catch (...)
         {
-            z1 = z0;
+            log()->get(LogLevel::Warning) << "Unable to triangulate ground "
+                "points. Using height of nearest ground point.\n";
         }
-        else
+    }
+
+    // Find Z difference between non-ground points and the nearest
+    // neighbor (2D) in the ground view or between non-ground points and the
+    // ground surface (Delaunay triangulation of the neighborhood or of all
+    // the ground points).
+    auto work = [&](size_t begin, size_t end)
+    {
+        const point_count_t count = surface ? 1 : m_count;
+        PointIdList ids(count);
+        std::vector<double> sqr_dists(count);
+        for (PointId i = begin; i < end; ++i)
         {
-            try
+            PointRef point = ngView->point(i);
+
+            // Non-ground view point for which we're trying to calc HAG
+            double x0 = point.getFieldAs<double>(Id::X);
+            double y0 = point.getFieldAs<double>(Id::Y);
+            double z0 = point.getFieldAs<double>(Id::Z);
+
+            ids.resize(count);
+            sqr_dists.resize(count);
+            kdi.knnSearch(x0, y0, count, &ids, &sqr_dists);
+
+            // Closest ground point.
+            double x = gView->getFieldAs<double>(Id::X, ids[0]);
+            double y = gView->getFieldAs<double>(Id::Y, ids[0]);
+            double z = gView->getFieldAs<double>(Id::Z, ids[0]);
+
+            double z1;
+            // If the close ground point is at the same X/Y as the non-ground
+            // point, we're done.  Also, if there's only one ground point, we
+            // just use that.
+            if ((x0 == x && y0 == y) || gView->size() == 1)
             {
-                z1 = delaunay_interp_ground(x0, y0, gView, ids);
+                z1 = z;
             }
-            // In degenerate cases (ids are collinear or duplicates), the above will throw,
-            // so treat x0/y0 as outside and assign the current value.
-            catch (...)
+            // If the non-ground point is outside the bounds of all the
+            // ground points and we're not doing extrapolation, just return
+            // its current Z, which will give a HAG of 0.
+            else if (!gBounds.contains(x0, y0) && !m_allowExtrapolation)
             {
                 z1 = z0;
             }
+            else if (m_triangulation == "global")
+            {
+                z1 = surface ? surface->interpolate(x0, y0, ids[0]) :
+                    std::numeric_limits<double>::infinity();
+                // If the non ground point is outside the triangulation,
+                // use the Z coordinate of the closest ground point.
+                if (z1 == std::numeric_limits<double>::infinity())
+                    z1 = z;
+            }
+            else
+            {
+                try
+                {
+                    z1 = delaunay_interp_ground(x0, y0, gView, ids);
+                }
+                // In degenerate cases (ids are collinear or duplicates), the
+                // above will throw, so treat x0/y0 as outside and assign the
+                // current value.
+                catch (...)
+                {
+                    z1 = z0;
+                }
+            }
+            ngView->setField(Dimension::Id::HeightAboveGround, i, z0 - z1);
         }
-        ngView->setField(Dimension::Id::HeightAboveGround, i, z0 - z1);
-    }
+    };
+
+    parallelFor(ngView->size(), m_threads, work);
 }
 
 } // namespace pdal
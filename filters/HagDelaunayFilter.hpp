@@ -58,12 +58,15 @@ public:
 
 private:
     virtual void addArgs(ProgramArgs& args);
+    virtual void initialize();
     virtual void addDimensions(PointLayoutPtr layout);
     virtual void prepared(PointTableRef table);
     virtual void filter(PointView& view);
 
     bool m_allowExtrapolation;
     point_count_t m_count;
+    std::string m_triangulation;
+    int m_threads;
 };
 
 } // namespace pdal
@@ -34,6 +34,9 @@
 
 #include "HagDemFilter.hpp"
 
+#include <algorithm>
+#include <vector>
+
 #include <pdal/private/gdal/Raster.hpp>
 
 namespace pdal
@@ -66,6 +69,8 @@ void HagDemFilter::addArgs(ProgramArgs& args)
     args.add("zero_ground", "If true, set HAG of ground-classified points "
         "to 0 rather than comparing Z value to raster DEM",
         m_zeroGround, true);
+    args.add("cache_size", "Size of the raster block cache in megabytes",
+        m_cacheSize, (uint64_t)(gdal::Raster::DefaultCacheSize >> 20));
 }
 
 
@@ -78,30 +83,49 @@ void HagDemFilter::addDimensions(PointLayoutPtr layout)
 void HagDemFilter::ready(PointTableRef table)
 {
     m_raster.reset(new gdal::Raster(m_rasterName));
-    m_raster->open();
+    if (m_raster->openForSampling(m_cacheSize << 20, m_band, log()) !=
+            gdal::GDALError::None)
+        throwError(m_raster->errorMsg());
 }
 
 void HagDemFilter::prepared(PointTableRef table)
 {
     if (m_band <= 0)
         throwError("Band must be greater than 0");
+    if (m_cacheSize < 1)
+        throwError("Option 'cache_size' must be at least 1.");
 }
 
 void HagDemFilter::filter(PointView& view)
 {
-    PointRef point(view, 0);
-    for (PointId i = 0; i < view.size(); ++i)
+    using namespace pdal::Dimension;
+
+    // If "zero_ground" option is set, all ground points get HAG of 0.
+    // Other points get a HAG if the raster has a value at their X, Y.
+    auto ground = [&](PointId idx)
     {
-        point.setPointId(i);
-        processOne(point);
-    }
+        return m_zeroGround && view.getFieldAs<uint8_t>(Id::Classification,
+            idx) == ClassLabel::Ground;
+    };
+    for (PointId idx = 0; idx < view.size(); ++idx)
+        if (ground(idx))
+            view.setField(Id::HeightAboveGround, idx, 0);
+
+    auto include = [&](PointId idx){ return !ground(idx); };
+    gdal::GDALError error = m_raster->sampleView(view, include,
+        [&](PointId idx, const double *values)
+        {
+            double z = view.getFieldAs<double>(Id::Z, idx);
+            view.setField(Id::HeightAboveGround, idx, z - values[m_band - 1]);
+        });
+    if (error != gdal::GDALError::None)
+        throwError(m_raster->errorMsg());
 }
 
 bool HagDemFilter::processOne(PointRef& point)
 {
     using namespace pdal::Dimension;
     static std::vector<double> data;
-    static std::array<double, 2> pix;
 
     // If "zero_ground" option is set, all ground points get HAG of 0
     if (m_zeroGround &&
@@ -116,7 +140,11 @@ bool HagDemFilter::processOne(PointRef& point)
 
         // If raster has a point at X, Y of pointcloud point, use it.
         // Otherwise the HAG value is not set.
-        if (m_raster->read(x, y, data, pix ) == gdal::GDALError::None)
+        gdal::GDALError error = m_raster->read(x, y, data);
+        if (error != gdal::GDALError::None &&
+                error != gdal::GDALError::NoData)
+            throwError(m_raster->errorMsg());
+        if (error == gdal::GDALError::None)
         {
             double z = point.getFieldAs<double>(Id::Z);
             double hag = z - data[m_band - 1];
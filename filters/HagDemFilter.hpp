@@ -70,6 +70,7 @@ private:
     std::string m_rasterName;
     bool m_zeroGround;
     int32_t m_band;
+    uint64_t m_cacheSize;
 };
 
 } // namespace pdal
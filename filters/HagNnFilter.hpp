@@ -61,6 +61,8 @@ private:
     virtual void addDimensions(PointLayoutPtr layout);
     virtual void prepared(PointTableRef table);
     virtual void filter(PointView& view);
+    virtual bool viewParallelSafe() const
+        { return true; }
 
     bool m_allowExtrapolation;
     double m_maxDistance;
@@ -38,6 +38,7 @@
 #include <vector>
 
 #include <pdal/KDIndex.hpp>
+#include <pdal/private/Parallel.hpp>
 
 namespace pdal
 {
@@ -94,6 +95,15 @@ void NNDistanceFilter::addArgs(ProgramArgs& args)
 {
     args.add("mode", "Distance computation mode (kth, avg)", m_mode, Mode::Kth);
     args.add("k", "k neighbors", m_k, size_t(10));
+    args.add("threads", "Number of threads used to run this filter",
+        m_threads, 1);
+}
+
+
+void NNDistanceFilter::initialize()
+{
+    if (m_threads < 1)
+        throwError("Option 'threads' must be at least 1.");
 }
 
 
@@ -108,34 +118,40 @@ void NNDistanceFilter::filter(PointView& view)
     using namespace Dimension;
 
     // Build the 3D KD-tree.
-    KD3Index& index = view.build3dIndex();
+    KD3Index& index = view.build3dIndex(m_threads);
 
     // Increment the minimum number of points, as knnSearch will be returning
     // the query point along with the neighbors.
     size_t k = m_k + 1;
 
     // Compute the k-distance for each point. The k-distance is the Euclidean
-    // distance to k-th nearest neighbor.
+    // distance to k-th nearest neighbor.  Neighbors are found for a block
+    // of points at a time.
     log()->get(LogLevel::Debug) << "Computing k-distances...\n";
-    for (PointId idx = 0; idx < view.size(); ++idx)
+    PointIdList indices;
+    std::vector<double> sqr_dists;
+    forEachBlock(view.size(), [&](const PointIdList& ids)
     {
-        PointIdList indices(k);
-        std::vector<double> sqr_dists(k);
-        index.knnSearch(idx, k, &indices, &sqr_dists);
-        double val;
-        if (m_mode == Mode::Kth)
-            val = std::sqrt(sqr_dists[k - 1]);
-        else // m_mode == Mode::Average
+        // If there are fewer than k points, the missing distances are zero.
+        size_t found = index.knnSearch(ids, k, indices, sqr_dists, m_threads);
+        for (size_t i = 0; i < ids.size(); ++i)
         {
-            val = 0;
-
-            // We start at 1 since index 0 is the test point.
-            for (size_t i = 1; i < k; ++i)
-                val += std::sqrt(sqr_dists[i]);
-            val /= (k - 1);
+            const double *dists = sqr_dists.data() + i * found;
+            double val;
+            if (m_mode == Mode::Kth)
+                val = (found == k) ? std::sqrt(dists[k - 1]) : 0;
+            else // m_mode == Mode::Average
+            {
+                val = 0;
+
+                // We start at 1 since index 0 is the test point.
+                for (size_t j = 1; j < found; ++j)
+                    val += std::sqrt(dists[j]);
+                val /= (k - 1);
+            }
+            view.setField(Dimension::Id::NNDistance, ids[i], val);
         }
-        view.setField(Dimension::Id::NNDistance, idx, val);
-    }
+    });
 }
 
 } // namespace pdal
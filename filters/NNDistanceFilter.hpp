@@ -62,10 +62,14 @@ private:
 
     size_t m_k;
     Mode m_mode;
+    int m_threads;
 
     virtual void addArgs(ProgramArgs& args);
+    virtual void initialize();
     virtual void addDimensions(PointLayoutPtr layout);
     virtual void filter(PointView& view);
+    virtual bool viewParallelSafe() const
+        { return true; }
 
     friend std::istream& operator>>(std::istream& in,
         NNDistanceFilter::Mode& mode);
@@ -46,9 +46,11 @@
 #include <pdal/KDIndex.hpp>
 #include <pdal/util/ProgramArgs.hpp>
 #include <pdal/private/MathUtils.hpp>
+#include <pdal/private/Parallel.hpp>
 
 #include <Eigen/Dense>
 
+#include <algorithm>
 #include <string>
 #include <vector>
 
@@ -70,8 +72,55 @@ struct NormalArgs
     filter::Point m_viewpoint;
     bool m_up;
     bool m_refine;
+    int m_threads;
 };
 
+namespace
+{
+
+struct NormalResult
+{
+    Vector3d normal;
+    double curvature;
+    bool zeroCovariance;
+    bool solved;
+};
+
+// Compute the normal/curvature of a point from its neighborhood.
+NormalResult computeNormal(const PointView& view, const PointIdList& neighbors)
+{
+    NormalResult r { Vector3d::Zero(), 0, false, false };
+
+    // Perform eigen decomposition of covariance matrix computed from
+    // neighborhood composed of k-nearest neighbors.
+    auto B = math::computeCovariance(view, neighbors);
+
+    // Check if the covariance matrix is all zeros
+    if (B.isZero())
+    {
+        r.zeroCovariance = true;
+        return r;
+    }
+
+    SelfAdjointEigenSolver<Matrix3d> solver(B);
+    if (solver.info() != Success)
+        return r;
+    r.solved = true;
+
+    // The curvature is computed as the ratio of the first (smallest)
+    // eigenvalue to the sum of all eigenvalues.
+    auto eval = solver.eigenvalues();
+    double sum = eval[0] + eval[1] + eval[2];
+    r.curvature = sum ? std::fabs(eval[0] / sum) : 0;
+
+    // The normal is defined by the eigenvector corresponding to the
+    // smallest eigenvalue.
+    r.normal = solver.eigenvectors().col(0);
+    return r;
+}
+
+} // unnamed namespace
+
 NormalFilter::NormalFilter() : m_args(new NormalArgs), m_count(0) {}
 
 NormalFilter::~NormalFilter() {}
@@ -91,6 +140,8 @@ void NormalFilter::addArgs(ProgramArgs& args)
     args.add("refine",
              "Refine normals using minimum spanning tree propagation?",
              m_args->m_refine, false);
+    args.add("threads", "Number of threads used to run this filter",
+             m_args->m_threads, 1);
 }
 
 void NormalFilter::addDimensions(PointLayoutPtr layout)
@@ -110,6 +161,12 @@ void NormalFilter::doFilter(PointView& view, int knn)
     filter(view);
 }
 
+void NormalFilter::initialize()
+{
+    if (m_args->m_threads < 1)
+        throwError("Option 'threads' must be at least 1.");
+}
+
 void NormalFilter::prepared(PointTableRef table)
 {
     if (m_args->m_up && m_viewpointArg->set())
@@ -127,65 +184,82 @@ void NormalFilter::prepared(PointTableRef table)
 void NormalFilter::compute(PointView& view, KD3Index& kdi)
 {
     log()->get(LogLevel::Debug) << "Computing normal vectors\n";
-    for (auto&& p : view)
+
+    // Points are processed in blocks.  The neighbors and normals of the
+    // points in a block are computed using all threads, after which the
+    // normals are oriented and written to the view.
+    PointIdList neighbors;
+    std::vector<double> sqr_dists;
+    std::vector<NormalResult> results;
+    forEachBlock(view.size(), [&](const PointIdList& ids)
     {
-        // Perform eigen decomposition of covariance matrix computed from
-        // neighborhood composed of k-nearest neighbors.
-        PointIdList neighbors = kdi.neighbors(p.pointId(), m_args->m_knn);
-        auto B = math::computeCovariance(view, neighbors);
+        point_count_t k =
+            kdi.knnSearch(ids, m_args->m_knn, neighbors, sqr_dists,
+                m_args->m_threads);
 
-        // Check if the covariance matrix is all zeros
-        if (B.isZero())
+        results.resize(ids.size());
+        auto work = [&](size_t first, size_t last)
         {
-            log()->get(LogLevel::Info)
-                << "Skipping point " << p.pointId()
-                << ". Covariance matrix is all zeros. This suggests a large "
-                   "number of redundant points. Consider using filters.sample "
-                   "with a small radius to remove redundant points.\n";
-            continue;
-        }
+            PointIdList nbrs(k);
+            for (size_t i = first; i < last; ++i)
+            {
+                std::copy(neighbors.begin() + i * k,
+                    neighbors.begin() + (i + 1) * k, nbrs.begin());
+                results[i] = computeNormal(view, nbrs);
+            }
+        };
 
-        SelfAdjointEigenSolver<Matrix3d> solver(B);
-        if (solver.info() != Success)
-            throwError("Cannot perform eigen decomposition.");
+        parallelFor(ids.size(), m_args->m_threads, work);
 
-        // The curvature is computed as the ratio of the first (smallest)
-        // eigenvalue to the sum of all eigenvalues.
-        auto eval = solver.eigenvalues();
-        double sum = eval[0] + eval[1] + eval[2];
-        double curvature = sum ? std::fabs(eval[0] / sum) : 0;
+        for (size_t i = 0; i < ids.size(); ++i)
+        {
+            PointRef p(view, ids[i]);
+            NormalResult& r = results[i];
+            if (r.zeroCovariance)
+            {
+                log()->get(LogLevel::Info)
+                    << "Skipping point " << p.pointId()
+                    << ". Covariance matrix is all zeros. This suggests a "
+                       "large number of redundant points. Consider using "
+                       "filters.sample with a small radius to remove "
+                       "redundant points.\n";
+                continue;
+            }
+            if (!r.solved)
+                throwError("Cannot perform eigen decomposition.");
 
-        // The normal is defined by the eigenvector corresponding to the
-        // smallest eigenvalue.
-        Vector3d normal = solver.eigenvectors().col(0);
+            Vector3d& normal = r.normal;
+            if (m_viewpointArg->set())
+            {
+                // If a viewpoint has been specified, orient the normals to
+                // face the viewpoint by taking the dot product of the vector
+                // connecting the point with the viewpoint and the normal.
+                // Flip the normal, where the dot product is negative.
+                double dx = m_args->m_viewpoint.x() -
+                    p.getFieldAs<double>(Id::X);
+                double dy = m_args->m_viewpoint.y() -
+                    p.getFieldAs<double>(Id::Y);
+                double dz = m_args->m_viewpoint.z() -
+                    p.getFieldAs<double>(Id::Z);
+                Vector3d vp(dx, dy, dz);
+                if (vp.dot(normal) < 0)
+                    normal *= -1.0;
+            }
+            else if (m_args->m_up)
+            {
+                // If normals are expected to be upward facing, invert them
+                // when the Z component is negative.
+                if (normal[2] < 0)
+                    normal *= -1.0;
+            }
 
-        if (m_viewpointArg->set())
-        {
-            // If a viewpoint has been specified, orient the normals to face the
-            // viewpoint by taking the dot product of the vector connecting the
-            // point with the viewpoint and the normal. Flip the normal, where
-            // the dot product is negative.
-            double dx = m_args->m_viewpoint.x() - p.getFieldAs<double>(Id::X);
-            double dy = m_args->m_viewpoint.y() - p.getFieldAs<double>(Id::Y);
-            double dz = m_args->m_viewpoint.z() - p.getFieldAs<double>(Id::Z);
-            Vector3d vp(dx, dy, dz);
-            if (vp.dot(normal) < 0)
-                normal *= -1.0;
+            // Set the computed normal and curvature dimensions.
+            p.setField(Id::NormalX, normal[0]);
+            p.setField(Id::NormalY, normal[1]);
+            p.setField(Id::NormalZ, normal[2]);
+            p.setField(Id::Curvature, r.curvature);
         }
-        else if (m_args->m_up)
-        {
-            // If normals are expected to be upward facing, invert them when the
-            // Z component is negative.
-            if (normal[2] < 0)
-                normal *= -1.0;
-        }
-
-        // Set the computed normal and curvature dimensions.
-        p.setField(Id::NormalX, normal[0]);
-        p.setField(Id::NormalY, normal[1]);
-        p.setField(Id::NormalZ, normal[2]);
-        p.setField(Id::Curvature, curvature);
-    }
+    });
 }
 
 void NormalFilter::update(
@@ -289,7 +363,7 @@ void NormalFilter::refine(PointView& view, KD3Index& kdi)
 
 void NormalFilter::filter(PointView& view)
 {
-    KD3Index& kdi = view.build3dIndex();
+    KD3Index& kdi = view.build3dIndex(m_args->m_threads);
 
     // Compute the normal/curvature and optionally orient toward viewpoint or
     // positive Z.
@@ -300,4 +374,10 @@ void NormalFilter::filter(PointView& view)
         refine(view, kdi);
 }
 
+// Refinement keeps a count of visited points in the filter.
+bool NormalFilter::viewParallelSafe() const
+{
+    return !m_args->m_refine;
+}
+
 } // namespace pdal
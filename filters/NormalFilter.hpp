@@ -97,8 +97,10 @@ private:
 
     virtual void addArgs(ProgramArgs& args);
     virtual void addDimensions(PointLayoutPtr layout);
+    virtual void initialize();
     virtual void prepared(PointTableRef table);
     virtual void filter(PointView& view);
+    virtual bool viewParallelSafe() const;
 };
 
 } // namespace pdal
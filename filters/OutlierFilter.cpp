@@ -35,6 +35,7 @@
 #include "OutlierFilter.hpp"
 
 #include <pdal/KDIndex.hpp>
+#include <pdal/private/Parallel.hpp>
 #include <pdal/util/ProgramArgs.hpp>
 #include <pdal/util/Utils.hpp>
 
@@ -67,6 +68,14 @@ void OutlierFilter::addArgs(ProgramArgs& args)
     args.add("mean_k", "Mean number of neighbors", m_meanK, 8);
     args.add("multiplier", "Standard deviation threshold", m_multiplier, 2.0);
     args.add("class", "Class to use for noise points", m_class, ClassLabel::LowPoint);
+    args.add("threads", "Number of threads used to run this filter",
+        m_threads, 1);
+}
+
+void OutlierFilter::initialize()
+{
+    if (m_threads < 1)
+        throwError("Option 'threads' must be at least 1.");
 }
 
 void OutlierFilter::addDimensions(PointLayoutPtr layout)
@@ -77,20 +86,23 @@ void OutlierFilter::addDimensions(PointLayoutPtr layout)
 Indices OutlierFilter::processRadius(PointViewPtr inView)
 {
     KD3Index index(*inView);
-    index.build();
+    index.build(m_threads);
 
     point_count_t np = inView->size();
 
     PointIdList inliers, outliers;
 
-    for (PointId i = 0; i < np; ++i)
+    forEachBlock(np, [&](const PointIdList& block)
     {
-        auto ids = index.radius(i, m_radius);
-        if (ids.size() > size_t(m_minK))
-            inliers.push_back(i);
-        else
-            outliers.push_back(i);
-    }
+        std::vector<PointIdList> ids = index.radius(block, m_radius, m_threads);
+        for (size_t i = 0; i < block.size(); ++i)
+        {
+            if (ids[i].size() > size_t(m_minK))
+                inliers.push_back(block[i]);
+            else
+                outliers.push_back(block[i]);
+        }
+    });
 
     return Indices{inliers, outliers};
 }
@@ -98,7 +110,7 @@ Indices OutlierFilter::processRadius(PointViewPtr inView)
 Indices OutlierFilter::processStatistical(PointViewPtr inView)
 {
     KD3Index index(*inView);
-    index.build();
+    index.build(m_threads);
 
     point_count_t np = inView->size();
 
@@ -109,21 +121,25 @@ Indices OutlierFilter::processStatistical(PointViewPtr inView)
     // we increase the count by one because the query point itself will
     // be included with a distance of 0
     point_count_t count = m_meanK + 1;
-    PointIdList indices(count);
-    std::vector<double> sqr_dists(count);
-    for (PointId i = 0; i < np; ++i)
+    PointIdList indices;
+    std::vector<double> sqr_dists;
+    forEachBlock(np, [&](const PointIdList& block)
     {
-
-        index.knnSearch(i, count, &indices, &sqr_dists);
-
-        for (size_t j = 1; j < count; ++j)
+        // If there are fewer than 'count' points, the missing distances
+        // are zero.
+        point_count_t found =
+            index.knnSearch(block, count, indices, sqr_dists, m_threads);
+        for (size_t b = 0; b < block.size(); ++b)
         {
-            double delta = std::sqrt(sqr_dists[j]) - distances[i];
-            distances[i] += (delta / j);
+            PointId i = block[b];
+            for (size_t j = 1; j < count; ++j)
+            {
+                double d = (j < found) ? sqr_dists[b * found + j] : 0.0;
+                double delta = std::sqrt(d) - distances[i];
+                distances[i] += (delta / j);
+            }
         }
-        indices.clear(); indices.resize(count);
-        sqr_dists.clear(); sqr_dists.resize(count);
-    }
+    });
 
     size_t n(0);
     double M1(0.0);
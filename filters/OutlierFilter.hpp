@@ -67,12 +67,16 @@ private:
     int m_meanK;
     double m_multiplier;
     uint8_t m_class;
+    int m_threads;
 
     virtual void addDimensions(PointLayoutPtr layout);
     virtual void addArgs(ProgramArgs& args);
+    virtual void initialize();
     Indices processRadius(PointViewPtr inView);
     Indices processStatistical(PointViewPtr inView);
     virtual PointViewSet run(PointViewPtr view);
+    virtual bool viewParallelSafe() const
+        { return true; }
 
     OutlierFilter& operator=(const OutlierFilter&); // not implemented
     OutlierFilter(const OutlierFilter&);            // not implemented
@@ -34,16 +34,19 @@
 
 #include "OverlayFilter.hpp"
 
-#include <thread>
+#include <cmath>
 #include <vector>
 
 #include <ogr_api.h>
 
 #include <pdal/Polygon.hpp>
 #include <pdal/util/ProgramArgs.hpp>
+#include <pdal/private/Parallel.hpp>
 #include <pdal/private/gdal/GDALUtils.hpp>
 #include <pdal/private/gdal/SpatialRef.hpp>
 
+#include "private/StrTree.hpp"
+
 namespace pdal
 {
 
@@ -57,6 +60,13 @@ static StaticPluginInfo const s_info
 
 CREATE_STATIC_STAGE(OverlayFilter, s_info)
 
+OverlayFilter::OverlayFilter() : m_ds(0), m_lyr(0), m_index(new StrTree)
+{}
+
+
+OverlayFilter::~OverlayFilter()
+{}
+
 
 void OverlayFilter::addArgs(ProgramArgs& args)
 {
@@ -76,6 +86,8 @@ void OverlayFilter::addArgs(ProgramArgs& args)
 
 void OverlayFilter::initialize()
 {
+    if (m_threads < 1)
+        throwError("Option 'threads' must be at least 1.");
     gdal::registerDrivers();
 }
 
@@ -85,8 +97,6 @@ void OverlayFilter::prepared(PointTableRef table)
     m_dim = table.layout()->findDim(m_dimName);
     if (m_dim == Dimension::Id::Unknown)
         throwError("Dimension '" + m_dimName + "' not found.");
-    if (m_threads < 1)
-        throwError("Number of threads should be positive.");
 }
 
 
@@ -146,12 +156,25 @@ void OverlayFilter::ready(PointTableRef table)
     }
     while (feature);
 
-    // Initialise m_grids, otherwise this will lead to a race condition when
-    // using threading.
-    for (const auto& poly : m_polygons)
+    buildIndex();
+}
+
+
+// Index the bounds of the polygons.  This must be done again whenever the
+// polygons are transformed.
+void OverlayFilter::buildIndex()
+{
+    std::vector<BOX2D> boxes;
+    boxes.reserve(m_polygons.size());
+    for (auto& poly : m_polygons)
     {
+        // Initialise m_grids, otherwise this will lead to a race condition
+        // when using threading.
         poly.geom.initGrids();
+        poly.bounds = poly.geom.bounds().to2d();
+        boxes.push_back(poly.bounds);
     }
+    m_index->build(boxes);
 }
 
 
@@ -165,52 +188,128 @@ void OverlayFilter::spatialReferenceChanged(const SpatialReference& srs)
         if (!ok)
             throwError(ok.what());
     }
+    buildIndex();
 }
 
 
-bool OverlayFilter::processOne(PointRef& point)
+// Set the dimension from the first of the candidate polygons that contains
+// the point.  Candidates are in the order the polygons were read.
+void OverlayFilter::overlay(PointRef& point, double x, double y,
+    const std::vector<size_t>& candidates)
 {
-    for (const auto& poly : m_polygons)
+    for (size_t idx : candidates)
     {
-        double x = point.getFieldAs<double>(Dimension::Id::X);
-        double y = point.getFieldAs<double>(Dimension::Id::Y);
-        if (poly.geom.contains(x, y))
+        const PolyVal& poly = m_polygons[idx];
+        if (poly.bounds.contains(x, y) && poly.geom.contains(x, y))
         {
             point.setField(m_dim, poly.val);
             break;
         }
     }
+}
+
+
+bool OverlayFilter::processOne(PointRef& point)
+{
+    double x = point.getFieldAs<double>(Dimension::Id::X);
+    double y = point.getFieldAs<double>(Dimension::Id::Y);
+
+    m_candidates.clear();
+    m_index->query(x, y, m_candidates);
+    overlay(point, x, y, m_candidates);
     return true;
 }
 
 
+// Points are bucketed into grid cells and processed a cell at a time.
+// The polygon index is queried once for each cell and the points in the
+// cell are only tested against the polygons whose bounds overlap the cell.
+// Nearby points are tested together, which also keeps the point-in-polygon
+// grids of the candidate polygons in cache.
 void OverlayFilter::filter(PointView& view)
 {
+    // Average number of points in a cell.
+    const double CellPoints = 64;
+
+    if (view.empty() || m_polygons.empty())
+        return;
+
+    BOX2D bounds;
+    view.calculateBounds(bounds);
+
     point_count_t npoints = view.size();
-    point_count_t chunk_size = npoints / m_threads;
-    if (npoints % m_threads) chunk_size++;
-    std::vector<std::thread> threadList(m_threads);
+    size_t side = (std::max)((size_t)1,
+        (size_t)std::ceil(std::sqrt(npoints / CellPoints)));
+    double width = (bounds.maxx - bounds.minx) / side;
+    double height = (bounds.maxy - bounds.miny) / side;
+    auto cellPos = [&](double v, double min, double size)
+    {
+        if (size <= 0)
+            return (size_t)0;
+        return (std::min)((size_t)((v - min) / size), side - 1);
+    };
 
-    for (int t = 0; t < m_threads; t++)
+    // Counting sort of the point IDs by cell.
+    std::vector<size_t> cells(npoints);
+    std::vector<PointId> offsets(side * side + 1);
+    for (PointId id = 0; id < npoints; ++id)
     {
-        threadList[t] = std::thread(
-            [&](const PointId start, const PointId end) {
-                PointRef point(view, start);
-
-                for (PointId id = start; id < end; id++)
-                {
-                    point.setPointId(id);
-                    processOne(point);
-                }
-            },
-            t * chunk_size,
-            (t + 1) == m_threads ? npoints : (t + 1) * chunk_size
-        );
+        size_t col = cellPos(view.getFieldAs<double>(Dimension::Id::X, id),
+            bounds.minx, width);
+        size_t row = cellPos(view.getFieldAs<double>(Dimension::Id::Y, id),
+            bounds.miny, height);
+        cells[id] = row * side + col;
+        offsets[cells[id] + 1]++;
     }
+    for (size_t i = 1; i < offsets.size(); ++i)
+        offsets[i] += offsets[i - 1];
+    std::vector<PointId> ids(npoints);
+    {
+        std::vector<PointId> pos(offsets.begin(), offsets.end() - 1);
+        for (PointId id = 0; id < npoints; ++id)
+            ids[pos[cells[id]]++] = id;
+    }
+    cells = std::vector<size_t>();
 
-    for (auto& t : threadList)
-        t.join();
-
+    // Cells are handed out one at a time, since they may differ greatly in
+    // the number of points and candidate polygons.
+    parallelFor(side * side, m_threads, [&](size_t first, size_t last)
+    {
+        PointRef point(view);
+        std::vector<size_t> candidates;
+        std::vector<std::pair<double, double>> xy;
+        for (size_t cell = first; cell < last; ++cell)
+        {
+            PointId begin = offsets[cell];
+            PointId end = offsets[cell + 1];
+            if (begin == end)
+                continue;
+
+            // Use the bounds of the points rather than the bounds of the
+            // cell so that rounding can't leave a point outside of its cell.
+            BOX2D cellBounds;
+            xy.clear();
+            for (PointId i = begin; i < end; ++i)
+            {
+                point.setPointId(ids[i]);
+                double x = point.getFieldAs<double>(Dimension::Id::X);
+                double y = point.getFieldAs<double>(Dimension::Id::Y);
+                cellBounds.grow(x, y);
+                xy.push_back({ x, y });
+            }
+
+            candidates.clear();
+            m_index->query(cellBounds, candidates);
+            if (candidates.empty())
+                continue;
+            for (PointId i = begin; i < end; ++i)
+            {
+                point.setPointId(ids[i]);
+                overlay(point, xy[i - begin].first, xy[i - begin].second,
+                    candidates);
+            }
+        }
+    }, 1);
 }
 
 } // namespace pdal
@@ -68,6 +68,7 @@ typedef std::shared_ptr<void> OGRFeaturePtr;
 #endif
 
 class Arg;
+class StrTree;
 
 class PDAL_EXPORT OverlayFilter : public Filter, public Streamable
 {
@@ -75,11 +76,12 @@ class PDAL_EXPORT OverlayFilter : public Filter, public Streamable
     {
         Polygon geom;
         int32_t val;
+        BOX2D bounds;
     };
 
 public:
-    OverlayFilter() : m_ds(0), m_lyr(0)
-    {}
+    OverlayFilter();
+    ~OverlayFilter();
 
     std::string getName() const { return "filters.overlay"; }
 
@@ -92,6 +94,10 @@ private:
     virtual void ready(PointTableRef table);
     virtual void filter(PointView& view);
 
+    void buildIndex();
+    void overlay(PointRef& point, double x, double y,
+        const std::vector<size_t>& candidates);
+
     OverlayFilter& operator=(const OverlayFilter&) = delete;
     OverlayFilter(const OverlayFilter&) = delete;
 
@@ -104,6 +110,8 @@ private:
     std::string m_layer;
     Dimension::Id m_dim;
     std::vector<PolyVal> m_polygons;
+    std::unique_ptr<StrTree> m_index;
+    std::vector<size_t> m_candidates;
     BOX2D m_bounds;
     int m_threads;
 
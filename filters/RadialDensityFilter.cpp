@@ -35,8 +35,10 @@
 #include "RadialDensityFilter.hpp"
 
 #include <pdal/KDIndex.hpp>
+#include <pdal/private/Parallel.hpp>
 
 #include <string>
+#include <vector>
 
 namespace pdal
 {
@@ -60,6 +62,14 @@ std::string RadialDensityFilter::getName() const
 void RadialDensityFilter::addArgs(ProgramArgs& args)
 {
     args.add("radius", "Radius", m_rad, 1.0);
+    args.add("threads", "Number of threads used to run this filter",
+        m_threads, 1);
+}
+
+void RadialDensityFilter::initialize()
+{
+    if (m_threads < 1)
+        throwError("Option 'threads' must be at least 1.");
 }
 
 void RadialDensityFilter::addDimensions(PointLayoutPtr layout)
@@ -70,18 +80,19 @@ void RadialDensityFilter::addDimensions(PointLayoutPtr layout)
 void RadialDensityFilter::filter(PointView& view)
 {
     // Build the 3D KD-tree.
-    const KD3Index& index = view.build3dIndex();
+    const KD3Index& index = view.build3dIndex(m_threads);
 
     // Search for neighboring points within the specified radius. The number of
     // neighbors (which includes the query point) is normalized by the volume
     // of the search sphere and recorded as the density.
     log()->get(LogLevel::Debug) << "Computing densities...\n";
     double factor = 1.0 / ((4.0 / 3.0) * 3.14159 * (m_rad * m_rad * m_rad));
-    for (PointRef p : view)
+    forEachBlock(view.size(), [&](const PointIdList& ids)
     {
-        PointIdList pts = index.radius(p, m_rad);
-        p.setField(Id::RadialDensity, pts.size() * factor);
-    }
+        std::vector<PointIdList> pts = index.radius(ids, m_rad, m_threads);
+        for (size_t i = 0; i < ids.size(); ++i)
+            view.setField(Id::RadialDensity, ids[i], pts[i].size() * factor);
+    });
 }
 
 } // namespace pdal
@@ -55,10 +55,14 @@ public:
 
 private:
     double m_rad;
+    int m_threads;
 
     virtual void addArgs(ProgramArgs& args);
+    virtual void initialize();
     virtual void addDimensions(PointLayoutPtr layout);
     virtual void filter(PointView& view);
+    virtual bool viewParallelSafe() const
+        { return true; }
 };
 
 } // namespace pdal
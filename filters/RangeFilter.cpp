@@ -102,6 +102,16 @@ bool RangeFilter::processOne(PointRef& point)
 }
 
 
+void RangeFilter::processBatch(StreamPointTable& table,
+    const std::vector<uint8_t>& active, point_count_t count)
+{
+    DimRange::pointsPass(m_ranges, table, active, count, m_passes);
+    for (PointId idx = 0; idx < count; ++idx)
+        if (active[idx] && !m_passes[idx])
+            table.setSkip(idx);
+}
+
+
 PointViewSet RangeFilter::run(PointViewPtr inView)
 {
     PointViewSet viewSet;
@@ -56,10 +56,13 @@ public:
 
 private:
     std::vector<DimRange> m_ranges;
+    std::vector<uint8_t> m_passes;
 
     virtual void addArgs(ProgramArgs& args);
     virtual void prepared(PointTableRef table);
     virtual bool processOne(PointRef& point);
+    virtual void processBatch(StreamPointTable& table,
+        const std::vector<uint8_t>& active, point_count_t count);
     virtual PointViewSet run(PointViewPtr view);
 
     RangeFilter& operator=(const RangeFilter&) = delete;
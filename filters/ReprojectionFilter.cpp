@@ -35,14 +35,25 @@
 #include "ReprojectionFilter.hpp"
 
 #include <pdal/PointView.hpp>
+#include <pdal/private/Parallel.hpp>
 #include <pdal/private/SrsTransform.hpp>
 #include <pdal/util/ProgramArgs.hpp>
 
-//#include <memory>
+#include <algorithm>
+#include <memory>
+#include <numeric>
 
 namespace pdal
 {
 
+namespace
+{
+
+// Number of points transformed with each call to PROJ.
+const size_t BlockSize = 4096;
+
+} // unnamed namespace
+
 static StaticPluginInfo const s_info
 {
     "filters.reprojection",
@@ -72,11 +83,15 @@ void ReprojectionFilter::addArgs(ProgramArgs& args)
     args.add("out_coord_epoch", "Output coordinate epoch for transformation", m_outCoordEpochArg);
     args.add("error_on_failure", "Throw an exception if we can't reproject any point",
         m_errorOnFailure);
+    args.add("threads", "Number of threads used to transform points",
+        m_threads, 1);
 }
 
 
 void ReprojectionFilter::initialize()
 {
+    if (m_threads < 1)
+        throwError("Option 'threads' must be at least 1.");
     m_inferInputSRS = m_inSRS.empty();
     setSpatialReference(m_outSRS);
 }
@@ -183,12 +198,55 @@ PointViewSet ReprojectionFilter::run(PointViewPtr view)
 
     createTransform(view->spatialReference());
 
+    const point_count_t size = view->size();
+    std::vector<char> ok(size);
+
+    const point_count_t blocks = (size + BlockSize - 1) / BlockSize;
+    const int threads = (int)(std::max)(point_count_t(1),
+        (std::min)((point_count_t)m_threads, blocks));
+    const point_count_t chunkSize =
+        ((blocks + threads - 1) / threads) * BlockSize;
+
+    // PROJ transforms aren't thread-safe, so each range of points other
+    // than the first uses a copy.  The copies are made before the original
+    // is used.
+    std::vector<std::unique_ptr<SrsTransform>> transforms;
+    for (int t = 1; t < threads; t++)
+    {
+        transforms.emplace_back(new SrsTransform(*m_transform));
+        if (!transforms.back()->valid())
+            throwError("Unable to copy coordinate transformation.");
+    }
+
+    // Each range of points is transformed in blocks.
+    parallelFor(size, threads, [&](size_t begin, size_t end)
+    {
+        const size_t t = begin / chunkSize;
+        const SrsTransform& transform = t ? *transforms[t - 1] : *m_transform;
+
+        PointRef point(*view, 0);
+        Block block;
+        std::vector<PointId> ids;
+        for (PointId start = begin; start < end; start += BlockSize)
+        {
+            size_t count = (std::min)((PointId)BlockSize, end - start);
+            ids.resize(count);
+            std::iota(ids.begin(), ids.end(), start);
+            transformPoints(transform, point, ids.data(), count, block,
+                ok.data() + start);
+        }
+    }, chunkSize);
+
     PointRef point(*view, 0);
-    for (PointId id = 0; id < view->size(); ++id)
+    for (PointId id = 0; id < size; ++id)
     {
-        point.setPointId(id);
-        if (processOne(point))
+        if (ok[id])
             outView->appendPoint(*view, id);
+        else if (m_errorOnFailure)
+        {
+            point.setPointId(id);
+            throwFailure(point);
+        }
     }
 
     viewSet.insert(outView);
@@ -196,6 +254,72 @@ PointViewSet ReprojectionFilter::run(PointViewPtr view)
 }
 
 
+// Gather the coordinates of the points 'ids', transform them with one call
+// and scatter the ones that succeed back to the points.
+void ReprojectionFilter::transformPoints(const SrsTransform& transform,
+    PointRef& point, const PointId *ids, size_t count, Block& block,
+    char *ok) const
+{
+    block.x.resize(count);
+    block.y.resize(count);
+    block.z.resize(count);
+    block.success.resize(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        point.setPointId(ids[i]);
+        block.x[i] = point.getFieldAs<double>(Dimension::Id::X);
+        block.y[i] = point.getFieldAs<double>(Dimension::Id::Y);
+        block.z[i] = point.getFieldAs<double>(Dimension::Id::Z);
+    }
+
+    if (!transform.transform(block.x.data(), block.y.data(), block.z.data(),
+            count, block.success.data()) && !transform.valid())
+        std::fill(block.success.begin(), block.success.end(), 0);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        ok[i] = (block.success[i] != 0);
+        if (!ok[i])
+            continue;
+        point.setPointId(ids[i]);
+        point.setField(Dimension::Id::X, block.x[i]);
+        point.setField(Dimension::Id::Y, block.y[i]);
+        point.setField(Dimension::Id::Z, block.z[i]);
+    }
+}
+
+
+void ReprojectionFilter::processBatch(StreamPointTable& table,
+    const std::vector<uint8_t>& active, point_count_t count)
+{
+    m_ids.clear();
+    for (PointId idx = 0; idx < count; ++idx)
+        if (active[idx])
+            m_ids.push_back(idx);
+
+    m_ok.resize(m_ids.size());
+    PointRef point(table, 0);
+    for (size_t start = 0; start < m_ids.size(); start += BlockSize)
+    {
+        size_t n = (std::min)(BlockSize, m_ids.size() - start);
+        transformPoints(*m_transform, point, m_ids.data() + start, n, m_block,
+            m_ok.data() + start);
+    }
+
+    for (size_t i = 0; i < m_ids.size(); ++i)
+    {
+        if (m_ok[i])
+            continue;
+        if (m_errorOnFailure)
+        {
+            point.setPointId(m_ids[i]);
+            throwFailure(point);
+        }
+        table.setSkip(m_ids[i]);
+    }
+}
+
+
 bool ReprojectionFilter::processOne(PointRef& point)
 {
     double x(point.getFieldAs<double>(Dimension::Id::X));
@@ -210,11 +334,17 @@ bool ReprojectionFilter::processOne(PointRef& point)
         point.setField(Dimension::Id::Z, z);
     }
     else if (m_errorOnFailure)
-        throwError("Couldn't reproject point with X/Y/Z coordinates of (" +
-            std::to_string(point.getFieldAs<double>(Dimension::Id::X)) + ", " +
-            std::to_string(point.getFieldAs<double>(Dimension::Id::Y)) + ", " +
-            std::to_string(point.getFieldAs<double>(Dimension::Id::Z)) + ").");
+        throwFailure(point);
     return ok;
 }
 
+
+void ReprojectionFilter::throwFailure(PointRef& point) const
+{
+    throwError("Couldn't reproject point with X/Y/Z coordinates of (" +
+        std::to_string(point.getFieldAs<double>(Dimension::Id::X)) + ", " +
+        std::to_string(point.getFieldAs<double>(Dimension::Id::Y)) + ", " +
+        std::to_string(point.getFieldAs<double>(Dimension::Id::Z)) + ").");
+}
+
 } // namespace pdal
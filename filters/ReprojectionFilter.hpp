@@ -60,10 +60,24 @@ private:
     virtual void initialize();
     virtual PointViewSet run(PointViewPtr view);
     virtual bool processOne(PointRef& point);
+    virtual void processBatch(StreamPointTable& table,
+        const std::vector<uint8_t>& active, point_count_t count);
     virtual void spatialReferenceChanged(const SpatialReference& srs);
     virtual void prepared(PointTableRef table);
 
+    // Coordinate buffers for transforming a block of points.
+    struct Block
+    {
+        std::vector<double> x;
+        std::vector<double> y;
+        std::vector<double> z;
+        std::vector<int> success;
+    };
+
     void createTransform(const SpatialReference& srs);
+    void transformPoints(const SrsTransform& transform, PointRef& point,
+        const PointId *ids, size_t count, Block& block, char *ok) const;
+    void throwFailure(PointRef& point) const;
 
     SpatialReference m_inSRS;
     SpatialReference m_outSRS;
@@ -77,6 +91,10 @@ private:
     double m_outCoordEpochArg;
 
     bool m_errorOnFailure;
+    int m_threads;
+    Block m_block;
+    std::vector<PointId> m_ids;
+    std::vector<char> m_ok;
 };
 
 } // namespace pdal
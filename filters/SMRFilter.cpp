@@ -43,6 +43,7 @@
 #include <pdal/util/FileUtils.hpp>
 #include <pdal/util/ProgramArgs.hpp>
 #include <pdal/private/MathUtils.hpp>
+#include <pdal/private/Parallel.hpp>
 
 #include "private/DimRange.hpp"
 #include "private/Segmentation.hpp"
@@ -92,6 +93,29 @@ struct SMRArgs
     StringList m_returns;
     Segmentation::PointClasses m_classbits;
     Arg *m_windowArg;
+    double m_tileSize;
+    double m_buffer;
+    Arg *m_bufferArg;
+    int m_threads;
+};
+
+// Raster covering the points being processed: either the whole input or a
+// buffered tile.
+struct SMRGrid
+{
+    int rows = 0;
+    int cols = 0;
+    BOX2D bounds;
+    // Area in which points are classified when processing tiles.
+    BOX2D core;
+    bool tiled = false;
+    int threads = 1;
+
+    void init(double cell)
+    {
+        cols = static_cast<int>(((bounds.maxx - bounds.minx) / cell) + 1);
+        rows = static_cast<int>(((bounds.maxy - bounds.miny) / cell) + 1);
+    }
 };
 
 SMRFilter::SMRFilter() : m_args(new SMRArgs) {}
@@ -118,6 +142,12 @@ void SMRFilter::addArgs(ProgramArgs& args)
         "classification bits?", m_args->m_classbits);
     m_args->m_windowArg = &args.add("window", "Max window size?",
         m_args->m_window);
+    args.add("tile_size", "Size of tiles processed independently. Zero "
+        "processes all points at once.", m_args->m_tileSize, 0.0);
+    m_args->m_bufferArg = &args.add("buffer", "Size of the buffer around "
+        "each tile", m_args->m_buffer);
+    args.add("threads", "Number of threads used to run this filter",
+        m_args->m_threads, 1);
 }
 
 void SMRFilter::addDimensions(PointLayoutPtr layout)
@@ -125,6 +155,12 @@ void SMRFilter::addDimensions(PointLayoutPtr layout)
     layout->registerDim(Id::Classification);
 }
 
+void SMRFilter::initialize()
+{
+    if (m_args->m_threads < 1)
+        throwError("Option 'threads' must be at least 1.");
+}
+
 void SMRFilter::prepared(PointTableRef table)
 {
     const PointLayoutPtr layout(table.layout());
@@ -160,6 +196,17 @@ void SMRFilter::prepared(PointTableRef table)
     }
     if (!m_args->m_windowArg->set())
         m_args->m_window = 18 * m_args->m_cell;
+
+    if (m_args->m_tileSize < 0)
+        throwError("Option 'tile_size' must not be negative.");
+    if (m_args->m_tileSize > 0 && !m_args->m_dir.empty())
+        throwError("Option 'dir' can't be used with 'tile_size'.");
+    // The buffer must hold the largest structuring elements, or the surface
+    // near the edges of tiles will differ from that of the whole area.
+    if (!m_args->m_bufferArg->set())
+        m_args->m_buffer = m_args->m_window + 2 * m_args->m_cut;
+    if (m_args->m_buffer < 0)
+        throwError("Option 'buffer' must not be negative.");
 }
 
 void SMRFilter::ready(PointTableRef table)
@@ -241,47 +288,142 @@ PointViewSet SMRFilter::run(PointViewPtr view)
 
     m_srs = inlierView->spatialReference();
 
-    inlierView->calculateBounds(m_bounds);
-    m_cols = static_cast<int>(
-        ((m_bounds.maxx - m_bounds.minx) / m_args->m_cell) + 1);
-    m_rows = static_cast<int>(
-        ((m_bounds.maxy - m_bounds.miny) / m_args->m_cell) + 1);
-    if (m_cols * m_rows < 10000)
+    if (m_args->m_tileSize > 0)
+    {
+        processTiles(inlierView);
+        return viewSet;
+    }
+
+    SMRGrid grid;
+    inlierView->calculateBounds(grid.bounds);
+    grid.init(m_args->m_cell);
+    grid.threads = m_args->m_threads;
+    if (grid.cols * grid.rows < 10000)
         log()->get(LogLevel::Warning) << "SMRF running with a small number "
-            "of cells (" << (m_cols * m_rows) << ").  Consider changing "
+            "of cells (" << (grid.cols * grid.rows) << ").  Consider changing "
             "cell size.\n";
 
+    processGrid(grid, inlierView);
+    return viewSet;
+}
+
+// Split the points into tiles, each with a buffer of points from its
+// neighbors, and run the filter on the tiles in parallel.  Each tile only
+// classifies the points in its core, so each point is classified exactly
+// once.
+void SMRFilter::processTiles(PointViewPtr view)
+{
+    BOX2D bounds;
+    view->calculateBounds(bounds);
+
+    const double size = m_args->m_tileSize;
+    const double buffer = m_args->m_buffer;
+    const int tileCols =
+        static_cast<int>((bounds.maxx - bounds.minx) / size) + 1;
+    const int tileRows =
+        static_cast<int>((bounds.maxy - bounds.miny) / size) + 1;
+
+    auto clamp = [](double d, int max)
+    {
+        return (std::min)((std::max)(static_cast<int>(std::floor(d)), 0),
+            max - 1);
+    };
+
+    std::vector<PointViewPtr> views(tileCols * tileRows);
+    std::vector<char> hasCore(views.size(), 0);
+    for (PointId idx = 0; idx < view->size(); ++idx)
+    {
+        double x = view->getFieldAs<double>(Id::X, idx);
+        double y = view->getFieldAs<double>(Id::Y, idx);
+        double cx = (x - bounds.minx) / size;
+        double cy = (y - bounds.miny) / size;
+        double b = buffer / size;
+
+        int c0 = clamp(cx - b, tileCols);
+        int c1 = clamp(cx + b, tileCols);
+        int r0 = clamp(cy - b, tileRows);
+        int r1 = clamp(cy + b, tileRows);
+        for (int c = c0; c <= c1; ++c)
+            for (int r = r0; r <= r1; ++r)
+            {
+                PointViewPtr& v = views[c * tileRows + r];
+                if (!v)
+                    v = view->makeNew();
+                v->appendPoint(*view, idx);
+            }
+        hasCore[clamp(cx, tileCols) * tileRows + clamp(cy, tileRows)] = 1;
+    }
+
+    std::vector<size_t> tiles;
+    for (size_t t = 0; t < views.size(); ++t)
+        if (hasCore[t])
+            tiles.push_back(t);
+    log()->get(LogLevel::Debug) << "Processing " << tiles.size() <<
+        " tiles.\n";
+
+    // Tiles are handed out one at a time, since they may differ greatly in
+    // the number of points.
+    parallelFor(tiles.size(), m_args->m_threads, [&](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            size_t t = tiles[i];
+            int c = static_cast<int>(t / tileRows);
+            int r = static_cast<int>(t % tileRows);
+
+            SMRGrid grid;
+            grid.tiled = true;
+            views[t]->calculateBounds(grid.bounds);
+            grid.init(m_args->m_cell);
+
+            // Tiles on the edge classify everything on their outer side.
+            const double inf = (std::numeric_limits<double>::max)();
+            grid.core.minx = c ? bounds.minx + c * size : -inf;
+            grid.core.maxx = c < tileCols - 1 ?
+                bounds.minx + (c + 1) * size : inf;
+            grid.core.miny = r ? bounds.miny + r * size : -inf;
+            grid.core.maxy = r < tileRows - 1 ?
+                bounds.miny + (r + 1) * size : inf;
+
+            processGrid(grid, views[t]);
+            views[t].reset();
+        }
+    }, 1);
+}
+
+void SMRFilter::processGrid(SMRGrid& grid, PointViewPtr view)
+{
     // Create raster of minimum Z values per element.
-    std::vector<double> ZImin = createZImin(inlierView);
+    std::vector<double> ZImin = createZImin(grid, view);
 
     // Create raster mask of pixels containing low outlier points.
-    std::vector<int> Low = createLowMask(ZImin);
+    std::vector<int> Low = createLowMask(grid, ZImin);
 
     // Create raster mask of net cuts. Net cutting is used to when a scene
     // contains large buildings in highly differentiated terrain.
-    std::vector<int> isNetCell = createNetMask();
+    std::vector<int> isNetCell = createNetMask(grid);
 
     // Apply net cutting to minimum Z raster.
-    std::vector<double> ZInet = createZInet(ZImin, isNetCell);
+    std::vector<double> ZInet = createZInet(grid, ZImin, isNetCell);
 
     // Create raster mask of pixels containing object points. Note that we use
     // ZInet, the result of net cutting, to identify object pixels.
-    std::vector<int> Obj = createObjMask(ZInet);
+    std::vector<int> Obj = createObjMask(grid, ZInet);
+    std::vector<double>().swap(ZInet);
 
     // Create raster representing the provisional DEM. Note that we use the
     // original ZImin (not ZInet), however the net cut mask will still force
     // interpolation at these pixels.
     std::vector<double> ZIpro =
-        createZIpro(inlierView, ZImin, Low, isNetCell, Obj);
+        createZIpro(grid, view, ZImin, Low, isNetCell, Obj);
 
     // Classify ground returns by comparing elevation values to the provisional
     // DEM.
-    classifyGround(inlierView, ZIpro);
-
-    return viewSet;
+    classifyGround(grid, view, ZIpro);
 }
 
-void SMRFilter::classifyGround(PointViewPtr view, std::vector<double>& ZIpro)
+void SMRFilter::classifyGround(const SMRGrid& grid, PointViewPtr view,
+    std::vector<double>& ZIpro)
 {
     // "While many authors use a single value for the elevation threshold, we
     // suggest that a second parameter be used to increase the threshold on
@@ -292,10 +434,10 @@ void SMRFilter::classifyGround(PointViewPtr view, std::vector<double>& ZIpro)
     // vertical displacements yield larger errors on steep slopes, and as a
     // result the BE/OBJ threshold distance should be more permissive at these
     // points."
-    MatrixXd gsurfs(m_rows, m_cols);
-    MatrixXd thresh(m_rows, m_cols);
+    MatrixXd gsurfs(grid.rows, grid.cols);
+    MatrixXd thresh(grid.rows, grid.cols);
     {
-        MatrixXd ZIproM = Map<MatrixXd>(ZIpro.data(), m_rows, m_cols);
+        MatrixXd ZIproM = Map<MatrixXd>(ZIpro.data(), grid.rows, grid.cols);
         MatrixXd scaled = ZIproM / m_args->m_cell;
 
         MatrixXd gx = math::gradX(scaled);
@@ -307,8 +449,8 @@ void SMRFilter::classifyGround(PointViewPtr view, std::vector<double>& ZIpro)
         //ABELL - We can eliminate this copy if we're OK with not writing
         //  both the filled and non-filled array to output.
         std::vector<double> gsurfs_fillV = gsurfsV;
-        knnfill(view, gsurfs_fillV);
-        gsurfs = Map<MatrixXd>(gsurfs_fillV.data(), m_rows, m_cols);
+        knnfill(grid, gsurfs_fillV);
+        gsurfs = Map<MatrixXd>(gsurfs_fillV.data(), grid.rows, grid.cols);
         thresh =
             (m_args->m_threshold + m_args->m_scalar * gsurfs.array()).matrix();
 
@@ -316,21 +458,21 @@ void SMRFilter::classifyGround(PointViewPtr view, std::vector<double>& ZIpro)
         {
             std::string fname =
                 FileUtils::toAbsolutePath("gx.tif", m_args->m_dir);
-            math::writeMatrix(gx, fname, "GTiff", m_args->m_cell, m_bounds, m_srs);
+            math::writeMatrix(gx, fname, "GTiff", m_args->m_cell, grid.bounds, m_srs);
 
             fname = FileUtils::toAbsolutePath("gy.tif", m_args->m_dir);
-            math::writeMatrix(gy, fname, "GTiff", m_args->m_cell, m_bounds, m_srs);
+            math::writeMatrix(gy, fname, "GTiff", m_args->m_cell, grid.bounds, m_srs);
 
             fname = FileUtils::toAbsolutePath("gsurfs.tif", m_args->m_dir);
-            math::writeMatrix(gsurfs, fname, "GTiff", m_args->m_cell, m_bounds, m_srs);
+            math::writeMatrix(gsurfs, fname, "GTiff", m_args->m_cell, grid.bounds, m_srs);
 
             fname = FileUtils::toAbsolutePath("gsurfs_fill.tif", m_args->m_dir);
             MatrixXd gsurfs_fill =
-                Map<MatrixXd>(gsurfs_fillV.data(), m_rows, m_cols);
-            math::writeMatrix(gsurfs_fill, fname, "GTiff", m_args->m_cell, m_bounds, m_srs);
+                Map<MatrixXd>(gsurfs_fillV.data(), grid.rows, grid.cols);
+            math::writeMatrix(gsurfs_fill, fname, "GTiff", m_args->m_cell, grid.bounds, m_srs);
 
             fname = FileUtils::toAbsolutePath("thresh.tif", m_args->m_dir);
-            math::writeMatrix(thresh, fname, "GTiff", m_args->m_cell, m_bounds, m_srs);
+            math::writeMatrix(thresh, fname, "GTiff", m_args->m_cell, grid.bounds, m_srs);
         }
     }
 
@@ -342,10 +484,15 @@ void SMRFilter::classifyGround(PointViewPtr view, std::vector<double>& ZIpro)
         double y = p.getFieldAs<double>(Id::Y);
         double z = p.getFieldAs<double>(Id::Z);
 
-        int c = static_cast<int>(floor((x - m_bounds.minx) / m_args->m_cell));
-        int r = static_cast<int>(floor((y - m_bounds.miny) / m_args->m_cell));
+        // Points in a tile's buffer are classified by a neighboring tile.
+        if (grid.tiled && (x < grid.core.minx || x >= grid.core.maxx ||
+                y < grid.core.miny || y >= grid.core.maxy))
+            continue;
+
+        int c = static_cast<int>(floor((x - grid.bounds.minx) / m_args->m_cell));
+        int r = static_cast<int>(floor((y - grid.bounds.miny) / m_args->m_cell));
 
-        size_t cell = c * m_rows + r;
+        size_t cell = c * grid.rows + r;
 
         // TODO(chambbj): We don't quite do this by the book and yet it seems to
         // work reasonably well:
@@ -377,6 +524,8 @@ void SMRFilter::classifyGround(PointViewPtr view, std::vector<double>& ZIpro)
             p.setField(Id::Classification, ClassLabel::Ground);
         }
     }
+    if (grid.tiled)
+        return;
     double p(100.0 * double(ng) / double(view->size()));
     log()->floatPrecision(2);
     log()->get(LogLevel::Debug) << "\t" << g << " ground points"
@@ -384,7 +533,8 @@ void SMRFilter::classifyGround(PointViewPtr view, std::vector<double>& ZIpro)
                                 << "\t(" << p << "% classified as ground)\n";
 }
 
-std::vector<int> SMRFilter::createLowMask(std::vector<double> const& ZImin)
+std::vector<int> SMRFilter::createLowMask(const SMRGrid& grid,
+    std::vector<double> const& ZImin)
 {
     // "[The] minimum surface is checked for low outliers by inverting the point
     // cloud in the z-axis and applying the filter with parameters (slope =
@@ -395,20 +545,21 @@ std::vector<int> SMRFilter::createLowMask(std::vector<double> const& ZImin)
     std::vector<double> negZImin;
     std::transform(ZImin.begin(), ZImin.end(), std::back_inserter(negZImin),
                    [](double v) { return -v; });
-    std::vector<int> LowV = progressiveFilter(negZImin, 5.0, m_args->m_cell);
+    std::vector<int> LowV = progressiveFilter(grid, negZImin, 5.0,
+        m_args->m_cell);
 
     if (!m_args->m_dir.empty())
     {
         std::string fname =
             FileUtils::toAbsolutePath("zilow.tif", m_args->m_dir);
-        MatrixXi Low = Map<MatrixXi>(LowV.data(), m_rows, m_cols);
-        math::writeMatrix(Low.cast<double>(), fname, "GTiff", m_args->m_cell, m_bounds, m_srs);
+        MatrixXi Low = Map<MatrixXi>(LowV.data(), grid.rows, grid.cols);
+        math::writeMatrix(Low.cast<double>(), fname, "GTiff", m_args->m_cell, grid.bounds, m_srs);
     }
 
     return LowV;
 }
 
-std::vector<int> SMRFilter::createNetMask()
+std::vector<int> SMRFilter::createNetMask(const SMRGrid& grid)
 {
     // "To accommodate the removal of [very large buildings on highly
     // differentiated terrain], we implemented a feature in the published SMRF
@@ -417,23 +568,23 @@ std::vector<int> SMRFilter::createNetMask()
     // at a spacing equal to the maximum window diameter, where these minimum
     // values are found by applying a morphological open operation with a disk
     // shaped structuring element of radius (2*wkmax)."
-    std::vector<int> isNetCell(m_rows * m_cols, 0);
+    std::vector<int> isNetCell(grid.rows * grid.cols, 0);
     if (m_args->m_cut > 0.0)
     {
         int v = ceil<int>(m_args->m_cut / m_args->m_cell);
 
-        for (auto c = 0; c < m_cols; c += v)
+        for (auto c = 0; c < grid.cols; c += v)
         {
-            for (auto r = 0; r < m_rows; ++r)
+            for (auto r = 0; r < grid.rows; ++r)
             {
-                isNetCell[c * m_rows + r] = 1;
+                isNetCell[c * grid.rows + r] = 1;
             }
         }
-        for (auto c = 0; c < m_cols; ++c)
+        for (auto c = 0; c < grid.cols; ++c)
         {
-            for (auto r = 0; r < m_rows; r += v)
+            for (auto r = 0; r < grid.rows; r += v)
             {
-                isNetCell[c * m_rows + r] = 1;
+                isNetCell[c * grid.rows + r] = 1;
             }
         }
     }
@@ -441,31 +592,33 @@ std::vector<int> SMRFilter::createNetMask()
     return isNetCell;
 }
 
-std::vector<int> SMRFilter::createObjMask(std::vector<double> const& ZImin)
+std::vector<int> SMRFilter::createObjMask(const SMRGrid& grid,
+    std::vector<double> const& ZImin)
 {
     // "The second stage of the ground identification algorithm involves the
     // application of a progressive morphological filter to the minimum surface
     // grid (ZImin)."
     std::vector<int> ObjV =
-        progressiveFilter(ZImin, m_args->m_slope, m_args->m_window);
+        progressiveFilter(grid, ZImin, m_args->m_slope, m_args->m_window);
 
     if (!m_args->m_dir.empty())
     {
         std::string fname =
             FileUtils::toAbsolutePath("ziobj.tif", m_args->m_dir);
-        MatrixXi Obj = Map<MatrixXi>(ObjV.data(), m_rows, m_cols);
-        math::writeMatrix(Obj.cast<double>(), fname, "GTiff", m_args->m_cell, m_bounds, m_srs);
+        MatrixXi Obj = Map<MatrixXi>(ObjV.data(), grid.rows, grid.cols);
+        math::writeMatrix(Obj.cast<double>(), fname, "GTiff", m_args->m_cell, grid.bounds, m_srs);
     }
 
     return ObjV;
 }
 
-std::vector<double> SMRFilter::createZImin(PointViewPtr view)
+std::vector<double> SMRFilter::createZImin(const SMRGrid& grid,
+    PointViewPtr view)
 {
     // "As with many other ground filtering algorithms, the first step is
     // generation of ZImin from the cell size parameter and the extent of the
     // data."
-    std::vector<double> ZIminV(m_rows * m_cols,
+    std::vector<double> ZIminV(grid.rows * grid.cols,
                                std::numeric_limits<double>::quiet_NaN());
 
     for (PointRef p : *view)
@@ -474,10 +627,10 @@ std::vector<double> SMRFilter::createZImin(PointViewPtr view)
         double y = p.getFieldAs<double>(Id::Y);
         double z = p.getFieldAs<double>(Id::Z);
 
-        int c = static_cast<int>(floor((x - m_bounds.minx) / m_args->m_cell));
-        int r = static_cast<int>(floor((y - m_bounds.miny) / m_args->m_cell));
+        int c = static_cast<int>(floor((x - grid.bounds.minx) / m_args->m_cell));
+        int r = static_cast<int>(floor((y - grid.bounds.miny) / m_args->m_cell));
 
-        size_t cell = c * m_rows + r;
+        size_t cell = c * grid.rows + r;
         if (z < ZIminV[cell] || std::isnan(ZIminV[cell]))
             ZIminV[cell] = z;
     }
@@ -490,24 +643,25 @@ std::vector<double> SMRFilter::createZImin(PointViewPtr view)
     //ABELL - We can eliminate this copy if we're OK with not writing
     //  both the filled and non-filled array to output.
     std::vector<double> ZImin_fillV = ZIminV;
-    knnfill(view, ZImin_fillV);
+    knnfill(grid, ZImin_fillV);
 
     if (!m_args->m_dir.empty())
     {
         std::string fname =
             FileUtils::toAbsolutePath("zimin.tif", m_args->m_dir);
-        MatrixXd ZImin = Map<MatrixXd>(ZIminV.data(), m_rows, m_cols);
-        math::writeMatrix(ZImin, fname, "GTiff", m_args->m_cell, m_bounds, m_srs);
+        MatrixXd ZImin = Map<MatrixXd>(ZIminV.data(), grid.rows, grid.cols);
+        math::writeMatrix(ZImin, fname, "GTiff", m_args->m_cell, grid.bounds, m_srs);
 
         fname = FileUtils::toAbsolutePath("zimin_fill.tif", m_args->m_dir);
-        MatrixXd ZImin_fill = Map<MatrixXd>(ZImin_fillV.data(), m_rows, m_cols);
-        math::writeMatrix(ZImin_fill, fname, "GTiff", m_args->m_cell, m_bounds, m_srs);
+        MatrixXd ZImin_fill = Map<MatrixXd>(ZImin_fillV.data(), grid.rows, grid.cols);
+        math::writeMatrix(ZImin_fill, fname, "GTiff", m_args->m_cell, grid.bounds, m_srs);
     }
 
     return ZImin_fillV;
 }
 
-std::vector<double> SMRFilter::createZInet(std::vector<double> const& ZImin,
+std::vector<double> SMRFilter::createZInet(const SMRGrid& grid,
+                                           std::vector<double> const& ZImin,
                                            std::vector<int> const& isNetCell)
 {
     // "To accommodate the removal of [very large buildings on highly
@@ -522,15 +676,16 @@ std::vector<double> SMRFilter::createZInet(std::vector<double> const& ZImin,
     {
         std::vector<double> dilated = ZImin;
         int v = ceil<int>(m_args->m_cut / m_args->m_cell);
-        math::erodeDiamond(dilated, m_rows, m_cols, 2 * v);
-        math::dilateDiamond(dilated, m_rows, m_cols, 2 * v);
-        for (auto c = 0; c < m_cols; ++c)
+        math::erodeDiamond(dilated, grid.rows, grid.cols, 2 * v, grid.threads);
+        math::dilateDiamond(dilated, grid.rows, grid.cols, 2 * v,
+            grid.threads);
+        for (auto c = 0; c < grid.cols; ++c)
         {
-            for (auto r = 0; r < m_rows; ++r)
+            for (auto r = 0; r < grid.rows; ++r)
             {
-                if (isNetCell[c * m_rows + r] == 1)
+                if (isNetCell[c * grid.rows + r] == 1)
                 {
-                    ZInetV[c * m_rows + r] = dilated[c * m_rows + r];
+                    ZInetV[c * grid.rows + r] = dilated[c * grid.rows + r];
                 }
             }
         }
@@ -540,14 +695,15 @@ std::vector<double> SMRFilter::createZInet(std::vector<double> const& ZImin,
     {
         std::string fname =
             FileUtils::toAbsolutePath("zinet.tif", m_args->m_dir);
-        MatrixXd ZInet = Map<MatrixXd>(ZInetV.data(), m_rows, m_cols);
-        math::writeMatrix(ZInet, fname, "GTiff", m_args->m_cell, m_bounds, m_srs);
+        MatrixXd ZInet = Map<MatrixXd>(ZInetV.data(), grid.rows, grid.cols);
+        math::writeMatrix(ZInet, fname, "GTiff", m_args->m_cell, grid.bounds, m_srs);
     }
 
     return ZInetV;
 }
 
-std::vector<double> SMRFilter::createZIpro(PointViewPtr view,
+std::vector<double> SMRFilter::createZIpro(const SMRGrid& grid,
+                                           PointViewPtr view,
                                            std::vector<double> const& ZImin,
                                            std::vector<int> const& Low,
                                            std::vector<int> const& isNetCell,
@@ -569,48 +725,46 @@ std::vector<double> SMRFilter::createZIpro(PointViewPtr view,
     //ABELL - We can eliminate this copy if we're OK with not writing
     //  both the filled and non-filled array to output.
     std::vector<double> ZIpro_fillV = ZIproV;
-    knnfill(view, ZIpro_fillV);
+    knnfill(grid, ZIpro_fillV);
 
     if (!m_args->m_dir.empty())
     {
         std::string fname =
             FileUtils::toAbsolutePath("zipro.tif", m_args->m_dir);
-        MatrixXd ZIpro = Map<MatrixXd>(ZIproV.data(), m_rows, m_cols);
-        math::writeMatrix(ZIpro, fname, "GTiff", m_args->m_cell, m_bounds, m_srs);
+        MatrixXd ZIpro = Map<MatrixXd>(ZIproV.data(), grid.rows, grid.cols);
+        math::writeMatrix(ZIpro, fname, "GTiff", m_args->m_cell, grid.bounds, m_srs);
 
         fname = FileUtils::toAbsolutePath("zipro_fill.tif", m_args->m_dir);
-        MatrixXd ZIpro_fill = Map<MatrixXd>(ZIpro_fillV.data(), m_rows, m_cols);
-        math::writeMatrix(ZIpro_fill, fname, "GTiff", m_args->m_cell, m_bounds, m_srs);
+        MatrixXd ZIpro_fill = Map<MatrixXd>(ZIpro_fillV.data(), grid.rows, grid.cols);
+        math::writeMatrix(ZIpro_fill, fname, "GTiff", m_args->m_cell, grid.bounds, m_srs);
     }
 
     return ZIpro_fillV;
 }
 
 // Fill voids with the average of eight nearest neighbors.
-void SMRFilter::knnfill(PointViewPtr view, std::vector<double>& cz)
+void SMRFilter::knnfill(const SMRGrid& grid, std::vector<double>& cz)
 {
-    //ABELL - This potentially means moving a lot of data from the raster
-    //  to the temporary view.  This can be improved by either
-    //  1) using some method other than a KD tree to find neighbors
-    //  2) build a KDtree from the raster data directly, rather than moving it
-    //     to a view.
-
     // Create a temporary PointView that encodes our raster values so that we
-    // can construct a 2D KDIndex and perform nearest neighbor searches.
-    PointViewPtr temp = view->makeNew();
+    // can construct a 2D KDIndex and perform nearest neighbor searches.  The
+    // view has its own table so that tiles can be filled in parallel and the
+    // raster values don't take space in the input table.
+    PointTable table;
+    table.layout()->registerDims({Id::X, Id::Y, Id::Z});
+    PointViewPtr temp(new PointView(table));
     PointId i(0);
-    for (int c = 0; c < m_cols; ++c)
+    for (int c = 0; c < grid.cols; ++c)
     {
-        for (int r = 0; r < m_rows; ++r)
+        for (int r = 0; r < grid.rows; ++r)
         {
-            size_t cell = c * m_rows + r;
+            size_t cell = c * grid.rows + r;
             double val = cz[cell];
             if (std::isnan(val))
                 continue;
 
             PointRef p = temp->point(i++);
-            p.setField(Id::X, m_bounds.minx + (c + 0.5) * m_args->m_cell);
-            p.setField(Id::Y, m_bounds.miny + (r + 0.5) * m_args->m_cell);
+            p.setField(Id::X, grid.bounds.minx + (c + 0.5) * m_args->m_cell);
+            p.setField(Id::Y, grid.bounds.miny + (r + 0.5) * m_args->m_cell);
             p.setField(Id::Z, val);
         }
     }
@@ -619,41 +773,48 @@ void SMRFilter::knnfill(PointViewPtr view, std::vector<double>& cz)
     if (!temp->size())
         return;
 
-    KD2Index& kdi = temp->build2dIndex();
+    KD2Index& kdi = temp->build2dIndex(grid.threads);
 
     // Where the raster has voids (i.e., NaN), we search for that cell's eight
     // nearest neighbors, and fill the void with the average value of the
-    // neighbors.
-    for (int c = 0; c < m_cols; ++c)
+    // neighbors.  Columns are split among threads.  Filled values aren't
+    // indexed, so the order doesn't matter.
+    auto fill = [&](size_t begin, size_t end)
     {
-        for (int r = 0; r < m_rows; ++r)
+        for (size_t c = begin; c < end; ++c)
         {
-            size_t cell = c * m_rows + r;
-            if (!std::isnan(cz[cell]))
-                continue;
-
-            double x = m_bounds.minx + (c + 0.5) * m_args->m_cell;
-            double y = m_bounds.miny + (r + 0.5) * m_args->m_cell;
-            const int k = 8;
-            PointIdList neighbors = kdi.neighbors(x, y, k);
-
-            double M1(0.0);
-            size_t j(0);
-            for (auto const& n : neighbors)
+            for (int r = 0; r < grid.rows; ++r)
             {
-                j++;
-                double delta = temp->getFieldAs<double>(Id::Z, n) - M1;
-                M1 += (delta / j);
+                size_t cell = c * grid.rows + r;
+                if (!std::isnan(cz[cell]))
+                    continue;
+
+                double x = grid.bounds.minx + (c + 0.5) * m_args->m_cell;
+                double y = grid.bounds.miny + (r + 0.5) * m_args->m_cell;
+                const int k = 8;
+                PointIdList neighbors = kdi.neighbors(x, y, k);
+
+                double M1(0.0);
+                size_t j(0);
+                for (auto const& n : neighbors)
+                {
+                    j++;
+                    double delta = temp->getFieldAs<double>(Id::Z, n) - M1;
+                    M1 += (delta / j);
+                }
+                cz[cell] = M1;
             }
-            cz[cell] = M1;
         }
-    }
+    };
+
+    parallelFor(grid.cols, grid.threads, fill);
 }
 
 // Iteratively open the estimated surface. progressiveFilter can be used to
 // identify both low points and object (i.e., non-ground) points, depending on
 // the inputs.
-std::vector<int> SMRFilter::progressiveFilter(std::vector<double> const& ZImin,
+std::vector<int> SMRFilter::progressiveFilter(const SMRGrid& grid,
+                                              std::vector<double> const& ZImin,
                                               double slope, double max_window)
 {
     // "The maximum window radius is supplied as a distance metric (e.g., 21 m),
@@ -667,14 +828,16 @@ std::vector<int> SMRFilter::progressiveFilter(std::vector<double> const& ZImin,
     // "...the radius of the element at each step [is] increased by one pixel
     // from a starting value of one pixel to the pixel equivalent of the maximum
     // value."
-    std::vector<int> Obj(m_rows * m_cols, 0);
+    std::vector<int> Obj(grid.rows * grid.cols, 0);
+    std::vector<double> curOpening;
     for (int radius = 1; radius <= max_radius; ++radius)
     {
         // "On the first iteration, the minimum surface (ZImin) is opened using
         // a disk-shaped structuring element with a radius of one pixel."
-        math::erodeDiamond(erosion, m_rows, m_cols, 1);
-        std::vector<double> curOpening = erosion;
-        math::dilateDiamond(curOpening, m_rows, m_cols, radius);
+        math::erodeDiamond(erosion, grid.rows, grid.cols, 1, grid.threads);
+        curOpening = erosion;
+        math::dilateDiamond(curOpening, grid.rows, grid.cols, radius,
+            grid.threads);
 
         // "An elevation threshold is then calculated, where the value is equal
         // to the supplied slope tolerance parameter multiplied by the product
@@ -684,28 +847,20 @@ std::vector<int> SMRFilter::progressiveFilter(std::vector<double> const& ZImin,
         // "This elevation threshold is applied to the difference of the minimum
         // and the opened surfaces."
 
-        // Need to provide means of diffing two vectors.
-        std::vector<double> diff;
-        std::transform(prevSurface.begin(), prevSurface.end(),
-                       curOpening.begin(), std::back_inserter(diff),
-                       [&](double l, double r) { return std::fabs(l - r); });
-
         // "Any grid cell with a difference value exceeding the calculated
         // elevation threshold for the iteration is then flagged as an OBJ
         // cell."
-        std::vector<int> foo;
-        std::transform(diff.begin(), diff.end(), std::back_inserter(foo),
-                       [threshold](double x) {
-                           return (x > threshold) ? int(1) : int(0);
-                       });
-        std::transform(Obj.begin(), Obj.end(), foo.begin(), Obj.begin(),
-                       [](int a, int b) { return (std::max)(a, b); });
+        for (size_t i = 0; i < Obj.size(); ++i)
+            if (std::fabs(prevSurface[i] - curOpening[i]) > threshold)
+                Obj[i] = 1;
 
         // "The algorithm then proceeds to the next window radius (up to the
         // maximum), and proceeds as above with the last opened surface acting
         // as the minimum surface for the next difference calculation."
-        prevSurface = curOpening;
+        prevSurface.swap(curOpening);
 
+        if (grid.tiled)
+            continue;
         size_t ng = std::count(Obj.begin(), Obj.end(), 1);
         size_t g(Obj.size() - ng);
         double p(100.0 * double(ng) / double(Obj.size()));
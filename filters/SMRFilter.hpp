@@ -43,6 +43,7 @@ namespace pdal
 {
 
 struct SMRArgs;
+struct SMRGrid;
 
 class PDAL_EXPORT SMRFilter : public Filter
 {
@@ -55,31 +56,33 @@ public:
     std::string getName() const;
 
 private:
-    int m_rows;
-    int m_cols;
-    BOX2D m_bounds;
     SpatialReference m_srs;
     std::unique_ptr<SMRArgs> m_args;
 
     virtual void addArgs(ProgramArgs& args);
     virtual void addDimensions(PointLayoutPtr layout);
+    virtual void initialize();
     virtual void prepared(PointTableRef table);
     virtual void ready(PointTableRef table);
     virtual PointViewSet run(PointViewPtr view);
 
-    void classifyGround(PointViewPtr, std::vector<double>&);
-    std::vector<int> createLowMask(std::vector<double> const&);
-    std::vector<int> createNetMask();
-    std::vector<int> createObjMask(std::vector<double> const&);
-    std::vector<double> createZImin(PointViewPtr view);
-    std::vector<double> createZInet(std::vector<double> const&,
+    void processTiles(PointViewPtr view);
+    void processGrid(SMRGrid& grid, PointViewPtr view);
+    void classifyGround(const SMRGrid&, PointViewPtr, std::vector<double>&);
+    std::vector<int> createLowMask(const SMRGrid&, std::vector<double> const&);
+    std::vector<int> createNetMask(const SMRGrid&);
+    std::vector<int> createObjMask(const SMRGrid&, std::vector<double> const&);
+    std::vector<double> createZImin(const SMRGrid&, PointViewPtr view);
+    std::vector<double> createZInet(const SMRGrid&, std::vector<double> const&,
                                     std::vector<int> const&);
-    std::vector<double> createZIpro(PointViewPtr, std::vector<double> const&,
+    std::vector<double> createZIpro(const SMRGrid&, PointViewPtr,
+                                    std::vector<double> const&,
                                     std::vector<int> const&,
                                     std::vector<int> const&,
                                     std::vector<int> const&);
-    void knnfill(PointViewPtr, std::vector<double>&);
-    std::vector<int> progressiveFilter(std::vector<double> const&, double,
+    void knnfill(const SMRGrid&, std::vector<double>&);
+    std::vector<int> progressiveFilter(const SMRGrid&,
+                                       std::vector<double> const&, double,
                                        double);
 };
 
@@ -34,6 +34,7 @@
 
 #include "StatsFilter.hpp"
 
+#include <algorithm>
 #include <cmath>
 #include <unordered_map>
 
@@ -59,6 +60,131 @@ std::string StatsFilter::getName() const { return s_info.name; }
 namespace stats
 {
 
+QuantileSketch::QuantileSketch(size_t k) : m_k(k), m_size(0), m_maxSize(0),
+    m_count(0), m_seed(0x9E3779B9)
+{
+    grow();
+}
+
+
+// Levels near the top of the stack hold more values than those near the
+// bottom.  The top level has capacity 'k'.
+size_t QuantileSketch::capacity(size_t level) const
+{
+    double depth = (double)(m_levels.size() - level - 1);
+    return (size_t)std::ceil(std::pow(2.0 / 3.0, depth) * m_k) + 1;
+}
+
+
+void QuantileSketch::grow()
+{
+    m_levels.emplace_back();
+    m_maxSize = 0;
+    for (size_t level = 0; level < m_levels.size(); ++level)
+        m_maxSize += capacity(level);
+}
+
+
+void QuantileSketch::compress()
+{
+    for (size_t level = 0; level < m_levels.size(); ++level)
+    {
+        if (m_levels[level].size() < capacity(level))
+            continue;
+        if (level + 1 == m_levels.size())
+            grow();
+
+        std::vector<double>& vals = m_levels[level];
+        std::vector<double>& next = m_levels[level + 1];
+
+        // Promote one of each pair of adjacent values.  Which one is chosen
+        // at random so that the error doesn't accumulate in one direction.
+        // With an odd count the smallest value stays where it is.
+        m_seed ^= m_seed << 13;
+        m_seed ^= m_seed >> 17;
+        m_seed ^= m_seed << 5;
+        std::sort(vals.begin(), vals.end());
+        size_t keep = vals.size() % 2;
+        for (size_t i = keep + (m_seed & 1); i < vals.size(); i += 2)
+            next.push_back(vals[i]);
+        m_size -= vals.size() - keep;
+        m_size += (vals.size() - keep) / 2;
+        vals.resize(keep);
+
+        if (m_size < m_maxSize)
+            break;
+    }
+}
+
+
+void QuantileSketch::merge(const QuantileSketch& s)
+{
+    while (m_levels.size() < s.m_levels.size())
+        grow();
+    for (size_t level = 0; level < s.m_levels.size(); ++level)
+    {
+        const std::vector<double>& vals = s.m_levels[level];
+        m_levels[level].insert(m_levels[level].end(), vals.begin(), vals.end());
+    }
+    m_size += s.m_size;
+    m_count += s.m_count;
+    while (m_size >= m_maxSize)
+        compress();
+}
+
+
+// Sorted values and the number of inserted values each one represents.
+QuantileSketch::WeightedValues QuantileSketch::weightedValues() const
+{
+    WeightedValues vals;
+    vals.reserve(m_size);
+    for (size_t level = 0; level < m_levels.size(); ++level)
+        for (double d : m_levels[level])
+            vals.emplace_back(d, point_count_t(1) << level);
+    std::sort(vals.begin(), vals.end());
+    return vals;
+}
+
+
+// Return the first value whose cumulative weight exceeds 'q' of the total.
+// With no compaction this matches selecting position q * count from the
+// sorted values.
+double QuantileSketch::rankValue(const WeightedValues& vals, double q)
+{
+    if (vals.empty())
+        return 0.0;
+
+    point_count_t total = 0;
+    for (auto& v : vals)
+        total += v.second;
+
+    double target = q * total;
+    point_count_t cumulative = 0;
+    for (auto& v : vals)
+    {
+        cumulative += v.second;
+        if (cumulative > target)
+            return v.first;
+    }
+    return vals.back().first;
+}
+
+
+double QuantileSketch::quantile(double q) const
+{
+    return rankValue(weightedValues(), q);
+}
+
+
+double QuantileSketch::mad(double median) const
+{
+    WeightedValues vals = weightedValues();
+    for (auto& v : vals)
+        v.first = std::fabs(v.first - median);
+    std::sort(vals.begin(), vals.end());
+    return rankValue(vals, .5);
+}
+
 
 void Summary::extractMetadata(MetadataNode &m)
 {
@@ -98,6 +224,12 @@ void Summary::extractMetadata(MetadataNode &m)
         computeGlobalStats();
         m.add("median", m_median);
         m.add("mad", m_mad);
+        if (m_quantiles.size())
+        {
+            MetadataNode quantiles = m.add("quantiles");
+            for (size_t i = 0; i < m_quantiles.size(); ++i)
+                quantiles.add(Utils::toString(m_probs[i]), m_quantiles[i]);
+        }
     }
     else if (m_enumerate == Count)
     {
@@ -135,17 +267,35 @@ void Summary::extractMetadata(MetadataNode &m)
 
 void Summary::computeGlobalStats()
 {
-    auto compute_median = [](std::vector<double> vals)
+    m_quantiles.clear();
+    if (m_sketched)
     {
-        std::nth_element(vals.begin(), vals.begin() + vals.size() / 2, vals.end());
-        return *(vals.begin() + vals.size() / 2);
+        if (m_sketch.count() == 0)
+            return;
+        m_median = m_sketch.quantile(.5);
+        m_mad = m_sketch.mad(m_median);
+        for (double q : m_probs)
+            m_quantiles.push_back(m_sketch.quantile(q));
+        return;
+    }
+
+    if (m_data.empty())
+        return;
+
+    // Values are selected in place, so the data is reordered but not copied.
+    auto select = [this](double q)
+    {
+        size_t pos = (std::min)(m_data.size() - 1, (size_t)(q * m_data.size()));
+        std::nth_element(m_data.begin(), m_data.begin() + pos, m_data.end());
+        return m_data[pos];
     };
 
-    // TODO add quantiles
-    m_median = compute_median(m_data);
+    m_median = select(.5);
+    for (double q : m_probs)
+        m_quantiles.push_back(select(q));
     std::transform(m_data.begin(), m_data.end(), m_data.begin(),
        [this](double v) { return std::fabs(v - this->m_median); });
-    m_mad = compute_median(m_data);
+    m_mad = select(.5);
 }
 
 // Math comes from https://prod.sandia.gov/techlib-noauth/access-control.cgi/2008/086212.pdf
@@ -154,6 +304,8 @@ bool Summary::merge(const Summary& s)
 {
     if ((m_name != s.m_name) || (m_enumerate != s.m_enumerate) || (m_advanced != s.m_advanced))
         return false;
+    if ((m_sketched != s.m_sketched) || (m_sketch.k() != s.m_sketch.k()))
+        return false;
 
     double n1 = (double)m_cnt;
     double n2 = (double)s.m_cnt;
@@ -185,6 +337,7 @@ bool Summary::merge(const Summary& s)
     m_max = (std::max)(m_max, s.m_max);
     m_cnt = s.m_cnt + m_cnt;
     m_data.insert(m_data.begin(), s.m_data.begin(), s.m_data.end());
+    m_sketch.merge(s.m_sketch);
     for (auto p : s.m_values)
         m_values[p.first] += p.second;
 
@@ -207,13 +360,71 @@ bool StatsFilter::processOne(PointRef& point)
 }
 
 
+namespace
+{
+
+// Insert the values of a dimension using direct access to its memory.
+template<typename T>
+bool insertColumn(const PointView& view, Dimension::Id dim, Summary& summary)
+{
+    auto spans = view.column<const T>(dim);
+    if (spans.empty())
+        return false;
+    for (const ColumnSpan<const T>& span : spans)
+        for (T val : span)
+            summary.insert((double)val);
+    return true;
+}
+
+bool insertColumn(const PointView& view, Dimension::Id dim, Summary& summary)
+{
+    switch (view.dimType(dim))
+    {
+    case Dimension::Type::Float:
+        return insertColumn<float>(view, dim, summary);
+    case Dimension::Type::Double:
+        return insertColumn<double>(view, dim, summary);
+    case Dimension::Type::Signed8:
+        return insertColumn<int8_t>(view, dim, summary);
+    case Dimension::Type::Signed16:
+        return insertColumn<int16_t>(view, dim, summary);
+    case Dimension::Type::Signed32:
+        return insertColumn<int32_t>(view, dim, summary);
+    case Dimension::Type::Signed64:
+        return insertColumn<int64_t>(view, dim, summary);
+    case Dimension::Type::Unsigned8:
+        return insertColumn<uint8_t>(view, dim, summary);
+    case Dimension::Type::Unsigned16:
+        return insertColumn<uint16_t>(view, dim, summary);
+    case Dimension::Type::Unsigned32:
+        return insertColumn<uint32_t>(view, dim, summary);
+    case Dimension::Type::Unsigned64:
+        return insertColumn<uint64_t>(view, dim, summary);
+    default:
+        return false;
+    }
+}
+
+} // unnamed namespace
+
+
 void StatsFilter::filter(PointView& view)
 {
+    // Each summary only depends on the values of its own dimension, so
+    // dimensions that can be accessed directly are scanned one at a time.
+    std::vector<std::pair<Dimension::Id, Summary *>> rest;
+    for (auto& p : m_stats)
+        if (!insertColumn(view, p.first, p.second))
+            rest.push_back({ p.first, &p.second });
+    if (rest.empty())
+        return;
+
     PointRef point(view, 0);
     for (PointId idx = 0; idx < view.size(); ++idx)
     {
         point.setPointId(idx);
-        processOne(point);
+        for (auto& r : rest)
+            r.second->insert(point.getFieldAs<double>(r.first));
     }
 }
 
@@ -232,6 +443,11 @@ void StatsFilter::addArgs(ProgramArgs& args)
         m_enums);
     args.add("global", "Dimensions to compute global stats (median, mad, mode)",
         m_global);
+    args.add("quantiles", "Quantiles (0 - 1) to compute for dimensions "
+        "listed in 'global'", m_quantiles);
+    args.add("sketch", "Approximate global stats in fixed memory", m_sketch);
+    args.add("sketch_size", "Size of the sketch used to approximate global "
+        "stats", m_sketchSize, (size_t)200);
     args.add("count", "Dimensions whose values should be counted", m_counts);
     args.add("advanced", "Calculate skewness and kurtosis", m_advanced);
     args.add("commonsrs", "Common SRS to use for normalizing bounding boxes", m_commonSrs, "EPSG:4326");
@@ -243,6 +459,12 @@ void StatsFilter::prepared(PointTableRef table)
     PointLayoutPtr layout(table.layout());
     std::unordered_map<std::string, Summary::EnumType> dims;
 
+    for (double q : m_quantiles)
+        if (q < 0 || q > 1)
+            throwError("Option 'quantiles' values must be between 0 and 1.");
+    if (m_sketch && m_sketchSize < 8)
+        throwError("Option 'sketch_size' must be at least 8.");
+
     auto getWarn([this]()->std::ostream&
     {
         return log()->get(LogLevel::Warning);
@@ -297,8 +519,16 @@ void StatsFilter::prepared(PointTableRef table)
     }
     // Create the summary objects.
     for (auto& dv : dims)
-        m_stats.insert(std::make_pair(layout->findDim(dv.first),
-            Summary(dv.first, dv.second, m_advanced)));
+    {
+        Summary summary(dv.first, dv.second, m_advanced);
+        if (dv.second == Summary::Global)
+        {
+            if (m_sketch)
+                summary.useSketch(m_sketchSize);
+            summary.setQuantiles(m_quantiles);
+        }
+        m_stats.insert(std::make_pair(layout->findDim(dv.first), summary));
+    }
 }
 
 
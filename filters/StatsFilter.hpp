@@ -42,6 +42,54 @@ namespace pdal
 namespace stats
 {
 
+// KLL quantile sketch (Karnin, Lang & Liberty, 2016).  Values are kept in
+// a stack of compactors.  A value at level N stands in for 2^N inserted
+// values.  When the sketch is full, the lowest full level is sorted and
+// every other value is promoted to the next level.  Memory use is
+// O(k log(n/k)) and the rank error is roughly 1.7 / k.
+class PDAL_EXPORT QuantileSketch
+{
+public:
+    QuantileSketch(size_t k = 200);
+
+    void insert(double value)
+    {
+        m_levels[0].push_back(value);
+        m_size++;
+        m_count++;
+        if (m_size >= m_maxSize)
+            compress();
+    }
+    void merge(const QuantileSketch& s);
+    point_count_t count() const
+        { return m_count; }
+    size_t size() const
+        { return m_size; }
+    size_t k() const
+        { return m_k; }
+
+    // Approximate value at rank 'q' (0 <= q <= 1).
+    double quantile(double q) const;
+    // Approximate median absolute deviation from 'median'.
+    double mad(double median) const;
+
+private:
+    using WeightedValues = std::vector<std::pair<double, point_count_t>>;
+
+    size_t capacity(size_t level) const;
+    void grow();
+    void compress();
+    WeightedValues weightedValues() const;
+    static double rankValue(const WeightedValues& vals, double q);
+
+    size_t m_k;
+    std::vector<std::vector<double>> m_levels;
+    size_t m_size;
+    size_t m_maxSize;
+    point_count_t m_count;
+    uint32_t m_seed;
+};
+
 class PDAL_EXPORT Summary
 {
 public:
@@ -61,9 +109,24 @@ public:
         m_name(name), m_enumerate(enumerate), m_advanced(advanced)
     { reset(); }
 
-    // Merge another summary with this one. 'name', 'enumerate' and 'advanced' must match
-    // or false is returned and no merge occurs.
+    // Merge another summary with this one. 'name', 'enumerate', 'advanced'
+    // and the sketch size must match or false is returned and no merge occurs.
     bool merge(const Summary& s);
+
+    // Approximate global statistics with a sketch of size 'k' instead of
+    // storing every value.  Must be called before any values are inserted.
+    void useSketch(size_t k)
+    {
+        m_sketch = QuantileSketch(k);
+        m_sketched = true;
+    }
+    bool sketched() const
+        { return m_sketched; }
+    // Set the quantiles (0 <= q <= 1) reported with the global statistics.
+    void setQuantiles(const std::vector<double>& probs)
+        { m_probs = probs; }
+    const std::vector<double>& quantiles() const
+        { return m_quantiles; }
     double minimum() const
         { return m_min; }
     double maximum() const
@@ -159,13 +222,20 @@ public:
         m_min = (std::min)(m_min, value);
         m_max = (std::max)(m_max, value);
 
-        if (m_enumerate != NoEnum)
+        // A sketch bounds the memory used by global statistics, so the
+        // distinct values, which aren't reported for them, aren't kept.
+        if (m_enumerate != NoEnum && !(m_enumerate == Global && m_sketched))
             m_values[value]++;
         if (m_enumerate == Global)
         {
-            if (m_data.capacity() - m_data.size() < 10000)
-                m_data.reserve(m_data.capacity() + m_cnt);
-            m_data.push_back(value);
+            if (m_sketched)
+                m_sketch.insert(value);
+            else
+            {
+                if (m_data.capacity() - m_data.size() < 10000)
+                    m_data.reserve(m_data.capacity() + m_cnt);
+                m_data.push_back(value);
+            }
         }
 
         // stolen from http://www.johndcook.com/blog/skewness_kurtosis/
@@ -205,6 +275,10 @@ private:
     double m_median;
     EnumMap m_values;
     DataVector m_data;
+    bool m_sketched = false;
+    QuantileSketch m_sketch;
+    std::vector<double> m_probs;
+    std::vector<double> m_quantiles;
     point_count_t m_cnt;
     double M1, M2, M3, M4;
 };
@@ -238,6 +312,9 @@ private:
     StringList m_enums;
     StringList m_counts;
     StringList m_global;
+    std::vector<double> m_quantiles;
+    bool m_sketch;
+    size_t m_sketchSize;
     std::string m_commonSrs;
     bool m_advanced;
     std::map<Dimension::Id, stats::Summary> m_stats;
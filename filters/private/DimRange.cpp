@@ -34,6 +34,8 @@
 
 #include "DimRange.hpp"
 
+#include <algorithm>
+
 #include <pdal/util/Utils.hpp>
 
 namespace pdal
@@ -163,6 +165,44 @@ bool DimRange::pointPasses(const std::vector<DimRange>& ranges, PointRef& point)
     return passes;
 }
 
+// Batch version of pointPasses().  Values for each dimension are gathered
+// into a column once and the ranges for that dimension are tested in tight
+// loops over the column.  On return, 'passes' is non-zero for each active
+// point that passes the ranges.
+void DimRange::pointsPass(const std::vector<DimRange>& ranges,
+    PointTableRef table, const std::vector<uint8_t>& active,
+    point_count_t count, std::vector<uint8_t>& passes)
+{
+    passes.assign(active.begin(), active.begin() + count);
+
+    std::vector<double> values(count);
+    std::vector<uint8_t> dimPasses(count);
+    PointRef point(table, 0);
+    auto ri = ranges.begin();
+    while (ri != ranges.end())
+    {
+        // Ranges for the same dimension are contiguous.
+        const Dimension::Id id = ri->m_id;
+        auto end = std::find_if(ri, ranges.end(),
+            [id](const DimRange& r){ return r.m_id != id; });
+
+        for (PointId idx = 0; idx < count; ++idx)
+        {
+            if (!passes[idx])
+                continue;
+            point.setPointId(idx);
+            values[idx] = point.getFieldAs<double>(id);
+        }
+
+        std::fill(dimPasses.begin(), dimPasses.end(), 0);
+        for (; ri != end; ++ri)
+            for (PointId idx = 0; idx < count; ++idx)
+                dimPasses[idx] |= (uint8_t)ri->valuePasses(values[idx]);
+        for (PointId idx = 0; idx < count; ++idx)
+            passes[idx] &= dimPasses[idx];
+    }
+}
+
 void DimRange::parse(const std::string& r)
 {
     std::string::size_type pos = subParse(r);
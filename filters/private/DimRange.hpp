@@ -73,6 +73,9 @@ struct DimRange
     bool valuePasses(double d) const;
     static bool pointPasses(const std::vector<DimRange>& ranges,
         PointRef& point);
+    static void pointsPass(const std::vector<DimRange>& ranges,
+        PointTableRef table, const std::vector<uint8_t>& active,
+        point_count_t count, std::vector<uint8_t>& passes);
 
     std::string m_name;
     Dimension::Id m_id;
@@ -0,0 +1,153 @@
+/******************************************************************************
+* Copyright (c) 2026, Hobu Inc. (info@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#include "StrTree.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace pdal
+{
+
+namespace
+{
+
+template<typename T>
+double centerX(const T& box)
+{
+    return (box.minx + box.maxx) / 2;
+}
+
+template<typename T>
+double centerY(const T& box)
+{
+    return (box.miny + box.maxy) / 2;
+}
+
+} // unnamed namespace
+
+
+void StrTree::build(const std::vector<BOX2D>& boxes)
+{
+    m_levels.clear();
+    if (boxes.empty())
+        return;
+
+    Level leaves;
+    leaves.reserve(boxes.size());
+    for (size_t i = 0; i < boxes.size(); ++i)
+    {
+        const BOX2D& b = boxes[i];
+        leaves.push_back({ b.minx, b.miny, b.maxx, b.maxy, i, i + 1 });
+    }
+    m_levels.push_back(std::move(leaves));
+
+    // Order the nodes of a level so that each run of NodeSize nodes is
+    // spatially compact, then make a parent node for each run.
+    while (m_levels.back().size() > 1)
+    {
+        Level& level = m_levels.back();
+        sortTileRecursive(level);
+
+        Level parents;
+        for (size_t begin = 0; begin < level.size(); begin += NodeSize)
+        {
+            size_t end = (std::min)(begin + NodeSize, level.size());
+            Node parent = level[begin];
+            for (size_t i = begin + 1; i < end; ++i)
+            {
+                const Node& n = level[i];
+                parent.minx = (std::min)(parent.minx, n.minx);
+                parent.miny = (std::min)(parent.miny, n.miny);
+                parent.maxx = (std::max)(parent.maxx, n.maxx);
+                parent.maxy = (std::max)(parent.maxy, n.maxy);
+            }
+            parent.begin = begin;
+            parent.end = end;
+            parents.push_back(parent);
+        }
+        m_levels.push_back(std::move(parents));
+    }
+}
+
+
+// Sort nodes into vertical slices by X and then sort each slice by Y.  The
+// number of slices is chosen so that the slices are about as tall as they
+// are wide, in terms of parent nodes.
+void StrTree::sortTileRecursive(Level& nodes) const
+{
+    size_t numParents = (nodes.size() + NodeSize - 1) / NodeSize;
+    size_t numSlices = (size_t)std::ceil(std::sqrt((double)numParents));
+    size_t sliceSize = numSlices * NodeSize;
+
+    std::sort(nodes.begin(), nodes.end(), [](const Node& a, const Node& b)
+        { return centerX(a) < centerX(b); });
+    for (size_t begin = 0; begin < nodes.size(); begin += sliceSize)
+    {
+        auto end = nodes.begin() + (std::min)(begin + sliceSize, nodes.size());
+        std::sort(nodes.begin() + begin, end, [](const Node& a, const Node& b)
+            { return centerY(a) < centerY(b); });
+    }
+}
+
+
+void StrTree::query(const BOX2D& box, std::vector<size_t>& out) const
+{
+    if (m_levels.empty())
+        return;
+
+    size_t first = out.size();
+
+    // Stack of (level, node) pairs to visit.
+    std::vector<std::pair<size_t, size_t>> stack;
+    stack.push_back({ m_levels.size() - 1, 0 });
+    while (stack.size())
+    {
+        size_t level = stack.back().first;
+        const Node& node = m_levels[level][stack.back().second];
+        stack.pop_back();
+
+        if (node.minx > box.maxx || node.maxx < box.minx ||
+                node.miny > box.maxy || node.maxy < box.miny)
+            continue;
+        if (level == 0)
+            out.push_back(node.begin);
+        else
+            for (size_t i = node.begin; i < node.end; ++i)
+                stack.push_back({ level - 1, i });
+    }
+    std::sort(out.begin() + first, out.end());
+}
+
+} // namespace pdal
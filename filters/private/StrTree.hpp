@@ -0,0 +1,88 @@
+/******************************************************************************
+* Copyright (c) 2026, Hobu Inc. (info@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#pragma once
+
+#include <vector>
+
+#include <pdal/util/Bounds.hpp>
+
+namespace pdal
+{
+
+// A static R-tree of 2D boxes.  The tree is bulk loaded with the
+// sort-tile-recursive (STR) algorithm and can't be modified once built.
+class StrTree
+{
+public:
+    // Maximum number of children of a node.
+    static const size_t NodeSize = 16;
+
+    StrTree()
+    {}
+
+    // Build the tree.  Boxes are identified by their position in 'boxes'.
+    void build(const std::vector<BOX2D>& boxes);
+    bool empty() const
+        { return m_levels.empty(); }
+
+    // Find the boxes that overlap 'box'.  Indices of the boxes are appended
+    // to 'out' in ascending order.
+    void query(const BOX2D& box, std::vector<size_t>& out) const;
+    void query(double x, double y, std::vector<size_t>& out) const
+        { query(BOX2D(x, y, x, y), out); }
+
+private:
+    // For leaves, 'begin' is the index of the box.  For interior nodes,
+    // 'begin' and 'end' are the range of the children in the level below.
+    // The bounds are stored directly rather than as a BOX2D to keep nodes
+    // small.
+    struct Node
+    {
+        double minx;
+        double miny;
+        double maxx;
+        double maxy;
+        size_t begin;
+        size_t end;
+    };
+    using Level = std::vector<Node>;
+
+    void sortTileRecursive(Level& nodes) const;
+
+    // Leaves are level 0.  The root is the only node in the last level.
+    std::vector<Level> m_levels;
+};
+
+} // namespace pdal
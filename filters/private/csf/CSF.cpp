@@ -25,6 +25,7 @@
 #include "c2cdist.h"
 #include <fstream>
 #include <pdal/Log.hpp>
+#include <pdal/private/Parallel.hpp>
 
 
 CSF::CSF(int index) {
@@ -35,6 +36,8 @@ CSF::CSF(int index) {
     params.cloth_resolution = 1;
     params.rigidness        = 3;
     params.interations      = 500;
+    params.debug            = false;
+    params.threads          = 1;
 
     this->index = index;
 }
@@ -47,6 +50,8 @@ CSF::CSF() {
     params.cloth_resolution = 1;
     params.rigidness        = 3;
     params.interations      = 500;
+    params.debug            = false;
+    params.threads          = 1;
 
     this->index = 0;
 }
@@ -98,6 +103,22 @@ void CSF::setPointCloud(csf::PointCloud& pc) {
     }
 }
 
+void CSF::setPointCloud(const pdal::PointView& view) {
+    using namespace pdal::Dimension;
+
+    log->get(pdal::LogLevel::Debug) << "setPointCloud: " << view.size() << endl;
+    point_cloud.resize(view.size());
+    int pointCount = static_cast<int>(view.size());
+    pdal::parallelFor(pointCount, params.threads, [&](int begin, int end) {
+        for (int i = begin; i < end; i++) {
+            csf::Point& las = point_cloud[i];
+            las.x = view.getFieldAs<double>(Id::X, i);
+            las.y = -view.getFieldAs<double>(Id::Z, i);
+            las.z = view.getFieldAs<double>(Id::Y, i);
+        }
+    });
+}
+
 void CSF::setPointCloud(vector<vector<float> > points) {
     point_cloud.resize(points.size());
     int pointCount = static_cast<int>(points.size());
@@ -158,7 +179,8 @@ void CSF::do_filtering(std::vector<int>& groundIndexes,
         params.rigidness,
         params.time_step,
         params.debug,
-        params.m_dir
+        params.m_dir,
+        params.threads
     );
 
     log->get(pdal::LogLevel::Debug) << "[" << this->index << "] Rasterizing..." << endl;
@@ -39,6 +39,7 @@
 #include <string>
 #include "point_cloud.h"
 #include <pdal/Log.hpp>
+#include <pdal/PointView.hpp>
 using namespace std;
 
 
@@ -53,6 +54,7 @@ struct Params {
     int interations;
     bool debug;
     std::string m_dir;
+    int threads;
 };
 
 #ifdef _CSF_DLL_EXPORT_
@@ -105,6 +107,9 @@ public:
     // PointCloud set pointcloud
     void setPointCloud(csf::PointCloud& pc);
 
+    // set pointcloud from the X, Y and Z of a PDAL point view
+    void setPointCloud(const pdal::PointView& view);
+
     // set Log
     void setLog(const pdal::LogPtr& log);
 
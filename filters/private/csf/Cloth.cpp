@@ -17,7 +17,9 @@
 
 #include "Cloth.h"
 #include <fstream>
+#include <mutex>
 #include <pdal/util/FileUtils.hpp>
+#include <pdal/private/Parallel.hpp>
 
 
 Cloth::Cloth(const Vec3& _origin_pos,
@@ -30,12 +32,14 @@ Cloth::Cloth(const Vec3& _origin_pos,
              int         rigidness,
              double      time_step,
              bool        debug,
-             string      output_dir)
+             string      output_dir,
+             int         threads)
     : constraint_iterations(rigidness),
     smoothThreshold(_smoothThreshold),
     heightThreshold(_heightThreshold),
     m_outputDir(output_dir),
     debug(debug),
+    threads(threads),
     origin_pos(_origin_pos),
     step_x(_step_x),
     step_y(_step_y),
@@ -102,24 +106,61 @@ Cloth::Cloth(const Vec3& _origin_pos,
 
 double Cloth::timeStep() {
     int particleCount = static_cast<int>(particles.size());
-    #pragma omp parallel for
-    for (int i = 0; i < particleCount; i++) {
-        particles[i].timeStep();
-    }
-    #pragma omp parallel for
-    for (int j = 0; j < particleCount; j++) {
-        particles[j].satisfyConstraintSelf(constraint_iterations);
+    pdal::parallelFor(particleCount, threads, [&](int begin, int end) {
+        for (int i = begin; i < end; i++) {
+            particles[i].timeStep();
+        }
+    });
+
+    // A particle moves itself and its neighbors up to two rows away.  With
+    // more than one thread, the rows are split into bands that are relaxed
+    // in parallel, in row order, except for the last rows of each band,
+    // which are relaxed once all the bands are done.  The band size is fixed
+    // so that the result doesn't depend on the number of threads.  A single
+    // thread relaxes the particles in their original order.
+    if (threads == 1) {
+        for (int j = 0; j < particleCount; j++) {
+            particles[j].satisfyConstraintSelf(constraint_iterations);
+        }
+    } else {
+        const int bandRows = 64;
+        const int seamRows = 4;
+        int bandCount = (num_particles_height + bandRows - 1) / bandRows;
+        auto relaxRows = [&](int begin, int end) {
+            end = (std::min)(end, num_particles_height);
+            for (int y = begin; y < end; y++) {
+                for (int x = 0; x < num_particles_width; x++) {
+                    getParticle(x, y)->satisfyConstraintSelf(constraint_iterations);
+                }
+            }
+        };
+        pdal::parallelFor(bandCount, threads, [&](int begin, int end) {
+            for (int b = begin; b < end; b++)
+                relaxRows(b * bandRows, (b + 1) * bandRows - seamRows);
+        });
+        pdal::parallelFor(bandCount, threads, [&](int begin, int end) {
+            for (int b = begin; b < end; b++)
+                relaxRows((b + 1) * bandRows - seamRows, (b + 1) * bandRows);
+        });
     }
-    double maxDiff = 0;
 
-    for (int i = 0; i < particleCount; i++) {
-        if (particles[i].isMovable()) {
-            double diff = fabs(particles[i].old_pos.f[1] - particles[i].pos.f[1]);
-
-            if (diff > maxDiff)
-                maxDiff = diff;
+    double maxDiff = 0;
+    std::mutex mutex;
+    pdal::parallelFor(particleCount, threads, [&](int begin, int end) {
+        double localMax = 0;
+        for (int i = begin; i < end; i++) {
+            if (particles[i].isMovable()) {
+                double diff = fabs(particles[i].old_pos.f[1] - particles[i].pos.f[1]);
+
+                if (diff > localMax)
+                    localMax = diff;
+            }
         }
-    }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (localMax > maxDiff)
+            maxDiff = localMax;
+    });
 
     return maxDiff;
 }
@@ -133,15 +174,16 @@ void Cloth::addForce(const Vec3 direction) {
 
 void Cloth::terrCollision() {
     int particleCount = static_cast<int>(particles.size());
-    #pragma omp parallel for
-    for (int i = 0; i < particleCount; i++) {
-        Vec3 v = particles[i].getPos();
+    pdal::parallelFor(particleCount, threads, [&](int begin, int end) {
+        for (int i = begin; i < end; i++) {
+            Vec3 v = particles[i].getPos();
 
-        if (v.f[1] < heightvals[i]) {
-            particles[i].offsetPos(Vec3(0, heightvals[i] - v.f[1], 0));
-            particles[i].makeUnmovable();
+            if (v.f[1] < heightvals[i]) {
+                particles[i].offsetPos(Vec3(0, heightvals[i] - v.f[1], 0));
+                particles[i].makeUnmovable();
+            }
         }
-    }
+    });
     saveToFile("collision-notes.txt");
 }
 
@@ -85,6 +85,7 @@ private:
     double heightThreshold;
     string m_outputDir;
     bool debug;
+    int threads;
 
 public:
 
@@ -105,6 +106,10 @@ public:
 
 public:
 
+    int getThreads() {
+        return threads;
+    }
+
     int getSize() {
         return num_particles_width * num_particles_height;
     }
@@ -135,12 +140,17 @@ public:
           int         rigidness,
           double      time_step,
           bool        debug,
-          string      output_dir);
+          string      output_dir,
+          int         threads = 1);
 
     /* this is an important methods where the time is progressed one
      * time step for the entire cloth.  This includes calling
      * satisfyConstraint() for every constraint, and calling
-     * timeStep() for all particles
+     * timeStep() for all particles.  A single thread relaxes the
+     * constraints in particle order.  More threads relax them in parallel
+     * over bands of rows, which may give slightly different results from a
+     * single thread, but the same results for any number of threads
+     * greater than one.
      */
     double timeStep();
 
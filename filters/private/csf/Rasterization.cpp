@@ -17,41 +17,51 @@
 
 #include "Rasterization.h"
 #include <queue>
+#include <pdal/private/Parallel.hpp>
 
 
-double Rasterization::findHeightValByScanline(Particle *p, Cloth& cloth) {
+bool Rasterization::findHeightValByScanline(Particle *p, Cloth& cloth,
+                                            double& height) {
     int xpos = p->pos_x;
     int ypos = p->pos_y;
 
     for (int i = xpos + 1; i < cloth.num_particles_width; i++) {
         double crresHeight = cloth.getParticle(i, ypos)->nearestPointHeight;
 
-        if (crresHeight > MIN_INF)
-            return crresHeight;
+        if (crresHeight > MIN_INF) {
+            height = crresHeight;
+            return true;
+        }
     }
 
     for (int i = xpos - 1; i >= 0; i--) {
         double crresHeight = cloth.getParticle(i, ypos)->nearestPointHeight;
 
-        if (crresHeight > MIN_INF)
-            return crresHeight;
+        if (crresHeight > MIN_INF) {
+            height = crresHeight;
+            return true;
+        }
     }
 
     for (int j = ypos - 1; j >= 0; j--) {
         double crresHeight = cloth.getParticle(xpos, j)->nearestPointHeight;
 
-        if (crresHeight > MIN_INF)
-            return crresHeight;
+        if (crresHeight > MIN_INF) {
+            height = crresHeight;
+            return true;
+        }
     }
 
     for (int j = ypos + 1; j < cloth.num_particles_height; j++) {
         double crresHeight = cloth.getParticle(xpos, j)->nearestPointHeight;
 
-        if (crresHeight > MIN_INF)
-            return crresHeight;
+        if (crresHeight > MIN_INF) {
+            height = crresHeight;
+            return true;
+        }
     }
 
-    return findHeightValByNeighbor(p, cloth);
+    return false;
 }
 
 
@@ -130,15 +140,25 @@ void Rasterization::RasterTerrian(Cloth          & cloth,
     }
     heightVal.resize(cloth.getSize());
 
-    #pragma omp parallel for
-    for (int i = 0; i < cloth.getSize(); i++) {
-        Particle *pcur          = cloth.getParticle1d(i);
-        double    nearestHeight = pcur->nearestPointHeight;
-
-        if (nearestHeight > MIN_INF) {
-            heightVal[i] = nearestHeight;
-        } else {
-            heightVal[i] = findHeightValByScanline(pcur, cloth);
+    // The scanline search only reads the cloth, so it can run in parallel.
+    // The search over neighbors marks particles as visited, so particles
+    // that need it are handled afterwards.
+    vector<char> unresolved(cloth.getSize(), 0);
+    pdal::parallelFor(cloth.getSize(), cloth.getThreads(), [&](int begin, int end) {
+        for (int i = begin; i < end; i++) {
+            Particle *pcur          = cloth.getParticle1d(i);
+            double    nearestHeight = pcur->nearestPointHeight;
+
+            if (nearestHeight > MIN_INF) {
+                heightVal[i] = nearestHeight;
+            } else if (!findHeightValByScanline(pcur, cloth, heightVal[i])) {
+                unresolved[i] = 1;
+            }
         }
+    });
+
+    for (int i = 0; i < cloth.getSize(); i++) {
+        if (unresolved[i])
+            heightVal[i] = findHeightValByNeighbor(cloth.getParticle1d(i), cloth);
     }
 }
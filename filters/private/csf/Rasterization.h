@@ -33,7 +33,10 @@ public:
     // for a cloth particle, if no corresponding lidar point are found.
     // the heightval are set as its neighbor's
     double static findHeightValByNeighbor(Particle *p, Cloth& cloth);
-    double static findHeightValByScanline(Particle *p, Cloth& cloth);
+    // set the height from the nearest particle with a lidar point in the
+    // same row or column.  returns false if there is none.
+    bool static   findHeightValByScanline(Particle *p, Cloth& cloth,
+                                          double& height);
 
     void static   RasterTerrian(Cloth          & cloth,
                                 csf::PointCloud& pc,
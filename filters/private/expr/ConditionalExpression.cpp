@@ -1,5 +1,7 @@
 #include "ConditionalExpression.hpp"
 
+#include <vector>
+
 namespace pdal
 {
 namespace expr
@@ -7,6 +9,7 @@ namespace expr
 
 Utils::StatusWithReason ConditionalExpression::prepare(PointLayoutPtr layout)
 {
+    m_program.clear();
     Node *top = topNode();
     if (top)
     {
@@ -28,6 +31,8 @@ Utils::StatusWithReason ConditionalExpression::prepare(PointLayoutPtr layout)
                 }
             }
         }
+        if (status)
+            m_program.setResult(top->compile(m_program));
         return status;
     }
     return true;
@@ -39,6 +44,29 @@ bool ConditionalExpression::eval(PointRef& p) const
     return n ? n->eval(p).m_bval : true;
 }
 
+void ConditionalExpression::eval(PointRef& point, const PointId *ids,
+    size_t count, uint8_t *out) const
+{
+    // If the expression hasn't been compiled, evaluate it point by point.
+    if (m_program.empty())
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            point.setPointId(ids[i]);
+            out[i] = eval(point);
+        }
+        return;
+    }
+
+    // The values are kept between calls so that they're only allocated
+    // for the largest batch.
+    if (m_vals.size() < count)
+        m_vals.resize(count);
+    m_program.eval(point, ids, count, m_vals.data());
+    for (size_t i = 0; i < count; ++i)
+        out[i] = (m_vals[i] != 0);
+}
+
 } // namespace expr
 } // namespace pdal
 
@@ -3,6 +3,7 @@
 #include "Expression.hpp"
 #include "Lexer.hpp"
 #include "ConditionalParser.hpp"
+#include "Program.hpp"
 
 namespace pdal
 {
@@ -14,6 +15,15 @@ class ConditionalExpression : public Expression
 public:
     Utils::StatusWithReason prepare(PointLayoutPtr layout);
     bool eval(PointRef& p) const;
+
+    // Evaluate the expression for the points 'ids' using the program
+    // compiled by prepare().  'point' provides access to the points.
+    void eval(PointRef& point, const PointId *ids, size_t count,
+        uint8_t *out) const;
+
+private:
+    Program m_program;
+    mutable std::vector<double> m_vals;
 };
 
 } // namespace expr
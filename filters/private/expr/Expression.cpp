@@ -1,4 +1,5 @@
 #include "Expression.hpp"
+#include "Program.hpp"
 
 namespace pdal
 {
@@ -37,6 +38,11 @@ Result NotNode::eval(PointRef& p) const
     return !(m_sub->eval(p).m_bval);
 }
 
+int NotNode::compile(Program& prog) const
+{
+    return prog.unary(type(), m_sub->compile(prog));
+}
+
 
 //
 // UnMathNode
@@ -60,6 +66,11 @@ Result UnMathNode::eval(PointRef& p) const
     return -(m_sub->eval(p).m_dval);
 }
 
+int UnMathNode::compile(Program& prog) const
+{
+    return prog.unary(NodeType::Negative, m_sub->compile(prog));
+}
+
 
 //
 // BinMathNode
@@ -125,6 +136,13 @@ Result BinMathNode::eval(PointRef& p) const
     return 0.0;
 }
 
+int BinMathNode::compile(Program& prog) const
+{
+    int left = m_left->compile(prog);
+    int right = m_right->compile(prog);
+    return prog.binary(type(), left, right);
+}
+
 //
 // Bool node
 //
@@ -175,6 +193,13 @@ Result BoolNode::eval(PointRef& p) const
     return false;
 }
 
+int BoolNode::compile(Program& prog) const
+{
+    int left = m_left->compile(prog);
+    int right = m_right->compile(prog);
+    return prog.binary(type(), left, right);
+}
+
 //
 // FuncNode
 //
@@ -192,6 +217,11 @@ Result FuncNode::eval(PointRef& p) const
     return m_func.function(m_sub->eval(p).m_dval);
 }
 
+int FuncNode::compile(Program& prog) const
+{
+    return prog.func(m_func.function, m_sub->compile(prog));
+}
+
 std::string FuncNode::print() const
 {
     return m_func.name + "(" + m_sub->print() + ")";
@@ -214,6 +244,11 @@ Result BoolFuncNode::eval(PointRef& p) const
     return m_func.function(m_sub->eval(p).m_dval);
 }
 
+int BoolFuncNode::compile(Program& prog) const
+{
+    return prog.boolFunc(m_func.function, m_sub->compile(prog));
+}
+
 std::string BoolFuncNode::print() const
 {
     return m_func.name + "(" + m_sub->print() + ")";
@@ -288,6 +323,13 @@ Result CompareNode::eval(PointRef& p) const
     return false;
 }
 
+int CompareNode::compile(Program& prog) const
+{
+    int left = m_left->compile(prog);
+    int right = m_right->compile(prog);
+    return prog.binary(type(), left, right);
+}
+
 //
 // ConstValueNode
 //
@@ -310,6 +352,11 @@ Result ConstValueNode::eval(PointRef&) const
     return m_val;
 }
 
+int ConstValueNode::compile(Program& prog) const
+{
+    return prog.constant(m_val);
+}
+
 double ConstValueNode::value() const
 {
     return m_val;
@@ -338,6 +385,11 @@ Result ConstLogicalNode::eval(PointRef&) const
     return m_val;
 }
 
+int ConstLogicalNode::compile(Program& prog) const
+{
+    return prog.constant(m_val ? 1 : 0);
+}
+
 bool ConstLogicalNode::value() const
 {
     return m_val;
@@ -360,6 +412,11 @@ Result VarNode::eval(PointRef& p) const
     return p.getFieldAs<double>(m_id);
 }
 
+int VarNode::compile(Program& prog) const
+{
+    return prog.load(m_id);
+}
+
 Dimension::Id VarNode::eval() const
 {
     return m_id;
@@ -15,6 +15,8 @@ namespace pdal
 namespace expr
 {
 
+class Program;
+
 enum class NodeType
 {
     And,
@@ -87,6 +89,9 @@ public:
     virtual std::string print() const = 0;
     virtual Utils::StatusWithReason prepare(PointLayoutPtr l) = 0;
     virtual Result eval(PointRef& p) const = 0;
+    // Add the instructions to evaluate the node to the program and
+    // return the register holding the result.
+    virtual int compile(Program& prog) const = 0;
     virtual bool isBool() const = 0;
     virtual bool isValue() const
     { return !isBool(); }
@@ -128,6 +133,7 @@ public:
     virtual std::string print() const;
     virtual Utils::StatusWithReason prepare(PointLayoutPtr l);
     virtual Result eval(PointRef& p) const;
+    virtual int compile(Program& prog) const;
 
 private:
     NodePtr m_left;
@@ -142,6 +148,7 @@ public:
     virtual std::string print() const;
     virtual Utils::StatusWithReason prepare(PointLayoutPtr l);
     virtual Result eval(PointRef& p) const;
+    virtual int compile(Program& prog) const;
 
 private:
     Func1 m_func;
@@ -156,6 +163,7 @@ public:
     virtual std::string print() const;
     virtual Utils::StatusWithReason prepare(PointLayoutPtr l);
     virtual Result eval(PointRef& p) const;
+    virtual int compile(Program& prog) const;
 
 private:
     NodePtr m_sub;
@@ -169,6 +177,7 @@ public:
     virtual std::string print() const;
     virtual Utils::StatusWithReason prepare(PointLayoutPtr l);
     virtual Result eval(PointRef& p) const;
+    virtual int compile(Program& prog) const;
 
 private:
     BoolFunc1 m_func;
@@ -183,6 +192,7 @@ public:
     virtual std::string print() const;
     virtual Utils::StatusWithReason prepare(PointLayoutPtr l);
     virtual Result eval(PointRef& p) const;
+    virtual int compile(Program& prog) const;
 
 private:
     NodePtr m_sub;
@@ -196,6 +206,7 @@ public:
     virtual std::string print() const;
     virtual Utils::StatusWithReason prepare(PointLayoutPtr l);
     virtual Result eval(PointRef& p) const;
+    virtual int compile(Program& prog) const;
 
 private:
     NodePtr m_left;
@@ -210,6 +221,7 @@ public:
     virtual std::string print() const;
     virtual Utils::StatusWithReason prepare(PointLayoutPtr l);
     virtual Result eval(PointRef& p) const;
+    virtual int compile(Program& prog) const;
 
 private:
     NodePtr m_left;
@@ -224,6 +236,7 @@ public:
     virtual std::string print() const;
     virtual Utils::StatusWithReason prepare(PointLayoutPtr l);
     virtual Result eval(PointRef&) const;
+    virtual int compile(Program& prog) const;
 
     double value() const;
 
@@ -239,6 +252,7 @@ public:
     virtual std::string print() const;
     virtual Utils::StatusWithReason prepare(PointLayoutPtr l);
     virtual Result eval(PointRef&) const;
+    virtual int compile(Program& prog) const;
 
     bool value() const;
 
@@ -254,6 +268,7 @@ public:
     virtual std::string print() const;
     virtual Utils::StatusWithReason prepare(PointLayoutPtr l);
     virtual Result eval(PointRef& p) const;
+    virtual int compile(Program& prog) const;
     Dimension::Id eval() const;
     inline std::string const& name() const { return m_name; }
 
@@ -7,6 +7,7 @@ namespace expr
 
 Utils::StatusWithReason MathExpression::prepare(PointLayoutPtr layout)
 {
+    m_program.clear();
     Node *top = topNode();
     if (top)
     {
@@ -16,6 +17,8 @@ Utils::StatusWithReason MathExpression::prepare(PointLayoutPtr layout)
             if (!top->isValue())
                 status = { -1, "Expression doesn't evaluate to a value." };
         }
+        if (status)
+            m_program.setResult(top->compile(m_program));
         return status;
     }
     return true;
@@ -27,6 +30,22 @@ double MathExpression::eval(PointRef& p) const
     return n ? n->eval(p).m_dval : 0;
 }
 
+void MathExpression::eval(PointRef& point, const PointId *ids, size_t count,
+    double *out) const
+{
+    // If the expression hasn't been compiled, evaluate it point by point.
+    if (m_program.empty())
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            point.setPointId(ids[i]);
+            out[i] = eval(point);
+        }
+    }
+    else
+        m_program.eval(point, ids, count, out);
+}
+
 } // namespace expr
 } // namespace pdal
 
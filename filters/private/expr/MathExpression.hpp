@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Expression.hpp"
+#include "Program.hpp"
 
 namespace pdal
 {
@@ -12,6 +13,14 @@ class MathExpression : public Expression
 public:
     Utils::StatusWithReason prepare(PointLayoutPtr layout);
     double eval(PointRef& p) const;
+
+    // Evaluate the expression for the points 'ids' using the program
+    // compiled by prepare().  'point' provides access to the points.
+    void eval(PointRef& point, const PointId *ids, size_t count,
+        double *out) const;
+
+private:
+    Program m_program;
 };
 
 } // namespace expr
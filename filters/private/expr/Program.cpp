@@ -0,0 +1,283 @@
+#include "Program.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace pdal
+{
+namespace expr
+{
+
+namespace
+{
+
+template<typename F>
+void unaryLoop(const double *a, double *out, size_t count, F f)
+{
+    for (size_t i = 0; i < count; ++i)
+        out[i] = f(a[i]);
+}
+
+template<typename F>
+void binaryLoop(const double *a, const double *b, double *out, size_t count,
+    F f)
+{
+    for (size_t i = 0; i < count; ++i)
+        out[i] = f(a[i], b[i]);
+}
+
+} // unnamed namespace
+
+void Program::clear()
+{
+    m_instructions.clear();
+    m_loads.clear();
+    m_result = -1;
+}
+
+bool Program::empty() const
+{
+    return m_result < 0;
+}
+
+size_t Program::size() const
+{
+    return m_instructions.size();
+}
+
+int Program::add(const Instruction& inst)
+{
+    m_instructions.push_back(inst);
+    return (int)m_instructions.size() - 1;
+}
+
+int Program::constant(double val)
+{
+    return add({ NodeType::Value, -1, -1, val, Dimension::Id::Unknown,
+        nullptr, nullptr });
+}
+
+int Program::load(Dimension::Id id)
+{
+    // Each dimension only needs to be loaded once.
+    auto it = m_loads.find(id);
+    if (it != m_loads.end())
+        return it->second;
+
+    int reg = add({ NodeType::Identifier, -1, -1, 0, id, nullptr, nullptr });
+    m_loads[id] = reg;
+    return reg;
+}
+
+int Program::unary(NodeType op, int reg)
+{
+    Instruction inst { op, reg, -1, 0, Dimension::Id::Unknown,
+        nullptr, nullptr };
+    if (isConstant(reg))
+        return constant(apply(inst, constantValue(reg), 0));
+    return add(inst);
+}
+
+int Program::binary(NodeType op, int left, int right)
+{
+    Instruction inst { op, left, right, 0, Dimension::Id::Unknown,
+        nullptr, nullptr };
+    if (isConstant(left) && isConstant(right))
+        return constant(apply(inst, constantValue(left),
+            constantValue(right)));
+    return add(inst);
+}
+
+int Program::func(FuncPtr f, int reg)
+{
+    Instruction inst { NodeType::Function, reg, -1, 0, Dimension::Id::Unknown,
+        f, nullptr };
+    if (isConstant(reg))
+        return constant(apply(inst, constantValue(reg), 0));
+    return add(inst);
+}
+
+int Program::boolFunc(BoolFuncPtr f, int reg)
+{
+    Instruction inst { NodeType::Function, reg, -1, 0, Dimension::Id::Unknown,
+        nullptr, f };
+    if (isConstant(reg))
+        return constant(apply(inst, constantValue(reg), 0));
+    return add(inst);
+}
+
+bool Program::isConstant(int reg) const
+{
+    return m_instructions[reg].m_op == NodeType::Value;
+}
+
+double Program::constantValue(int reg) const
+{
+    return m_instructions[reg].m_val;
+}
+
+void Program::setResult(int reg)
+{
+    m_result = reg;
+}
+
+// Scalar evaluation of an instruction.  This is used to fold constants and
+// matches the evaluation done by the expression nodes.
+double Program::apply(const Instruction& inst, double l, double r) const
+{
+    switch (inst.m_op)
+    {
+    case NodeType::Add:
+        return l + r;
+    case NodeType::Subtract:
+        return l - r;
+    case NodeType::Multiply:
+        return l * r;
+    case NodeType::Divide:
+        return r == 0 ? std::numeric_limits<double>::quiet_NaN() : l / r;
+    case NodeType::Negative:
+        return -l;
+    case NodeType::Not:
+        return l == 0;
+    case NodeType::And:
+        return l != 0 && r != 0;
+    case NodeType::Or:
+        return l != 0 || r != 0;
+    case NodeType::Equal:
+        return l == r;
+    case NodeType::NotEqual:
+        return l != r;
+    case NodeType::Less:
+        return l < r;
+    case NodeType::LessEqual:
+        return l <= r;
+    case NodeType::Greater:
+        return l > r;
+    case NodeType::GreaterEqual:
+        return l >= r;
+    case NodeType::Function:
+        return inst.m_func ? inst.m_func(l) : (double)inst.m_boolFunc(l);
+    case NodeType::Value:
+        return inst.m_val;
+    default:
+        break;
+    }
+    throw pdal_error("Invalid instruction in expression program.");
+}
+
+// Run one instruction for 'count' points.  The switch on the operation is
+// outside of the loops over the points.
+void Program::run(size_t reg, PointRef& point, const PointId *ids,
+    size_t count) const
+{
+    const Instruction& inst = m_instructions[reg];
+    double *out = m_regs.data() + reg * BatchSize;
+    const double *a = inst.m_left < 0 ? nullptr :
+        m_regs.data() + inst.m_left * BatchSize;
+    const double *b = inst.m_right < 0 ? nullptr :
+        m_regs.data() + inst.m_right * BatchSize;
+
+    switch (inst.m_op)
+    {
+    case NodeType::Value:
+        std::fill(out, out + count, inst.m_val);
+        break;
+    case NodeType::Identifier:
+        for (size_t i = 0; i < count; ++i)
+        {
+            point.setPointId(ids[i]);
+            out[i] = point.getFieldAs<double>(inst.m_dim);
+        }
+        break;
+    case NodeType::Add:
+        binaryLoop(a, b, out, count, [](double l, double r){ return l + r; });
+        break;
+    case NodeType::Subtract:
+        binaryLoop(a, b, out, count, [](double l, double r){ return l - r; });
+        break;
+    case NodeType::Multiply:
+        binaryLoop(a, b, out, count, [](double l, double r){ return l * r; });
+        break;
+    case NodeType::Divide:
+        binaryLoop(a, b, out, count, [](double l, double r)
+            { return r == 0 ? std::numeric_limits<double>::quiet_NaN() :
+                l / r; });
+        break;
+    case NodeType::Negative:
+        unaryLoop(a, out, count, [](double v){ return -v; });
+        break;
+    case NodeType::Not:
+        unaryLoop(a, out, count, [](double v){ return (double)(v == 0); });
+        break;
+    case NodeType::And:
+        binaryLoop(a, b, out, count, [](double l, double r)
+            { return (double)(l != 0 && r != 0); });
+        break;
+    case NodeType::Or:
+        binaryLoop(a, b, out, count, [](double l, double r)
+            { return (double)(l != 0 || r != 0); });
+        break;
+    case NodeType::Equal:
+        binaryLoop(a, b, out, count, [](double l, double r)
+            { return (double)(l == r); });
+        break;
+    case NodeType::NotEqual:
+        binaryLoop(a, b, out, count, [](double l, double r)
+            { return (double)(l != r); });
+        break;
+    case NodeType::Less:
+        binaryLoop(a, b, out, count, [](double l, double r)
+            { return (double)(l < r); });
+        break;
+    case NodeType::LessEqual:
+        binaryLoop(a, b, out, count, [](double l, double r)
+            { return (double)(l <= r); });
+        break;
+    case NodeType::Greater:
+        binaryLoop(a, b, out, count, [](double l, double r)
+            { return (double)(l > r); });
+        break;
+    case NodeType::GreaterEqual:
+        binaryLoop(a, b, out, count, [](double l, double r)
+            { return (double)(l >= r); });
+        break;
+    case NodeType::Function:
+        if (inst.m_func)
+            unaryLoop(a, out, count, inst.m_func);
+        else
+            unaryLoop(a, out, count, [&inst](double v)
+                { return (double)inst.m_boolFunc(v); });
+        break;
+    default:
+        throw pdal_error("Invalid instruction in expression program.");
+    }
+}
+
+void Program::eval(PointRef& point, const PointId *ids, size_t count,
+    double *out) const
+{
+    if (empty())
+        return;
+
+    if (isConstant(m_result))
+    {
+        std::fill(out, out + count, constantValue(m_result));
+        return;
+    }
+
+    // Only instructions up to the result need to be run.
+    const size_t numRegs = m_result + 1;
+    if (m_regs.size() < numRegs * BatchSize)
+        m_regs.resize(numRegs * BatchSize);
+    for (size_t start = 0; start < count; start += BatchSize)
+    {
+        size_t n = (std::min)(BatchSize, count - start);
+        for (size_t reg = 0; reg < numRegs; ++reg)
+            run(reg, point, ids + start, n);
+        const double *result = m_regs.data() + m_result * BatchSize;
+        std::copy(result, result + n, out + start);
+    }
+}
+
+} // namespace expr
+} // namespace pdal
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <map>
+#include <vector>
+
+#include "Expression.hpp"
+
+namespace pdal
+{
+namespace expr
+{
+
+// An expression compiled to a linear list of instructions.  Each instruction
+// writes a register that holds its result for every point in a batch.
+// Register N is written by instruction N.  Logical results are stored
+// as 0 or 1.
+class Program
+{
+public:
+    using FuncPtr = double(*)(double);
+    using BoolFuncPtr = bool(*)(double);
+
+    // Maximum number of points evaluated at once.
+    static const size_t BatchSize = 256;
+
+    void clear();
+    bool empty() const;
+    size_t size() const;
+
+    // Instructions with constant operands are folded into constants.
+    // Each function returns the register that holds its result.
+    int constant(double val);
+    int load(Dimension::Id id);
+    int unary(NodeType op, int reg);
+    int binary(NodeType op, int left, int right);
+    int func(FuncPtr f, int reg);
+    int boolFunc(BoolFuncPtr f, int reg);
+
+    bool isConstant(int reg) const;
+    double constantValue(int reg) const;
+    void setResult(int reg);
+
+    // Evaluate the program for points 'ids', using 'point' to access the
+    // point data.  'out' must have room for 'count' values.  The registers
+    // are kept between calls, so a program can't be evaluated by more than
+    // one thread at a time.
+    void eval(PointRef& point, const PointId *ids, size_t count,
+        double *out) const;
+
+private:
+    struct Instruction
+    {
+        NodeType m_op;
+        int m_left;
+        int m_right;
+        double m_val;
+        Dimension::Id m_dim;
+        FuncPtr m_func;
+        BoolFuncPtr m_boolFunc;
+    };
+
+    int add(const Instruction& inst);
+    double apply(const Instruction& inst, double left, double right) const;
+    void run(size_t reg, PointRef& point, const PointId *ids,
+        size_t count) const;
+
+    std::vector<Instruction> m_instructions;
+    std::map<Dimension::Id, int> m_loads;
+    int m_result = -1;
+    mutable std::vector<double> m_regs;
+};
+
+} // namespace expr
+} // namespace pdal
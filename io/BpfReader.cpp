@@ -63,6 +63,7 @@ CREATE_STATIC_STAGE(BpfReader, s_info)
 struct BpfReader::Args
 {
     bool m_fixNames;
+    bool m_useMmap;
 };
 
 std::string BpfReader::getName() const { return s_info.name; }
@@ -89,6 +90,8 @@ void BpfReader::addArgs(ProgramArgs& args)
 {
     args.add("fix_dims", "Make invalid dimension names valid by changing "
         "invalid characters to '_'", m_args->m_fixNames, true);
+    args.add("use_mmap", "Read point data from a memory mapping of the file",
+        m_args->m_useMmap);
 }
 
 
@@ -326,13 +329,61 @@ void BpfReader::ready(PointTableRef)
         } while (bytesRead > 0 && index < m_deflateBuf.size());
         m_charbuf.initialize(m_deflateBuf.data(), m_deflateBuf.size(), m_start);
         m_stream.pushStream(new std::istream(&m_charbuf));
+        // With 'use_mmap', inflated data is decoded from memory as mapped
+        // data would be.
+        if (m_args->m_useMmap)
+        {
+            m_extractor.reset(new LeExtractor(m_deflateBuf.data(),
+                m_deflateBuf.size()));
+            log()->get(LogLevel::Debug) << "Reading inflated point data "
+                "from memory.\n";
+        }
     }
 #endif // PDAL_HAVE_ZLIB
+    if (!m_extractor && m_args->m_useMmap)
+        mapPoints();
+}
+
+
+// Map the file so that point data is decoded directly from memory.  If
+// the file can't be mapped, points are read from the stream.
+void BpfReader::mapPoints()
+{
+    const uintmax_t size = numPoints() * m_dims.size() * sizeof(float);
+    const uintmax_t start = (uintmax_t)m_start;
+
+    if (FileUtils::fileSize(m_filename) < start + size)
+    {
+        log()->get(LogLevel::Warning) << "Can't map '" << m_filename <<
+            "': file is too small for its points. Reading from stream.\n";
+        return;
+    }
+    m_map = FileUtils::mapFile(m_filename);
+    if (!m_map.addr())
+    {
+        log()->get(LogLevel::Warning) << "Unable to map '" << m_filename <<
+            "': " << m_map.what() << " Reading from stream.\n";
+        return;
+    }
+
+    // Point-major data is read in order.  The other formats read each
+    // dimension (or byte) as a separate sequence, so just prefetch.
+    FileUtils::adviseMap(m_map,
+        m_header.m_pointFormat == BpfFormat::PointMajor ?
+            FileUtils::MapAdvice::Sequential : FileUtils::MapAdvice::WillNeed,
+        start, size);
+    m_extractor.reset(new LeExtractor((const char *)m_map.addr() + start,
+        (size_t)size));
+    log()->get(LogLevel::Debug) << "Reading point data from a mapping of '" <<
+        m_filename << "'.\n";
 }
 
 
 void BpfReader::done(PointTableRef)
 {
+    m_extractor.reset();
+    if (m_map.addr())
+        m_map = FileUtils::unmapFile(m_map);
     if (auto s = m_stream.popStream())
         delete s;
     m_stream.close();
@@ -397,7 +448,7 @@ void BpfReader::readPointMajor(PointRef& point)
     {
         float f;
 
-        m_stream >> f;
+        extract(f);
         double d = f + m_dims[dim].m_offset;
         if (m_dims[dim].m_id == Dimension::Id::X)
             x = d;
@@ -429,7 +480,7 @@ point_count_t BpfReader::readPointMajor(PointViewPtr view, point_count_t count)
         {
             float f;
 
-            m_stream >> f;
+            extract(f);
             view->setField(m_dims[d].m_id, nextId, f + m_dims[d].m_offset);
         }
 
@@ -455,7 +506,7 @@ point_count_t BpfReader::readPointMajor(PointViewPtr view, point_count_t count)
 
 void BpfReader::readDimMajor(PointRef& point)
 {
-    if (m_streams.empty())
+    if (m_streams.empty() && !m_extractor)
     {
         for (std::size_t dim(0); dim < m_dims.size(); ++dim)
         {
@@ -486,7 +537,13 @@ void BpfReader::readDimMajor(PointRef& point)
 
     for (size_t dim = 0; dim < m_dims.size(); ++dim)
     {
-        *m_streams[dim] >> f;
+        if (m_extractor)
+        {
+            seekDimMajor(dim, m_index);
+            *m_extractor >> f;
+        }
+        else
+            *m_streams[dim] >> f;
         d = f + m_dims[dim].m_offset;
         if (m_dims[dim].m_id == Dimension::Id::X)
             x = d;
@@ -522,7 +579,7 @@ point_count_t BpfReader::readDimMajor(PointViewPtr data, point_count_t count)
         {
             float f;
 
-            m_stream >> f;
+            extract(f);
             data->setField(m_dims[d].m_id, nextId, f + m_dims[d].m_offset);
         }
     }
@@ -565,7 +622,7 @@ void BpfReader::readByteMajor(PointRef& point)
         {
             seekByteMajor(dim, b, m_index);
 
-            m_stream >> u8;
+            extract(u8);
             u.u32 |= ((uint32_t)u8 << (b * CHAR_BIT));
         }
         double d = u.f + m_dims[dim].m_offset;
@@ -619,7 +676,7 @@ point_count_t BpfReader::readByteMajor(PointViewPtr data, point_count_t count)
                 if (b == 0)
                     u.u32 = 0;
                 uint8_t u8;
-                m_stream >> u8;
+                extract(u8);
                 u.u32 |= ((uint32_t)u8 << (b * CHAR_BIT));
                 if (b == 3)
                 {
@@ -653,7 +710,10 @@ point_count_t BpfReader::readByteMajor(PointViewPtr data, point_count_t count)
 void BpfReader::seekPointMajor(PointId ptIdx)
 {
     std::streamoff offset = ptIdx * sizeof(float) * m_dims.size();
-    m_stream.seek(m_start + offset);
+    if (m_extractor)
+        m_extractor->seek((size_t)offset);
+    else
+        m_stream.seek(m_start + offset);
 }
 
 
@@ -661,7 +721,10 @@ void BpfReader::seekDimMajor(size_t dimIdx, PointId ptIdx)
 {
     std::streamoff offset = ((sizeof(float) * dimIdx * numPoints()) +
         (sizeof(float) * ptIdx));
-    m_stream.seek(m_start + offset);
+    if (m_extractor)
+        m_extractor->seek((size_t)offset);
+    else
+        m_stream.seek(m_start + offset);
 }
 
 
@@ -671,7 +734,10 @@ void BpfReader::seekByteMajor(size_t dimIdx, size_t byteIdx, PointId ptIdx)
         (dimIdx * numPoints() * sizeof(float)) +
         (byteIdx * numPoints()) +
         ptIdx;
-    m_stream.seek(m_start + offset);
+    if (m_extractor)
+        m_extractor->seek((size_t)offset);
+    else
+        m_stream.seek(m_start + offset);
 }
 
 
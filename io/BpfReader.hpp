@@ -42,6 +42,8 @@
 #include <pdal/Reader.hpp>
 #include <pdal/Streamable.hpp>
 #include <pdal/util/Charbuf.hpp>
+#include <pdal/util/Extractor.hpp>
+#include <pdal/util/FileUtils.hpp>
 #include <pdal/util/IStream.hpp>
 #include <pdal/pdal_export.hpp>
 
@@ -82,6 +84,11 @@ private:
     std::vector<char> m_deflateBuf;
     /// Streambuf for deflated data.
     Charbuf m_charbuf;
+    /// Mapping of the file when point data is read from memory.
+    FileUtils::MapContext m_map;
+    /// Extractor for point data in memory (mapped or deflated).  When set,
+    /// it's used in place of m_stream.  Positions are relative to m_start.
+    std::unique_ptr<LeExtractor> m_extractor;
     std::unique_ptr<Args> m_args;
 
     // For dimension-major point-at-a-time usage.
@@ -116,6 +123,16 @@ private:
     void seekPointMajor(PointId ptIdx);
     void seekDimMajor(size_t dimIdx, PointId ptIdx);
     void seekByteMajor(size_t dimIdx, size_t byteIdx, PointId ptIdx);
+    void mapPoints();
+
+    template<typename T>
+    void extract(T& t)
+    {
+        if (m_extractor)
+            *m_extractor >> t;
+        else
+            m_stream >> t;
+    }
 };
 
 } // namespace pdal
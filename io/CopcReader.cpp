@@ -229,6 +229,9 @@ public:
     int keepAliveChunkCount = 10;
     SrsOrderSpec srsVlrOrder;
     bool nosrs;
+    std::string cacheDir;
+    uint64_t cacheSize;
+    bool cacheValidate;
 };
 
 struct CopcReader::Private
@@ -307,6 +310,12 @@ void CopcReader::addArgs(ProgramArgs& args)
     args.add("srs_vlr_order", "Preference order to read SRS VLRs "
         "(list of 'wkt1', 'wkt2' or 'projjson'", m_args->srsVlrOrder);
     args.add("nosrs", "Skip reading/processing file SRS", m_args->nosrs, false);
+    args.add("cache_dir", "Directory in which to cache fetched data",
+        m_args->cacheDir);
+    args.add("cache_size", "Maximum size of the cache in megabytes",
+        m_args->cacheSize, (uint64_t)1024);
+    args.add("cache_validate", "Check that cached data is current once per "
+        "run", m_args->cacheValidate, true);
 }
 
 
@@ -318,7 +327,21 @@ void CopcReader::initialize(PointTableRef table)
     // Make sure we allow at least as many chunks as we have threads.
     m_args->keepAliveChunkCount = (std::max)(m_args->threads, (size_t)m_args->keepAliveChunkCount);
 
+    if (m_args->cacheSize < 1)
+        throwError("Option 'cache_size' must be at least 1.");
     m_p->connector.reset(new connector::Connector(m_filespec));
+    if (m_args->cacheDir.size())
+    {
+        try
+        {
+            m_p->connector->setCache(m_args->cacheDir,
+                m_args->cacheSize * 1024 * 1024, m_args->cacheValidate);
+        }
+        catch (const pdal_error& err)
+        {
+            throwError(err.what());
+        }
+    }
 
     MetadataNode forward = table.privateMetadata("lasforward");
     MetadataNode m = getMetadata();
@@ -986,6 +1009,11 @@ void CopcReader::done()
         m_p->done = true;
         m_p->consumedCv.notify_all();
         m_p->pool->stop();
+        if (m_p->connector && m_args->cacheDir.size())
+            log()->get(LogLevel::Debug) << "Read " <<
+                m_p->connector->cacheHits() << " of " <<
+                m_p->connector->cacheRequests() <<
+                " cacheable requests from the cache." << std::endl;
         m_p->connector.reset();
     }
 }
@@ -49,6 +49,9 @@
 #include "private/copcwriter/CellManager.hpp"
 #include "private/copcwriter/Grid.hpp"
 #include "private/copcwriter/Reprocessor.hpp"
+#include "private/copcwriter/Spill.hpp"
+
+#include <random>
 
 namespace pdal
 {
@@ -132,6 +135,10 @@ void CopcWriter::addArgs(ProgramArgs& args)
         decltype(b->opts.enhancedSrsVlrs)(false));
     args.add("extra_dims", "List of dimension names to write in addition to those of the "
         "point format or 'all' for all available dimensions", b->opts.extraDimSpec);
+    args.add("temp_dir", "Directory for temporary files written in stream mode",
+        b->opts.tempDir);
+    args.add("memory_budget", "Memory used to buffer points in stream mode (MB)",
+        b->opts.memoryBudget, (uint64_t)1024);
 }
 
 void CopcWriter::fillForwardList()
@@ -317,6 +324,28 @@ void CopcWriter::ready(PointTableRef table)
     if (b->opts.emitPipeline)
         handlePipelineVlr();
     handleUserVlrs(table.metadata());
+
+    // In stream mode, points are written to temporary files as packed data of all
+    // the dimensions in the layout.
+    PointLayoutPtr layout = table.layout();
+    b->spillDims.clear();
+    b->spillNames.clear();
+    b->spillPointSize = 0;
+    for (Dimension::Id id : layout->dims())
+    {
+        Dimension::Type type = layout->dimType(id);
+        b->spillDims.emplace_back(id, type);
+        b->spillNames.push_back(layout->dimName(id));
+        b->spillPointSize += Dimension::size(type);
+    }
+    if (b->opts.tempDir.empty())
+        b->opts.tempDir = arbiter::getTempPath();
+    std::random_device rd;
+    b->spillPrefix = FileUtils::stem(filename()) + "-" + std::to_string(rd());
+
+    spill.reset();
+    streamBounds.clear();
+    streamSrs = table.anySpatialReference();
 }
 
 void CopcWriter::handlePipelineVlr()
@@ -367,13 +396,7 @@ void CopcWriter::write(const PointViewPtr v)
         double x = p.getFieldAs<double>(Dimension::Id::X);
         double y = p.getFieldAs<double>(Dimension::Id::Y);
         double z = p.getFieldAs<double>(Dimension::Id::Z);
-        double t = p.getFieldAs<double>(Dimension::Id::GpsTime);
-        double r = p.getFieldAs<double>(Dimension::Id::ReturnNumber);
-        b->stats[(int)stats::Index::X].insert(x);
-        b->stats[(int)stats::Index::Y].insert(y);
-        b->stats[(int)stats::Index::Z].insert(z);
-        b->stats[(int)stats::Index::GpsTime].insert(t);
-        b->stats[(int)stats::Index::ReturnNumber].insert(r);
+        updateStats(p, x, y, z);
 
         VoxelKey key = grid.key(x, y, z);
         PointViewPtr& cell = mgr.get(key);
@@ -402,12 +425,79 @@ void CopcWriter::write(const PointViewPtr v)
     }
     mgr.merge(reprocessMgr);
 
+    setupOutput(grid, v->spatialReference());
+    BuPyramid bu(*b);
+    bu.run(mgr);
+}
+
+// Stream mode. The points are passed to the cell files as they arrive.
+bool CopcWriter::processOne(PointRef& point)
+{
+    using namespace copcwriter;
+
+    if (!spill)
+    {
+        spill.reset(new CellFiles(*b));
+        spillBuf.resize(b->spillPointSize);
+    }
+
+    double x = point.getFieldAs<double>(Dimension::Id::X);
+    double y = point.getFieldAs<double>(Dimension::Id::Y);
+    double z = point.getFieldAs<double>(Dimension::Id::Z);
+    updateStats(point, x, y, z);
+    streamBounds.grow(x, y, z);
+
+    point.getPackedData(b->spillDims, spillBuf.data());
+    spill->add(spillBuf.data());
+    return true;
+}
+
+void CopcWriter::spatialReferenceChanged(const SpatialReference& srs)
+{
+    streamSrs = srs;
+}
+
+// Stream mode. Once the bounds are known, the cells become the voxels of the grid.
+// Cells with too many points are split, as in standard mode, and the octree is built
+// from the cell files.
+void CopcWriter::writeStreamed()
+{
+    using namespace copcwriter;
+
+    Grid grid = spill->finish(streamBounds);
+    for (const VoxelKey& key : spill->largeCells(MaxPointsPerNode))
+    {
+        OctantInfo cell = spill->release(key);
+        Grid cellGrid(grid);
+        cellGrid.resetLevel(grid.maxLevel() + Reprocessor::levels(cell.numPoints()));
+        spill->distribute(cell, cellGrid);
+    }
+
+    setupOutput(grid, streamSrs);
+    BuPyramid bu(*b);
+    bu.run(spill->releaseAll());
+    spill.reset();
+}
+
+void CopcWriter::updateStats(PointRef& point, double x, double y, double z)
+{
+    double t = point.getFieldAs<double>(Dimension::Id::GpsTime);
+    double r = point.getFieldAs<double>(Dimension::Id::ReturnNumber);
+    b->stats[(int)stats::Index::X].insert(x);
+    b->stats[(int)stats::Index::Y].insert(y);
+    b->stats[(int)stats::Index::Z].insert(z);
+    b->stats[(int)stats::Index::GpsTime].insert(t);
+    b->stats[(int)stats::Index::ReturnNumber].insert(r);
+}
+
+void CopcWriter::setupOutput(copcwriter::Grid& grid, const SpatialReference& srs)
+{
     b->bounds = grid.processingBounds();
     b->trueBounds = grid.conformingBounds();
     if (!b->opts.aSrs.empty())
        b->srs = b->opts.aSrs;
     else
-       b->srs = v->spatialReference();
+       b->srs = srs;
 
     if (b->opts.enhancedSrsVlrs) {
         auto addVlr = [&](const std::string& userId, uint16_t recordId, const std::string& desc,
@@ -453,12 +543,26 @@ void CopcWriter::write(const PointViewPtr v)
         b->scaling.m_zXform.m_offset = XForm::XFormComponent(t[2]);
 
     b->filename = filename();
+}
+
+// Write a file without points when none arrived in either mode.
+void CopcWriter::writeEmpty(const SpatialReference& srs)
+{
+    using namespace copcwriter;
+
+    Grid grid(BOX3D(0, 0, 0, 0, 0, 0), 0);
+    setupOutput(grid, srs);
     BuPyramid bu(*b);
-    bu.run(mgr);
+    bu.run(std::vector<OctantInfo>());
 }
 
 void CopcWriter::done(PointTableRef table)
 {
+    if (spill)
+        writeStreamed();
+    else if (b->viewCount == 0)
+        writeEmpty(streamSrs);
+
     if (isRemote)
     {
         arbiter::Arbiter a;
@@ -34,6 +34,7 @@
 
 #pragma once
 
+#include <pdal/Streamable.hpp>
 #include <pdal/Writer.hpp>
 
 namespace pdal
@@ -41,9 +42,11 @@ namespace pdal
 namespace copcwriter
 {
     struct BaseInfo;
+    class CellFiles;
+    class Grid;
 }
 
-class PDAL_EXPORT CopcWriter : public Writer
+class PDAL_EXPORT CopcWriter : public Writer, public Streamable
 {
 public:
     CopcWriter();
@@ -56,6 +59,8 @@ private:
     virtual void prepared(PointTableRef table) override;
     virtual void ready(PointTableRef table) override;
     virtual void write(const PointViewPtr view) override;
+    virtual bool processOne(PointRef& point) override;
+    virtual void spatialReferenceChanged(const SpatialReference& srs) override;
     virtual void done(PointTableRef table) override;
 
     void fillForwardList();
@@ -65,10 +70,20 @@ private:
     void handleForwardVlrs(MetadataNode& forward);
     void handleUserVlrs(MetadataNode m);
     void handlePipelineVlr();
+    void updateStats(PointRef& point, double x, double y, double z);
+    void setupOutput(copcwriter::Grid& grid, const SpatialReference& srs);
+    void writeStreamed();
+    void writeEmpty(const SpatialReference& srs);
 
     std::unique_ptr<copcwriter::BaseInfo> b;
     bool isRemote;
     std::string remoteFilename;
+
+    // Stream mode.
+    std::unique_ptr<copcwriter::CellFiles> spill;
+    std::vector<char> spillBuf;
+    BOX3D streamBounds;
+    SpatialReference streamSrs;
 };
 
 } // namespace pdal
@@ -160,6 +160,9 @@ public:
     NL::json m_addons;
     OGRSpec m_ogr;
     bool m_ignoreUnreadable = false;
+    std::string m_cacheDir;
+    uint64_t m_cacheSize = 0;
+    bool m_cacheValidate = true;
 };
 
 struct EptReader::Private
@@ -212,6 +215,12 @@ void EptReader::addArgs(ProgramArgs& args)
     args.add("ogr", "OGR filter geometries", m_args->m_ogr);
     args.add("ignore_unreadable", "Ignore errors for missing point data nodes",
         m_args->m_ignoreUnreadable);
+    args.add("cache_dir", "Directory in which to cache fetched data",
+        m_args->m_cacheDir);
+    args.add("cache_size", "Maximum size of the cache in megabytes",
+        m_args->m_cacheSize, (uint64_t)1024);
+    args.add("cache_validate", "Check that cached data is current once per "
+        "run", m_args->m_cacheValidate, true);
 }
 
 
@@ -225,7 +234,21 @@ void EptReader::initialize()
             threads << " threads" << std::endl;
     m_p->pool.reset(new ThreadPool(threads));
 
+    if (m_args->m_cacheSize < 1)
+        throwError("Option 'cache_size' must be at least 1.");
     m_p->connector.reset(new connector::Connector(m_filespec));
+    if (m_args->m_cacheDir.size())
+    {
+        try
+        {
+            m_p->connector->setCache(m_args->m_cacheDir,
+                m_args->m_cacheSize * 1024 * 1024, m_args->m_cacheValidate);
+        }
+        catch (const pdal_error& err)
+        {
+            throwError(err.what());
+        }
+    }
 
     try
     {
@@ -944,6 +967,11 @@ void EptReader::process(PointViewPtr dstView, const ept::TileContents& tile,
 void EptReader::done(PointTableRef)
 {
     m_p->pool->await();
+    if (m_args->m_cacheDir.size())
+        log()->get(LogLevel::Debug) << "Read " <<
+            m_p->connector->cacheHits() << " of " <<
+            m_p->connector->cacheRequests() <<
+            " cacheable requests from the cache." << std::endl;
     m_p->connector.reset();
 }
 
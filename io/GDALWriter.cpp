@@ -103,6 +103,8 @@ void GDALWriter::addArgs(ProgramArgs& args)
         m_binMode, false);
     args.add("allow_empty", "Allow writing GDAL output that do not have any pixel values (no points)",
         m_allowEmpty, false);
+    args.add("threads", "Number of threads used to compute the grid",
+        m_threads, 1);
 }
 
 
@@ -139,6 +141,9 @@ void GDALWriter::initialize()
     if (!m_radiusArg->set())
         m_radius = m_edgeLength * sqrt(2.0);
 
+    if (m_threads < 1)
+        throwError("Option 'threads' must be at least 1.");
+
     int args = 0;
     if (m_xOriginArg->set())
         args |= 1;
@@ -252,7 +257,48 @@ void GDALWriter::writeView(const PointViewPtr view)
         }
     }
 
+    // Use direct access to the dimension values when it's available.
+    auto xs = view->column<const double>(Dimension::Id::X);
+    auto ys = view->column<const double>(Dimension::Id::Y);
+    auto zs = view->column<const double>(m_interpDim);
+    if (m_grid && xs.size() && ys.size() && zs.size())
+    {
+        if (m_threads > 1)
+        {
+            std::vector<std::array<double, 3>> points;
+            points.reserve(view->size());
+            for (size_t span = 0; span < xs.size(); ++span)
+                for (point_count_t i = 0; i < xs[span].size; ++i)
+                    points.push_back({ xs[span].data[i], ys[span].data[i],
+                        zs[span].data[i] });
+            m_grid->addPoints(points, m_threads);
+        }
+        else
+        {
+            for (size_t span = 0; span < xs.size(); ++span)
+                for (point_count_t i = 0; i < xs[span].size; ++i)
+                    m_grid->addPoint(xs[span].data[i], ys[span].data[i],
+                        zs[span].data[i]);
+        }
+        return;
+    }
+
     PointRef point(*view, 0);
+    if (m_threads > 1 && m_grid)
+    {
+        std::vector<std::array<double, 3>> points;
+        points.reserve(view->size());
+        for (PointId idx = 0; idx < view->size(); ++idx)
+        {
+            point.setPointId(idx);
+            points.push_back({ point.getFieldAs<double>(Dimension::Id::X),
+                point.getFieldAs<double>(Dimension::Id::Y),
+                point.getFieldAs<double>(m_interpDim) });
+        }
+        m_grid->addPoints(points, m_threads);
+        return;
+    }
+
     for (PointId idx = 0; idx < view->size(); ++idx)
     {
         point.setPointId(idx);
@@ -296,7 +342,7 @@ void GDALWriter::doneFile()
     pixelToPos[5] = -m_edgeLength;
     gdal::Raster raster(m_outputFilename, m_drivername, m_srs, pixelToPos);
 
-    m_grid->finalize();
+    m_grid->finalize(m_threads);
 
     gdal::GDALError err = raster.open(m_grid->width(), m_grid->height(),
         m_grid->numBands(), m_dataType, m_noData, m_options);
@@ -305,27 +351,12 @@ void GDALWriter::doneFile()
         throwError(raster.errorMsg());
     int bandNum = 1;
 
-    // Perhaps the grid should return an iterator, which would work as well.
-    double *src;
-    src = m_grid->data("min");
+    // Bands are read from the grid's tiles as GDAL writes each block, so
+    // no full-size copy of a band is made.
     double srcNoData = std::numeric_limits<double>::quiet_NaN();
-    if (src && err == gdal::GDALError::None)
-        err = raster.writeBand(src, srcNoData, bandNum++, "min");
-    src = m_grid->data("max");
-    if (src && err == gdal::GDALError::None)
-        err = raster.writeBand(src, srcNoData, bandNum++, "max");
-    src = m_grid->data("mean");
-    if (src && err == gdal::GDALError::None)
-        err = raster.writeBand(src, srcNoData, bandNum++, "mean");
-    src = m_grid->data("idw");
-    if (src && err == gdal::GDALError::None)
-        err = raster.writeBand(src, srcNoData, bandNum++, "idw");
-    src = m_grid->data("count");
-    if (src && err == gdal::GDALError::None)
-        err = raster.writeBand(src, srcNoData, bandNum++, "count");
-    src = m_grid->data("stdev");
-    if (src && err == gdal::GDALError::None)
-        err = raster.writeBand(src, srcNoData, bandNum++, "stdev");
+    for (const std::string name : { "min", "max", "mean", "idw", "count", "stdev" })
+        if (m_grid->hasBand(name) && err == gdal::GDALError::None)
+            err = raster.writeBand(m_grid->band(name), srcNoData, bandNum++, name);
     if (err != gdal::GDALError::None)
         throwError(raster.errorMsg());
 
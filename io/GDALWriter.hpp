@@ -100,6 +100,7 @@ private:
     bool m_writePDALMetadata;
     bool m_binMode;
     bool m_allowEmpty;
+    int m_threads;
 };
 
 }
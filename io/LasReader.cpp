@@ -36,6 +36,7 @@
 #include "LasReader.hpp"
 #include "private/las/ChunkInfo.hpp"
 #include "private/las/Header.hpp"
+#include "private/las/Loader.hpp"
 #include "private/las/Srs.hpp"
 #include "private/las/Tile.hpp"
 #include "private/las/Utils.hpp"
@@ -142,6 +143,7 @@ struct LasReader::Options
     bool nosrs;
     int numThreads;
     SrsOrderSpec srsVlrOrder;
+    bool useMmap;
 };
 
 struct LasReader::Private
@@ -154,6 +156,7 @@ struct LasReader::Private
     las::VlrList vlrs;
     las::Srs srs;
     las::TilePtr currentTile;
+    std::unique_ptr<las::Loader> loader;
     las::ChunkInfo chunkInfo;
     std::vector<las::TilePtr> tiles;
     std::vector<las::ExtraDim> extraDims;
@@ -172,6 +175,8 @@ struct LasReader::Private
     std::condition_variable processedCv;
     bool isRemote;
     std::unique_ptr<connector::Connector> connector;
+    // Mapping of the file when point data is read from memory.
+    FileUtils::MapContext map;
 
     Private() : apiHeader(header, srs, vlrs), index(0), pool(DefaultNumThreads), isRemote(false)
     {}
@@ -198,6 +203,8 @@ void LasReader::addArgs(ProgramArgs& args)
     args.add("threads", "Thread pool size", d->opts.numThreads, DefaultNumThreads);
     args.add("srs_vlr_order", "Preference order to read SRS VLRs",
         d->opts.srsVlrOrder);
+    args.add("use_mmap", "Read point data from a memory mapping of the file",
+        d->opts.useMmap);
 }
 
 
@@ -467,12 +474,37 @@ void LasReader::ready(PointTableRef table)
         return;
 
     d->pool.resize(d->opts.numThreads);
+    d->loader.reset(new las::Loader(d->header, *table.layout()));
     LasStreamPtr lasStream(createStream());
     std::istream& stream(*lasStream);
 
     d->currentTile.reset();
     d->tiles.clear();
 
+    if (d->map.addr())
+        d->map = FileUtils::unmapFile(d->map);
+    if (d->opts.useMmap)
+    {
+        if (lasStream->filename().empty())
+            log()->get(LogLevel::Debug) << "Can't map embedded LAS data. "
+                "Reading from stream.\n";
+        else
+        {
+            d->map = FileUtils::mapFile(lasStream->filename());
+            if (d->map.addr())
+            {
+                FileUtils::adviseMap(d->map, FileUtils::MapAdvice::Sequential,
+                    d->header.pointOffset);
+                log()->get(LogLevel::Debug) << "Reading point data from a "
+                    "mapping of '" << lasStream->filename() << "'.\n";
+            }
+            else
+                log()->get(LogLevel::Warning) << "Unable to map '" <<
+                    m_filename << "': " << d->map.what() <<
+                    " Reading from stream.\n";
+        }
+    }
+
     d->index = 0;
     if (d->header.dataCompressed())
     {
@@ -522,24 +554,38 @@ void LasReader::queueNextCompressedChunk()
     uint32_t chunk = d->nextFetchChunk;
     uint32_t start = (uint32_t)d->nextFetchPoint;
 
+    if (d->map.addr())
+        FileUtils::adviseMap(d->map, FileUtils::MapAdvice::WillNeed,
+            d->chunkInfo.chunkOffset(chunk), d->chunkInfo.chunkSize(chunk));
+
     d->pool.add([this, chunk, start]()
     {
         uint32_t chunkpoints = d->chunkInfo.chunkPoints(chunk);
         uint64_t chunkoffset = d->chunkInfo.chunkOffset(chunk);
         uint32_t chunksize = d->chunkInfo.chunkSize(chunk);
 
-        LasStreamPtr lasStream = createStream();
-        std::istream& in(*lasStream);
+        // Decompress directly from the mapped file if we can, otherwise
+        // read the chunk into a buffer.
+        const char *data;
+        std::vector<char> buf;
+        if (d->map.addr() && chunkoffset + chunksize <= d->map.m_size)
+            data = (const char *)d->map.addr() + chunkoffset;
+        else
+        {
+            LasStreamPtr lasStream = createStream();
+            std::istream& in(*lasStream);
 
-        std::vector<char> buf(chunksize);
-        in.seekg(chunkoffset);
-        in.read(buf.data(), buf.size());
+            buf.resize(chunksize);
+            in.seekg(chunkoffset);
+            in.read(buf.data(), buf.size());
+            data = buf.data();
+        }
 
         int32_t tilepoints = chunkpoints - start;
         las::TilePtr tile = std::make_unique<las::Tile>(chunk, tilepoints * d->header.pointSize);
 
         lazperf::reader::chunk_decompressor decomp(d->header.pointFormat(), d->header.ebCount(),
-            buf.data());
+            data);
 
         // We have to decompress all the points, even if we're discarding the points at
         // the front because nextFetchPoint isn't 0. Just reuse the front of the tile
@@ -581,14 +627,28 @@ void LasReader::queueNextStandardChunk()
     int chunk = d->nextFetchChunk;
     uint64_t start = d->nextFetchPoint;
     uint64_t count = (std::min)(chunkSize, d->end - start);
-    d->pool.add([this, chunk, count, start]()
+    uint64_t offset = d->header.pointOffset + start * d->header.pointSize;
+    uint64_t size = count * d->header.pointSize;
+
+    if (d->map.addr())
+        FileUtils::adviseMap(d->map, FileUtils::MapAdvice::WillNeed, offset, size);
+
+    d->pool.add([this, chunk, offset, size]()
     {
-        LasStreamPtr lasStream = createStream();
-        std::istream& in(*lasStream);
+        // When the file is mapped, the tile just refers to the point data in the mapping.
+        las::TilePtr tile;
+        if (d->map.addr() && offset + size <= d->map.m_size)
+            tile = std::make_unique<las::Tile>(chunk, (const char *)d->map.addr() + offset,
+                size);
+        else
+        {
+            LasStreamPtr lasStream = createStream();
+            std::istream& in(*lasStream);
 
-        las::TilePtr tile = std::make_unique<las::Tile>(chunk, count * d->header.pointSize);
-        in.seekg(d->header.pointOffset + start * d->header.pointSize);
-        in.read(tile->data(), tile->size());
+            tile = std::make_unique<las::Tile>(chunk, size);
+            in.seekg(offset);
+            in.read(tile->data(), tile->size());
+        }
 
         {
             std::unique_lock l(d->mutex);
@@ -683,7 +743,8 @@ void LasReader::addDimensions(PointLayoutPtr layout)
 }
 
 
-bool LasReader::processOne(PointRef& point)
+// Make sure there's a current tile, waiting for the next one if necessary.
+void LasReader::nextTile()
 {
     // This is called under lock. Note that we don't remove the tile *pointer* from the
     // vector, it just gets set to null. When we add a tile, we'll look for a null
@@ -696,28 +757,34 @@ bool LasReader::processOne(PointRef& point)
         return las::TilePtr();
     };
 
-    if (eof())
-        return false;
+    if (d->currentTile)
+        return;
 
-    // If we don't have an active tile, get the next one or wait for it to be ready.
-    if (!d->currentTile)
     {
+        std::unique_lock<std::mutex> l(d->mutex);
+        while (true)
         {
-            std::unique_lock<std::mutex> l(d->mutex);
-            while (true)
-            {
-                d->currentTile = getTile(d->nextReadChunk);
-                if (d->currentTile)
-                    break;
-                d->processedCv.wait(l);
-            }
+            d->currentTile = getTile(d->nextReadChunk);
+            if (d->currentTile)
+                break;
+            d->processedCv.wait(l);
         }
-
-        // Found the tile we wanted. Queue the next file read.
-        d->nextReadChunk++;
-        d->queueNext();
     }
 
+    // Found the tile we wanted. Queue the next file read.
+    d->nextReadChunk++;
+    d->queueNext();
+}
+
+
+bool LasReader::processOne(PointRef& point)
+{
+    if (eof())
+        return false;
+
+    // If we don't have an active tile, get the next one or wait for it to be ready.
+    nextTile();
+
     // Load the point and advance the tile location.
     d->loadPoint(point, d->currentTile->pos(), d->header.pointSize);
     if (!d->currentTile->advance(d->header.pointSize))
@@ -727,17 +794,61 @@ bool LasReader::processOne(PointRef& point)
     return true;
 }
 
+// Points are loaded a tile at a time. When the point table stores points as rows
+// or dimensions as columns, the standard fields are loaded directly into the
+// table by the loader.
 point_count_t LasReader::read(PointViewPtr view, point_count_t count)
 {
     count = (std::min)(count, getNumPoints() - (point_count_t)d->index);
 
+    const int pointSize = d->header.pointSize;
+    std::vector<char *> rows;
     PointId i = 0;
-    for (i = 0; i < count; i++)
+    while (i < count)
     {
-        PointRef point = view->point(i);
-        processOne(point);
+        nextTile();
+        const char *pos = d->currentTile->pos();
+        point_count_t n = (std::min)(count - i,
+            (point_count_t)(d->currentTile->remaining() / pointSize));
+
+        rows.resize(n);
+        for (point_count_t k = 0; k < n; ++k)
+            rows[k] = view->getOrAddPoint(i + k);
+
+        bool loaded = true;
+        if (rows.front())
+            d->loader->load(pos, n, rows.data());
+        else
+            loaded = d->loader->load(pos, n, *view, i);
+
+        if (loaded)
+        {
+            if (d->extraDims.size())
+                for (point_count_t k = 0; k < n; ++k)
+                {
+                    PointRef point = view->point(i + k);
+                    LeExtractor istream(pos + k * pointSize + d->header.baseCount(),
+                        d->header.ebCount());
+                    loadExtraDims(istream, point);
+                }
+        }
+        else
+        {
+            for (point_count_t k = 0; k < n; ++k)
+            {
+                PointRef point = view->point(i + k);
+                d->loadPoint(point, pos + k * pointSize, pointSize);
+            }
+        }
+
+        if (!d->currentTile->advance((int)(n * pointSize)))
+            d->currentTile.reset();
+        d->index += n;
+
         if (m_cb)
-            m_cb(*view, view->size() - 1);
+            for (point_count_t k = 0; k < n; ++k)
+                m_cb(*view, i + k);
+        i += n;
     }
     return (point_count_t)i;
 }
@@ -933,6 +1044,13 @@ void LasReader::done(PointTableRef)
 void LasReader::cleanup()
 {
     d->pool.join();
+    if (d->map.addr())
+    {
+        // Tiles may refer to the mapping.
+        d->currentTile.reset();
+        d->tiles.clear();
+        d->map = FileUtils::unmapFile(d->map);
+    }
     if (d->isRemote)
         FileUtils::deleteFile(m_filename);
 }
@@ -70,7 +70,7 @@ protected:
         {}
 
     public:
-        LasStreamIf(const std::string& filename)
+        LasStreamIf(const std::string& filename) : m_filename(filename)
             { m_istream = FileUtils::openFile(filename); }
 
         virtual ~LasStreamIf()
@@ -87,8 +87,14 @@ protected:
             return m_istream && m_istream->good();
         }
 
+        // Name of the file when the stream reads a plain LAS/LAZ file, or
+        // empty when the data is embedded in some other file.
+        const std::string& filename() const
+        { return m_filename; }
+
     protected:
         std::istream *m_istream;
+        std::string m_filename;
     };
     using LasStreamPtr = std::unique_ptr<LasStreamIf>;
 
@@ -132,6 +138,7 @@ private:
     bool eof();
     void queueNextCompressedChunk();
     void queueNextStandardChunk();
+    void nextTile();
 
     const las::Header& lasHeader() const;
     
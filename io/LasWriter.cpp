@@ -99,6 +99,7 @@ struct LasWriter::Options
     StringHeaderVal<0> offsetZ;
     std::vector<las::Evlr> userVlrs;
     bool enhancedSrsVlrs;
+    int threads;
 };
 
 struct LasWriter::Private
@@ -175,10 +176,15 @@ void LasWriter::addArgs(ProgramArgs& args)
     args.add("vlrs", "List of VLRs to set", d->opts.userVlrs);
     args.add("enhanced_srs_vlrs", "Write WKT2 and PROJJSON as VLR?", d->opts.enhancedSrsVlrs,
         decltype(d->opts.enhancedSrsVlrs)(false));
+    args.add("threads", "Number of threads used to compress LAZ output",
+        d->opts.threads, 1);
 }
 
 void LasWriter::initialize()
 {
+    if (d->opts.threads < 1)
+        throwError("Option 'threads' must be at least 1.");
+
     std::string ext = FileUtils::extension(filename());
     ext = Utils::tolower(ext);
     if (ext == ".laz")
@@ -757,7 +763,8 @@ void LasWriter::readyCompression()
 {
     deleteVlr(las::LaszipUserId, las::LaszipRecordId);
     m_compressor = new LazPerfVlrCompressor(*m_ostream, d->header.pointFormat(),
-        d->header.ebCount());
+        d->header.ebCount(), LazPerfVlrCompressor::DefaultChunkSize,
+        d->opts.threads);
     std::vector<char> lazVlrData = m_compressor->vlrData();
     std::vector<char> vlrdata(lazVlrData.begin(), lazVlrData.end());
     addVlr(las::LaszipUserId, las::LaszipRecordId, "http://laszip.org", vlrdata);
@@ -38,23 +38,30 @@
 #include <cmath>
 #include <limits>
 #include <iostream>
+#include <set>
 #include <pdal/pdal_types.hpp>
+#include <pdal/private/Parallel.hpp>
 
 namespace pdal
 {
 
-//ABELL - In the beginning this data needed to be contiguous, as it was passed
-//  directly to GDAL to write.  Since we started supporting various data types
-//  in GDAL output, we end up copying/casting data to a block for output,
-//  so there's no reason that we must have contiguous data -- we just need
-//  an iterator that allows traversal of the data in row-major order.  So,
-//  this should probably be re-implemented in some way that doesn't require
-//  moving data around every time the grid is resized.
+namespace
+{
+
+// Index of the tile holding the cell at a tile-frame index.
+int64_t tileIndex(int64_t a)
+{
+    return a >= 0 ? a / GDALGrid::TileSize :
+        -((-a + GDALGrid::TileSize - 1) / GDALGrid::TileSize);
+}
+
+} // unnamed namespace
 
 GDALGrid::GDALGrid(double xOrigin, double yOrigin, size_t width, size_t height, double edgeLength,
         double radius, int outputTypes, size_t windowSize, double power, bool binMode) :
-    m_windowSize(windowSize), m_edgeLength(edgeLength), m_radius(radius), m_power(power),
-    m_outputTypes(outputTypes), m_binMode(binMode)
+    m_iBase(0), m_jBase(0), m_windowSize(windowSize), m_edgeLength(edgeLength),
+    m_radius(radius), m_power(power),
+    m_outputTypes(outputTypes), m_binMode(binMode), m_filling(false)
 {
     if (width > (size_t)(std::numeric_limits<int>::max)() ||
         height > (size_t)(std::numeric_limits<int>::max)())
@@ -65,80 +72,218 @@ GDALGrid::GDALGrid(double xOrigin, double yOrigin, size_t width, size_t height,
             "Try setting bounds or increasing resolution.";
         throw error(oss.str());
     }
-    RasterLimits limits(xOrigin, yOrigin, width, height, edgeLength);
-
-    m_count.reset(new Rasterd(limits));
-    if (m_outputTypes & statMin)
-        m_min.reset(new Rasterd(limits, (std::numeric_limits<double>::max)()));
-    if (m_outputTypes & statMax)
-        m_max.reset(new Rasterd(limits, std::numeric_limits<double>::lowest()));
-    if (m_outputTypes & statIdw)
-    {
-        m_idw.reset(new Rasterd(limits));
-        m_idwDist.reset(new Rasterd(limits));
-    }
-    if ((m_outputTypes & statMean) || (m_outputTypes & statStdDev))
-        m_mean.reset(new Rasterd(limits));
-    if (m_outputTypes & statStdDev)
-        m_stdDev.reset(new Rasterd(limits));
+    m_limits = RasterLimits(xOrigin, yOrigin, (int)width, (int)height,
+        edgeLength);
 }
 
 int GDALGrid::width() const
 {
-    return m_count->width();
+    return m_limits.width;
 }
 
 int GDALGrid::height() const
 {
-    return m_count->height();
+    return m_limits.height;
 }
 
 double GDALGrid::xOrigin() const
 {
-    return m_count->xOrigin();
+    return m_limits.xOrigin;
 }
 
 double GDALGrid::yOrigin() const
 {
-    return m_count->yOrigin();
+    return m_limits.yOrigin;
+}
+
+size_t GDALGrid::tileCount() const
+{
+    return m_tiles.size();
+}
+
+uint64_t GDALGrid::tileKey(int64_t ti, int64_t tj)
+{
+    return ((uint64_t)(uint32_t)ti << 32) | (uint32_t)tj;
+}
+
+GDALGrid::Slot GDALGrid::findSlot(int i, int j, Access& a) const
+{
+    int64_t ii = i - m_iBase;
+    int64_t jj = j - m_jBase;
+    int64_t ti = tileIndex(ii);
+    int64_t tj = tileIndex(jj);
+    size_t pos =
+        (size_t)((jj - tj * TileSize) * TileSize + (ii - ti * TileSize));
+
+    uint64_t key = tileKey(ti, tj);
+    if (a.lastTile && key == a.lastKey)
+        return { a.lastTile, pos };
+
+    // The grid's tiles are only read here, so threads with their own
+    // 'added' map can look them up concurrently.
+    Tile *tile = nullptr;
+    if (a.added)
+    {
+        auto it = a.added->find(key);
+        if (it != a.added->end())
+            tile = it->second.get();
+    }
+    if (!tile)
+    {
+        auto it = m_tiles.find(key);
+        if (it == m_tiles.end())
+            return { nullptr, pos };
+        tile = it->second.get();
+    }
+    a.lastKey = key;
+    a.lastTile = tile;
+    return { tile, pos };
+}
+
+GDALGrid::Slot GDALGrid::slot(int i, int j, Access& a)
+{
+    Slot s = findSlot(i, j, a);
+    if (!s.tile)
+        s.tile = allocTile(tileKey(tileIndex(i - m_iBase),
+            tileIndex(j - m_jBase)), a);
+    return s;
+}
+
+GDALGrid::Tile *GDALGrid::allocTile(uint64_t key, Access& a)
+{
+    const size_t size = TileSize * TileSize;
+    // Tiles allocated when filling empty cells have no data to accumulate.
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+
+    TilePtr& tile = a.added ? (*a.added)[key] : m_tiles[key];
+    tile.reset(new Tile);
+    tile->count.resize(size, 0);
+    if (has(statMin))
+        tile->min.resize(size,
+            m_filling ? nan : (std::numeric_limits<double>::max)());
+    if (has(statMax))
+        tile->max.resize(size,
+            m_filling ? nan : std::numeric_limits<double>::lowest());
+    if (hasMean())
+        tile->mean.resize(size, m_filling ? nan : 0);
+    if (has(statStdDev))
+        tile->stdDev.resize(size, m_filling ? nan : 0);
+    if (has(statIdw))
+    {
+        tile->idw.resize(size, m_filling ? nan : 0);
+        tile->idwDist.resize(size, 0);
+    }
+
+    a.lastKey = key;
+    a.lastTile = tile.get();
+    return a.lastTile;
+}
+
+template<typename F>
+void GDALGrid::parallel(size_t count, int threads, F f)
+{
+    // Each task puts the tiles it allocates in its own map.
+    std::vector<TileMap> added(count);
+    parallelFor(count, threads, [&added, &f](size_t begin, size_t end)
+    {
+        for (size_t task = begin; task < end; ++task)
+        {
+            Access a;
+            a.added = &added[task];
+            f(task, a);
+        }
+    }, 1);
+
+    for (TileMap& tiles : added)
+        for (auto& t : tiles)
+            m_tiles[t.first] = std::move(t.second);
+}
+
+bool GDALGrid::empty(int i, int j, Access& a) const
+{
+    Slot s = findSlot(i, j, a);
+    return !s.tile || s.tile->count[s.pos] <= 0;
 }
 
 double GDALGrid::distance(int i, int j, double x, double y) const
 {
-    double x1 = m_count->xCellPos(i);
-    double y1 = m_count->yCellPos(j);
+    double x1 = m_limits.xOrigin + (i + .5) * m_edgeLength;
+    double y1 = m_limits.yOrigin + (j + .5) * m_edgeLength;
     return std::sqrt(std::pow(x1 - x, 2) + std::pow(y1 - y, 2));
 }
 
-void GDALGrid::windowFill()
+void GDALGrid::windowFill(int threads)
 {
-    for (int i = 0; i < width(); ++i)
-        for (int j = 0; j < height(); ++j)
-            if (empty(i, j))
-                windowFill(i, j);
+    // Only cells within the window of a cell with data can be filled, so
+    // only tiles near allocated tiles need to be visited.
+    const int64_t reach = (m_windowSize + TileSize - 1) / TileSize;
+    std::set<std::pair<int64_t, int64_t>> candidates;
+    for (auto& t : m_tiles)
+    {
+        int64_t ti = (int32_t)(t.first >> 32);
+        int64_t tj = (int32_t)(t.first & 0xFFFFFFFF);
+        for (int64_t di = -reach; di <= reach; ++di)
+            for (int64_t dj = -reach; dj <= reach; ++dj)
+                candidates.insert({ ti + di, tj + dj });
+    }
+
+    // Each candidate tile is filled by one task.  Filled cells are only
+    // written to their own tile and values are only read from cells with
+    // data, so tasks don't depend on each other.
+    std::vector<std::pair<int64_t, int64_t>> tiles(candidates.begin(),
+        candidates.end());
+    m_filling = true;
+    parallel(tiles.size(), threads, [this, &tiles](size_t task, Access& a)
+    {
+        const auto& c = tiles[task];
+        int64_t iStart = c.first * TileSize + m_iBase;
+        int64_t jStart = c.second * TileSize + m_jBase;
+        int64_t iEnd = (std::min)(iStart + TileSize, (int64_t)width());
+        int64_t jEnd = (std::min)(jStart + TileSize, (int64_t)height());
+        for (int64_t i = (std::max)(iStart, (int64_t)0); i < iEnd; ++i)
+            for (int64_t j = (std::max)(jStart, (int64_t)0); j < jEnd; ++j)
+                if (empty((int)i, (int)j, a))
+                    windowFill((int)i, (int)j, a);
+    });
+    m_filling = false;
 }
 
 /**
-  Expand the grid to a new size.
+  Expand the grid to a new size.  Cell data isn't moved, only the offsets
+  of grid cells into the tile storage are updated.
 
   /param width
 */
 void GDALGrid::expandToInclude(double x, double y)
 {
-    m_count->expandToInclude(x, y);
-    if (m_outputTypes & statMin)
-        m_min->expandToInclude(x, y);
-    if (m_outputTypes & statMax)
-        m_max->expandToInclude(x, y);
-    if (m_outputTypes & statIdw)
-    {
-        m_idw->expandToInclude(x, y);
-        m_idwDist->expandToInclude(x, y);
-    }
-    if ((m_outputTypes & statMean) || (m_outputTypes & statStdDev))
-        m_mean->expandToInclude(x, y);
-    if (m_outputTypes & statStdDev)
-        m_stdDev->expandToInclude(x, y);
+    double xc = std::floor((x - m_limits.xOrigin) / m_edgeLength);
+    double yc = std::floor((y - m_limits.yOrigin) / m_edgeLength);
+    if (xc < std::numeric_limits<int>::lowest() ||
+        xc + 1 > (std::numeric_limits<int>::max)() ||
+        yc < std::numeric_limits<int>::lowest() ||
+        yc + 1 > (std::numeric_limits<int>::max)())
+        return;
+
+    int xi = static_cast<int>(xc);
+    int yi = static_cast<int>(yc);
+    if (xi >= 0 && yi >= 0 && xi < width() && yi < height())
+        return;
+
+    int64_t xshift = (std::max)(-xi, 0);
+    int64_t yshift = (std::max)(-yi, 0);
+    int64_t w = (std::max)(width(), xi + 1) + xshift;
+    int64_t h = (std::max)(height(), yi + 1) + yshift;
+
+    if (w > (std::numeric_limits<int>::max)() ||
+        h > (std::numeric_limits<int>::max)())
+        return;
+
+    m_limits.xOrigin -= xshift * m_edgeLength;
+    m_limits.yOrigin -= yshift * m_edgeLength;
+    m_limits.width = static_cast<int>(w);
+    m_limits.height = static_cast<int>(h);
+    m_iBase += xshift;
+    m_jBase += yshift;
 }
 
 
@@ -162,38 +307,127 @@ int GDALGrid::numBands() const
 }
 
 
-double *GDALGrid::data(const std::string& name)
+bool GDALGrid::hasBand(const std::string& name) const
 {
-    if (name == "count" && (m_outputTypes & statCount))
-        return m_count->data();
-    if (name == "min" && (m_outputTypes & statMin))
-        return m_min->data();
-    if (name == "max" && (m_outputTypes & statMax))
-        return m_max->data();
-    if (name == "mean" && (m_outputTypes & statMean))
-        return m_mean->data();
-    if (name == "idw" && (m_outputTypes & statIdw))
-         return m_idw->data();
-    if (name == "stdev" && (m_outputTypes & statStdDev))
-        return m_stdDev->data();
-    return nullptr;
+    return (name == "count" && (m_outputTypes & statCount)) ||
+        (name == "min" && (m_outputTypes & statMin)) ||
+        (name == "max" && (m_outputTypes & statMax)) ||
+        (name == "mean" && (m_outputTypes & statMean)) ||
+        (name == "idw" && (m_outputTypes & statIdw)) ||
+        (name == "stdev" && (m_outputTypes & statStdDev));
 }
 
-GDALGrid::Cell GDALGrid::pointToCell(const Point& p)
+
+GDALGrid::BandIterator GDALGrid::band(const std::string& name) const
 {
-    bool okX, okY;
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+
+    if (!hasBand(name))
+        throw error("Grid has no band '" + name + "'.");
+    if (name == "count")
+        return BandIterator(this, &Tile::count, 0);
+    if (name == "min")
+        return BandIterator(this, &Tile::min, nan);
+    if (name == "max")
+        return BandIterator(this, &Tile::max, nan);
+    if (name == "mean")
+        return BandIterator(this, &Tile::mean, nan);
+    if (name == "idw")
+        return BandIterator(this, &Tile::idw, nan);
+    return BandIterator(this, &Tile::stdDev, nan);
+}
 
-    Cell cell;
-    cell.i = m_count->xCell(p.x, okX);
-    cell.j = m_count->yCell(p.y, okY);
-    if (!okX)
+
+double GDALGrid::BandIterator::operator*() const
+{
+    const size_t w = (size_t)m_grid->width();
+    int i = (int)(m_idx % w);
+    int j = m_grid->height() - 1 - (int)(m_idx / w);
+    Slot s = m_grid->findSlot(i, j);
+    return s.tile ? (s.tile->*m_band)[s.pos] : m_empty;
+}
+
+
+GDALGrid::Cell GDALGrid::pointToCell(const Point& p)
+{
+    // We check cell + 1 for validity because we may make a grid with
+    // width/height one larger than the limit.
+    double i = std::floor((p.x - m_limits.xOrigin) / m_edgeLength);
+    double j = std::floor((p.y - m_limits.yOrigin) / m_edgeLength);
+    if (i < std::numeric_limits<int>::lowest() ||
+            i + 1 > (std::numeric_limits<int>::max)())
         throw error("Range of X coordinates exceeds limits.");
-    if (!okY)
+    if (j < std::numeric_limits<int>::lowest() ||
+            j + 1 > (std::numeric_limits<int>::max)())
         throw error("Range of Y coordinates exceeds limits.");
+
+    Cell cell;
+    cell.i = static_cast<int>(i);
+    cell.j = static_cast<int>(j);
     return cell;
 }
 
+
 void GDALGrid::addPoint(double x, double y, double z)
+{
+    m_access.jBegin = 0;
+    m_access.jEnd = height();
+    addPoint(x, y, z, m_access);
+}
+
+
+void GDALGrid::addPoints(const std::vector<std::array<double, 3>>& points,
+    int threads)
+{
+    if (threads <= 1)
+    {
+        for (const std::array<double, 3>& p : points)
+            addPoint(p[0], p[1], p[2]);
+        return;
+    }
+
+    // The grid is split into bands one tile high.  Each band is updated
+    // by a single task with the points that can reach its rows, in the
+    // order the points were provided, so cell values are the same as when
+    // points are added one at a time.  Bands don't share tiles, so tasks
+    // don't need to synchronize.
+    const int64_t bandFirst = tileIndex(-m_jBase);
+    const int64_t bandLast = tileIndex(height() - 1 - m_jBase);
+    const size_t bandCount = (size_t)(bandLast - bandFirst + 1);
+    const double reach = m_binMode ? 0 : m_radius;
+
+    std::vector<std::vector<size_t>> bands(bandCount);
+    for (size_t idx = 0; idx < points.size(); ++idx)
+    {
+        const double y = points[idx][1];
+        double lo = std::floor((y - reach - yOrigin()) / m_edgeLength);
+        double hi = std::floor((y + reach - yOrigin()) / m_edgeLength);
+        lo = (std::max)(lo, 0.0);
+        hi = (std::min)(hi, (double)(height() - 1));
+        if (!(lo <= hi))
+            continue;
+        int64_t b0 = tileIndex((int64_t)lo - m_jBase) - bandFirst;
+        int64_t b1 = tileIndex((int64_t)hi - m_jBase) - bandFirst;
+        for (int64_t b = b0; b <= b1; ++b)
+            bands[(size_t)b].push_back(idx);
+    }
+
+    parallel(bandCount, threads,
+        [this, &points, &bands, bandFirst](size_t band, Access& a)
+    {
+        int64_t jStart = (bandFirst + (int64_t)band) * TileSize + m_jBase;
+        a.jBegin = (int)(std::max)(jStart, (int64_t)0);
+        a.jEnd = (int)(std::min)(jStart + TileSize, (int64_t)height());
+        for (size_t idx : bands[band])
+        {
+            const std::array<double, 3>& p = points[idx];
+            addPoint(p[0], p[1], p[2], a);
+        }
+    });
+}
+
+
+void GDALGrid::addPoint(double x, double y, double z, Access& a)
 {
     // Here's the logic... we divide the cells around the subject cell
     // (at iOrigin, jOrigin) into four quadrants.  We move outward from the
@@ -228,10 +462,10 @@ void GDALGrid::addPoint(double x, double y, double z)
 
     if (!m_binMode)
     {
-        updateFirstQuadrant(x, y, z);
-        updateSecondQuadrant(x, y, z);
-        updateThirdQuadrant(x, y, z);
-        updateFourthQuadrant(x, y, z);
+        updateFirstQuadrant(x, y, z, a);
+        updateSecondQuadrant(x, y, z, a);
+        updateThirdQuadrant(x, y, z, a);
+        updateFourthQuadrant(x, y, z, a);
         d = distance(origin.i, origin.j, x, y);
     }
     else
@@ -240,13 +474,14 @@ void GDALGrid::addPoint(double x, double y, double z)
     // In non bin mode, this case is where a point lies in a cell.
     // In bin mode, this is the only case and distance is zero.
     if ((m_binMode || d < m_radius) &&
-        origin.i >= 0 && origin.j >= 0 &&
-        origin.i < width() && origin.j < height())
-        update(origin.i, origin.j, z, d);
+        origin.i >= 0 && origin.j >= a.jBegin &&
+        origin.i < width() && origin.j < a.jEnd)
+        update(origin.i, origin.j, z, d, a);
 }
 
 
-void GDALGrid::updateFirstQuadrant(double x, double y, double z)
+void GDALGrid::updateFirstQuadrant(double x, double y, double z,
+    Access& a)
 {
     int i, j;
     int iStart;
@@ -254,17 +489,17 @@ void GDALGrid::updateFirstQuadrant(double x, double y, double z)
     Cell origin = pointToCell({x, y});
 
     i = iStart = (std::max)(0, origin.i + 1);
-    j = (std::min)(origin.j, (height() - 1));
+    j = (std::min)(origin.j, (a.jEnd - 1));
 
     if (iStart >= width())
         return;
 
-    while (j >= 0)
+    while (j >= a.jBegin)
     {
         double d = distance(i, j, x, y);
         if (d < m_radius)
         {
-            update(i, j, z, d);
+            update(i, j, z, d, a);
             i++;
             if (i < width())
                 continue;
@@ -280,7 +515,8 @@ void GDALGrid::updateFirstQuadrant(double x, double y, double z)
 }
 
 
-void GDALGrid::updateSecondQuadrant(double x, double y, double z)
+void GDALGrid::updateSecondQuadrant(double x, double y, double z,
+    Access& a)
 {
     int i, j;
     int jStart;
@@ -288,9 +524,9 @@ void GDALGrid::updateSecondQuadrant(double x, double y, double z)
     Cell origin = pointToCell({x, y});
 
     i = (std::min)(origin.i, (width() - 1));
-    j = jStart = (std::min)(origin.j - 1, (height() - 1));
+    j = jStart = (std::min)(origin.j - 1, (a.jEnd - 1));
 
-    if (jStart < 0)
+    if (jStart < a.jBegin)
         return;
 
     while (i >= 0)
@@ -298,13 +534,13 @@ void GDALGrid::updateSecondQuadrant(double x, double y, double z)
         double d = distance(i, j, x, y);
         if (d < m_radius)
         {
-            update(i, j, z, d);
+            update(i, j, z, d, a);
             j--;
-            if (j >= 0)
+            if (j >= a.jBegin)
                 continue;
         }
 
-        // Either d >= m_radius or we've hit the end of a column (j < 0),
+        // Either d >= m_radius or we've hit the end of a column,
         // so move to the next column.
         if (j == jStart)
             break;
@@ -314,7 +550,8 @@ void GDALGrid::updateSecondQuadrant(double x, double y, double z)
 }
 
 
-void GDALGrid::updateThirdQuadrant(double x, double y, double z)
+void GDALGrid::updateThirdQuadrant(double x, double y, double z,
+    Access& a)
 {
     int i, j;
     int iStart;
@@ -322,17 +559,17 @@ void GDALGrid::updateThirdQuadrant(double x, double y, double z)
     Cell origin = pointToCell({x, y});
 
     i = iStart = (std::min)(origin.i - 1, (width() - 1));
-    j = (std::max)(origin.j, 0);
+    j = (std::max)(origin.j, a.jBegin);
 
     if (iStart < 0)
         return;
 
-    while (j < height())
+    while (j < a.jEnd)
     {
         double d = distance(i, j, x, y);
         if (d < m_radius)
         {
-            update(i, j, z, d);
+            update(i, j, z, d, a);
             i--;
             if (i >= 0)
                 continue;
@@ -348,7 +585,8 @@ void GDALGrid::updateThirdQuadrant(double x, double y, double z)
 }
 
 
-void GDALGrid::updateFourthQuadrant(double x, double y, double z)
+void GDALGrid::updateFourthQuadrant(double x, double y, double z,
+    Access& a)
 {
     int i, j;
     int jStart;
@@ -356,9 +594,9 @@ void GDALGrid::updateFourthQuadrant(double x, double y, double z)
     Cell origin = pointToCell({x, y});
 
     i = (std::max)(origin.i, 0);
-    j = jStart = (std::max)(origin.j + 1, 0);
+    j = jStart = (std::max)(origin.j + 1, a.jBegin);
 
-    if (jStart >= height())
+    if (jStart >= a.jEnd)
         return;
 
     while (i < width())
@@ -366,13 +604,13 @@ void GDALGrid::updateFourthQuadrant(double x, double y, double z)
         double d = distance(i, j, x, y);
         if (d < m_radius)
         {
-            update(i, j, z, d);
+            update(i, j, z, d, a);
             j++;
-            if (j < height())
+            if (j < a.jEnd)
                 continue;
         }
 
-        // Either d >= m_radius or we've hit the end of a column (j == height())
+        // Either d >= m_radius or we've hit the end of a column
         // so move to the next row.
         if (j == jStart)
             break;
@@ -382,7 +620,7 @@ void GDALGrid::updateFourthQuadrant(double x, double y, double z)
 }
 
 
-void GDALGrid::update(size_t i, size_t j, double val, double dist)
+void GDALGrid::update(int i, int j, double val, double dist, Access& a)
 {
     // Once we determine that a point is close enough to a cell to count it,
     // this function does the actual math.  We use the value of the
@@ -394,38 +632,42 @@ void GDALGrid::update(size_t i, size_t j, double val, double dist)
     // https://en.wikipedia.org/wiki/Algorithms_for_calculating_variance
     // https://en.wikipedia.org/wiki/Inverse_distance_weighting
 
-    double& count = m_count->at(i, j);
+    Slot s = slot(i, j, a);
+    Tile& t = *s.tile;
+    const size_t k = s.pos;
+
+    double& count = t.count[k];
     count++;
 
-    if (m_min)
+    if (has(statMin))
     {
-        double& min = m_min->at(i, j);
+        double& min = t.min[k];
         min = (std::min)(val, min);
     }
 
-    if (m_max)
+    if (has(statMax))
     {
-        double& max = m_max->at(i, j);
+        double& max = t.max[k];
         max = (std::max)(val, max);
     }
 
-    if (m_mean)
+    if (hasMean())
     {
-        double& mean = m_mean->at(i, j);
+        double& mean = t.mean[k];
         double delta = val - mean;
 
         mean += delta / count;
-        if (m_stdDev)
+        if (has(statStdDev))
         {
-            double& stdDev = m_stdDev->at(i, j);
+            double& stdDev = t.stdDev[k];
             stdDev += delta * (val - mean);
         }
     }
 
-    if (m_idw)
+    if (has(statIdw))
     {
-        double& idw = m_idw->at(i, j);
-        double& idwDist = m_idwDist->at(i, j);
+        double& idw = t.idw[k];
+        double& idwDist = t.idwDist[k];
 
         // If the distance is 0, we set the idwDist to nan to signal that
         // we should ignore the distance and take the value as is.
@@ -445,53 +687,69 @@ void GDALGrid::update(size_t i, size_t j, double val, double dist)
     }
 }
 
-void GDALGrid::finalize()
+void GDALGrid::finalize(int threads)
 {
+    std::vector<Tile *> tiles;
+    tiles.reserve(m_tiles.size());
+    for (auto& tile : m_tiles)
+        tiles.push_back(tile.second.get());
+
     // See
     // https://en.wikipedia.org/wiki/Algorithms_for_calculating_variance
     // https://en.wikipedia.org/wiki/Inverse_distance_weighting
-    if (m_stdDev)
-        for (size_t i = 0; i < m_count->size(); ++i)
-            if (!empty(i))
-                (*m_stdDev)[i] = sqrt((*m_stdDev)[i] / (*m_count)[i]);
-
-    if (m_idw)
-        for (size_t i = 0; i < m_count->size(); ++i)
-            if (!empty(i))
+    parallel(tiles.size(), threads, [this, &tiles](size_t task, Access&)
+    {
+        Tile& t = *tiles[task];
+        for (size_t k = 0; k < t.count.size(); ++k)
+        {
+            if (t.count[k] <= 0)
+                continue;
+            if (has(statStdDev))
+                t.stdDev[k] = sqrt(t.stdDev[k] / t.count[k]);
+            if (has(statIdw))
             {
-                double& distSum = (*m_idwDist)[i];
+                double& distSum = t.idwDist[k];
                 if (!std::isnan(distSum))
-                    (*m_idw)[i] /= distSum;
+                    t.idw[k] /= distSum;
             }
+        }
+    });
 
     if (m_windowSize > 0)
-        windowFill();
+        windowFill(threads);
     else
     {
-        for (int i = 0; i < m_count->width(); ++i)
-            for (int j = 0; j < m_count->height(); ++j)
-                if (empty(i, j))
-                    fillNodata(i, j);
+        // Cells of unallocated tiles already read as nodata.
+        parallel(tiles.size(), threads, [this, &tiles](size_t task, Access&)
+        {
+            Tile& t = *tiles[task];
+            for (size_t k = 0; k < t.count.size(); ++k)
+                if (t.count[k] <= 0)
+                    fillNodata({ &t, k });
+        });
     }
 }
 
 
-void GDALGrid::fillNodata(int i, int j)
+void GDALGrid::fillNodata(const Slot& s)
 {
-    if (m_min)
-        m_min->at(i, j) = std::numeric_limits<double>::quiet_NaN();
-    if (m_max)
-        m_max->at(i, j) = std::numeric_limits<double>::quiet_NaN();
-    if (m_mean)
-        m_mean->at(i, j) = std::numeric_limits<double>::quiet_NaN();
-    if (m_idw)
-        m_idw->at(i, j) = std::numeric_limits<double>::quiet_NaN();
-    if (m_stdDev)
-        m_stdDev->at(i, j) = std::numeric_limits<double>::quiet_NaN();
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    Tile& t = *s.tile;
+
+    if (has(statMin))
+        t.min[s.pos] = nan;
+    if (has(statMax))
+        t.max[s.pos] = nan;
+    if (hasMean())
+        t.mean[s.pos] = nan;
+    if (has(statIdw))
+        t.idw[s.pos] = nan;
+    if (has(statStdDev))
+        t.stdDev[s.pos] = nan;
 }
 
 
-void GDALGrid::windowFill(int dstI, int dstJ)
+void GDALGrid::windowFill(int dstI, int dstJ, Access& a)
 {
     int istart = dstI > m_windowSize ? dstI - m_windowSize : (size_t)0;
     int iend = (std::min)(width(), dstI + m_windowSize + 1);
@@ -499,58 +757,61 @@ void GDALGrid::windowFill(int dstI, int dstJ)
     int jend = (std::min)(height(), dstJ + m_windowSize + 1);
 
     double distSum = 0;
-
-    // Initialize to 0 (rather than numeric_limits::max/lowest) since we're
-    // going to accumulate and average.
-    if (m_min)
-        m_min->at(dstI, dstJ) = 0;
-    if (m_max)
-        m_max->at(dstI, dstJ) = 0;
+    double min = 0;
+    double max = 0;
+    double mean = 0;
+    double idw = 0;
+    double stdDev = 0;
 
     for (int i = istart; i < iend; ++i)
         for (int j = jstart; j < jend; ++j)
         {
-            if ((i == dstI && j == dstJ) || empty(i, j))
+            if (i == dstI && j == dstJ)
+                continue;
+            Slot src = findSlot(i, j, a);
+            if (!src.tile || src.tile->count[src.pos] <= 0)
                 continue;
+
             // The ternaries just avoid underflow UB.  We're just trying to
             // find the distance from j to dstJ or i to dstI.
             double distance = (double)(std::max)(j > dstJ ? j - dstJ : dstJ - j,
                 i > dstI ? i - dstI : dstI - i);
-            windowFillCell(i, j, dstI, dstJ, distance);
+            const Tile& t = *src.tile;
+            if (has(statMin))
+                min += t.min[src.pos] / distance;
+            if (has(statMax))
+                max += t.max[src.pos] / distance;
+            if (hasMean())
+                mean += t.mean[src.pos] / distance;
+            if (has(statIdw))
+                idw += t.idw[src.pos] / distance;
+            if (has(statStdDev))
+                stdDev += t.stdDev[src.pos] / distance;
             distSum += (1 / distance);
         }
 
     // Divide summed values by the (inverse) distance sum.
     if (distSum > 0)
     {
-        if (m_min)
-            m_min->at(dstI, dstJ) /= distSum;
-        if (m_max)
-            m_max->at(dstI, dstJ) /= distSum;
-        if (m_mean)
-            m_mean->at(dstI, dstJ) /= distSum;
-        if (m_idw)
-            m_idw->at(dstI, dstJ) /= distSum;
-        if (m_stdDev)
-            m_stdDev->at(dstI, dstJ) /= distSum;
+        Slot dst = slot(dstI, dstJ, a);
+        Tile& t = *dst.tile;
+        if (has(statMin))
+            t.min[dst.pos] = min / distSum;
+        if (has(statMax))
+            t.max[dst.pos] = max / distSum;
+        if (hasMean())
+            t.mean[dst.pos] = mean / distSum;
+        if (has(statIdw))
+            t.idw[dst.pos] = idw / distSum;
+        if (has(statStdDev))
+            t.stdDev[dst.pos] = stdDev / distSum;
     }
     else
-        fillNodata(dstI, dstJ);
-}
-
-
-void GDALGrid::windowFillCell(int srcI, int srcJ, int dstI, int dstJ, double distance)
-{
-    if (m_min)
-        m_min->at(dstI, dstJ) += m_min->at(srcI, srcJ) / distance;
-    if (m_max)
-        m_max->at(dstI, dstJ) += m_max->at(srcI, srcJ) / distance;
-    if (m_mean)
-        m_mean->at(dstI, dstJ) += m_mean->at(srcI, srcJ) / distance;
-    if (m_idw)
-        m_idw->at(dstI, dstJ) += m_idw->at(srcI, srcJ) / distance;
-    if (m_stdDev)
-        m_stdDev->at(dstI, dstJ) += m_stdDev->at(srcI, srcJ) / distance;
+    {
+        Slot dst = findSlot(dstI, dstJ, a);
+        if (dst.tile)
+            fillNodata(dst);
+    }
 }
 
 } //namespace pdal
@@ -33,8 +33,12 @@
 ****************************************************************************/
 
 #include <math.h>
+#include <array>
+#include <cstdint>
+#include <iterator>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include <stdexcept>
 
@@ -44,6 +48,9 @@
 namespace pdal
 {
 
+// Cell data is stored in square tiles that are allocated the first time a
+// point touches them, so memory use depends on the area covered by points
+// rather than the extent of the grid.
 class GDALGrid
 {
     FRIEND_TEST(GDALWriterTest, issue_2095);
@@ -59,6 +66,39 @@ class GDALGrid
         int j;
     };
 
+    struct Tile
+    {
+        std::vector<double> count;
+        std::vector<double> min;
+        std::vector<double> max;
+        std::vector<double> mean;
+        std::vector<double> stdDev;
+        std::vector<double> idw;
+        std::vector<double> idwDist;
+    };
+    using TilePtr = std::unique_ptr<Tile>;
+    using TileMap = std::unordered_map<uint64_t, TilePtr>;
+
+    // State of one thread accessing the grid: the rows it may update,
+    // the map in which it puts new tiles (the grid's tiles if null) and
+    // the most recently used tile.
+    struct Access
+    {
+        int jBegin = 0;
+        int jEnd = 0;
+        TileMap *added = nullptr;
+        uint64_t lastKey = 0;
+        Tile *lastTile = nullptr;
+    };
+
+    // Location of a cell in tile storage.  'tile' is null if the tile that
+    // would hold the cell hasn't been allocated.
+    struct Slot
+    {
+        Tile *tile;
+        size_t pos;
+    };
+
 public:
     static const int statCount = 1;
     static const int statMin = 2;
@@ -67,12 +107,57 @@ public:
     static const int statStdDev = 16;
     static const int statIdw = 32;
 
+    // Number of cells on a side of a storage tile.
+    static const int TileSize = 128;
+
     struct error : public std::runtime_error
     {
         error(const std::string& err) : std::runtime_error(err)
         {}
     };
 
+    // Random-access iterator over the values of a band in row-major order,
+    // starting at the top left of the grid.  Cells of tiles that haven't
+    // been allocated read as 0 for the count band and NaN otherwise.
+    class BandIterator
+    {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = double;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const double *;
+        using reference = double;
+
+        BandIterator(const GDALGrid *grid, std::vector<double> Tile::*band,
+                double empty, size_t idx = 0) :
+            m_grid(grid), m_band(band), m_empty(empty), m_idx(idx)
+        {}
+
+        double operator*() const;
+        double operator[](difference_type n) const
+            { return *(*this + n); }
+        BandIterator& operator++()
+            { m_idx++; return *this; }
+        BandIterator operator++(int)
+            { BandIterator it(*this); m_idx++; return it; }
+        BandIterator& operator+=(difference_type n)
+            { m_idx += n; return *this; }
+        BandIterator operator+(difference_type n) const
+            { BandIterator it(*this); it.m_idx += n; return it; }
+        difference_type operator-(const BandIterator& other) const
+            { return (difference_type)m_idx - (difference_type)other.m_idx; }
+        bool operator==(const BandIterator& other) const
+            { return m_idx == other.m_idx; }
+        bool operator!=(const BandIterator& other) const
+            { return m_idx != other.m_idx; }
+
+    private:
+        const GDALGrid *m_grid;
+        std::vector<double> Tile::*m_band;
+        double m_empty;
+        size_t m_idx;
+    };
+
     // Exported for testing.
     PDAL_EXPORT GDALGrid(double xOrigin, double yOrigin, size_t width, size_t height,
         double edgeLength, double radius, int outputTypes, size_t windowSize,
@@ -83,47 +168,75 @@ public:
     // Get the number of bands represented by this grid.
     int numBands() const;
 
-    // Return a pointer to the data in a raster band, row-major ordered.
-    double *data(const std::string& name);
+    // Determine if the grid has a band with the given name.
+    bool hasBand(const std::string& name) const;
+
+    // Return an iterator to the data in a raster band, row-major ordered.
+    BandIterator band(const std::string& name) const;
 
     // Add a point to the raster grid.
-    void addPoint(double x, double y, double z);
+    PDAL_EXPORT void addPoint(double x, double y, double z);
+
+    // Add points to the raster grid using up to 'threads' threads.  The
+    // result is the same as adding the points in order with addPoint().
+    void addPoints(const std::vector<std::array<double, 3>>& points,
+        int threads);
 
     // Compute final values after all points have been added.
-    void finalize();
+    PDAL_EXPORT void finalize(int threads = 1);
 
     int width() const;
     int height() const;
     double xOrigin() const;
     double yOrigin() const;
 
+    // Number of storage tiles that have been allocated.
+    PDAL_EXPORT size_t tileCount() const;
 
 private:
+    RasterLimits m_limits;
+    // Offsets of cell indices in the tile frame from cell indices in the
+    // grid.  They change when the grid is expanded down or to the left.
+    int64_t m_iBase;
+    int64_t m_jBase;
     int m_windowSize;
     double m_edgeLength;
     double m_radius;
     double m_power;
 
-    typedef std::unique_ptr<Rasterd> DataPtr;
-    DataPtr m_count;
-    DataPtr m_min;
-    DataPtr m_max;
-    DataPtr m_mean;
-    DataPtr m_stdDev;
-    DataPtr m_idw;
-    DataPtr m_idwDist;
+    TileMap m_tiles;
+    // Access used when the grid is used from a single thread.
+    mutable Access m_access;
 
     int m_outputTypes;
 
     bool m_binMode;
+    // Set while empty cells are being filled.  Tiles allocated at that time
+    // start with no data.
+    bool m_filling;
 
-    // Determine if a cell i, j has no associated points.
-    bool empty(size_t i, size_t j) const
-        { return m_count->at(i, j) <= 0; }
+    bool has(int stat) const
+        { return m_outputTypes & stat; }
+    bool hasMean() const
+        { return has(statMean) || has(statStdDev); }
+
+    // Find the storage for cell i, j.  findSlot() doesn't allocate a tile
+    // for the cell, slot() does.
+    Slot findSlot(int i, int j) const
+        { return findSlot(i, j, m_access); }
+    Slot findSlot(int i, int j, Access& a) const;
+    Slot slot(int i, int j, Access& a);
+    Tile *allocTile(uint64_t key, Access& a);
+    static uint64_t tileKey(int64_t ti, int64_t tj);
+
+    // Run f(task, access) for tasks [0, count) on up to 'threads' threads.
+    // Tiles allocated by the tasks are added to the grid once all tasks
+    // are done.
+    template<typename F>
+    void parallel(size_t count, int threads, F f);
 
-    // Determine if a cell with index \c idx has no associated points.
-    bool empty(size_t idx) const
-        { return (m_count->at(idx) <= 0); }
+    // Determine if a cell i, j has no associated points.
+    bool empty(int i, int j, Access& a) const;
 
     // Determine the distance from the center of cell at coordinate i, j to
     // a point at absolute coordinate x, y.
@@ -132,31 +245,28 @@ private:
     // Convert an x/y point to a grid cell location.
     Cell pointToCell(const Point& p);
 
+    // Add a point, only updating the rows of the grid allowed by 'a'.
+    void addPoint(double x, double y, double z, Access& a);
+
     // Update cells in the Nth quadrant about point at (x, y, z)
-    void updateFirstQuadrant(double x, double y, double z);
-    void updateSecondQuadrant(double x, double y, double z);
-    void updateThirdQuadrant(double x, double y, double z);
-    void updateFourthQuadrant(double x, double y, double z);
+    void updateFirstQuadrant(double x, double y, double z, Access& a);
+    void updateSecondQuadrant(double x, double y, double z, Access& a);
+    void updateThirdQuadrant(double x, double y, double z, Access& a);
+    void updateFourthQuadrant(double x, double y, double z, Access& a);
 
     // Update cell at i, j with value at a distance.
-    void update(size_t i, size_t j, double val, double dist);
+    void update(int i, int j, double val, double dist, Access& a);
 
-    // Fill cell at index \c i with the nondata value.
-    // \i  I coordinate.
-    // \j  J coordinate.
-    void fillNodata(int i, int j);
+    // Fill the cell at a slot with the nodata value.
+    void fillNodata(const Slot& s);
 
     // Fill an empty cell with a value inverse-distance averaged from
     // surrounding cells.
-    void windowFill();
+    void windowFill(int threads);
 
     // Fill empty cell at dstI, dstJ with inverse-distance weighted values
     // from neighboring cells.
-    void windowFill(int dstI, int dstJ);
-
-    // Cumulate data from a source cell to a destination cell when doing
-    // a window fill.
-    void windowFillCell(int srcI, int srcJ, int dstI, int dstJ, double distance);
+    void windowFill(int dstI, int dstJ, Access& a);
 };
 
 } //namespace pdal
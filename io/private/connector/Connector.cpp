@@ -33,6 +33,11 @@
  ****************************************************************************/
 
 #include "Connector.hpp"
+#include "DiskCache.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <random>
 
 #include <pdal/pdal_types.hpp>
 #include <pdal/pdal_config.hpp>
@@ -107,9 +112,179 @@ Connector::Connector(const FileSpec& spec) :
     }
 }
 
+Connector::~Connector()
+{}
+
+
+void Connector::setCache(const std::string& dir, uintmax_t maxSize,
+    bool validate)
+{
+    m_cache.reset(new DiskCache(dir, maxSize));
+    m_cacheValidate = validate;
+}
+
+
+uint64_t Connector::cacheRequests() const
+{
+    return m_cacheRequests;
+}
+
+
+uint64_t Connector::cacheHits() const
+{
+    return m_cacheHits;
+}
+
+
+bool Connector::cacheable(const std::string& path) const
+{
+    if (!m_cache)
+        return false;
+
+    // Other HTTP-derived drivers sign their requests, which a plain GET
+    // through the endpoint doesn't do.
+    const std::string protocol = arbiter::getProtocol(path);
+    return protocol == "http" || protocol == "https";
+}
+
+
+namespace
+{
+
+// A cache entry is the version of its source, a newline and the data.
+std::vector<char> makeEntry(const std::string& version,
+    const std::vector<char>& data)
+{
+    std::vector<char> entry(version.begin(), version.end());
+    entry.push_back('\n');
+    entry.insert(entry.end(), data.begin(), data.end());
+    return entry;
+}
+
+
+bool splitEntry(const std::vector<char>& entry, std::string& version,
+    std::vector<char>& data)
+{
+    auto it = std::find(entry.begin(), entry.end(), '\n');
+    if (it == entry.end())
+        return false;
+    version.assign(entry.begin(), it);
+    data.assign(it + 1, entry.end());
+    return true;
+}
+
+
+std::string etag(const StringMap& headers)
+{
+    for (auto& header : headers)
+        if (Utils::iequals(header.first, "etag"))
+            return header.second;
+    return std::string();
+}
+
+
+} // unnamed namespace
+
+
+// Find data in the cache, or fetch it and add it to the cache.  Entries are
+// keyed by source path and byte range and hold the version of the source
+// they were fetched from.  Remote data is fetched with a GET that carries
+// the version of any cached entry, so that an unchanged source answers
+// without data, and the ETag of the response is the version that's stored.
+// Once the version of a path is known, entries of that version are used
+// without contacting the source.  The version isn't kept between runs, so
+// each run checks each path once.  If validation is off, an entry of a path
+// whose version isn't known yet is used as is and its version becomes the
+// known one.
+std::vector<char> Connector::cached(const std::string& path,
+    const std::string& range,
+    const std::function<std::vector<char>()>& fetch) const
+{
+    if (!cacheable(path))
+        return fetch();
+    m_cacheRequests++;
+
+    const std::string key = path + "\n" + range;
+    std::vector<char> entry;
+    std::string entryVersion;
+    std::vector<char> data;
+    bool found = m_cache->get(key, entry) &&
+        splitEntry(entry, entryVersion, data);
+
+    std::string version;
+    bool known;
+    {
+        std::lock_guard<std::mutex> lock(m_versionMutex);
+        auto it = m_versions.find(path);
+        known = (it != m_versions.end());
+        if (known)
+            version = it->second;
+    }
+    if (found && known && version.size() && version == entryVersion)
+    {
+        m_cacheHits++;
+        return data;
+    }
+    if (found && !known && !m_cacheValidate)
+    {
+        std::lock_guard<std::mutex> lock(m_versionMutex);
+        // Another thread may have fetched the path in the meantime.
+        auto it = m_versions.emplace(path, entryVersion).first;
+        if (it->second == entryVersion)
+        {
+            m_cacheHits++;
+            return data;
+        }
+    }
+
+    StringMap headers(m_headers);
+    if (range.size())
+        headers["Range"] = "bytes=" + range;
+    if (found)
+        headers["If-None-Match"] = entryVersion;
+
+    arbiter::http::Response r =
+        m_arbiter->getEndpoint(arbiter::getDirname(path)).httpGet(
+            arbiter::getBasename(path), headers, m_query);
+    bool hit = false;
+    bool store = false;
+    if (found && r.code() == 304)
+    {
+        version = entryVersion;
+        hit = true;
+    }
+    else if (r.ok())
+    {
+        // A server that ignores the range answers with the whole file,
+        // which isn't what the key says.
+        version = etag(r.headers());
+        data = r.data();
+        store = r.code() == 206 || (r.code() == 200 && range.empty());
+    }
+    else
+        throw arbiter::ArbiterError("Could not read file " + path +
+            " (HTTP status " + std::to_string(r.code()) + ").");
+
+    {
+        std::lock_guard<std::mutex> lock(m_versionMutex);
+        m_versions[path] = version;
+    }
+    if (hit)
+        m_cacheHits++;
+    else if (store && version.size())
+        m_cache->put(key, makeEntry(version, data));
+    return data;
+}
+
 
 std::string Connector::get(const std::string& path) const
 {
+    if (m_cache)
+    {
+        std::vector<char> data = getBinary(path);
+        return std::string(data.begin(), data.end());
+    }
+
     if (m_arbiter->isLocal(path))
         return m_arbiter->get(path);
     else
@@ -131,10 +306,13 @@ NL::json Connector::getJson(const std::string& path) const
 
 std::vector<char> Connector::getBinary(const std::string& path) const
 {
-    if (m_arbiter->isLocal(path))
-        return m_arbiter->getBinary(path);
-    else
-        return m_arbiter->getBinary(path, m_headers, m_query);
+    return cached(path, "", [this, &path]()
+    {
+        if (m_arbiter->isLocal(path))
+            return m_arbiter->getBinary(path);
+        else
+            return m_arbiter->getBinary(path, m_headers, m_query);
+    });
 }
 
 
@@ -146,8 +324,22 @@ arbiter::LocalHandle Connector::getLocalHandle(const std::string& path) const
 
     if (m_arbiter->isLocal(path))
         return m_arbiter->getLocalHandle(path);
-    else
-        return m_arbiter->getLocalHandle(path, m_headers, m_query);
+
+    // Write cached data to a temporary file.  The cache entry itself isn't
+    // used since it could be evicted while the handle is in use.
+    if (cacheable(path))
+    {
+        static std::atomic<uint64_t> counter(0);
+        static const uint64_t seed = std::random_device()();
+
+        std::vector<char> data = getBinary(path);
+        std::string filename = arbiter::join(arbiter::getTempPath(),
+            std::to_string(seed) + "-" + std::to_string(counter++) + "-" +
+            arbiter::getBasename(path));
+        m_arbiter->put(filename, data);
+        return arbiter::LocalHandle(filename, true);
+    }
+    return m_arbiter->getLocalHandle(path, m_headers, m_query);
 }
 
 void Connector::put(const std::string& path, const std::vector<char>& buf) const
@@ -184,6 +376,17 @@ std::vector<char> Connector::getBinary(uint64_t offset, int32_t size) const
     if (size <= 0)
         return std::vector<char>();
 
+    const std::string range = std::to_string(offset) + "-" +
+        std::to_string(offset + size - 1);
+    return cached(m_filename, range, [this, offset, size]()
+    {
+        return fetchRange(offset, size);
+    });
+}
+
+
+std::vector<char> Connector::fetchRange(uint64_t offset, int32_t size) const
+{
     if (m_arbiter->isLocal(m_filename))
     {
         std::vector<char> buf(size);
@@ -34,6 +34,10 @@
 
 #pragma once
 
+#include <atomic>
+#include <functional>
+#include <mutex>
+
 #include <arbiter/arbiter.hpp>
 #include <pdal/FileSpec.hpp>
 
@@ -44,6 +48,8 @@ namespace pdal
 namespace connector
 {
 
+class DiskCache;
+
 class Connector
 {
     std::unique_ptr<arbiter::Arbiter> m_arbiter;
@@ -51,12 +57,37 @@ class Connector
     StringMap m_query;
     std::unique_ptr<arbiter::drivers::Http> m_httpDriver;
     std::string m_filename;
+    std::unique_ptr<DiskCache> m_cache;
+    bool m_cacheValidate = true;
+    mutable StringMap m_versions;
+    mutable std::mutex m_versionMutex;
+    mutable std::atomic<uint64_t> m_cacheRequests { 0 };
+    mutable std::atomic<uint64_t> m_cacheHits { 0 };
+
+    bool cacheable(const std::string& path) const;
+    std::vector<char> fetchRange(uint64_t offset, int32_t size) const;
+    std::vector<char> cached(const std::string& path,
+        const std::string& range,
+        const std::function<std::vector<char>()>& fetch) const;
 
 public:
     Connector();
     Connector(const std::string& filename, const StringMap& headers, const StringMap& query);
     Connector(const StringMap& headers, const StringMap& query);
     Connector(const FileSpec& spec);
+    ~Connector();
+
+    // Keep data fetched over HTTP in a cache in directory 'dir' that holds
+    // at most 'maxSize' bytes.  Data is only cached if its response has an
+    // ETag.  Local sources and other remote storage are read directly.
+    // Unless 'validate' is false, the first use of a path's cached data
+    // asks the source whether it has changed.
+    void setCache(const std::string& dir, uintmax_t maxSize,
+        bool validate = true);
+    // Number of fetches that could have been served from the cache.
+    uint64_t cacheRequests() const;
+    // Number of fetches that were served from the cache.
+    uint64_t cacheHits() const;
 
     std::string get(const std::string& path) const;
     NL::json getJson(const std::string& path) const;
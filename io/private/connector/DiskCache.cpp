@@ -0,0 +1,228 @@
+/******************************************************************************
+* Copyright (c) 2026, Hobu Inc. (info@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#include "DiskCache.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <system_error>
+
+#include <arbiter/arbiter.hpp>
+#include <pdal/pdal_types.hpp>
+#include <pdal/util/FileUtils.hpp>
+
+namespace fs = std::filesystem;
+
+namespace pdal
+{
+namespace connector
+{
+
+namespace
+{
+
+const std::string Extension(".pdalcache");
+const std::string TempExtension(".tmp");
+
+// Temporary files older than this were left by a writer that failed.
+const std::chrono::hours TempLifetime(1);
+
+bool isEntry(const fs::directory_entry& entry)
+{
+    std::error_code ec;
+    return entry.is_regular_file(ec) &&
+        entry.path().extension().string() == Extension;
+}
+
+bool isTemp(const fs::directory_entry& entry)
+{
+    std::error_code ec;
+    return entry.is_regular_file(ec) &&
+        entry.path().filename().string().find(Extension + TempExtension) !=
+            std::string::npos;
+}
+
+// A name for a temporary file that is unique across threads and processes.
+std::string uniqueSuffix()
+{
+    static std::atomic<uint64_t> counter(0);
+    static const uint64_t seed = std::random_device()();
+    return TempExtension + std::to_string(seed) + "-" +
+        std::to_string(counter++);
+}
+
+} // unnamed namespace
+
+
+DiskCache::DiskCache(const std::string& dir, uintmax_t maxSize) :
+    m_dir(dir), m_maxSize(maxSize), m_size(0)
+{
+    if (!FileUtils::directoryExists(m_dir) &&
+            !FileUtils::createDirectories(m_dir))
+        throw pdal_error("Unable to create cache directory '" + m_dir + "'.");
+
+    std::error_code ec;
+    for (const fs::directory_entry& entry : fs::directory_iterator(m_dir, ec))
+        if (isEntry(entry))
+            m_size += entry.file_size(ec);
+    evict();
+}
+
+
+std::string DiskCache::filename(const std::string& key) const
+{
+    using namespace arbiter::crypto;
+
+    return (fs::path(m_dir) / (encodeAsHex(sha256(key)) + Extension)).string();
+}
+
+
+bool DiskCache::get(const std::string& key, std::vector<char>& data) const
+{
+    const std::string name = filename(key);
+    std::ifstream in(name, std::ios::binary);
+    if (!in)
+        return false;
+
+    std::error_code ec;
+    uintmax_t size = fs::file_size(name, ec);
+    if (ec)
+        return false;
+    data.resize(size);
+    if (!in.read(data.data(), size))
+        return false;
+
+    // The modification time of an entry is its last use.
+    fs::last_write_time(name, fs::file_time_type::clock::now(), ec);
+    return true;
+}
+
+
+void DiskCache::put(const std::string& key, const std::vector<char>& data) const
+{
+    if (data.size() > m_maxSize)
+        return;
+
+    // Write to a temporary file and rename it so that readers never see
+    // a partial entry.
+    const std::string name = filename(key);
+    const std::string tempName = name + uniqueSuffix();
+    {
+        std::ofstream out(tempName, std::ios::binary | std::ios::trunc);
+        if (!out.write(data.data(), data.size()))
+        {
+            out.close();
+            FileUtils::deleteFile(tempName);
+            return;
+        }
+    }
+
+    // An entry that is replaced no longer counts toward the size.  The
+    // lock keeps threads that store the same key from both counting it.
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::error_code ec;
+    uintmax_t oldSize = fs::file_size(name, ec);
+    if (ec)
+        oldSize = 0;
+    fs::rename(tempName, name, ec);
+    if (ec)
+    {
+        FileUtils::deleteFile(tempName);
+        return;
+    }
+
+    m_size += data.size();
+    m_size -= (std::min)(m_size, oldSize);
+    if (m_size > m_maxSize)
+        evict();
+}
+
+
+uintmax_t DiskCache::size() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_size;
+}
+
+
+// Remove the least recently used entries until the cache is below a
+// low-water mark, so that a full cache doesn't rescan its directory on every
+// insertion.  Sizes are recomputed from the directory since other processes
+// may share it.  Temporary files left by failed writers are removed too.
+void DiskCache::evict() const
+{
+    struct Entry
+    {
+        fs::path path;
+        uintmax_t size;
+        fs::file_time_type time;
+    };
+
+    std::error_code ec;
+    std::vector<Entry> entries;
+    const fs::file_time_type staleTime =
+        fs::file_time_type::clock::now() - TempLifetime;
+    m_size = 0;
+    for (const fs::directory_entry& entry : fs::directory_iterator(m_dir, ec))
+    {
+        if (isTemp(entry) && entry.last_write_time(ec) < staleTime && !ec)
+            fs::remove(entry.path(), ec);
+        if (!isEntry(entry))
+            continue;
+        Entry e { entry.path(), entry.file_size(ec),
+            entry.last_write_time(ec) };
+        entries.push_back(e);
+        m_size += e.size;
+    }
+    if (m_size <= m_maxSize)
+        return;
+
+    const uintmax_t target = m_maxSize / 10 * 9;
+    std::sort(entries.begin(), entries.end(),
+        [](const Entry& a, const Entry& b){ return a.time < b.time; });
+    for (const Entry& e : entries)
+    {
+        if (m_size <= target)
+            break;
+        if (fs::remove(e.path, ec))
+            m_size -= e.size;
+    }
+}
+
+} // namespace connector
+} // namespace pdal
@@ -0,0 +1,76 @@
+/******************************************************************************
+* Copyright (c) 2026, Hobu Inc. (info@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace pdal
+{
+namespace connector
+{
+
+// A persistent cache of fetched data in a local directory.  Each entry is
+// stored in a file named by a hash of its key.  The cache doesn't know
+// whether an entry is stale; callers store what they need to check that
+// with the data.  When the total size of the entries exceeds the maximum
+// size, the least recently used entries are removed until it is 90% of the
+// maximum.
+class DiskCache
+{
+public:
+    DiskCache(const std::string& dir, uintmax_t maxSize);
+
+    // Find the data for a key.  Returns false if the key isn't cached.
+    bool get(const std::string& key, std::vector<char>& data) const;
+    // Add data for a key.
+    void put(const std::string& key, const std::vector<char>& data) const;
+    // Total size of the cached data in bytes.
+    uintmax_t size() const;
+
+private:
+    std::string filename(const std::string& key) const;
+    void evict() const;
+
+    std::string m_dir;
+    uintmax_t m_maxSize;
+    mutable uintmax_t m_size;
+    mutable std::mutex m_mutex;
+};
+
+} // namespace connector
+} // namespace pdal
@@ -55,6 +55,21 @@ BuPyramid::BuPyramid(const BaseInfo& common) : m_manager(common)
 
 
 void BuPyramid::run(CellManager& cells)
+{
+    std::vector<OctantInfo> have;
+    for (auto& kv : cells)
+    {
+        OctantInfo o(kv.first);
+        o.source() = kv.second;
+        have.push_back(o);
+    }
+    run(have);
+}
+
+
+// In stream mode the cells hold the names of the files that contain their points
+// rather than point views.
+void BuPyramid::run(const std::vector<OctantInfo>& cells)
 {
     queueWork(cells);
     std::thread runner(&PyramidManager::run, &m_manager);
@@ -62,22 +77,15 @@ void BuPyramid::run(CellManager& cells)
 }
 
 
-size_t BuPyramid::queueWork(CellManager& cells)
+size_t BuPyramid::queueWork(const std::vector<OctantInfo>& have)
 {
     std::set<VoxelKey> needed;
     std::set<VoxelKey> parentsToProcess;
-    std::vector<OctantInfo> have;
     const VoxelKey root;
 
-    for (auto& kv : cells)
+    for (const OctantInfo& o : have)
     {
-        VoxelKey k = kv.first;
-        PointViewPtr v = kv.second;
-
-        // Stick an OctantInfo for this cell in the 'have' list.
-        OctantInfo o(k);
-        o.source() = v;
-        have.push_back(o);
+        VoxelKey k = o.key();
 
         // Walk up the tree and make sure that we're populated for all children necessary
         // to process to the top level.  We do this in order to facilitate processing --
@@ -103,6 +111,10 @@ size_t BuPyramid::queueWork(CellManager& cells)
         }
     }
 
+    // With no cells there is only an empty root, which completes the processing.
+    if (have.empty())
+        m_manager.queue(OctantInfo(root));
+
     // Queue what we have.
     for (const OctantInfo& o : have)
         m_manager.queue(o);
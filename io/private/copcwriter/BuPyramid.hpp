@@ -56,9 +56,10 @@ class BuPyramid
 public:
     BuPyramid(const BaseInfo& common);
     void run(CellManager& cells);
+    void run(const std::vector<OctantInfo>& cells);
 
 private:
-    size_t queueWork(CellManager& cells);
+    size_t queueWork(const std::vector<OctantInfo>& have);
     void writeInfo();
 
     PyramidManager m_manager;
@@ -110,6 +110,8 @@ struct Options
     pdal::SpatialReference aSrs;
     int threadCount = 10;
     bool enhancedSrsVlrs = false;
+    std::string tempDir;
+    uint64_t memoryBudget;
 };
 
 struct BaseInfo
@@ -138,6 +140,13 @@ struct BaseInfo
         stats::Summary("ReturnNumber", stats::Summary::Enumerate),
     };
     std::string filename;
+
+    // In stream mode, points are written to temporary files packed as the
+    // dimensions/types of 'spillDims'.
+    std::string spillPrefix;
+    StringList spillNames;
+    DimTypeList spillDims;
+    size_t spillPointSize = 0;
 };
 
 } // namespace copcwriter
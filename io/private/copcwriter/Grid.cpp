@@ -61,6 +61,12 @@ Grid::Grid(const BOX3D& bounds, size_t points) : m_gridSize(-1), m_cubic(true)
     resetLevel(calcLevel());
 }
 
+Grid::Grid(const BOX3D& cube, const BOX3D& bounds, int level) : m_gridSize(-1),
+    m_bounds(bounds), m_cubicBounds(cube), m_millionPoints(0), m_cubic(true)
+{
+    resetLevel(level);
+}
+
 int Grid::calcLevel()
 {
     int level = 0;
@@ -114,9 +120,10 @@ void Grid::resetLevel(int level)
 
 VoxelKey Grid::key(double x, double y, double z)
 {
-    int xi = (int)std::floor((x - m_bounds.minx) / m_xsize);
-    int yi = (int)std::floor((y - m_bounds.miny) / m_ysize);
-    int zi = (int)std::floor((z - m_bounds.minz) / m_zsize);
+    const BOX3D& origin = m_cubic ? m_cubicBounds : m_bounds;
+    int xi = (int)std::floor((x - origin.minx) / m_xsize);
+    int yi = (int)std::floor((y - origin.miny) / m_ysize);
+    int zi = (int)std::floor((z - origin.minz) / m_zsize);
     xi = (std::min)((std::max)(0, xi), m_gridSize - 1);
     yi = (std::min)((std::max)(0, yi), m_gridSize - 1);
     zi = (std::min)((std::max)(0, zi), m_gridSize - 1);
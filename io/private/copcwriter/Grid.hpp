@@ -51,6 +51,9 @@ class Grid
 {
 public:
     Grid(const BOX3D& bounds, size_t points);
+    // A grid over a given cube at a fixed level. 'bounds' are the bounds of the data
+    // within the cube.
+    Grid(const BOX3D& cube, const BOX3D& bounds, int level);
 
     int calcLevel();
     void resetLevel(int level);
@@ -66,6 +69,8 @@ public:
 
     int maxLevel() const
         { return m_maxLevel; }
+    double cellSize() const
+        { return m_xsize; }
     void setCubic(bool cubic)
         { m_cubic = cubic; }
 
@@ -35,6 +35,9 @@
 
 #pragma once
 
+#include <string>
+#include <vector>
+
 #include "VoxelKey.hpp"
 #include <pdal/PointView.hpp>
 
@@ -71,7 +74,17 @@ public:
 
     size_t numPoints() const
     {
-        return m_source ? m_source->size() : 0;
+        return m_source ? m_source->size() : m_spillCount;
+    }
+
+    // In stream mode, the points of an octant are kept in temporary files when
+    // the octant isn't being processed.
+    const std::vector<std::string>& spillFiles() const
+        { return m_spillFiles; }
+    void setSpill(const std::vector<std::string>& filenames, point_count_t count)
+    {
+        m_spillFiles = filenames;
+        m_spillCount = count;
     }
 
     VoxelKey key() const
@@ -87,6 +100,8 @@ private:
     PointViewPtr m_source;
     VoxelKey m_key;
     bool m_mustWrite;
+    std::vector<std::string> m_spillFiles;
+    point_count_t m_spillCount = 0;
 };
 
 } // namespace copcwriter
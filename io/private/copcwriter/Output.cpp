@@ -73,12 +73,19 @@ Output::Output(const BaseInfo& b) : b(b)
     m_header.offset.z = b.scaling.m_zXform.m_offset.m_val;
     m_header.vlr_count = 0;
 
-    m_header.minx = b.stats[(int)stats::Index::X].minimum();
-    m_header.maxx = b.stats[(int)stats::Index::X].maximum();
-    m_header.miny = b.stats[(int)stats::Index::Y].minimum();
-    m_header.maxy = b.stats[(int)stats::Index::Y].maximum();
-    m_header.minz = b.stats[(int)stats::Index::Z].minimum();
-    m_header.maxz = b.stats[(int)stats::Index::Z].maximum();
+    // A file without points has zero bounds.
+    m_header.minx = m_header.maxx = 0;
+    m_header.miny = m_header.maxy = 0;
+    m_header.minz = m_header.maxz = 0;
+    if (b.stats[(int)stats::Index::X].count())
+    {
+        m_header.minx = b.stats[(int)stats::Index::X].minimum();
+        m_header.maxx = b.stats[(int)stats::Index::X].maximum();
+        m_header.miny = b.stats[(int)stats::Index::Y].minimum();
+        m_header.maxy = b.stats[(int)stats::Index::Y].maximum();
+        m_header.minz = b.stats[(int)stats::Index::Z].minimum();
+        m_header.maxz = b.stats[(int)stats::Index::Z].maximum();
+    }
 
     // legacy point counts are all zero, since COPC is LAS 1.4 only.
     std::fill(std::begin(m_header.points_by_return), std::end(m_header.points_by_return), 0);
@@ -108,6 +115,7 @@ Output::Output(const BaseInfo& b) : b(b)
     // The actual point data comes after the chunk table offset. m_pointPos is updated
     // as points are written.
     m_pointPos = m_chunkOffsetPos + sizeof(uint64_t);
+    m_writePos = m_pointPos;
 
     m_f.open(b.filename, std::ios::out | std::ios::binary);
 }
@@ -132,8 +140,13 @@ void Output::addCopcVlr()
     m_copcVlr.center_z = (b.bounds.maxz / 2) + (b.bounds.minz / 2);
     m_copcVlr.halfsize = (b.bounds.maxx - b.bounds.minx) / 2;
     m_copcVlr.spacing = (2.0 * m_copcVlr.halfsize) / RootCellCount;
-    m_copcVlr.gpstime_minimum = b.stats[(int)stats::Index::GpsTime].minimum();
-    m_copcVlr.gpstime_maximum = b.stats[(int)stats::Index::GpsTime].maximum();
+    m_copcVlr.gpstime_minimum = 0;
+    m_copcVlr.gpstime_maximum = 0;
+    if (b.stats[(int)stats::Index::GpsTime].count())
+    {
+        m_copcVlr.gpstime_minimum = b.stats[(int)stats::Index::GpsTime].minimum();
+        m_copcVlr.gpstime_maximum = b.stats[(int)stats::Index::GpsTime].maximum();
+    }
 
     std::vector<char> buf = m_copcVlr.header().data();
     m_vlrBuf.insert(m_vlrBuf.end(), buf.begin(), buf.end());
@@ -196,6 +209,8 @@ void Output::addEbVlr()
 
 void Output::finish(const std::unordered_map<VoxelKey, point_count_t>& childCounts)
 {
+    if (m_pending.size() || m_writePos != m_pointPos)
+        throw pdal_error("Not all point chunks were written to '" + b.filename + "'.");
     writeChunkTable();
     writeHierarchy(childCounts);
     writeEvlrs();
@@ -230,6 +245,32 @@ uint64_t Output::newChunk(const VoxelKey& key, int32_t size, int32_t count)
     return chunkStart;
 }
 
+/// Chunks are written through the single output stream in the order of their
+/// locations so that the file is written sequentially. Chunks that arrive before
+/// the chunks that precede them are held until they can be written.
+/// \param  location  Location of the chunk returned by newChunk().
+/// \param  chunk  Compressed chunk data.
+void Output::writeChunk(uint64_t location, std::vector<unsigned char>&& chunk)
+{
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+
+    m_pending.emplace(location, std::move(chunk));
+    auto it = m_pending.begin();
+    if (it->first != m_writePos)
+        return;
+
+    m_f.seekp(m_writePos);
+    while (it != m_pending.end() && it->first == m_writePos)
+    {
+        const std::vector<unsigned char>& data = it->second;
+        m_f.write(reinterpret_cast<const char *>(data.data()), data.size());
+        m_writePos += data.size();
+        it = m_pending.erase(it);
+    }
+    if (!m_f)
+        throw pdal_error("Failure writing to '" + b.filename + "'.");
+}
+
 void Output::writeHeader()
 {
     std::ostream& out = m_f;
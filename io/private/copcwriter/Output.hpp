@@ -34,6 +34,8 @@
 
 #pragma once
 
+#include <map>
+#include <mutex>
 #include <unordered_map>
 
 #include "Common.hpp"
@@ -65,6 +67,7 @@ public:
     Output(const BaseInfo& b);
     void finish(const CountMap& childCounts);
     uint64_t newChunk(const VoxelKey& key, int32_t size, int32_t count);
+    void writeChunk(uint64_t location, std::vector<unsigned char>&& chunk);
 
 private:
     const BaseInfo& b;
@@ -76,6 +79,10 @@ private:
     uint64_t m_chunkOffsetPos;
     uint64_t m_pointPos;
     std::unordered_map<VoxelKey, Entry> m_hierarchy;
+    // Chunks waiting to be written, keyed by location.
+    std::map<uint64_t, std::vector<unsigned char>> m_pending;
+    uint64_t m_writePos;
+    std::mutex m_writeMutex;
 
     void writeHeader();
     void writeVlrData();
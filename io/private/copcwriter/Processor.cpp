@@ -44,6 +44,7 @@
 #include "GridKey.hpp"
 #include "Processor.hpp"
 #include "PyramidManager.hpp"
+#include "Spill.hpp"
 
 namespace pdal
 {
@@ -57,7 +58,9 @@ Processor::Processor(PyramidManager& manager, const VoxelInfo& v, const BaseInfo
 
 void Processor::run()
 {
-    m_loader.init(b.pointFormatId, b.scaling, b.extraDims);
+    m_extraDims = b.extraDims;
+    loadSpilled();
+    m_loader.init(b.pointFormatId, b.scaling, m_extraDims);
     m_vi.initParentOctant();
 
     size_t totalPoints = 0;
@@ -79,9 +82,49 @@ void Processor::run()
 
     sample();
     write();
+
+    // In stream mode the points of the parent are kept on disk until its parent
+    // is processed.
+    if (m_table && m_vi.key() != VoxelKey(0, 0, 0, 0))
+        writeSpill(b, m_vi.octant(), m_spillDims);
     m_manager.queue(m_vi.octant());
 }
 
+// In stream mode, load the points of the children from their temporary files into
+// a point table owned by this processor.
+void Processor::loadSpilled()
+{
+    bool spilled = false;
+    for (int i = 0; i < 8; ++i)
+        if (m_vi.child(i).spillFiles().size())
+            spilled = true;
+    if (!spilled)
+        return;
+
+    m_table.reset(new PointTable);
+    PointLayoutPtr layout = m_table->layout();
+    for (size_t i = 0; i < b.spillDims.size(); ++i)
+    {
+        Dimension::Type type = b.spillDims[i].m_type;
+        m_spillDims.emplace_back(layout->registerOrAssignDim(b.spillNames[i], type), type);
+    }
+    layout->finalize();
+
+    // Proprietary dimensions may have different IDs in this table.
+    for (las::ExtraDim& dim : m_extraDims)
+        dim.m_dimType.m_id = layout->findDim(dim.m_name);
+
+    for (int i = 0; i < 8; ++i)
+    {
+        OctantInfo& child = m_vi.child(i);
+        if (child.spillFiles().empty())
+            continue;
+        PointViewPtr v(new PointView(*m_table));
+        readSpill(b, child, *v, m_spillDims);
+        child.source() = v;
+    }
+}
+
 void Processor::write()
 {
     OctantInfo& parent = m_vi.octant();
@@ -189,13 +232,7 @@ void Processor::writeCompressed(VoxelKey k, PointViewPtr v)
     }
     std::vector<unsigned char> chunk = compressor.done();
     uint64_t location = m_manager.newChunk(k, (uint32_t)chunk.size(), (uint32_t)v->size());
-
-    std::ofstream out(b.filename, std::ios::out | std::ios::in | std::ios::binary);
-    out.seekp(std::ofstream::pos_type(location));
-    out.write(reinterpret_cast<const char *>(chunk.data()), chunk.size());
-    out.close();
-    if (!out)
-        throw pdal_error("Failure writing to '" + b.filename + "'.");
+    m_manager.writeChunk(location, std::move(chunk));
 }
 
 } // namespace copcwriter
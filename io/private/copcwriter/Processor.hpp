@@ -56,6 +56,7 @@ public:
     void run();
 
 private:
+    void loadSpilled();
     void sample();
     void write();
     bool acceptable(GridKey key);
@@ -65,6 +66,9 @@ private:
     const BaseInfo& b;
     PyramidManager& m_manager;
     las::LoaderDriver m_loader;
+    las::ExtraDims m_extraDims;
+    std::unique_ptr<PointTable> m_table;
+    DimTypeList m_spillDims;
 };
 
 } // namespace copcwriter
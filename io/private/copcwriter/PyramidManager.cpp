@@ -121,6 +121,13 @@ uint64_t PyramidManager::newChunk(const VoxelKey& key, uint32_t size, uint32_t c
     return m_output.newChunk(key, size, count);
 }
 
+// Called when a processor has a compressed chunk to write at the location returned
+// by newChunk().
+void PyramidManager::writeChunk(uint64_t location, std::vector<unsigned char>&& chunk)
+{
+    m_output.writeChunk(location, std::move(chunk));
+}
+
 // Take the item off the queue and stick it on the complete list. If we have all 8 octants,
 // remove the items from the complete list and queue a Processor job.
 void PyramidManager::process(const OctantInfo& o)
@@ -63,6 +63,7 @@ public:
     void queue(const OctantInfo& o);
     void run();
     uint64_t newChunk(const VoxelKey& key, uint32_t size, uint32_t count);
+    void writeChunk(uint64_t location, std::vector<unsigned char>&& chunk);
     uint64_t totalPoints() const
         { return m_totalPoints; }
 
@@ -45,6 +45,16 @@ namespace copcwriter
 
 Reprocessor::Reprocessor(CellManager& mgr, PointViewPtr srcView, Grid grid) :
     m_mgr(mgr), m_srcView(srcView), m_grid(grid)
+{
+    m_levels = levels(srcView->size());
+
+    // We're going to steal points from the leaf nodes for sampling, so unless the
+    // spatial distribution is really off, this should be fine and pretty conservative.
+
+    m_grid.resetLevel(m_grid.maxLevel() + m_levels);
+}
+
+int Reprocessor::levels(point_count_t numPoints)
 {
     // We make an assumption that at most twice the number of points will be in a cell
     // than there would be if the distribution was uniform, so we calculate based on
@@ -57,12 +67,7 @@ Reprocessor::Reprocessor(CellManager& mgr, PointViewPtr srcView, Grid grid) :
     //  =>
     // log2(numPoints / MaxPointsPerNode) = 2n
 
-    m_levels = (int)std::ceil(log2((double)srcView->size() / MaxPointsPerNode) / 2);
-
-    // We're going to steal points from the leaf nodes for sampling, so unless the
-    // spatial distribution is really off, this should be fine and pretty conservative.
-
-    m_grid.resetLevel(m_grid.maxLevel() + m_levels);
+    return (int)std::ceil(log2((double)numPoints / MaxPointsPerNode) / 2);
 }
 
 void Reprocessor::run()
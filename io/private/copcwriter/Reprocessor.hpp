@@ -52,6 +52,10 @@ public:
 
     void run();
 
+    // Number of levels below a cell needed to split 'numPoints' points into cells
+    // of reasonable size.
+    static int levels(point_count_t numPoints);
+
 private:
     int m_levels;
     CellManager& m_mgr;
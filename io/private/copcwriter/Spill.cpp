@@ -0,0 +1,516 @@
+/******************************************************************************
+* Copyright (c) 2024, Hobu Inc. (info@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+#include <pdal/PDALUtils.hpp>
+#include <pdal/PointView.hpp>
+#include <pdal/util/FileUtils.hpp>
+
+#include "Grid.hpp"
+#include "Spill.hpp"
+
+namespace pdal
+{
+namespace copcwriter
+{
+
+namespace
+{
+
+// Number of points read from a temporary file at once.
+const point_count_t BlockPoints = 65536;
+
+// Number of cell files kept open at once.
+const size_t MaxOpenFiles = 64;
+
+// Limit of the lattice cell index along an axis.
+const int64_t MaxLatticeIndex = 1 << 24;
+
+// Number of lattice cells above which the lattice is made coarser.
+const size_t MaxLatticeCells = 1 << 14;
+
+int64_t floorDiv(int64_t i, int64_t d)
+{
+    return i >= 0 ? i / d : -((-i + d - 1) / d);
+}
+
+} // unnamed namespace
+
+CellFiles::CellFiles(const BaseInfo& b) : b(b), m_buffered(0), m_count(0), m_binned(false),
+    m_cellSize(0), m_coarsenings(0)
+{
+    // The budget is specified in megabytes.
+    m_budget = (std::max)(b.opts.memoryBudget, (uint64_t)1) << 20;
+
+    const Dimension::Id posIds[] { Dimension::Id::X, Dimension::Id::Y, Dimension::Id::Z };
+
+    size_t offset = 0;
+    for (const DimType& dt : b.spillDims)
+    {
+        for (int i = 0; i < 3; ++i)
+            if (dt.m_id == posIds[i])
+            {
+                m_posOffsets[i] = offset;
+                m_posTypes[i] = dt.m_type;
+            }
+        offset += Dimension::size(dt.m_type);
+    }
+}
+
+
+CellFiles::~CellFiles()
+{
+    for (auto& kv : m_cells)
+    {
+        kv.second.out.reset();
+        for (const std::string& filename : kv.second.filenames)
+            FileUtils::deleteFile(filename);
+    }
+}
+
+
+void CellFiles::add(const char *buf)
+{
+    m_count++;
+    if (m_binned)
+    {
+        addToLattice(buf);
+        return;
+    }
+
+    m_pending.insert(m_pending.end(), buf, buf + b.spillPointSize);
+    m_pendingBounds.grow(position(buf, 0), position(buf, 1), position(buf, 2));
+    if (m_pending.size() >= m_budget)
+        bin(m_pendingBounds);
+}
+
+
+// Start the lattice from the bounds of the pending points and move the points to
+// their lattice cells. The lattice extends a little beyond the bounds and is four
+// times finer than the grid the pending points would be given, so that the final
+// grid can be fit closely to the bounds of all the points.
+void CellFiles::bin(const BOX3D& bounds)
+{
+    Grid grid(bounds, m_count);
+    double side = (std::max)(bounds.maxx - bounds.minx,
+        (std::max)(bounds.maxy - bounds.miny, bounds.maxz - bounds.minz));
+    if (!(side > 0))
+        side = 1;
+    const double margin = side / 16;
+    m_origin = { bounds.minx - margin, bounds.miny - margin, bounds.minz - margin };
+    m_cellSize = (side + 2 * margin) / std::pow(2, grid.maxLevel() + 2);
+    m_binned = true;
+
+    std::vector<char> pending;
+    pending.swap(m_pending);
+    for (size_t pos = 0; pos < pending.size(); pos += b.spillPointSize)
+        addToLattice(pending.data() + pos);
+}
+
+
+// Add a point to its lattice cell, first making the lattice coarser if the point is
+// outside of it or if the point would start a cell when there are too many.
+void CellFiles::addToLattice(const char *buf)
+{
+    VoxelKey key;
+    while (!latticeKey(buf, key) ||
+        (m_cells.size() >= MaxLatticeCells && m_cells.find(key) == m_cells.end()))
+        coarsen();
+    add(key, buf);
+}
+
+
+// Find the key of the lattice cell of a point. Returns false if the point is outside
+// of the lattice.
+bool CellFiles::latticeKey(const char *buf, VoxelKey& key) const
+{
+    int idx[3];
+    for (int i = 0; i < 3; ++i)
+    {
+        double d = std::floor((position(buf, i) - m_origin[i]) / m_cellSize);
+        if (std::abs(d) >= MaxLatticeIndex)
+            return false;
+        idx[i] = (int)d;
+    }
+    // Lattice cells have negative levels so their files are distinct from those of
+    // voxels. Each coarsening uses a new level so the files of a merged cell are
+    // distinct from those it had before.
+    key = VoxelKey(idx[0], idx[1], idx[2], -1 - m_coarsenings);
+    return true;
+}
+
+
+// Double the lattice cell size and merge each 2x2x2 group of cells. The origin
+// stays put, so each new cell covers exactly the cells merged into it.
+void CellFiles::coarsen()
+{
+    for (auto& kv : m_cells)
+        close(kv.second);
+
+    m_cellSize *= 2;
+    m_coarsenings++;
+
+    std::unordered_map<VoxelKey, Cell> cells;
+    for (auto& kv : m_cells)
+    {
+        const VoxelKey& k = kv.first;
+        VoxelKey key((int)floorDiv(k.x(), 2), (int)floorDiv(k.y(), 2),
+            (int)floorDiv(k.z(), 2), -1 - m_coarsenings);
+        Cell& cell = cells[key];
+        Cell& old = kv.second;
+        cell.count += old.count;
+        cell.filenames.insert(cell.filenames.end(), old.filenames.begin(),
+            old.filenames.end());
+        cell.buf.insert(cell.buf.end(), old.buf.begin(), old.buf.end());
+    }
+    m_cells.swap(cells);
+}
+
+
+void CellFiles::add(const VoxelKey& key, const char *buf)
+{
+    Cell& cell = m_cells[key];
+    cell.buf.insert(cell.buf.end(), buf, buf + b.spillPointSize);
+    cell.count++;
+    m_buffered += b.spillPointSize;
+    if (m_buffered >= m_budget)
+        flush();
+}
+
+
+void CellFiles::flush()
+{
+    for (auto& kv : m_cells)
+        flush(kv.first, kv.second);
+    m_buffered = 0;
+}
+
+
+void CellFiles::flush(const VoxelKey& key, Cell& cell)
+{
+    if (cell.buf.empty())
+        return;
+
+    if (cell.out)
+        m_open.splice(m_open.begin(), m_open, cell.openPos);
+    else
+    {
+        if (m_open.size() >= MaxOpenFiles)
+            close(m_cells[m_open.back()]);
+
+        std::string filename = spillFilename(b, key);
+        if (cell.filenames.empty() || cell.filenames.back() != filename)
+            cell.filenames.push_back(filename);
+        cell.out.reset(new std::ofstream(filename,
+            std::ios::out | std::ios::app | std::ios::binary));
+        m_open.push_front(key);
+        cell.openPos = m_open.begin();
+    }
+
+    cell.out->write(cell.buf.data(), cell.buf.size());
+    if (!*cell.out)
+        throw pdal_error("Failure writing temporary file '" + cell.filenames.back() + "'.");
+    m_buffered -= (std::min)(m_buffered, (uint64_t)cell.buf.size());
+
+    // Release the memory rather than just clearing the buffer.
+    std::vector<char>().swap(cell.buf);
+}
+
+
+void CellFiles::close(Cell& cell)
+{
+    if (!cell.out)
+        return;
+
+    cell.out->close();
+    bool ok = (bool)*cell.out;
+    cell.out.reset();
+    m_open.erase(cell.openPos);
+    if (!ok)
+        throw pdal_error("Failure writing temporary file '" + cell.filenames.back() + "'.");
+}
+
+
+double CellFiles::position(const char *buf, int dim) const
+{
+    Everything e;
+    memcpy(&e, buf + m_posOffsets[dim], Dimension::size(m_posTypes[dim]));
+    return Utils::toDouble(e, m_posTypes[dim]);
+}
+
+
+Grid CellFiles::finish(const BOX3D& bounds)
+{
+    Grid grid(bounds, m_count);
+
+    // If all the points fit in memory, they go right to the voxels of the grid.
+    if (!m_binned)
+    {
+        std::vector<char> pending;
+        pending.swap(m_pending);
+        for (size_t pos = 0; pos < pending.size(); pos += b.spillPointSize)
+        {
+            const char *p = pending.data() + pos;
+            add(grid.key(position(p, 0), position(p, 1), position(p, 2)), p);
+        }
+        return grid;
+    }
+
+    flush();
+    std::array<int64_t, 3> lo { MaxLatticeIndex, MaxLatticeIndex, MaxLatticeIndex };
+    std::array<int64_t, 3> hi { -MaxLatticeIndex, -MaxLatticeIndex, -MaxLatticeIndex };
+    for (auto& kv : m_cells)
+    {
+        close(kv.second);
+        const VoxelKey& k = kv.first;
+        lo = { (std::min)(lo[0], (int64_t)k.x()), (std::min)(lo[1], (int64_t)k.y()),
+            (std::min)(lo[2], (int64_t)k.z()) };
+        hi = { (std::max)(hi[0], (int64_t)k.x()), (std::max)(hi[1], (int64_t)k.y()),
+            (std::max)(hi[2], (int64_t)k.z()) };
+    }
+
+    // Find the smallest cube of whole lattice cells that contains the points and whose
+    // voxels are made of whole lattice cells. 'shift' is the number of levels of lattice
+    // cells in a voxel. Prefer the level the grid would be given for the bounds or the
+    // closest level to it.
+    auto fits = [&lo, &hi](int shift, int level)
+    {
+        for (int i = 0; i < 3; ++i)
+            if (floorDiv(hi[i], (int64_t)1 << shift) - floorDiv(lo[i], (int64_t)1 << shift) >=
+                    ((int64_t)1 << level))
+                return false;
+        return true;
+    };
+
+    int shift = 0;
+    int level = 0;
+    for (int size = 1; !level; ++size)
+        for (int l = 1; l <= size; ++l)
+            if (fits(size - l, l) && (!level ||
+                    std::abs(l - grid.maxLevel()) < std::abs(level - grid.maxLevel())))
+            {
+                shift = size - l;
+                level = l;
+            }
+
+    const double voxelSize = m_cellSize * std::pow(2, shift);
+    const double side = voxelSize * std::pow(2, level);
+    std::array<int64_t, 3> start;
+    for (int i = 0; i < 3; ++i)
+        start[i] = floorDiv(lo[i], (int64_t)1 << shift);
+    BOX3D cube(m_origin[0] + start[0] * voxelSize, m_origin[1] + start[1] * voxelSize,
+        m_origin[2] + start[2] * voxelSize, 0, 0, 0);
+    cube.maxx = cube.minx + side;
+    cube.maxy = cube.miny + side;
+    cube.maxz = cube.minz + side;
+
+    // The points are already in the files of their voxels.
+    std::unordered_map<VoxelKey, Cell> cells;
+    for (auto& kv : m_cells)
+    {
+        const VoxelKey& k = kv.first;
+        VoxelKey key((int)(floorDiv(k.x(), (int64_t)1 << shift) - start[0]),
+            (int)(floorDiv(k.y(), (int64_t)1 << shift) - start[1]),
+            (int)(floorDiv(k.z(), (int64_t)1 << shift) - start[2]), level);
+        Cell& cell = cells[key];
+        cell.count += kv.second.count;
+        cell.filenames.insert(cell.filenames.end(), kv.second.filenames.begin(),
+            kv.second.filenames.end());
+    }
+    m_cells.swap(cells);
+
+    return Grid(cube, bounds, level);
+}
+
+
+void CellFiles::distribute(const OctantInfo& source, Grid& grid)
+{
+    const size_t pointSize = b.spillPointSize;
+
+    std::vector<char> buf(BlockPoints * pointSize);
+    for (const std::string& filename : source.spillFiles())
+    {
+        std::ifstream in(filename, std::ios::in | std::ios::binary);
+        if (!in)
+            throw pdal_error("Unable to open temporary file '" + filename + "'.");
+
+        point_count_t remaining = FileUtils::fileSize(filename) / pointSize;
+        while (remaining)
+        {
+            point_count_t count = (std::min)(remaining, BlockPoints);
+            in.read(buf.data(), count * pointSize);
+            if (!in)
+                throw pdal_error("Failure reading temporary file '" + filename + "'.");
+
+            const char *pos = buf.data();
+            for (point_count_t i = 0; i < count; ++i)
+            {
+                VoxelKey key = grid.key(position(pos, 0), position(pos, 1), position(pos, 2));
+                add(key, pos);
+                pos += pointSize;
+            }
+            remaining -= count;
+        }
+        in.close();
+        FileUtils::deleteFile(filename);
+    }
+}
+
+
+std::vector<VoxelKey> CellFiles::largeCells(point_count_t count) const
+{
+    std::vector<VoxelKey> keys;
+    for (auto& kv : m_cells)
+        if (kv.second.count > count)
+            keys.push_back(kv.first);
+    return keys;
+}
+
+
+OctantInfo CellFiles::release(const VoxelKey& key)
+{
+    OctantInfo o(key);
+
+    auto it = m_cells.find(key);
+    if (it != m_cells.end())
+    {
+        Cell& cell = it->second;
+        flush(key, cell);
+        close(cell);
+        o.setSpill(cell.filenames, cell.count);
+        m_cells.erase(it);
+    }
+    return o;
+}
+
+
+std::vector<OctantInfo> CellFiles::releaseAll()
+{
+    std::vector<OctantInfo> octants;
+
+    flush();
+    for (auto& kv : m_cells)
+    {
+        close(kv.second);
+        OctantInfo o(kv.first);
+        o.setSpill(kv.second.filenames, kv.second.count);
+        octants.push_back(o);
+    }
+    m_cells.clear();
+    return octants;
+}
+
+
+std::string spillFilename(const BaseInfo& b, const VoxelKey& key)
+{
+    return FileUtils::toAbsolutePath(b.spillPrefix + "-" + key.toString() + ".tmp",
+        b.opts.tempDir);
+}
+
+
+void readSpill(const BaseInfo& b, OctantInfo& o, PointView& view, const DimTypeList& dims)
+{
+    const size_t pointSize = b.spillPointSize;
+
+    std::vector<char> buf(BlockPoints * pointSize);
+    PointId idx = view.size();
+    for (const std::string& filename : o.spillFiles())
+    {
+        std::ifstream in(filename, std::ios::in | std::ios::binary);
+        if (!in)
+            throw pdal_error("Unable to open temporary file '" + filename + "'.");
+
+        point_count_t remaining = FileUtils::fileSize(filename) / pointSize;
+        while (remaining)
+        {
+            point_count_t count = (std::min)(remaining, BlockPoints);
+            in.read(buf.data(), count * pointSize);
+            if (!in)
+                throw pdal_error("Failure reading temporary file '" + filename + "'.");
+
+            const char *pos = buf.data();
+            for (point_count_t i = 0; i < count; ++i)
+            {
+                view.setPackedPoint(dims, idx++, pos);
+                pos += pointSize;
+            }
+            remaining -= count;
+        }
+        in.close();
+        FileUtils::deleteFile(filename);
+    }
+    o.setSpill({}, 0);
+}
+
+
+void writeSpill(const BaseInfo& b, OctantInfo& o, const DimTypeList& dims)
+{
+    PointViewPtr& v = o.source();
+    if (!v)
+        return;
+    if (v->empty())
+    {
+        v.reset();
+        return;
+    }
+
+    const std::string filename = spillFilename(b, o.key());
+    const size_t pointSize = b.spillPointSize;
+
+    std::ofstream out(filename, std::ios::out | std::ios::trunc | std::ios::binary);
+    std::vector<char> buf(BlockPoints * pointSize);
+    PointId idx = 0;
+    while (idx < v->size())
+    {
+        point_count_t count = (std::min)(v->size() - idx, BlockPoints);
+        char *pos = buf.data();
+        for (point_count_t i = 0; i < count; ++i)
+        {
+            v->getPackedPoint(dims, idx++, pos);
+            pos += pointSize;
+        }
+        out.write(buf.data(), count * pointSize);
+    }
+    out.close();
+    if (!out)
+        throw pdal_error("Failure writing temporary file '" + filename + "'.");
+    o.setSpill({ filename }, v->size());
+    v.reset();
+}
+
+} // namespace copcwriter
+} // namespace pdal
@@ -0,0 +1,144 @@
+/******************************************************************************
+* Copyright (c) 2024, Hobu Inc. (info@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#pragma once
+
+#include <array>
+#include <fstream>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <pdal/util/Bounds.hpp>
+
+#include "Common.hpp"
+#include "Grid.hpp"
+#include "OctantInfo.hpp"
+#include "VoxelKey.hpp"
+
+namespace pdal
+{
+namespace copcwriter
+{
+
+// In stream mode, points are kept in temporary files, one or more per voxel.
+// Points are held in memory until they exceed the memory budget.  The bounds of
+// the held points then start a lattice of cells and from there on each point is
+// written straight to the file of its lattice cell.  When a point falls outside
+// the lattice or there are too many cells, the lattice cell size is doubled
+// and each 2x2x2 group of cells becomes one cell.  Once all points have
+// arrived, the lattice cells become the voxels of a grid aligned with the
+// lattice, so the points don't have to be written again.
+class CellFiles
+{
+public:
+    CellFiles(const BaseInfo& b);
+    ~CellFiles();
+
+    CellFiles(const CellFiles&) = delete;
+    CellFiles& operator=(const CellFiles&) = delete;
+
+    // Add a packed point as it arrives.
+    void add(const char *buf);
+    // Assign all points to the voxels of a grid that contains 'bounds', the
+    // bounds of the points, and return the grid.
+    Grid finish(const BOX3D& bounds);
+    // Distribute the points of a spilled octant to cells using the grid and
+    // remove the octant's files.
+    void distribute(const OctantInfo& source, Grid& grid);
+    // Keys of the cells that have more than 'count' points.
+    std::vector<VoxelKey> largeCells(point_count_t count) const;
+    // Remove a cell and return it as an octant that owns the cell's files.
+    OctantInfo release(const VoxelKey& key);
+    // Remove all cells and return them as octants.
+    std::vector<OctantInfo> releaseAll();
+
+private:
+    struct Cell
+    {
+        std::vector<std::string> filenames;
+        point_count_t count = 0;
+        std::vector<char> buf;
+        std::unique_ptr<std::ofstream> out;
+        std::list<VoxelKey>::iterator openPos;
+    };
+
+    void add(const VoxelKey& key, const char *buf);
+    void bin(const BOX3D& bounds);
+    void addToLattice(const char *buf);
+    bool latticeKey(const char *buf, VoxelKey& key) const;
+    void coarsen();
+    void flush();
+    void flush(const VoxelKey& key, Cell& cell);
+    void close(Cell& cell);
+    double position(const char *buf, int dim) const;
+
+    const BaseInfo& b;
+    std::unordered_map<VoxelKey, Cell> m_cells;
+    // Cells with an open file, most recently written first.
+    std::list<VoxelKey> m_open;
+    uint64_t m_budget;
+    uint64_t m_buffered;
+    std::array<size_t, 3> m_posOffsets;
+    std::array<Dimension::Type, 3> m_posTypes;
+
+    // Points that haven't been assigned to a cell and their bounds.
+    std::vector<char> m_pending;
+    BOX3D m_pendingBounds;
+    point_count_t m_count;
+
+    // Origin and cell size of the lattice, once started, and the number of
+    // times the cell size has been doubled.
+    bool m_binned;
+    std::array<double, 3> m_origin;
+    double m_cellSize;
+    int m_coarsenings;
+};
+
+// Name of the temporary file for a voxel.
+std::string spillFilename(const BaseInfo& b, const VoxelKey& key);
+
+// Read the points of a spilled octant into 'view', which must use the
+// dimensions 'dims', and remove the octant's files.
+void readSpill(const BaseInfo& b, OctantInfo& o, PointView& view,
+    const DimTypeList& dims);
+
+// Write the points of an octant to its temporary file and release
+// the octant's point view.
+void writeSpill(const BaseInfo& b, OctantInfo& o, const DimTypeList& dims);
+
+} // namespace copcwriter
+} // namespace pdal
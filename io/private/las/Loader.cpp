@@ -0,0 +1,304 @@
+/******************************************************************************
+ * Copyright (c) 2024, Hobu Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following
+ * conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided
+ *       with the distribution.
+ *     * Neither the name of Hobu, Inc. nor the
+ *       names of its contributors may be used to endorse or promote
+ *       products derived from this software without specific prior
+ *       written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ ****************************************************************************/
+
+#include <algorithm>
+#include <cstring>
+
+#include <pdal/PointLayout.hpp>
+#include <pdal/PointView.hpp>
+#include <pdal/util/portable_endian.hpp>
+#include <pdal/util/Utils.hpp>
+
+#include "Header.hpp"
+#include "Loader.hpp"
+
+namespace pdal
+{
+namespace las
+{
+
+Loader::Loader(const Header& h, const PointLayout& layout) : m_pointSize(h.pointSize)
+{
+    using Id = Dimension::Id;
+
+    add(layout, Id::X, Kind::Scaled, 0, 0, 0, h.scale.x, h.offset.x);
+    add(layout, Id::Y, Kind::Scaled, 4, 0, 0, h.scale.y, h.offset.y);
+    add(layout, Id::Z, Kind::Scaled, 8, 0, 0, h.scale.z, h.offset.z);
+    add(layout, Id::Intensity, Kind::Unsigned16, 12);
+
+    int colorOffset;
+    if (h.has14PointFormat())
+    {
+        add(layout, Id::ReturnNumber, Kind::Bits, 14, 0, 0x0F);
+        add(layout, Id::NumberOfReturns, Kind::Bits, 14, 4, 0x0F);
+        add(layout, Id::Synthetic, Kind::Bits, 15, 0, 0x01);
+        add(layout, Id::KeyPoint, Kind::Bits, 15, 1, 0x01);
+        add(layout, Id::Withheld, Kind::Bits, 15, 2, 0x01);
+        add(layout, Id::Overlap, Kind::Bits, 15, 3, 0x01);
+        add(layout, Id::ScanChannel, Kind::Bits, 15, 4, 0x03);
+        add(layout, Id::ScanDirectionFlag, Kind::Bits, 15, 6, 0x01);
+        add(layout, Id::EdgeOfFlightLine, Kind::Bits, 15, 7, 0x01);
+        add(layout, Id::Classification, Kind::Unsigned8, 16);
+        add(layout, Id::UserData, Kind::Unsigned8, 17);
+        add(layout, Id::ScanAngleRank, Kind::Scaled16, 18, 0, 0, .006);
+        add(layout, Id::PointSourceId, Kind::Unsigned16, 20);
+        add(layout, Id::GpsTime, Kind::Double, 22);
+        colorOffset = 30;
+    }
+    else
+    {
+        add(layout, Id::ReturnNumber, Kind::Bits, 14, 0, 0x07);
+        add(layout, Id::NumberOfReturns, Kind::Bits, 14, 3, 0x07);
+        add(layout, Id::ScanDirectionFlag, Kind::Bits, 14, 6, 0x01);
+        add(layout, Id::EdgeOfFlightLine, Kind::Bits, 14, 7, 0x01);
+        add(layout, Id::Classification, Kind::ClassV10, 15);
+        add(layout, Id::Synthetic, Kind::Bits, 15, 5, 0x01);
+        add(layout, Id::KeyPoint, Kind::Bits, 15, 6, 0x01);
+        add(layout, Id::Withheld, Kind::Bits, 15, 7, 0x01);
+        add(layout, Id::Overlap, Kind::OverlapV10, 15);
+        add(layout, Id::ScanAngleRank, Kind::Signed8, 16);
+        add(layout, Id::UserData, Kind::Unsigned8, 17);
+        add(layout, Id::PointSourceId, Kind::Unsigned16, 18);
+        colorOffset = 20;
+        if (h.hasTime())
+        {
+            add(layout, Id::GpsTime, Kind::Double, 20);
+            colorOffset += 8;
+        }
+    }
+
+    if (h.hasColor())
+    {
+        add(layout, Id::Red, Kind::Unsigned16, colorOffset);
+        add(layout, Id::Green, Kind::Unsigned16, colorOffset + 2);
+        add(layout, Id::Blue, Kind::Unsigned16, colorOffset + 4);
+    }
+    if (h.hasInfrared())
+        add(layout, Id::Infrared, Kind::Unsigned16, colorOffset + 6);
+}
+
+
+void Loader::add(const PointLayout& layout, Dimension::Id id, Kind kind, int srcOffset,
+    int shift, int mask, double scale, double offset)
+{
+    const Dimension::Detail *dd = layout.dimDetail(id);
+    if (!dd || dd->type() == Dimension::Type::None)
+        return;
+    m_fields.push_back({ id, kind, srcOffset, shift, mask, scale, offset, dd->type(),
+        (size_t)dd->offset() });
+}
+
+
+template<typename F>
+bool Loader::dispatch(Dimension::Type type, F f)
+{
+    switch (type)
+    {
+    case Dimension::Type::Unsigned8:
+        return f(uint8_t());
+    case Dimension::Type::Signed8:
+        return f(int8_t());
+    case Dimension::Type::Unsigned16:
+        return f(uint16_t());
+    case Dimension::Type::Signed16:
+        return f(int16_t());
+    case Dimension::Type::Unsigned32:
+        return f(uint32_t());
+    case Dimension::Type::Signed32:
+        return f(int32_t());
+    case Dimension::Type::Unsigned64:
+        return f(uint64_t());
+    case Dimension::Type::Signed64:
+        return f(int64_t());
+    case Dimension::Type::Float:
+        return f(float());
+    case Dimension::Type::Double:
+        return f(double());
+    case Dimension::Type::None:
+        break;
+    }
+    return true;
+}
+
+
+// Store the value buffer in the points' storage, converting to the type
+// of the dimension in the layout.  Values that can't be converted are left
+// unset, as with PointRef::setField().
+template<typename T>
+void Loader::store(const Field& f, point_count_t count, char * const *rows)
+{
+    const double *in = m_values.data();
+    for (point_count_t i = 0; i < count; ++i)
+    {
+        T v;
+        if (Utils::numericCast(in[i], v))
+            memcpy(rows[i] + f.dstOffset, &v, sizeof(T));
+    }
+}
+
+
+// Same as above, for points stored in columns.
+template<typename T>
+bool Loader::store(const Field& f, point_count_t count, PointView& view,
+    PointId first)
+{
+    std::vector<ColumnSpan<T>> spans = view.column<T>(f.id);
+    if (spans.empty())
+        return false;
+
+    const double *in = m_values.data();
+    const PointId last = first + count;
+    PointId spanFirst = 0;
+    for (const ColumnSpan<T>& span : spans)
+    {
+        const PointId spanLast = spanFirst + span.size;
+        for (PointId idx = (std::max)(first, spanFirst);
+                idx < (std::min)(last, spanLast); ++idx)
+        {
+            T v;
+            if (Utils::numericCast(in[idx - first], v))
+                span.data[idx - spanFirst] = v;
+        }
+        if (spanLast >= last)
+            break;
+        spanFirst = spanLast;
+    }
+    return true;
+}
+
+void Loader::load(const char *buf, point_count_t count, char * const *rows)
+{
+    m_values.resize(count);
+    for (const Field& f : m_fields)
+    {
+        decode(f, buf, count);
+        dispatch(f.type, [&](auto t)
+        {
+            store<decltype(t)>(f, count, rows);
+            return true;
+        });
+    }
+}
+
+
+bool Loader::load(const char *buf, point_count_t count, PointView& view,
+    PointId first)
+{
+    m_values.resize(count);
+    for (const Field& f : m_fields)
+    {
+        decode(f, buf, count);
+        // Column access depends only on the view and table, so if it fails,
+        // it fails for the first field.
+        if (!dispatch(f.type, [&](auto t)
+                { return store<decltype(t)>(f, count, view, first); }))
+            return false;
+    }
+    return true;
+}
+
+
+// Decode a field of 'count' points into the value buffer.
+void Loader::decode(const Field& f, const char *buf, point_count_t count)
+{
+    const char *pos = buf + f.srcOffset;
+    double *out = m_values.data();
+
+    switch (f.kind)
+    {
+    case Kind::Scaled:
+        for (point_count_t i = 0; i < count; ++i, pos += m_pointSize)
+        {
+            uint32_t v;
+            memcpy(&v, pos, sizeof(v));
+            out[i] = (int32_t)le32toh(v) * f.scale + f.offset;
+        }
+        break;
+    case Kind::Unsigned8:
+        for (point_count_t i = 0; i < count; ++i, pos += m_pointSize)
+            out[i] = *(const uint8_t *)pos;
+        break;
+    case Kind::Signed8:
+        for (point_count_t i = 0; i < count; ++i, pos += m_pointSize)
+            out[i] = *(const int8_t *)pos;
+        break;
+    case Kind::Unsigned16:
+        for (point_count_t i = 0; i < count; ++i, pos += m_pointSize)
+        {
+            uint16_t v;
+            memcpy(&v, pos, sizeof(v));
+            out[i] = le16toh(v);
+        }
+        break;
+    case Kind::Scaled16:
+        for (point_count_t i = 0; i < count; ++i, pos += m_pointSize)
+        {
+            uint16_t v;
+            memcpy(&v, pos, sizeof(v));
+            out[i] = (int16_t)le16toh(v) * f.scale;
+        }
+        break;
+    case Kind::Double:
+        for (point_count_t i = 0; i < count; ++i, pos += m_pointSize)
+        {
+            uint64_t v;
+            memcpy(&v, pos, sizeof(v));
+            v = le64toh(v);
+            memcpy(&out[i], &v, sizeof(v));
+        }
+        break;
+    case Kind::Bits:
+        for (point_count_t i = 0; i < count; ++i, pos += m_pointSize)
+            out[i] = (*(const uint8_t *)pos >> f.shift) & f.mask;
+        break;
+    // For V10 PDRFs, "Overlap" was encoded as Classification=12.  It's
+    // mapped to the Overlap flag and a classification of "Never Classified",
+    // as for the V14 PDRFs.
+    case Kind::ClassV10:
+        for (point_count_t i = 0; i < count; ++i, pos += m_pointSize)
+        {
+            uint8_t c = *(const uint8_t *)pos & 0x1F;
+            out[i] = (c == ClassLabel::LegacyOverlap) ?
+                ClassLabel::CreatedNeverClassified : c;
+        }
+        break;
+    case Kind::OverlapV10:
+        for (point_count_t i = 0; i < count; ++i, pos += m_pointSize)
+            out[i] = (*(const uint8_t *)pos & 0x1F) == ClassLabel::LegacyOverlap;
+        break;
+    }
+}
+
+} // namespace las
+} // namespace pdal
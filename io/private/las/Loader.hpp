@@ -0,0 +1,118 @@
+/******************************************************************************
+ * Copyright (c) 2024, Hobu Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following
+ * conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided
+ *       with the distribution.
+ *     * Neither the name of Hobu, Inc. nor the
+ *       names of its contributors may be used to endorse or promote
+ *       products derived from this software without specific prior
+ *       written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <vector>
+
+#include <pdal/Dimension.hpp>
+#include <pdal/pdal_types.hpp>
+
+namespace pdal
+{
+
+class PointLayout;
+class PointView;
+
+namespace las
+{
+
+struct Header;
+
+// Loads the standard fields of LAS point records into rows of a point table
+// or into the columns of a table that stores each dimension separately.
+// The location and type of each field in the LAS record and in the point
+// table is computed once, so loading a field for a set of points is a tight
+// loop rather than a dimension lookup and type conversion for each value.
+// Extra bytes aren't handled.
+class Loader
+{
+public:
+    Loader(const Header& header, const PointLayout& layout);
+
+    // Load 'count' points from 'buf' into the point storage in 'rows'.
+    void load(const char *buf, point_count_t count, char * const *rows);
+
+    // Load 'count' points from 'buf' into the points of 'view' starting
+    // at 'first'.  The points must exist.  Returns false, without loading
+    // anything, if the view's dimensions can't be accessed as columns.
+    bool load(const char *buf, point_count_t count, PointView& view,
+        PointId first);
+
+private:
+    enum class Kind
+    {
+        Scaled,
+        Unsigned8,
+        Signed8,
+        Unsigned16,
+        Scaled16,
+        Double,
+        Bits,
+        ClassV10,
+        OverlapV10
+    };
+
+    struct Field
+    {
+        Dimension::Id id;
+        Kind kind;
+        int srcOffset;
+        int shift;
+        int mask;
+        double scale;
+        double offset;
+        Dimension::Type type;
+        size_t dstOffset;
+    };
+
+    void add(const PointLayout& layout, Dimension::Id id, Kind kind, int srcOffset,
+        int shift = 0, int mask = 0, double scale = 1.0, double offset = 0.0);
+    void decode(const Field& f, const char *buf, point_count_t count);
+    template<typename T>
+    void store(const Field& f, point_count_t count, char * const *rows);
+    template<typename T>
+    bool store(const Field& f, point_count_t count, PointView& view,
+        PointId first);
+    // Call f(T()), where T is the C++ type of a dimension type.
+    template<typename F>
+    bool dispatch(Dimension::Type type, F f);
+
+    int m_pointSize;
+    std::vector<Field> m_fields;
+    std::vector<double> m_values;
+};
+
+} // namespace las
+} // namespace pdal
@@ -42,29 +42,42 @@ namespace las
 class Tile
 {
 public:
-    Tile(uint32_t chunk, uint32_t size) : m_chunk(chunk), m_data(size), m_pos(m_data.data())
+    // A tile that holds its data in its own buffer.
+    Tile(uint32_t chunk, uint32_t size) : m_chunk(chunk), m_buf(size),
+        m_begin(m_buf.data()), m_end(m_begin + size), m_pos(m_begin)
+    {}
+
+    // A tile that refers to data held elsewhere, like a mapped file.  The
+    // data must stay valid for the life of the tile.
+    Tile(uint32_t chunk, const char *data, size_t size) : m_chunk(chunk),
+        m_begin(data), m_end(data + size), m_pos(data)
     {}
 
     const char *data() const
-    { return m_data.data(); }
+    { return m_begin; }
+    // Only valid for a tile with its own buffer.
     char *data()
-    { return m_data.data(); }
+    { return m_buf.data(); }
     size_t size() const
-    { return m_data.size(); }
+    { return m_end - m_begin; }
     const char *pos() const
     { return m_pos; }
     uint32_t chunk() const
     { return m_chunk; }
+    size_t remaining() const
+    { return m_end - m_pos; }
     bool advance(int pointSize)
     {
         m_pos += pointSize;
-        return m_pos < m_data.data() + m_data.size();
+        return m_pos < m_end;
     }
 
 private:
     uint32_t m_chunk;
-    std::vector<char> m_data;
-    char *m_pos;
+    std::vector<char> m_buf;
+    const char *m_begin;
+    const char *m_end;
+    const char *m_pos;
 };
 using TilePtr = std::unique_ptr<Tile>;
 
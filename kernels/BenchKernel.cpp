@@ -0,0 +1,428 @@
+/******************************************************************************
+* Copyright (c) 2026, Hobu Inc. (info@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#include "BenchKernel.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <limits>
+#include <random>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#include <pdal/KDIndex.hpp>
+#include <pdal/PDALUtils.hpp>
+#include <pdal/pdal_config.hpp>
+#include <pdal/util/FileUtils.hpp>
+
+#include "../filters/StreamCallbackFilter.hpp"
+#include "../io/BufferReader.hpp"
+
+namespace pdal
+{
+
+static StaticPluginInfo const s_info
+{
+    "kernels.bench",
+    "Bench Kernel",
+    "http://pdal.io/apps/bench.html"
+};
+
+CREATE_STATIC_KERNEL(BenchKernel, s_info)
+
+std::string BenchKernel::getName() const { return s_info.name; }
+
+namespace
+{
+
+// Peak resident set size of the process in bytes, or 0 if it isn't known.
+uint64_t peakRss()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return counters.PeakWorkingSetSize;
+    return 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+#ifdef __APPLE__
+    return (uint64_t)usage.ru_maxrss;
+#else
+    return (uint64_t)usage.ru_maxrss * 1024;
+#endif
+#endif
+}
+
+} // unnamed namespace
+
+
+BenchKernel::BenchKernel() : m_count(0), m_repeat(0), m_list(false),
+    m_checksum(0)
+{}
+
+
+BenchKernel::~BenchKernel()
+{
+    for (const std::string& filename : m_written)
+        FileUtils::deleteFile(filename);
+}
+
+
+void BenchKernel::addSwitches(ProgramArgs& args)
+{
+    args.add("benchmarks,b", "Benchmarks to run.  All are run if none are "
+        "specified.", m_names).setPositional();
+    args.add("count,c", "Number of points in the synthesized point cloud",
+        m_count, point_count_t(1000000));
+    args.add("repeat,r", "Number of times each benchmark is run", m_repeat, 3);
+    args.add("output,o", "Output filename for JSON results.  Results are "
+        "written to standard output if not provided.", m_outputFile);
+    args.add("list", "List the available benchmarks", m_list);
+}
+
+
+void BenchKernel::validateSwitches(ProgramArgs& args)
+{
+    if (m_count == 0)
+        throw pdal_error("Option 'count' must be greater than 0.");
+    if (m_repeat < 1)
+        throw pdal_error("Option 'repeat' must be at least 1.");
+}
+
+
+// The catalog of benchmarks.  Benchmarks that read files write them
+// in their setup if necessary.
+std::vector<BenchKernel::Benchmark> BenchKernel::catalog()
+{
+    std::vector<Benchmark> benchmarks;
+
+    benchmarks.push_back({ "faux", "Create points with readers.faux",
+        nullptr,
+        [this]()
+        {
+            PipelineManager mgr;
+            Options opts;
+            opts.add("mode", "uniform");
+            opts.add("count", m_count);
+            mgr.makeReader("", "readers.faux", opts);
+            return mgr.execute();
+        }
+    });
+
+    benchmarks.push_back({ "faux_stream",
+        "Create points with readers.faux in stream mode",
+        nullptr,
+        [this]()
+        {
+            PipelineManager mgr;
+            Options opts;
+            opts.add("mode", "uniform");
+            opts.add("count", m_count);
+            Stage& reader = mgr.makeReader("", "readers.faux", opts);
+            mgr.makeWriter("", "writers.null", reader);
+            mgr.execute(ExecMode::Stream);
+            return m_count;
+        }
+    });
+
+    benchmarks.push_back({ "las_write", "Write an uncompressed LAS file",
+        nullptr,
+        [this]()
+        {
+            writeFile(m_lasFile, false);
+            return m_view->size();
+        }
+    });
+
+    benchmarks.push_back({ "laz_write", "Write a LAZ file",
+        nullptr,
+        [this]()
+        {
+            writeFile(m_lazFile, true);
+            return m_view->size();
+        }
+    });
+
+    benchmarks.push_back({ "las_read", "Read an uncompressed LAS file",
+        [this]()
+        {
+            if (!m_written.count(m_lasFile))
+                writeFile(m_lasFile, false);
+        },
+        [this]()
+        {
+            return readFile(m_lasFile, false);
+        }
+    });
+
+    benchmarks.push_back({ "las_read_stream",
+        "Read an uncompressed LAS file in stream mode",
+        [this]()
+        {
+            if (!m_written.count(m_lasFile))
+                writeFile(m_lasFile, false);
+        },
+        [this]()
+        {
+            return readFile(m_lasFile, true);
+        }
+    });
+
+    benchmarks.push_back({ "laz_read", "Read a LAZ file",
+        [this]()
+        {
+            if (!m_written.count(m_lazFile))
+                writeFile(m_lazFile, true);
+        },
+        [this]()
+        {
+            return readFile(m_lazFile, false);
+        }
+    });
+
+    benchmarks.push_back({ "kd3_build", "Build a 3D k-d tree", nullptr,
+        [this]()
+        {
+            KD3Index index(*m_view);
+            index.build();
+            return m_view->size();
+        }
+    });
+
+    benchmarks.push_back({ "kd3_knn",
+        "Find the eight nearest neighbors of each point",
+        [this]()
+        {
+            if (!m_index)
+            {
+                m_index.reset(new KD3Index(*m_view));
+                m_index->build();
+            }
+        },
+        [this]()
+        {
+            PointIdList indices(8);
+            std::vector<double> sqrDists(8);
+            for (PointId idx = 0; idx < m_view->size(); ++idx)
+            {
+                m_index->knnSearch(idx, 8, &indices, &sqrDists);
+                m_checksum += sqrDists.back();
+            }
+            return m_view->size();
+        }
+    });
+
+    benchmarks.push_back({ "expression",
+        "Filter points with filters.expression", nullptr,
+        [this]()
+        {
+            PipelineManager mgr;
+            BufferReader reader;
+            reader.addView(m_view);
+
+            Options opts;
+            opts.add("expression", "Z > 50 && ReturnNumber == 1");
+            Stage& filter = mgr.makeFilter("filters.expression", reader, opts);
+            filter.prepare(*m_table);
+            filter.execute(*m_table);
+            return m_view->size();
+        }
+    });
+
+    benchmarks.push_back({ "get_field",
+        "Read X, Y and Z of each point with PointView::getFieldAs()", nullptr,
+        [this]()
+        {
+            double sum = 0;
+            for (PointId idx = 0; idx < m_view->size(); ++idx)
+                sum += m_view->getFieldAs<double>(Dimension::Id::X, idx) +
+                    m_view->getFieldAs<double>(Dimension::Id::Y, idx) +
+                    m_view->getFieldAs<double>(Dimension::Id::Z, idx);
+            m_checksum += sum;
+            return m_view->size();
+        }
+    });
+
+    return benchmarks;
+}
+
+
+// Create the point cloud used by the benchmarks that don't read files.
+void BenchKernel::createView()
+{
+    Options opts;
+    opts.add("mode", "uniform");
+    opts.add("count", m_count);
+    opts.add("bounds", "([0, 1000], [0, 1000], [0, 100])");
+    opts.add("number_of_returns", 3);
+    opts.add("seed", 1);
+    Stage& reader = makeReader("", "readers.faux", opts);
+
+    m_table.reset(new PointTable);
+    reader.prepare(*m_table);
+    m_view = *reader.execute(*m_table).begin();
+}
+
+
+void BenchKernel::writeFile(const std::string& filename, bool compress)
+{
+    PipelineManager mgr;
+    BufferReader reader;
+    reader.addView(m_view);
+
+    Options opts;
+    opts.add("compression", compress);
+    Stage& writer = mgr.makeWriter(filename, "writers.las", reader, opts);
+    writer.prepare(*m_table);
+    writer.execute(*m_table);
+    m_written.insert(filename);
+}
+
+
+point_count_t BenchKernel::readFile(const std::string& filename, bool stream)
+{
+    PipelineManager mgr;
+    Stage& reader = mgr.makeReader(filename, "readers.las");
+    if (!stream)
+        return mgr.execute();
+
+    point_count_t count = 0;
+    StreamCallbackFilter f;
+    f.setCallback([&count](PointRef&)
+    {
+        count++;
+        return true;
+    });
+    f.setInput(reader);
+
+    FixedPointTable table(10000);
+    f.prepare(table);
+    f.execute(table);
+    return count;
+}
+
+
+MetadataNode BenchKernel::run(const Benchmark& bench)
+{
+    using Clock = std::chrono::steady_clock;
+
+    m_log->get(LogLevel::Info) << "Running benchmark '" << bench.name <<
+        "'." << std::endl;
+    if (bench.setup)
+        bench.setup();
+
+    point_count_t points = 0;
+    double best = (std::numeric_limits<double>::max)();
+    double total = 0;
+    for (int i = 0; i < m_repeat; ++i)
+    {
+        Clock::time_point start = Clock::now();
+        points = bench.run();
+        double seconds =
+            std::chrono::duration<double>(Clock::now() - start).count();
+        best = (std::min)(best, seconds);
+        total += seconds;
+    }
+
+    MetadataNode node("benchmarks");
+    node.add("name", bench.name);
+    node.add("description", bench.description);
+    node.add("points", points);
+    node.add("best_seconds", best);
+    node.add("mean_seconds", total / m_repeat);
+    node.add("points_per_second", best > 0 ? points / best : 0.0);
+    node.add("peak_rss", peakRss());
+    return node;
+}
+
+
+int BenchKernel::execute()
+{
+    std::vector<Benchmark> benchmarks = catalog();
+
+    if (m_list)
+    {
+        for (const Benchmark& bench : benchmarks)
+            std::cout << std::left << std::setw(18) << bench.name <<
+                bench.description << std::endl;
+        return 0;
+    }
+
+    for (const std::string& name : m_names)
+        if (std::none_of(benchmarks.begin(), benchmarks.end(),
+            [&name](const Benchmark& bench){ return bench.name == name; }))
+            throw pdal_error("Unknown benchmark '" + name + "'.  Use "
+                "--list to show the available benchmarks.");
+
+    // Concurrent runs mustn't share files.
+    const std::string stem = "pdal_bench-" +
+        std::to_string(std::random_device()());
+    m_lasFile = Utils::tempFilename(stem + ".las");
+    m_lazFile = Utils::tempFilename(stem + ".laz");
+    createView();
+
+    MetadataNode root;
+    root.add("pdal_version", Config::fullVersionString());
+    root.add("count", m_count);
+    root.add("repeat", m_repeat);
+    for (const Benchmark& bench : benchmarks)
+        if (m_names.empty() || std::find(m_names.begin(), m_names.end(),
+                bench.name) != m_names.end())
+            root.addList(run(bench));
+    // Peak memory use of the process over all the benchmarks.
+    root.add("peak_rss", peakRss());
+
+    if (m_outputFile.empty())
+        Utils::toJSON(root, std::cout);
+    else
+    {
+        std::ostream *out = Utils::createFile(m_outputFile, false);
+        if (!out)
+            throw pdal_error("Unable to open output file '" +
+                m_outputFile + "'.");
+        Utils::toJSON(root, *out);
+        Utils::closeFile(out);
+    }
+    return 0;
+}
+
+} // namespace pdal
@@ -0,0 +1,96 @@
+/******************************************************************************
+* Copyright (c) 2026, Hobu Inc. (info@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <set>
+#include <string>
+
+#include <pdal/Kernel.hpp>
+#include <pdal/PointTable.hpp>
+#include <pdal/PointView.hpp>
+
+namespace pdal
+{
+
+class KD3Index;
+
+class PDAL_EXPORT BenchKernel : public Kernel
+{
+public:
+    BenchKernel();
+    ~BenchKernel();
+
+    std::string getName() const;
+    int execute();
+
+private:
+    struct Benchmark
+    {
+        std::string name;
+        std::string description;
+        // Run before timing starts.  May be empty.
+        std::function<void()> setup;
+        // Run the benchmark and return the number of points processed.
+        std::function<point_count_t()> run;
+    };
+
+    virtual void addSwitches(ProgramArgs& args);
+    virtual void validateSwitches(ProgramArgs& args);
+
+    std::vector<Benchmark> catalog();
+    MetadataNode run(const Benchmark& bench);
+    void createView();
+    void writeFile(const std::string& filename, bool compress);
+    point_count_t readFile(const std::string& filename, bool stream);
+
+    point_count_t m_count;
+    int m_repeat;
+    StringList m_names;
+    bool m_list;
+    std::string m_outputFile;
+
+    std::unique_ptr<PointTable> m_table;
+    PointViewPtr m_view;
+    std::unique_ptr<KD3Index> m_index;
+    std::string m_lasFile;
+    std::string m_lazFile;
+    // Files written by this run.
+    std::set<std::string> m_written;
+    double m_checksum;
+};
+
+} // namespace pdal
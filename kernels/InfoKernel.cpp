@@ -141,6 +141,11 @@ void InfoKernel::validateSwitches(ProgramArgs& args)
         throw pdal_error("'enumerate' option requires 'stats' option.");
     if (!m_showStats && m_dimensions.size())
         throw pdal_error("'dimensions' option requires 'stats' option.");
+    if (!m_showStats && m_global.size())
+        throw pdal_error("'global' option requires 'stats' option.");
+    if (m_global.empty() && (m_quantiles.size() || m_sketch))
+        throw pdal_error("'quantiles' and 'sketch' options require "
+            "'global' option.");
 }
 
 
@@ -165,6 +170,12 @@ void InfoKernel::addSwitches(ProgramArgs& args)
         m_dimensions);
     args.add("enumerate", "Dimensions whose values should be enumerated",
         m_enumerate);
+    args.add("global", "Dimensions for which to compute median, mad and "
+        "quantiles", m_global);
+    args.add("quantiles", "Quantiles (0 - 1) to compute for global "
+        "dimensions", m_quantiles);
+    args.add("sketch", "Approximate global statistics in fixed memory",
+        m_sketch);
     args.add("schema", "Dump the schema", m_showSchema);
     args.add("pipeline-serialization", "Output filename for pipeline "
         "serialization", m_pipelineFile);
@@ -241,6 +252,12 @@ void InfoKernel::makePipeline()
             filterOptions.add({"dimensions", m_dimensions});
         if (m_enumerate.size())
             filterOptions.add({"enumerate", m_enumerate});
+        if (m_global.size())
+            filterOptions.add({"global", m_global});
+        if (m_quantiles.size())
+            filterOptions.add({"quantiles", m_quantiles});
+        if (m_sketch)
+            filterOptions.add({"sketch", true});
         stage = m_statsStage =
             &m_manager.makeFilter("filters.stats", *stage, filterOptions);
 
@@ -83,6 +83,9 @@ private:
     std::string m_pointIndexes;
     std::string m_dimensions;
     std::string m_enumerate;
+    std::string m_global;
+    std::string m_quantiles;
+    bool m_sketch;
     std::string m_queryPoint;
     std::string m_pipelineFile;
     std::string m_pcType;
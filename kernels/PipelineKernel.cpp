@@ -57,7 +57,8 @@ CREATE_STATIC_KERNEL(PipelineKernel, s_info)
 
 std::string PipelineKernel::getName() const { return s_info.name; }
 
-PipelineKernel::PipelineKernel() : m_validate(false), m_progressFd(-1)
+PipelineKernel::PipelineKernel() : m_validate(false), m_progressFd(-1),
+    m_threads(1)
 {}
 
 
@@ -77,6 +78,8 @@ void PipelineKernel::validateSwitches(ProgramArgs& args)
         m_mode = ExecMode::Standard;
     else
         m_mode = ExecMode::PreferStream;
+
+    m_manager.setThreads(m_threads);
 }
 
 
@@ -107,6 +110,8 @@ void PipelineKernel::addSwitches(ProgramArgs& args)
     args.add("nostream", "Run in standard mode.", m_noStream);
     args.add("metadata", "Metadata filename", m_metadataFile);
     args.add("dims", "Dimensions to be stored", m_dimNames);
+    args.add("threads", "Number of threads used to run independent "
+        "branches of the pipeline in standard mode", m_threads);
 }
 
 
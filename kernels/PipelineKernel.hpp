@@ -66,6 +66,7 @@ private:
     bool m_noStream;
     ExecMode m_mode;
     StringList m_dimNames;
+    int m_threads;
 };
 
 } // pdal
@@ -38,11 +38,7 @@ namespace pdal
 {
 
 ColumnPointTable::~ColumnPointTable()
-{
-    for (DimBlockList& l : m_blocks)
-        for (auto ptr : l)
-            delete [] ptr;
-}
+{}
 
 
 void ColumnPointTable::finalize()
@@ -52,23 +48,31 @@ void ColumnPointTable::finalize()
 }
 
 
+// Point IDs are handed out atomically so that points can be added from
+// multiple threads.  A lock is only taken when new blocks are needed.
 PointId ColumnPointTable::addPoint()
 {
-    if (m_numPts % m_blockPtCnt == 0)
+    PointId idx = m_numPts++;
+    if (m_blocks.empty())
+        return idx;
+
+    // finalize() orders the dimensions, so blocks are added to the lists
+    // in list order.  If the last list has the block, they all do.
+    const size_t block = idx / m_blockPtCnt;
+    if (block >= m_blocks.back().size())
     {
-        for (Dimension::Id id : m_layoutRef.dims())
-        {
-            const Dimension::Detail *detail = m_layoutRef.dimDetail(id);
-
-            // Make a block that holds m_blockPtCnt values of a dimension.
-            size_t size = m_blockPtCnt * Dimension::size(detail->type());
-            char *buf = new char[size];
-            memset(buf, 0, size);
-            DimBlockList& dimBlocks = m_blocks[detail->order()];
-            dimBlocks.push_back(buf);
-        }
+        std::lock_guard<std::mutex> lock(m_mutex);
+        while (block >= m_blocks.back().size())
+            for (Dimension::Id id : m_layoutRef.dims())
+            {
+                const Dimension::Detail *detail = m_layoutRef.dimDetail(id);
+
+                // Make a block that holds m_blockPtCnt values of a dimension.
+                size_t size = m_blockPtCnt * Dimension::size(detail->type());
+                m_blocks[detail->order()].add(size);
+            }
     }
-    return m_numPts++;
+    return idx;
 }
 
 namespace
@@ -158,6 +162,14 @@ char *ColumnPointTable::getDimension(const Dimension::Detail *d, PointId idx)
 }
 
 
+char *ColumnPointTable::getColumn(const Dimension::Detail *d, PointId idx,
+    point_count_t& count)
+{
+    count = m_blockPtCnt - (idx % m_blockPtCnt);
+    return getDimension(d, idx);
+}
+
+
 const char *ColumnPointTable::getDimension(const Dimension::Detail *d,
     PointId idx) const
 {
@@ -54,9 +54,14 @@ KD2Index::KD2Index(const PointView& buf) :
 KD2Index::~KD2Index()
 {}
 
-void KD2Index::build()
+void KD2Index::build(int threads)
 {
-    m_impl->build();
+    m_impl->build(threads);
+}
+
+size_t KD2Index::memoryUsed() const
+{
+    return m_impl->memoryUsed();
 }
 
 PointId KD2Index::neighbor(double x, double y) const
@@ -145,6 +150,39 @@ PointIdList KD2Index::radius(PointRef &point, double const& r) const
     return radius(x, y, r);
 }
 
+point_count_t KD2Index::knnSearch(const PointIdList& ids, point_count_t k,
+    PointIdList& indices, std::vector<double>& sqr_dists, int threads) const
+{
+    k = (std::min)((point_count_t)m_impl->kdtree_get_point_count(), k);
+    indices.resize(ids.size() * k);
+    sqr_dists.resize(ids.size() * k);
+    if (k == 0)
+        return 0;
+
+    parallelFor(ids.size(), threads, [&](size_t start, size_t end)
+    {
+        for (PointId i = start; i < end; ++i)
+        {
+            double x = m_buf.getFieldAs<double>(Dimension::Id::X, ids[i]);
+            double y = m_buf.getFieldAs<double>(Dimension::Id::Y, ids[i]);
+            m_impl->knnSearch(x, y, k, &indices[i * k], &sqr_dists[i * k]);
+        }
+    });
+    return k;
+}
+
+std::vector<PointIdList> KD2Index::radius(const PointIdList& ids,
+    double const& r, int threads) const
+{
+    std::vector<PointIdList> out(ids.size());
+    parallelFor(ids.size(), threads, [&](size_t start, size_t end)
+    {
+        for (PointId i = start; i < end; ++i)
+            out[i] = radius(ids[i], r);
+    });
+    return out;
+}
+
 //
 // KD3Index
 //
@@ -163,9 +201,14 @@ KD3Index::KD3Index(const PointView& buf) :
 KD3Index::~KD3Index()
 {}
 
-void KD3Index::build()
+void KD3Index::build(int threads)
 {
-    m_impl->build();
+    m_impl->build(threads);
+}
+
+size_t KD3Index::memoryUsed() const
+{
+    return m_impl->memoryUsed();
 }
 
 PointId KD3Index::neighbor(double x, double y, double z) const
@@ -261,6 +304,40 @@ PointIdList KD3Index::radius(PointRef &point, double r) const
     return radius(x, y, z, r);
 }
 
+point_count_t KD3Index::knnSearch(const PointIdList& ids, point_count_t k,
+    PointIdList& indices, std::vector<double>& sqr_dists, int threads) const
+{
+    k = (std::min)((point_count_t)m_impl->kdtree_get_point_count(), k);
+    indices.resize(ids.size() * k);
+    sqr_dists.resize(ids.size() * k);
+    if (k == 0)
+        return 0;
+
+    parallelFor(ids.size(), threads, [&](size_t start, size_t end)
+    {
+        for (PointId i = start; i < end; ++i)
+        {
+            double x = m_buf.getFieldAs<double>(Dimension::Id::X, ids[i]);
+            double y = m_buf.getFieldAs<double>(Dimension::Id::Y, ids[i]);
+            double z = m_buf.getFieldAs<double>(Dimension::Id::Z, ids[i]);
+            m_impl->knnSearch(x, y, z, k, &indices[i * k], &sqr_dists[i * k]);
+        }
+    });
+    return k;
+}
+
+std::vector<PointIdList> KD3Index::radius(const PointIdList& ids, double r,
+    int threads) const
+{
+    std::vector<PointIdList> out(ids.size());
+    parallelFor(ids.size(), threads, [&](size_t start, size_t end)
+    {
+        for (PointId i = start; i < end; ++i)
+            out[i] = radius(ids[i], r);
+    });
+    return out;
+}
+
 //
 // KDFlexIndex
 //
@@ -272,9 +349,14 @@ KDFlexIndex::KDFlexIndex(const PointView& buf, const Dimension::IdList& dims) :
 KDFlexIndex::~KDFlexIndex()
 {}
 
-void KDFlexIndex::build()
+void KDFlexIndex::build(int threads)
+{
+    m_impl->build(threads);
+}
+
+size_t KDFlexIndex::memoryUsed() const
 {
-    m_impl->build();
+    return m_impl->memoryUsed();
 }
 
 PointId KDFlexIndex::neighbor(PointRef &point) const
@@ -49,7 +49,9 @@ public:
     KD2Index(const PointView& buf);
     ~KD2Index();
 
-    void build();
+    void build(int threads = 1);
+    // Bytes used by the index, including its copy of the point coordinates.
+    size_t memoryUsed() const;
     PointId neighbor(double x, double y) const;
     PointId neighbor(PointId idx) const;
     PointId neighbor(PointRef &point) const;
@@ -67,6 +69,16 @@ public:
     PointIdList radius(PointId idx, double const& r) const;
     PointIdList radius(PointRef &point, double const& r) const;
 
+    // Batch queries, run with up to 'threads' threads.  The k nearest
+    // neighbors of ids[i] are placed at [i * k, (i + 1) * k) of 'indices'
+    // and 'sqr_dists'.  Returns k, which is reduced to the number of
+    // indexed points if necessary.
+    point_count_t knnSearch(const PointIdList& ids, point_count_t k,
+        PointIdList& indices, std::vector<double>& sqr_dists,
+        int threads = 1) const;
+    std::vector<PointIdList> radius(const PointIdList& ids, double const& r,
+        int threads = 1) const;
+
 private:
     const PointView& m_buf;
     std::unique_ptr<KD2Impl> m_impl;
@@ -78,7 +90,8 @@ public:
     KD3Index(const PointView& buf);
     ~KD3Index();
 
-    void build();
+    void build(int threads = 1);
+    size_t memoryUsed() const;
     PointId neighbor(double x, double y, double z) const;
     PointId neighbor(PointId idx) const;
     PointId neighbor(PointRef &point) const;
@@ -98,6 +111,13 @@ public:
     PointIdList radius(PointId idx, double r) const;
     PointIdList radius(PointRef &point, double r) const;
 
+    // See KD2Index.
+    point_count_t knnSearch(const PointIdList& ids, point_count_t k,
+        PointIdList& indices, std::vector<double>& sqr_dists,
+        int threads = 1) const;
+    std::vector<PointIdList> radius(const PointIdList& ids, double r,
+        int threads = 1) const;
+
 private:
     const PointView& m_buf;
     std::unique_ptr<KD3Impl> m_impl;
@@ -109,7 +129,8 @@ public:
     KDFlexIndex(const PointView& buf, const Dimension::IdList& dims);
     ~KDFlexIndex();
 
-    void build();
+    void build(int threads = 1);
+    size_t memoryUsed() const;
     PointId neighbor(PointRef &point) const;
     PointIdList neighbors(PointRef &point, point_count_t k, size_t stride = 1) const;
     PointIdList radius(PointId idx, double r) const;
@@ -60,7 +60,8 @@ Log::Log(std::string const& leaderString, std::string const& outputName,
         m_log = Utils::createFile(outputName);
         m_deleteStreamOnCleanup = true;
     }
-    m_leaders.push(leaderString);
+    m_rootLeader = leaderString;
+    pushLeader(leaderString);
     if (m_timing)
         m_start = m_clock.now();
 }
@@ -72,7 +73,8 @@ Log::Log(std::string const& leaderString, std::ostream* v, bool timing)
     , m_timing(timing)
 {
     m_log = v;
-    m_leaders.push(leaderString);
+    m_rootLeader = leaderString;
+    pushLeader(leaderString);
     if (m_timing)
         m_start = m_clock.now();
 }
@@ -101,6 +103,54 @@ Log::~Log()
 }
 
 
+void Log::pushLeader(const std::string& leader)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_leaders[std::this_thread::get_id()].push(leader);
+}
+
+
+std::string Log::leader() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_leaders.find(std::this_thread::get_id());
+    return it == m_leaders.end() ? m_rootLeader : it->second.top();
+}
+
+
+void Log::popLeader()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_leaders.find(std::this_thread::get_id());
+    if (it == m_leaders.end())
+        return;
+    it->second.pop();
+    if (it->second.empty())
+        m_leaders.erase(it);
+}
+
+
+void Log::startBuffer()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto& buf = m_buffers[std::this_thread::get_id()];
+    if (!buf)
+        buf.reset(new std::ostringstream);
+}
+
+
+void Log::flushBuffer()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_buffers.find(std::this_thread::get_id());
+    if (it == m_buffers.end())
+        return;
+    *m_log << it->second->str();
+    m_log->flush();
+    m_buffers.erase(it);
+}
+
+
 void Log::floatPrecision(int level)
 {
     m_log->setf(std::ios_base::fixed, std::ios_base::floatfield);
@@ -124,16 +174,26 @@ std::ostream& Log::get(LogLevel level)
     {
         const std::string l = leader();
 
-        *m_log << "(" << l;
+        // Only the calling thread uses its buffer, so it can be written
+        // without the lock.
+        std::ostream *out = m_log;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_buffers.find(std::this_thread::get_id());
+            if (it != m_buffers.end())
+                out = it->second.get();
+        }
+
+        *out << "(" << l;
          if (l.size())
-             *m_log << " ";
-         *m_log << getLevelString(level);
+             *out << " ";
+         *out << getLevelString(level);
          if (m_timing)
-             *m_log << " " << now();
-         *m_log <<") " <<
+             *out << " " << now();
+         *out <<") " <<
          std::string(incoming < nativeDebug ? 0 : incoming - nativeDebug,
              '\t');
-        return *m_log;
+        return *out;
     }
     return m_nullStream;
 }
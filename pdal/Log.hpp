@@ -35,9 +35,13 @@
 #pragma once
 
 #include <cassert>
+#include <map>
 #include <memory> // shared_ptr
+#include <mutex>
+#include <sstream>
 #include <stack>
 #include <chrono>
+#include <thread>
 
 #include <pdal/pdal_internal.hpp>
 #include <pdal/util/NullOStream.hpp>
@@ -104,22 +108,17 @@ public:
     void setLeader(const std::string& leader)
         { pushLeader(leader); }
 
-    /// Push the leader string onto the stack.
+    /// Push the leader string onto the calling thread's stack.
     /// \param  leader  Leader string
-    void pushLeader(const std::string& leader)
-        { m_leaders.push(leader); }
+    void pushLeader(const std::string& leader);
 
-    /// Get the leader string.
+    /// Get the leader string of the calling thread.  Threads that haven't
+    /// pushed a leader get the leader the log was created with.
     /// \return  The current leader string.
-    std::string leader() const
-        { return m_leaders.empty() ? std::string() : m_leaders.top(); }
+    std::string leader() const;
 
-    /// Pop the current leader string.
-    void popLeader()
-    {
-        if (!m_leaders.empty())
-            m_leaders.pop();
-    }
+    /// Pop the calling thread's current leader string.
+    void popLeader();
 
     /// @return A string representing the LogLevel
     std::string getLevelString(LogLevel v) const;
@@ -139,6 +138,15 @@ public:
     /// pdal::Log::get is less than the logging level of the pdal::Log instance
     std::ostream& get(LogLevel level = LogLevel::Info);
 
+    /// Hold log output written by the calling thread in a buffer until
+    /// flushBuffer() is called.  Threads that log concurrently through the
+    /// same log should buffer so that their output isn't interleaved.
+    void startBuffer();
+
+    /// Write output buffered by the calling thread to the log stream and
+    /// stop buffering.
+    void flushBuffer();
+
     /// Sets the floating point precision
     void floatPrecision(int level);
 
@@ -155,7 +163,13 @@ private:
 
     LogLevel m_level;
     bool m_deleteStreamOnCleanup;
-    std::stack<std::string> m_leaders;
+    // Leader stacks and output buffers are kept per-thread so that stages
+    // running concurrently don't disturb each other.
+    using LeaderStack = std::stack<std::string>;
+    std::map<std::thread::id, LeaderStack> m_leaders;
+    std::map<std::thread::id, std::unique_ptr<std::ostringstream>> m_buffers;
+    std::string m_rootLeader;
+    mutable std::mutex m_mutex;
     NullOStream m_nullStream;
     bool m_timing;
     std::chrono::steady_clock m_clock;
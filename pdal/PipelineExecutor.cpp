@@ -140,6 +140,18 @@ int PipelineExecutor::getLogLevel() const
 }
 
 
+void PipelineExecutor::setThreads(int threads)
+{
+    m_manager.setThreads(threads);
+}
+
+
+int PipelineExecutor::getThreads() const
+{
+    return m_manager.threads();
+}
+
+
 std::string PipelineExecutor::getLog() const
 {
     return m_logStream.str();
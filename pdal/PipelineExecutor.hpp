@@ -113,6 +113,17 @@ public:
     */
     int getLogLevel() const;
 
+    /**
+      Set the number of threads used to run independent branches of the
+      pipeline concurrently.
+    */
+    void setThreads(int threads);
+
+    /**
+      \return number of threads used to run the pipeline
+    */
+    int getThreads() const;
+
     /**
       \return has the pipeline been executed
     */
@@ -50,7 +50,7 @@ PipelineManager::PipelineManager(point_count_t streamLimit) :
     m_tablePtr(new ColumnPointTable()), m_table(*m_tablePtr),
     m_streamTablePtr(new FixedPointTable(streamLimit)),
     m_streamTable(*m_streamTablePtr),
-    m_progressFd(-1), m_input(nullptr)
+    m_progressFd(-1), m_threads(1), m_input(nullptr)
 {}
 
 
@@ -60,6 +60,14 @@ PipelineManager::~PipelineManager()
 }
 
 
+void PipelineManager::setThreads(int threads)
+{
+    if (threads < 1)
+        throw pdal_error("Number of threads must be at least 1.");
+    m_threads = threads;
+}
+
+
 void PipelineManager::readPipeline(std::istream& input)
 {
     std::istreambuf_iterator<char> eos;
@@ -270,7 +278,7 @@ PipelineManager::ExecResult PipelineManager::execute(ExecMode mode)
     else if (mode == ExecMode::Standard)
     {
         s->prepare(m_table);
-        m_viewSet = s->execute(m_table);
+        m_viewSet = s->execute(m_table, m_threads);
         point_count_t cnt = 0;
         for (auto pi = m_viewSet.begin(); pi != m_viewSet.end(); ++pi)
         {
@@ -90,6 +90,13 @@ public:
     void setProgressFd(int fd)
         { m_progressFd = fd; }
 
+    // Set the number of threads used to run independent branches of a
+    // pipeline concurrently in standard mode.  Throws if 'threads' is
+    // less than 1.
+    void setThreads(int threads);
+    int threads() const
+        { return m_threads; }
+
     void readPipeline(std::istream& input);
     void readPipeline(const std::string& filename);
 
@@ -180,6 +187,7 @@ private:
     PointViewSet m_viewSet;
     std::vector<Stage*> m_stages; // stage observer, never owner
     int m_progressFd;
+    int m_threads;
     std::istream *m_input;
     LogPtr m_log;
 
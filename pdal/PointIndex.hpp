@@ -0,0 +1,153 @@
+/******************************************************************************
+* Copyright (c) 2026, Hobu Inc. (info@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#pragma once
+
+#include <stdexcept>
+#include <vector>
+
+#include <pdal/pdal_types.hpp>
+
+namespace pdal
+{
+
+/**
+  Map from point view positions to point table positions.
+
+  Most views refer to a contiguous range of the point table, so the index
+  is stored as a start and count until a point is added out of order or
+  an entry is changed.  From then on the table positions are stored in a
+  vector.
+*/
+class PointIndex
+{
+public:
+    PointIndex() : m_start(0), m_size(0), m_flat(false)
+    {}
+
+    point_count_t size() const
+        { return m_size; }
+    bool empty() const
+        { return m_size == 0; }
+
+    /// \return  Whether the index is stored as a single range.
+    bool contiguous() const
+        { return !m_flat; }
+
+    /// \return  First table position when the index is a single range.
+    PointId start() const
+        { return m_start; }
+
+    PointId operator[](PointId idx) const
+        { return m_flat ? m_ids[idx] : m_start + idx; }
+
+    PointId at(PointId idx) const
+    {
+        if (idx >= m_size)
+            throw std::out_of_range("Invalid point index.");
+        return (*this)[idx];
+    }
+
+    void push_back(PointId tableId)
+    {
+        if (m_flat)
+            m_ids.push_back(tableId);
+        else if (m_size == 0)
+            m_start = tableId;
+        else if (tableId != m_start + m_size)
+        {
+            flatten();
+            m_ids.push_back(tableId);
+        }
+        m_size++;
+    }
+
+    void set(PointId idx, PointId tableId)
+    {
+        if (m_flat)
+            m_ids[idx] = tableId;
+        else if (tableId != m_start + idx)
+        {
+            flatten();
+            m_ids[idx] = tableId;
+        }
+    }
+
+    void swap(PointId idx1, PointId idx2)
+    {
+        if (idx1 == idx2)
+            return;
+        flatten();
+        std::swap(m_ids[idx1], m_ids[idx2]);
+    }
+
+    /// Append the first 'count' entries of another index.
+    void append(const PointIndex& other, point_count_t count)
+    {
+        if (count == 0)
+            return;
+        if (!m_flat && !other.m_flat &&
+            (m_size == 0 || other.m_start == m_start + m_size))
+        {
+            if (m_size == 0)
+                m_start = other.m_start;
+            m_size += count;
+            return;
+        }
+
+        flatten();
+        m_ids.reserve(m_size + count);
+        for (PointId idx = 0; idx < count; ++idx)
+            m_ids.push_back(other[idx]);
+        m_size += count;
+    }
+
+private:
+    void flatten()
+    {
+        if (m_flat)
+            return;
+        m_ids.reserve(m_size + 1);
+        for (PointId idx = 0; idx < m_size; ++idx)
+            m_ids.push_back(m_start + idx);
+        m_flat = true;
+    }
+
+    PointId m_start;
+    point_count_t m_size;
+    bool m_flat;
+    std::vector<PointId> m_ids;
+};
+
+} // namespace pdal
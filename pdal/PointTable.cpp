@@ -97,22 +97,55 @@ void SimplePointTable::getFieldInternal(Dimension::Id id, PointId idx, void *val
 }
 
 
-RowPointTable::~RowPointTable()
+PointBlockList::PointBlockList(PointBlockList&& other) noexcept :
+    m_pages(std::move(other.m_pages)), m_size(other.m_size.load())
 {
-    for (auto vi = m_blocks.begin(); vi != m_blocks.end(); ++vi)
-        delete [] *vi;
+    other.m_size = 0;
 }
 
+
+PointBlockList::~PointBlockList()
+{
+    size_t cnt = size();
+    for (size_t i = 0; i < cnt; ++i)
+        delete [] (*this)[i];
+}
+
+
+void PointBlockList::add(size_t bytes)
+{
+    size_t i = m_size.load(std::memory_order_relaxed);
+    size_t page = i >> PageBits;
+    if (page >= MaxPages)
+        throw pdal_error("Point table capacity exceeded.");
+    if (!m_pages[page])
+        m_pages[page].reset(new char *[PageSize]);
+
+    char *buf = new char[bytes];
+    memset(buf, 0, bytes);
+    m_pages[page][i & PageMask] = buf;
+
+    // Publish the block only after it has been initialized.
+    m_size.store(i + 1, std::memory_order_release);
+}
+
+
+RowPointTable::~RowPointTable()
+{}
+
+// Point IDs are handed out atomically so that points can be added from
+// multiple threads.  A lock is only taken when a new block is needed.
 PointId RowPointTable::addPoint()
 {
-    if (m_numPts % m_blockPtCnt == 0)
+    PointId idx = m_numPts++;
+    const size_t block = idx / m_blockPtCnt;
+    if (block >= m_blocks.size())
     {
-        size_t size = pointsToBytes(m_blockPtCnt);
-        char *buf = new char[size];
-        memset(buf, 0, size);
-        m_blocks.push_back(buf);
+        std::lock_guard<std::mutex> lock(m_mutex);
+        while (block >= m_blocks.size())
+            m_blocks.add(pointsToBytes(m_blockPtCnt));
     }
-    return m_numPts++;
+    return idx;
 }
 
 
@@ -35,7 +35,11 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <list>
+#include <memory>
+#include <mutex>
 #include <vector>
 
 #include "pdal/SpatialReference.hpp"
@@ -102,6 +106,14 @@ private:
     virtual void setFieldInternal(Dimension::Id dim, PointId idx, const void *val) = 0;
     virtual void getFieldInternal(Dimension::Id dim, PointId idx, void *val) const = 0;
 
+    // Get a pointer to the value of a dimension for a point when the table
+    // stores each dimension in its own memory.  'count' is set to the number
+    // of values, starting with this one, that are contiguous in memory.
+    // Tables that don't store dimensions separately return nullptr.
+    virtual char *getColumn(const Dimension::Detail *d, PointId idx,
+            point_count_t& count)
+        { return nullptr; }
+
 protected:
     virtual char *getPoint(PointId idx) = 0;
 
@@ -139,14 +151,48 @@ private:
     }
 };
 
+// List of equal-sized memory blocks used to hold point data.  Blocks are
+// located through a two-level directory so that adding a block never moves
+// an existing directory entry.  This allows points to be added to a table
+// by one thread while other threads access existing points.
+class PDAL_EXPORT PointBlockList
+{
+public:
+    PointBlockList() : m_size(0)
+    {}
+    PointBlockList(PointBlockList&& other) noexcept;
+    ~PointBlockList();
+
+    PointBlockList(const PointBlockList&) = delete;
+    PointBlockList& operator=(const PointBlockList&) = delete;
+
+    char *operator[](size_t i) const
+        { return m_pages[i >> PageBits][i & PageMask]; }
+    size_t size() const
+        { return m_size.load(std::memory_order_acquire); }
+
+    // Add a zero-filled block.  Calls must be serialized by the caller.
+    void add(size_t bytes);
+
+private:
+    static const size_t PageBits = 10;
+    static const size_t PageSize = (size_t)1 << PageBits;
+    static const size_t PageMask = PageSize - 1;
+    static const size_t MaxPages = 2048;
+
+    std::array<std::unique_ptr<char *[]>, MaxPages> m_pages;
+    std::atomic<size_t> m_size;
+};
+
 // This provides a context for processing a set of points and allows the library
 // to be used to process multiple point sets simultaneously.
 class PDAL_EXPORT RowPointTable : public SimplePointTable
 {
 private:
     // Point storage.
-    std::vector<char *> m_blocks;
-    point_count_t m_numPts;
+    PointBlockList m_blocks;
+    std::atomic<point_count_t> m_numPts;
+    std::mutex m_mutex;
 
     // Make sure this is power-of-2 to facilitate fast div and mod ops.
     static const point_count_t m_blockPtCnt = 65536;
@@ -175,12 +221,13 @@ class PDAL_EXPORT ColumnPointTable : public SimplePointTable
 {
 private:
     // Point storage.
-    using DimBlockList = std::vector<char *>;
+    using DimBlockList = PointBlockList;
     using MemBlocks = std::vector<DimBlockList>;
 
     // List of dimension memory block lists.
     MemBlocks m_blocks;
-    point_count_t m_numPts;
+    std::atomic<point_count_t> m_numPts;
+    std::mutex m_mutex;
 
     // Make sure this is power-of-2 to facilitate fast div and mod ops.
     static const point_count_t m_blockPtCnt = 16384;
@@ -200,6 +247,8 @@ private:
     void getFieldInternal(Dimension::Id id, PointId idx, void *value) const override;
 
     PointId addPoint() override;
+    char *getColumn(const Dimension::Detail *d, PointId idx,
+        point_count_t& count) override;
 
     // Hide base class calls for now.
     const char *getDimension(const Dimension::Detail *d, PointId idx) const;
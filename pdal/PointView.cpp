@@ -44,7 +44,7 @@
 namespace pdal
 {
 
-int PointView::m_lastId = 0;
+std::atomic<int> PointView::m_lastId(0);
 
 PointView::PointView(PointTableRef pointTable) : m_pointTable(pointTable),
     m_layout(pointTable.layout()), m_size(0), m_id(0)
@@ -82,6 +82,16 @@ PointId PointView::addPoint()
 
 void PointView::calculateBounds(BOX2D& output) const
 {
+    auto xs = column<const double>(Dimension::Id::X);
+    auto ys = column<const double>(Dimension::Id::Y);
+    if (xs.size() && ys.size())
+    {
+        for (size_t span = 0; span < xs.size(); ++span)
+            for (point_count_t i = 0; i < xs[span].size; ++i)
+                output.grow(xs[span].data[i], ys[span].data[i]);
+        return;
+    }
+
     for (PointId idx = 0; idx < size(); idx++)
     {
         double x = getFieldAs<double>(Dimension::Id::X, idx);
@@ -94,6 +104,18 @@ void PointView::calculateBounds(BOX2D& output) const
 
 void PointView::calculateBounds(BOX3D& output) const
 {
+    auto xs = column<const double>(Dimension::Id::X);
+    auto ys = column<const double>(Dimension::Id::Y);
+    auto zs = column<const double>(Dimension::Id::Z);
+    if (xs.size() && ys.size() && zs.size())
+    {
+        for (size_t span = 0; span < xs.size(); ++span)
+            for (point_count_t i = 0; i < xs[span].size; ++i)
+                output.grow(xs[span].data[i], ys[span].data[i],
+                    zs[span].data[i]);
+        return;
+    }
+
     for (PointId idx = 0; idx < size(); idx++)
     {
         double x = getFieldAs<double>(Dimension::Id::X, idx);
@@ -179,7 +201,7 @@ void PointView::invalidateProducts()
 }
 
 
-KD3Index& PointView::build3dIndex()
+KD3Index& PointView::build3dIndex(int threads)
 {
     //ABELL
     // Should we allow a force of point view build - perhaps the index has
@@ -187,13 +209,13 @@ KD3Index& PointView::build3dIndex()
     if (!m_index3)
     {
         m_index3.reset(new KD3Index(*this));
-        m_index3->build();
+        m_index3->build(threads);
     }
     return *m_index3.get();
 }
 
 
-KD2Index& PointView::build2dIndex()
+KD2Index& PointView::build2dIndex(int threads)
 {
     //ABELL
     // Should we allow a force of point view build - perhaps the index has
@@ -201,7 +223,7 @@ KD2Index& PointView::build2dIndex()
     if (!m_index2)
     {
         m_index2.reset(new KD2Index(*this));
-        m_index2->build();
+        m_index2->build(threads);
     }
     return *m_index2.get();
 }
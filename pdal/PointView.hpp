@@ -37,14 +37,17 @@
 #include <pdal/DimDetail.hpp>
 #include <pdal/DimType.hpp>
 #include <pdal/Mesh.hpp>
+#include <pdal/PointIndex.hpp>
 #include <pdal/PointLayout.hpp>
 #include <pdal/PointTable.hpp>
 #include <pdal/PointRef.hpp>
 
+#include <atomic>
 #include <memory>
 #include <queue>
 #include <set>
-#include <deque>
+#include <type_traits>
+#include <vector>
 
 namespace pdal
 {
@@ -61,6 +64,21 @@ struct RasterLimits;
 template <class T> class Raster;
 using Rasterd = Raster<double>;
 
+/**
+  Consecutive values of a dimension for points of a point view.
+*/
+template<typename T>
+struct ColumnSpan
+{
+    T *data;
+    point_count_t size;
+
+    T *begin() const
+        { return data; }
+    T *end() const
+        { return data + size; }
+};
+
 typedef std::shared_ptr<PointView> PointViewPtr;
 typedef std::set<PointViewPtr, PointViewLess> PointViewSet;
 
@@ -93,12 +111,7 @@ public:
     inline void appendPoint(const PointView& buffer, PointId id);
     void append(const PointView& buf)
     {
-        // We use size() instead of the index end because temp points might have been
-        // placed at the end of the buffer. Those temp points on this view are discarded,
-        // as are any on the temp list.
-        auto thisEnd = m_index.begin() + size();
-        auto bufEnd = buf.m_index.begin() + buf.size();
-        m_index.insert(thisEnd, buf.m_index.begin(), bufEnd);
+        m_index.append(buf.m_index, buf.size());
         m_size += buf.size();
     }
 
@@ -165,6 +178,29 @@ public:
     template<typename T>
     void setField(Dimension::Id dim, PointId idx, T val);
 
+    /**
+      Get direct access to the values of a dimension.  The values for the
+      points of the view are returned, in order, as spans of memory in the
+      point table.  Spans of different dimensions of a view have the same
+      sizes.
+
+      Direct access is only available when the table stores each dimension
+      separately (ColumnPointTable), the dimension is stored as type T and
+      the points of the view are consecutive in the table.  Otherwise an
+      empty list is returned and values should be accessed with
+      getFieldAs().  Values of a const view are read-only.
+
+      \param dim  Dimension to access.
+      \return  List of spans holding the values of the dimension.
+    */
+    template<typename T>
+    std::vector<ColumnSpan<T>> column(Dimension::Id dim)
+        { return columnSpans<T>(dim); }
+
+    template<typename T>
+    std::vector<ColumnSpan<const T>> column(Dimension::Id dim) const
+        { return columnSpans<const T>(dim); }
+
     // Set value of type 'type' pointed to by 'val'.
     void setField(Dimension::Id dim, Dimension::Type type, PointId idx, const void *val)
     {
@@ -368,15 +404,26 @@ public:
     */
     Rasterd *raster(const std::string& name = "");
 
-    KD3Index& build3dIndex();
-    KD2Index& build2dIndex();
+    /**
+      Build (if necessary) and return a 3D index of the points in the view.
+
+      \param threads  Number of threads to use if the index is built.
+      \return  Reference to the index.
+    */
+    KD3Index& build3dIndex(int threads = 1);
+
+    /**
+      Build (if necessary) and return a 2D index of the points in the view.
+
+      \param threads  Number of threads to use if the index is built.
+      \return  Reference to the index.
+    */
+    KD2Index& build2dIndex(int threads = 1);
 
 protected:
     PointTableRef m_pointTable;
     PointLayoutPtr m_layout;
-    std::deque<PointId> m_index;
-    // The index might be larger than the size to support temporary point
-    // references.
+    PointIndex m_index;
     point_count_t m_size;
     int m_id;
     SpatialReference m_spatialReference;
@@ -386,25 +433,21 @@ protected:
     std::unique_ptr<KD2Index> m_index2;
 
 private:
-    static int m_lastId;
+    static std::atomic<int> m_lastId;
 
     PointId tableId(PointId idx)
         { return idx >= size() ? 0 : m_index[idx]; }
 
     PointId addPoint();
     void swapItems(PointId id1, PointId id2)
-    {
-        PointId temp = m_index[id2];
-        m_index[id2] = m_index[id1];
-        m_index[id1] = temp;
-    }
+        { m_index.swap(id1, id2); }
     void setTableId(PointId dst, PointId tableId)
-    {
-        m_index[dst] = tableId;
-    }
+        { m_index.set(dst, tableId); }
 
     void setSpatialReference(const SpatialReference& spatialRef)
         { m_spatialReference = spatialRef; }
+    template<typename T>
+    std::vector<ColumnSpan<T>> columnSpans(Dimension::Id dim) const;
 
     // For testing only.
     PointId index(PointId id) const
@@ -554,6 +597,33 @@ void PointView::setField(Dimension::Id dim, PointId idx, T val)
     }
 }
 
+template<typename T>
+std::vector<ColumnSpan<T>> PointView::columnSpans(Dimension::Id dim) const
+{
+    std::vector<ColumnSpan<T>> spans;
+
+    const Dimension::Detail *dd = m_layout->dimDetail(dim);
+    if (!m_index.contiguous() ||
+            dd->type() != Dimension::type<std::remove_const_t<T>>())
+        return spans;
+
+    PointId idx = 0;
+    while (idx < size())
+    {
+        point_count_t count;
+        char *data = m_pointTable.getColumn(dd, m_index[idx], count);
+        if (!data)
+        {
+            spans.clear();
+            break;
+        }
+        count = (std::min)(count, size() - idx);
+        spans.push_back({ reinterpret_cast<T *>(data), count });
+        idx += count;
+    }
+    return spans;
+}
+
 inline void PointView::appendPoint(const PointView& buffer, PointId id)
 {
     // Invalid 'id' is a programmer error.
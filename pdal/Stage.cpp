@@ -38,13 +38,20 @@
 #include <pdal/PDALUtils.hpp>
 #include <pdal/util/Algorithm.hpp>
 #include <pdal/util/ProgramArgs.hpp>
+#include <pdal/util/ThreadPool.hpp>
 #include <pdal/private/gdal/ErrorHandler.hpp>
 #include "../filters/private/expr/ConditionalExpression.hpp"
 
 #include "private/StageRunner.hpp"
 
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
 #include <iterator>
 #include <memory>
+#include <numeric>
+#include <set>
 
 namespace pdal
 {
@@ -65,10 +72,23 @@ void Stage::splitView(const PointViewPtr& view, PointViewPtr& keep, PointViewPtr
     {
         PointView *k = keep.get();
         PointView *s = skip.get();
-        for (PointRef p : *view)
+
+        // Evaluate the expression for a block of points at a time.
+        const point_count_t BlockSize = 4096;
+        PointRef point(*view, 0);
+        std::vector<PointId> ids;
+        std::vector<uint8_t> passes(BlockSize);
+        for (PointId start = 0; start < view->size(); start += BlockSize)
         {
-            PointView *active = where->eval(p) ? k : s;
-            active->appendPoint(*view, p.pointId());
+            PointId end = (std::min)(view->size(), start + BlockSize);
+            ids.resize(end - start);
+            std::iota(ids.begin(), ids.end(), start);
+            where->eval(point, ids.data(), ids.size(), passes.data());
+            for (size_t i = 0; i < ids.size(); ++i)
+            {
+                PointView *active = passes[i] ? k : s;
+                active->appendPoint(*view, ids[i]);
+            }
         }
     }
     else
@@ -203,7 +223,7 @@ void Stage::prepare(PointTableRef table)
 }
 
 
-PointViewSet Stage::execute(PointTableRef table)
+void Stage::finalizeTable(PointTableRef table)
 {
     if (!table.layout()->finalized())
     {
@@ -219,6 +239,12 @@ PointViewSet Stage::execute(PointTableRef table)
     }
 
     table.finalize();
+}
+
+
+PointViewSet Stage::execute(PointTableRef table)
+{
+    finalizeTable(table);
 
     // We store stage instances instead of stages because a stage may get
     // executed more than once.  A stage instance is created for each
@@ -285,9 +311,173 @@ PointViewSet Stage::execute(PointTableRef table)
     return outViews;
 }
 
+namespace
+{
+
+// An execution of a stage.  As with serial execution, a stage is executed
+// once for each path from it to the terminal stage.
+struct StageTask
+{
+    StageTask(Stage *stage, int child) : m_stage(stage), m_child(child),
+        m_waiting(0)
+    {}
+
+    Stage *m_stage;
+    int m_child;                // Task that consumes our output, or -1.
+    std::vector<int> m_parents; // Tasks that provide input, in input order.
+    size_t m_waiting;           // Number of parents that haven't completed.
+    PointViewSet m_input;
+    PointViewSet m_output;
+};
+
+} // unnamed namespace
+
+
+PointViewSet Stage::execute(PointTableRef table, int threads)
+{
+    if (threads < 2)
+        return execute(table);
+
+    finalizeTable(table);
+
+    m_log->get(LogLevel::Debug) << "Executing pipeline in standard mode "
+        "using " << threads << " threads." << std::endl;
+
+    // Build the tree of tasks.  Task storage doesn't move once built.
+    std::vector<StageTask> tasks;
+    tasks.emplace_back(this, -1);
+    for (size_t i = 0; i < tasks.size(); ++i)
+        for (Stage *in : tasks[i].m_stage->m_inputs)
+        {
+            tasks[i].m_parents.push_back((int)tasks.size());
+            tasks.emplace_back(in, (int)i);
+        }
+
+    std::deque<int> ready;
+    for (size_t i = 0; i < tasks.size(); ++i)
+    {
+        tasks[i].m_waiting = tasks[i].m_parents.size();
+        if (tasks[i].m_waiting == 0)
+            ready.push_back((int)i);
+    }
+
+    // Everything below is protected by 'mutex'.  Stages release the lock
+    // while they process points (see execute(table, views, lock)).
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::set<Stage *> busy;
+    std::exception_ptr error;
+    int running = 0;
+    bool finished = false;
+    PointViewSet outViews;
+
+    // Serial execution runs the inputs of a stage in input order, so point
+    // views created by earlier inputs have lower IDs.  Views are renumbered
+    // as they're passed to the next stage to provide the same ordering.
+    auto complete = [&](StageTask& t)
+    {
+        busy.erase(t.m_stage);
+        running--;
+        t.m_input.clear();
+        if (error)
+            return;
+        if (t.m_child < 0)
+        {
+            outViews = std::move(t.m_output);
+            finished = true;
+            return;
+        }
+
+        StageTask& child = tasks[t.m_child];
+        if (--child.m_waiting)
+            return;
+        for (int p : child.m_parents)
+        {
+            std::vector<PointViewPtr> views(tasks[p].m_output.begin(),
+                tasks[p].m_output.end());
+            tasks[p].m_output.clear();
+            for (PointViewPtr& v : views)
+            {
+                v->m_id = ++PointView::m_lastId;
+                child.m_input.insert(v);
+            }
+        }
+        ready.push_back(t.m_child);
+    };
+
+    ThreadPool pool(threads);
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!finished && !(error && running == 0))
+    {
+        // Start ready tasks.  A stage can't be run by more than one task at
+        // a time, which can happen with diamond-shaped pipelines.
+        for (auto it = ready.begin(); !error && it != ready.end() &&
+            running < threads;)
+        {
+            int id = *it;
+            if (busy.count(tasks[id].m_stage))
+            {
+                it++;
+                continue;
+            }
+            it = ready.erase(it);
+            busy.insert(tasks[id].m_stage);
+            running++;
+            pool.add([&, id]()
+            {
+                StageTask& t = tasks[id];
+
+                // Stages usually share a log.  Hold the output of each task
+                // until it completes so that messages from stages running
+                // at the same time aren't interleaved.
+                LogPtr log = t.m_stage->log();
+                log->startBuffer();
+                std::unique_lock<std::mutex> l(mutex);
+                try
+                {
+                    if (t.m_input.empty())
+                        t.m_input.insert(PointViewPtr(new PointView(table)));
+                    t.m_output = t.m_stage->execute(table, t.m_input, &l,
+                        threads);
+                }
+                catch (...)
+                {
+                    if (!l.owns_lock())
+                        l.lock();
+                    if (!error)
+                        error = std::current_exception();
+                }
+                log->flushBuffer();
+                complete(t);
+                l.unlock();
+                cv.notify_all();
+            });
+        }
+        cv.wait(lock);
+    }
+    lock.unlock();
+    pool.join();
+
+    if (error)
+        std::rethrow_exception(error);
+    return outViews;
+}
+
+
 PointViewSet Stage::execute(PointTableRef table, PointViewSet& views)
 {
+    return execute(table, views, nullptr, 1);
+}
 
+
+// If a lock is provided, it's held on entry and exit, but is released while
+// points are being processed so that other stages can run.  The table and
+// the stage's ready() and done() functions are only accessed while the lock
+// is held.  If more than one thread is allowed and the stage permits it,
+// the views are run concurrently.
+PointViewSet Stage::execute(PointTableRef table, PointViewSet& views,
+    std::unique_lock<std::mutex> *lock, int threads)
+{
     PointViewSet outViews;
     std::vector<StageRunnerPtr> runners;
 
@@ -311,6 +501,8 @@ PointViewSet Stage::execute(PointTableRef table, PointViewSet& views)
     // Do the ready operation and then start running all the views
     // through the stage.
     ready(table);
+    if (lock)
+        lock->unlock();
 
     // Create a runner for each view.
     for (PointViewPtr v : views)
@@ -326,8 +518,17 @@ PointViewSet Stage::execute(PointTableRef table, PointViewSet& views)
         keeps.insert(r->keeps());
     prerun(keeps);
 
-    for (StageRunnerPtr r : runners)
-        r->run();
+    // Views created while running have IDs greater than this.
+    const int lastId = PointView::m_lastId;
+    const bool concurrent = threads > 1 && runners.size() > 1 &&
+        viewParallelSafe();
+    if (concurrent)
+        runViews(runners, threads);
+    else
+        for (StageRunnerPtr r : runners)
+            r->run();
+    if (lock)
+        lock->lock();
 
     // As the stages complete (synchronously at this time), propagate the
     // spatial reference and merge the output views.
@@ -338,9 +539,16 @@ PointViewSet Stage::execute(PointTableRef table, PointViewSet& views)
 
         // If our stage has a spatial reference, the view takes it on once
         // the stage has been run.
-        if (!srs.empty())
-            for (PointViewPtr v : temp)
+        // When the views were run concurrently, views created by the runs
+        // are renumbered in runner order so that the output is ordered as
+        // it would be had the views been run serially.
+        for (PointViewPtr v : temp)
+        {
+            if (!srs.empty())
                 v->setSpatialReference(srs);
+            if (concurrent && v->m_id > lastId)
+                v->m_id = ++PointView::m_lastId;
+        }
         outViews.insert(temp.begin(), temp.end());
     }
 
@@ -351,6 +559,41 @@ PointViewSet Stage::execute(PointTableRef table, PointViewSet& views)
     return outViews;
 }
 
+// Run each view through the stage on a pool of threads.  The first
+// exception thrown by a run is rethrown once all runs have completed.
+void Stage::runViews(const std::vector<StageRunnerPtr>& runners, int threads)
+{
+    m_log->get(LogLevel::Debug) << "Running " << runners.size() <<
+        " point views using " << threads << " threads." << std::endl;
+
+    std::mutex mutex;
+    std::exception_ptr error;
+    ThreadPool pool((std::min)((size_t)threads, runners.size()));
+    for (StageRunnerPtr r : runners)
+        pool.add([this, r, &mutex, &error]()
+        {
+            // The log leader and output buffer are kept per thread.
+            m_log->pushLeader(m_logLeader);
+            m_log->startBuffer();
+            try
+            {
+                r->run();
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> l(mutex);
+                if (!error)
+                    error = std::current_exception();
+            }
+            m_log->flushBuffer();
+            m_log->popLeader();
+        });
+    pool.join();
+
+    if (error)
+        std::rethrow_exception(error);
+}
+
 void Stage::countElements(const PointViewSet& views)
 {
     // Count the number of views and the number of points and faces so they're
@@ -35,6 +35,7 @@
 #pragma once
 
 #include <list>
+#include <mutex>
 
 #include <pdal/Dimension.hpp>
 #include <pdal/DimType.hpp>
@@ -135,6 +136,30 @@ public:
     */
     PointViewSet execute(PointTableRef table);
 
+    /**
+      Execute a prepared pipeline (linked set of stages), running independent
+      branches of the pipeline concurrently.
+
+      Stages that don't depend on one another, such as several readers
+      feeding a merge filter, are run at the same time.  Each stage is still
+      run to completion before its output is passed to the next stage and
+      the resulting point views are ordered as they would be by
+      \ref execute(PointTableRef).  Stages that report that they're
+      \ref viewParallelSafe also run the point views they're passed
+      concurrently.
+
+      Point view IDs are assigned as views are passed between stages, so
+      their order matches serial execution but their values may differ
+      from those of a serial run.  Log output of a stage is written when
+      the stage completes.
+
+      \param table  Point table being used for stage pipeline.  This must be
+        the same \ref table used in the \ref prepare function.
+      \param threads  Maximum number of stages to run at once.  A value less
+        than two executes the pipeline serially.
+    */
+    PointViewSet execute(PointTableRef table, int threads);
+
     virtual void execute(StreamPointTable& table)
     {
         throw pdal_error("Attempting to use stream mode with a non-streamable "
@@ -149,6 +174,17 @@ public:
     virtual bool pipelineStreamable() const
     { return false; }
 
+    /**
+      Determine if the point views passed to this stage can be run
+      concurrently.  This should only return true if the stage's run()
+      (or filter()) function modifies no stage state and touches no
+      points other than those in the view being run.
+
+      \return  Whether point views can be run concurrently.
+    */
+    virtual bool viewParallelSafe() const
+    { return false; }
+
     /**
       Return a pointer to a pipeline's first non-streamable stage,
       if one exists.
@@ -386,6 +422,11 @@ private:
     virtual WhereMergeMode mergeMode() const = 0;
     void setupLog();
     void handleOptions();
+    void finalizeTable(PointTableRef table);
+    PointViewSet execute(PointTableRef table, PointViewSet& views,
+        std::unique_lock<std::mutex> *lock, int threads);
+    void runViews(const std::vector<std::shared_ptr<StageRunner>>& runners,
+        int threads);
     void countElements(const PointViewSet& views);
     // set subclass-specific options after they've been processed
     virtual void assignParsedOptions();
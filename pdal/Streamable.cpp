@@ -212,6 +212,13 @@ void Streamable::execute(StreamPointTable& table,
     // Loop until we're finished.  We handle the number of points up to
     // the capacity of the StreamPointTable that we've been provided.
 
+    // Mask of points to be processed by each filter.  Reused across
+    // stages and table loads.  'ids' and 'passes' hold the points that
+    // haven't been skipped and the result of a stage's where clause for them.
+    std::vector<uint8_t> active(table.capacity());
+    std::vector<PointId> ids;
+    std::vector<uint8_t> passes;
+
     bool finished = false;
     while (!finished)
     {
@@ -257,16 +264,21 @@ void Streamable::execute(StreamPointTable& table,
             s->startLogging();
 
             const expr::ConditionalExpression* where = s->whereExpr();
+            ids.clear();
             for (PointId idx = 0; idx < pointLimit; idx++)
             {
-                point.setPointId(idx);
-                if (table.skip(idx))
-                    continue;
-                if (where && !where->eval(point))
-                    continue;
-                if (!s->processOne(point))
-                    table.setSkip(idx);
+                active[idx] = !table.skip(idx);
+                if (active[idx])
+                    ids.push_back(idx);
+            }
+            if (where)
+            {
+                passes.resize(ids.size());
+                where->eval(point, ids.data(), ids.size(), passes.data());
+                for (size_t i = 0; i < ids.size(); ++i)
+                    active[ids[i]] = passes[i];
             }
+            s->processBatch(table, active, pointLimit);
             const SpatialReference& tempSrs = s->getSpatialReference();
             if (!tempSrs.empty())
             {
@@ -280,5 +292,19 @@ void Streamable::execute(StreamPointTable& table,
     }
 }
 
+void Streamable::processBatch(StreamPointTable& table,
+    const std::vector<uint8_t>& active, point_count_t count)
+{
+    PointRef point(table, 0);
+    for (PointId idx = 0; idx < count; idx++)
+    {
+        if (!active[idx])
+            continue;
+        point.setPointId(idx);
+        if (!processOne(point))
+            table.setSkip(idx);
+    }
+}
+
 } // namespace pdal
 
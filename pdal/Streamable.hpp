@@ -92,12 +92,24 @@ protected:
         to subsequent stages).
     */
     virtual bool processOne(PointRef& /*point*/) = 0;
+
     /**
-    {
-        throwStreamingError();
-        return false;
-    }
-    **/
+      Process a batch of points (streaming mode).  Filters and writers
+      that can operate on many points at once may implement this to avoid
+      per-point dispatch.  The default implementation calls \ref processOne
+      for each active point in the batch.
+
+      \param table  Table holding the points.  Points with IDs in the range
+        [0, count) have been populated.
+      \param active  Mask of points to process.  Points whose entry is zero
+        have been filtered out by an earlier stage or excluded by a 'where'
+        expression and must be left untouched.
+      \param count  Number of points in the batch.
+      \note  Active points that should be filtered out must be marked with
+        StreamPointTable::setSkip().
+    */
+    virtual void processBatch(StreamPointTable& table,
+        const std::vector<uint8_t>& active, point_count_t count);
 
     /**
       Notification that the points that will follow in processing are from
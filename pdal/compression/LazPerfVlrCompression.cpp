@@ -40,6 +40,7 @@
 #include <lazperf/lazperf.hpp>
 #include <lazperf/filestream.hpp>
 #include <lazperf/vlr.hpp>
+#include <lazperf/writers.hpp>
 
 #ifdef _MSC_VER
 #pragma warning (pop)
@@ -52,11 +53,16 @@
 
 #include <pdal/util/IStream.hpp>
 #include <pdal/util/OStream.hpp>
+#include <pdal/util/ThreadPool.hpp>
 #include <pdal/pdal_types.hpp>
 #include <io/private/las/Header.hpp>
 
 #include "LazPerfVlrCompression.hpp"
 
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
 namespace pdal
 {
 
@@ -73,10 +79,22 @@ namespace pdal
 class LazPerfVlrCompressorImpl
 {
 public:
-    LazPerfVlrCompressorImpl(std::ostream& stream, int format, int ebCount) :
+    LazPerfVlrCompressorImpl(std::ostream& stream, int format, int ebCount,
+            uint32_t chunksize, int threads) :
         m_stream(stream), m_outputStream(stream), m_format(format), m_ebCount(ebCount),
-        m_chunksize(50000), m_chunkPointsWritten(0), m_chunkInfoPos(0), m_chunkOffset(0)
-    {}
+        m_chunksize(chunksize), m_chunkPointsWritten(0), m_chunkInfoPos(0), m_chunkOffset(0),
+        m_pointSize(las::baseCount(format) + ebCount), m_started(false)
+    {
+        if (threads > 1)
+            m_pool.reset(new ThreadPool(threads));
+    }
+
+    ~LazPerfVlrCompressorImpl()
+    {
+        // Make sure no task refers to a chunk after we're gone.
+        if (m_pool)
+            m_pool->join();
+    }
 
     std::vector<char> vlrData() const
     {
@@ -86,6 +104,12 @@ public:
 
     void compress(const char *inbuf)
     {
+        if (m_pool)
+        {
+            compressParallel(inbuf);
+            return;
+        }
+
         // First time through.
         if (!m_compressor)
         {
@@ -114,6 +138,15 @@ public:
             newChunk();
         }
 
+        // Queue the partial last chunk and write everything that's pending.
+        if (m_pool)
+        {
+            if (m_current && m_current->count)
+                queueChunk();
+            while (m_pending.size())
+                writeChunk();
+        }
+
         // If we didn't write any points, chunk info pos will be 0 and we need to
         // set the chunk info pos. Could do this as an "else" case of the
         // above, but this seems safer in case some other compressor creation logic
@@ -143,6 +176,93 @@ public:
     }
 
 private:
+    // A chunk of points to be compressed by the thread pool.
+    struct Chunk
+    {
+        std::vector<char> points;
+        uint32_t count = 0;
+        std::vector<unsigned char> compressed;
+        bool done = false;
+        std::exception_ptr error;
+    };
+    using ChunkPtr = std::shared_ptr<Chunk>;
+
+    // Points are buffered until a full chunk is available.  Each chunk is
+    // compressed independently on the thread pool and the compressed chunks
+    // are written to the stream in the order they were queued.  The output
+    // is the same as that of the serial compressor.
+    void compressParallel(const char *inbuf)
+    {
+        if (!m_started)
+        {
+            m_chunkInfoPos = m_stream.tellp();
+            m_stream.seekp(sizeof(uint64_t), std::ios::cur);
+            m_chunkOffset = m_stream.tellp();
+            m_started = true;
+        }
+        if (!m_current)
+        {
+            m_current = std::make_shared<Chunk>();
+            m_current->points.resize((size_t)m_chunksize * m_pointSize);
+        }
+        std::copy(inbuf, inbuf + m_pointSize,
+            m_current->points.data() + (size_t)m_current->count * m_pointSize);
+        if (++m_current->count == m_chunksize)
+            queueChunk();
+    }
+
+    void queueChunk()
+    {
+        // Limit the number of chunks held in memory.
+        if (m_pending.size() >= 2 * m_pool->size())
+            writeChunk();
+
+        ChunkPtr chunk = std::move(m_current);
+        m_pending.push_back(chunk);
+        m_pool->add([this, chunk]()
+        {
+            try
+            {
+                lazperf::writer::chunk_compressor compressor(m_format, m_ebCount);
+                const char *pos = chunk->points.data();
+                for (uint32_t i = 0; i < chunk->count; ++i)
+                {
+                    compressor.compress(pos);
+                    pos += m_pointSize;
+                }
+                chunk->compressed = compressor.done();
+            }
+            catch (...)
+            {
+                chunk->error = std::current_exception();
+            }
+            chunk->points.clear();
+            chunk->points.shrink_to_fit();
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                chunk->done = true;
+            }
+            m_doneCv.notify_all();
+        });
+    }
+
+    // Wait for the oldest pending chunk and write it.
+    void writeChunk()
+    {
+        ChunkPtr chunk = m_pending.front();
+        m_pending.pop_front();
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_doneCv.wait(lock, [&chunk](){ return chunk->done; });
+        }
+        if (chunk->error)
+            std::rethrow_exception(chunk->error);
+
+        m_stream.write(reinterpret_cast<const char *>(chunk->compressed.data()),
+            chunk->compressed.size());
+        newChunk();
+    }
+
     void resetCompressor()
     {
         if (m_compressor)
@@ -168,11 +288,27 @@ private:
     std::streampos m_chunkInfoPos;
     std::streampos m_chunkOffset;
     std::vector<uint32_t> m_chunkTable;
+    int m_pointSize;
+    bool m_started;
+    std::unique_ptr<ThreadPool> m_pool;
+    ChunkPtr m_current;
+    std::deque<ChunkPtr> m_pending;
+    std::mutex m_mutex;
+    std::condition_variable m_doneCv;
 };
 
 
+const uint32_t LazPerfVlrCompressor::DefaultChunkSize = lazperf::DefaultChunkSize;
+
+
 LazPerfVlrCompressor::LazPerfVlrCompressor(std::ostream& stream, int format, int ebCount) :
-    m_impl(new LazPerfVlrCompressorImpl(stream, format, ebCount))
+    m_impl(new LazPerfVlrCompressorImpl(stream, format, ebCount, DefaultChunkSize, 1))
+{}
+
+
+LazPerfVlrCompressor::LazPerfVlrCompressor(std::ostream& stream, int format, int ebCount,
+        uint32_t chunksize, int threads) :
+    m_impl(new LazPerfVlrCompressorImpl(stream, format, ebCount, chunksize, threads))
 {}
 
 
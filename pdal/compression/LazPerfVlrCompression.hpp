@@ -54,13 +54,18 @@ namespace las
 // The compressor uses the schema of the point data in order to compress
 // the point stream.  The schema is also stored in a VLR that isn't
 // handled as part of the compression process itself.
+// When 'threads' is greater than one, full chunks are compressed
+// concurrently and written to the stream in order.
 class LazPerfVlrCompressorImpl;
 class LazPerfVlrCompressor
 {
 public:
+    // Number of points in a chunk when no chunk size is given.
+    static const uint32_t DefaultChunkSize;
+
     LazPerfVlrCompressor(std::ostream& stream, int format, int ebCount);
     LazPerfVlrCompressor(std::ostream& stream, int format, int ebCount,
-        uint32_t chunksize);
+        uint32_t chunksize, int threads = 1);
     ~LazPerfVlrCompressor();
 
     std::vector<char> vlrData() const;
@@ -36,9 +36,55 @@
 
 #include <nanoflann/nanoflann.hpp>
 
+#include "Parallel.hpp"
+
 namespace pdal
 {
 
+// Interleave the values of 'dims' into 'out', one point after another,
+// using direct access to the dimensions' memory.  The spans are split among
+// 'threads' threads.  Returns false, having copied nothing, if the view
+// doesn't support direct access to every dimension as doubles.
+inline bool kdCopyColumns(const PointView& view, const Dimension::IdList& dims,
+    double *out, int threads)
+{
+    struct Copy
+    {
+        ColumnSpan<const double> span;
+        double *out;
+    };
+
+    const size_t stride = dims.size();
+    std::vector<Copy> copies;
+    for (size_t i = 0; i < stride; ++i)
+    {
+        auto spans = view.column<const double>(dims[i]);
+        if (spans.empty())
+            return false;
+        double *o = out + i;
+        for (const ColumnSpan<const double>& span : spans)
+        {
+            copies.push_back({ span, o });
+            o += span.size * stride;
+        }
+    }
+
+    parallelFor(copies.size(), threads,
+        [&copies, stride](size_t start, size_t end)
+    {
+        for (size_t i = start; i < end; ++i)
+        {
+            double *o = copies[i].out;
+            for (double d : copies[i].span)
+            {
+                *o = d;
+                o += stride;
+            }
+        }
+    });
+    return true;
+}
+
 class KD2Impl
 {
 public:
@@ -48,21 +94,20 @@ public:
 
     std::size_t kdtree_get_point_count() const
     {
-        return m_buf.size();
+        return m_coords.size() / 2;
     }
 
     double kdtree_get_pt(const PointId idx, int dim) const
     {
-        using namespace Dimension;
-        std::array<Id, 2> ids { Id::X, Id::Y };
-        return m_buf.getFieldAs<double>(ids[dim], idx);
+        return m_coords[idx * 2 + dim];
     }
-    
+
     double kdtree_distance(const double *p1, const PointId p2_idx,
         size_t /*numDims*/) const
     {
-        double d0 = p1[0] - m_buf.getFieldAs<double>(Dimension::Id::X, p2_idx);
-        double d1 = p1[1] - m_buf.getFieldAs<double>(Dimension::Id::Y, p2_idx);
+        const double *p2 = m_coords.data() + p2_idx * 2;
+        double d0 = p1[0] - p2[0];
+        double d1 = p1[1] - p2[1];
 
         return (d0 * d0 + d1 * d1);
     }
@@ -70,26 +115,46 @@ public:
     template <class BBOX>
     bool kdtree_get_bbox(BBOX& bb) const
     {
-        if (m_buf.empty())
+        if (m_coords.empty())
             bb = {};
         else
         {
             BOX2D bounds;
-            m_buf.calculateBounds(bounds);
+            for (auto it = m_coords.begin(); it != m_coords.end(); it += 2)
+                bounds.grow(*it, *(it + 1));
 
             bb = { {bounds.minx, bounds.maxx}, {bounds.miny, bounds.maxy} };
         }
         return true;
     }
 
-    void build()
+    void build(int threads)
+    {
+        using namespace Dimension;
+
+        m_coords.resize(m_buf.size() * 2);
+        if (!kdCopyColumns(m_buf, { Id::X, Id::Y }, m_coords.data(), threads))
+            parallelFor(m_buf.size(), threads, [this](size_t start, size_t end)
+            {
+                double *c = m_coords.data() + start * 2;
+                for (PointId idx = start; idx < end; ++idx)
+                {
+                    *c++ = m_buf.getFieldAs<double>(Id::X, idx);
+                    *c++ = m_buf.getFieldAs<double>(Id::Y, idx);
+                }
+            });
+        m_index.buildIndex((std::max)(threads, 1));
+    }
+
+    size_t memoryUsed()
     {
-        m_index.buildIndex();
+        return m_coords.capacity() * sizeof(double) +
+            m_index.usedMemory(m_index);
     }
 
     PointIdList neighbors(double x, double y, point_count_t k) const
     {
-        k = (std::min)(m_buf.size(), k);
+        k = (std::min)((point_count_t)kdtree_get_point_count(), k);
         PointIdList output(k);
         std::vector<double> out_dist_sqr(k);
         nanoflann::KNNResultSet<double, PointId, point_count_t> resultSet(k);
@@ -104,10 +169,16 @@ public:
     void knnSearch(double x, double y, point_count_t k,
         PointIdList *indices, std::vector<double> *sqr_dists) const
     {
-        k = (std::min)(m_buf.size(), k);
+        knnSearch(x, y, k, &indices->front(), &sqr_dists->front());
+    }
+
+    void knnSearch(double x, double y, point_count_t k,
+        PointId *indices, double *sqr_dists) const
+    {
+        k = (std::min)((point_count_t)kdtree_get_point_count(), k);
         nanoflann::KNNResultSet<double, PointId, point_count_t> resultSet(k);
 
-        resultSet.init(&indices->front(), &sqr_dists->front());
+        resultSet.init(indices, sqr_dists);
 
         std::array<double, 2> pt { x, y };
         m_index.findNeighbors(resultSet, &pt[0], nanoflann::SearchParams(10));
@@ -134,6 +205,8 @@ public:
 
 private:
     const PointView& m_buf;
+    // X/Y of each point, copied from the view when the index is built.
+    std::vector<double> m_coords;
 
     typedef nanoflann::KDTreeSingleIndexAdaptor<nanoflann::L2_Simple_Adaptor<
         double, KD2Impl, double>, KD2Impl, -1, std::size_t> KDTree;
@@ -150,51 +223,72 @@ public:
 
     std::size_t kdtree_get_point_count() const
     {
-        return m_buf.size();
+        return m_coords.size() / 3;
     }
 
     double kdtree_get_pt(const PointId idx, int dim) const
     {
-        if (idx >= m_buf.size())
+        if (idx >= kdtree_get_point_count())
             return 0.0;
 
-        using namespace Dimension;
-        std::array<Id, 3> ids { Id::X, Id::Y, Id::Z };
-        if ((size_t)dim >= ids.size())
+        if (dim < 0 || dim >= 3)
             throw pdal_error("kdtree_get_pt: Request for invalid dimension "
                 "from nanoflann");
 
-        return m_buf.getFieldAs<double>(ids[dim], idx);
+        return m_coords[idx * 3 + dim];
     }
 
     double kdtree_distance(const double *p1, const PointId p2_idx,
         size_t /*numDims*/) const
     {
-        double d0 = p1[0] - m_buf.getFieldAs<double>(Dimension::Id::X, p2_idx);
-        double d1 = p1[1] - m_buf.getFieldAs<double>(Dimension::Id::Y, p2_idx);
-        double d2 = p1[2] - m_buf.getFieldAs<double>(Dimension::Id::Z, p2_idx);
+        const double *p2 = m_coords.data() + p2_idx * 3;
+        double d0 = p1[0] - p2[0];
+        double d1 = p1[1] - p2[1];
+        double d2 = p1[2] - p2[2];
 
         return (d0 * d0 + d1 * d1 + d2 * d2);
     }
-        
+
     template <class BBOX>
     bool kdtree_get_bbox(BBOX& bb) const
     {
-        if (m_buf.empty())
+        if (m_coords.empty())
             bb = {};
         else
         {
             BOX3D bounds;
-            m_buf.calculateBounds(bounds);
+            for (auto it = m_coords.begin(); it != m_coords.end(); it += 3)
+                bounds.grow(*it, *(it + 1), *(it + 2));
             bb = { {bounds.minx, bounds.maxx}, {bounds.miny, bounds.maxy},
                 {bounds.minz, bounds.maxz} };
         }
         return true;
     }
 
-    void build()
+    void build(int threads)
+    {
+        using namespace Dimension;
+
+        m_coords.resize(m_buf.size() * 3);
+        if (!kdCopyColumns(m_buf, { Id::X, Id::Y, Id::Z }, m_coords.data(),
+                threads))
+            parallelFor(m_buf.size(), threads, [this](size_t start, size_t end)
+            {
+                double *c = m_coords.data() + start * 3;
+                for (PointId idx = start; idx < end; ++idx)
+                {
+                    *c++ = m_buf.getFieldAs<double>(Id::X, idx);
+                    *c++ = m_buf.getFieldAs<double>(Id::Y, idx);
+                    *c++ = m_buf.getFieldAs<double>(Id::Z, idx);
+                }
+            });
+        m_index.buildIndex((std::max)(threads, 1));
+    }
+
+    size_t memoryUsed()
     {
-        m_index.buildIndex();
+        return m_coords.capacity() * sizeof(double) +
+            m_index.usedMemory(m_index);
     }
 
     PointIdList neighbors(double x, double y, double z, point_count_t k,
@@ -203,7 +297,7 @@ public:
         // Account for input buffer size smaller than requested number of
         // neighbors, then determine the number of neighbors to extract based
         // on the desired stride.
-        k = (std::min)(m_buf.size(), k);
+        k = (std::min)((point_count_t)kdtree_get_point_count(), k);
         point_count_t k2 = stride * k;
 
         // Prepare output indices and squared distances.
@@ -232,15 +326,18 @@ public:
     void knnSearch(double x, double y, double z, point_count_t k,
         PointIdList *indices, std::vector<double> *sqr_dists) const
     {
-        k = (std::min)(m_buf.size(), k);
+        knnSearch(x, y, z, k, &indices->front(), &sqr_dists->front());
+    }
+
+    void knnSearch(double x, double y, double z, point_count_t k,
+        PointId *indices, double *sqr_dists) const
+    {
+        k = (std::min)((point_count_t)kdtree_get_point_count(), k);
         nanoflann::KNNResultSet<double, PointId, point_count_t> resultSet(k);
 
-        resultSet.init(&indices->front(), &sqr_dists->front());
+        resultSet.init(indices, sqr_dists);
 
-        std::vector<double> pt;
-        pt.push_back(x);
-        pt.push_back(y);
-        pt.push_back(z);
+        std::array<double, 3> pt { x, y, z };
         m_index.findNeighbors(resultSet, &pt[0], nanoflann::SearchParams(10));
     }
 
@@ -265,6 +362,8 @@ public:
 
 private:
     const PointView& m_buf;
+    // X/Y/Z of each point, copied from the view when the index is built.
+    std::vector<double> m_coords;
 
     typedef nanoflann::KDTreeSingleIndexAdaptor<nanoflann::L2_Simple_Adaptor<
         double, KD3Impl, double>, KD3Impl, -1, std::size_t> KDTree;
@@ -283,12 +382,29 @@ public:
 
     std::size_t kdtree_get_point_count() const
     {
-        return m_buf.size();
+        return m_dims.size() ? m_coords.size() / m_dims.size() : 0;
+    }
+
+    void build(int threads)
+    {
+        const size_t numDims = m_dims.size();
+        m_coords.resize(m_buf.size() * numDims);
+        if (!numDims || !kdCopyColumns(m_buf, m_dims, m_coords.data(), threads))
+            parallelFor(m_buf.size(), threads,
+                [this, numDims](size_t start, size_t end)
+            {
+                double *c = m_coords.data() + start * numDims;
+                for (PointId idx = start; idx < end; ++idx)
+                    for (size_t i = 0; i < numDims; ++i)
+                        *c++ = m_buf.getFieldAs<double>(m_dims[i], idx);
+            });
+        m_index.buildIndex((std::max)(threads, 1));
     }
 
-    void build()
+    size_t memoryUsed()
     {
-        m_index.buildIndex();
+        return m_coords.capacity() * sizeof(double) +
+            m_index.usedMemory(m_index);
     }
 
     PointIdList neighbors(PointRef &point, point_count_t k, size_t stride) const
@@ -296,7 +412,7 @@ public:
         // Account for input buffer size smaller than requested number of
         // neighbors, then determine the number of neighbors to extract based
         // on the desired stride.
-        k = (std::min)(m_buf.size(), k);
+        k = (std::min)((point_count_t)kdtree_get_point_count(), k);
         point_count_t k2 = stride * k;
 
         // Prepare output indices and squared distances.
@@ -353,19 +469,21 @@ public:
 
     inline double kdtree_get_pt(const PointId idx, int dim) const
     {
-        if (idx >= m_buf.size())
+        if (idx >= kdtree_get_point_count())
             return 0.0;
 
-        return m_buf.getFieldAs<double>(m_dims[dim], idx);
+        return m_coords[idx * m_dims.size() + dim];
     }
 
     inline double kdtree_distance(const double* p1, const PointId idx,
                                   size_t /*numDims*/) const
     {
+        const size_t numDims = m_dims.size();
+        const double *p2 = m_coords.data() + idx * numDims;
         double result(0.0);
-        for (size_t i = 0; i < m_dims.size(); ++i)
+        for (size_t i = 0; i < numDims; ++i)
         {
-            double d = p1[i] - m_buf.getFieldAs<double>(m_dims[i], idx);
+            double d = p1[i] - p2[i];
             result += d * d;
         }
 
@@ -375,22 +493,22 @@ public:
     template <class BBOX>
     bool kdtree_get_bbox(BBOX& bb) const
     {
-        if (m_buf.empty())
+        if (m_coords.empty())
             bb = {};
         else
         {
-            for (size_t j = 0; j < m_dims.size(); ++j)
+            const size_t numDims = m_dims.size();
+            for (size_t j = 0; j < numDims; ++j)
             {
-                double val = m_buf.getFieldAs<double>(m_dims[j], 0);
-                bb[j].low = val;
-                bb[j].high = val;
+                bb[j].low = m_coords[j];
+                bb[j].high = m_coords[j];
             }
 
-            for (PointId i = 1; i < m_buf.size(); ++i)
+            for (size_t i = numDims; i < m_coords.size(); i += numDims)
             {
-                for (size_t j = 0; j < m_dims.size(); ++j)
+                for (size_t j = 0; j < numDims; ++j)
                 {
-                    double val = m_buf.getFieldAs<double>(m_dims[j], i);
+                    double val = m_coords[i + j];
                     if (val < bb[j].low)
                         bb[j].low = val;
                     if (val > bb[j].high)
@@ -404,6 +522,9 @@ public:
 private:
     const PointView& m_buf;
     const Dimension::IdList& m_dims;
+    // Values of the index dimensions of each point, copied from the view
+    // when the index is built.
+    std::vector<double> m_coords;
 
     typedef nanoflann::KDTreeSingleIndexAdaptor< nanoflann::L2_Simple_Adaptor<
         double, KDFlexImpl, double>, KDFlexImpl, -1, std::size_t> KDTree;
@@ -32,8 +32,11 @@
 * OF SUCH DAMAGE.
 ****************************************************************************/
 
+#include <algorithm>
 #include <array>
 #include <cfloat>
+#include <cstddef>
+#include <limits>
 #include <numeric>
 #include <vector>
 
@@ -44,6 +47,7 @@
 #include <pdal/private/gdal/Raster.hpp>
 
 #include "MathUtils.hpp"
+#include "Parallel.hpp"
 
 namespace pdal
 {
@@ -255,79 +259,257 @@ Eigen::MatrixXd extendedLocalMinimum(const PointView& view, int rows, int cols,
     return ZImin;
 }
 
-void dilateDiamond(std::vector<double>& data, size_t rows, size_t cols, int iterations)
+namespace
 {
-    std::vector<double> out(data.size(), std::numeric_limits<double>::lowest());
-    std::array<size_t, 5> idx;
 
-    for (int iter = 0; iter < iterations; ++iter)
+// Operations used for dilation and erosion.  They're written so that a NaN
+// value is never selected and so that the compiler can use vector min/max
+// instructions for the loops below.
+struct MaxOp
+{
+    static double init()
+        { return std::numeric_limits<double>::lowest(); }
+    double operator()(double acc, double v) const
+        { return v > acc ? v : acc; }
+};
+
+struct MinOp
+{
+    static double init()
+        { return (std::numeric_limits<double>::max)(); }
+    double operator()(double acc, double v) const
+        { return v < acc ? v : acc; }
+};
+
+// dst[r] = op(prev[r - shift], cur[r]), or cur[r] where r - shift is outside
+// the column.
+template<typename Op>
+void combine(const double *prev, const double *cur, double *dst, size_t rows,
+    int shift, Op op)
+{
+    size_t lo = shift > 0 ? 1 : 0;
+    size_t hi = shift < 0 ? rows - 1 : rows;
+    if (lo > 0)
+        dst[0] = cur[0];
+    if (hi < rows)
+        dst[rows - 1] = cur[rows - 1];
+    for (size_t r = lo; r < hi; ++r)
+        dst[r] = op(prev[r - shift], cur[r]);
+}
+
+// Van Herk/Gil-Werman running 'op' over windows of 'w' cells along lines
+// that advance one column and 'shift' (-1, 0 or 1) rows per step.
+// out(c, r) is the result over in(c + i, r + i * shift) for i in [0, w).
+// The cost is independent of the window size.  Windows that run off the
+// raster aren't complete, so callers pad the raster so that those results
+// aren't used.
+template<typename Op>
+void columnPass(const std::vector<double>& in, std::vector<double>& out,
+    size_t rows, size_t cols, size_t w, int shift, int threads)
+{
+    Op op;
+    std::vector<double> g(in.size());
+    std::vector<double> h(in.size());
+
+    // Prefix (g) and suffix (h) results restart at each block of 'w'
+    // columns, so blocks can be processed independently.
+    size_t blocks = (cols + w - 1) / w;
+    parallelFor(blocks, threads, [&](size_t begin, size_t end)
     {
-        for (size_t col = 0; col < cols; ++col)
+        for (size_t b = begin; b < end; ++b)
         {
-            size_t index = col*rows;
-            for (size_t row = 0; row < rows; ++row)
-            {
-                // Find the index into the vector of the current cell.  Then
-                // find the index of the cells to the right/left/above/below
-                // if they exist.
-                size_t j = 0;
-                idx[j++] = index+row;
-                if (row > 0)
-                    idx[j++] = idx[0]-1;
-                if (row < rows-1)
-                    idx[j++] = idx[0]+1;
-                if (col > 0)
-                    idx[j++] = idx[0]-rows;
-                if (col < cols-1)
-                    idx[j++] = idx[0]+rows;
-                // If the data at the test cell pos is greater than that
-                // from the last iteration, set the value to the maximum of
-                // the value of those cells.
-                for (size_t i = 0; i < j; ++i)
-                {
-                    if (data[idx[i]] > out[index+row])
-                        out[index+row] = data[idx[i]];
-                }
-            }
+            size_t first = b * w;
+            size_t last = (std::min)(first + w, cols) - 1;
+
+            const double *x = in.data() + first * rows;
+            std::copy(x, x + rows, g.data() + first * rows);
+            for (size_t c = first + 1; c <= last; ++c)
+                combine(g.data() + (c - 1) * rows, in.data() + c * rows,
+                    g.data() + c * rows, rows, shift, op);
+
+            x = in.data() + last * rows;
+            std::copy(x, x + rows, h.data() + last * rows);
+            for (size_t c = last; c-- > first;)
+                combine(h.data() + (c + 1) * rows, in.data() + c * rows,
+                    h.data() + c * rows, rows, -shift, op);
         }
-        data.swap(out);
+    });
+
+    const size_t span = w - 1;
+    parallelFor(cols, threads, [&](size_t begin, size_t end)
+    {
+        for (size_t c = begin; c < end; ++c)
+        {
+            const double *hc = h.data() + c * rows;
+            double *o = out.data() + c * rows;
+            std::copy(hc, hc + rows, o);
+            if (c + span >= cols || span >= rows)
+                continue;
+
+            // The window ends in row r + offset of column c + span.
+            const double *gc = g.data() + (c + span) * rows;
+            const ptrdiff_t offset = (ptrdiff_t)span * shift;
+            size_t lo = offset < 0 ? span : 0;
+            size_t hi = offset > 0 ? rows - span : rows;
+            for (size_t r = lo; r < hi; ++r)
+                o[r] = op(o[r], gc[r + offset]);
+        }
+    });
+}
+
+// Van Herk/Gil-Werman running 'op' over windows of 'w' cells down each
+// column: out(c, r) is the result over in(c, r + i) for i in [0, w).
+template<typename Op>
+void rowPass(const std::vector<double>& in, std::vector<double>& out,
+    size_t rows, size_t cols, size_t w, int threads)
+{
+    parallelFor(cols, threads, [&](size_t begin, size_t end)
+    {
+        Op op;
+        std::vector<double> g(rows);
+        std::vector<double> h(rows);
+        for (size_t c = begin; c < end; ++c)
+        {
+            const double *x = in.data() + c * rows;
+            double *o = out.data() + c * rows;
+            for (size_t r = 0; r < rows; ++r)
+                g[r] = (r % w) ? op(g[r - 1], x[r]) : x[r];
+            for (size_t r = rows; r-- > 0;)
+                h[r] = (r % w == w - 1 || r == rows - 1) ?
+                    x[r] : op(h[r + 1], x[r]);
+            for (size_t r = 0; r < rows; ++r)
+                o[r] = (r + w - 1 < rows) ? op(h[r], g[r + w - 1]) : h[r];
+        }
+    });
+}
+
+// Copy the raster into one with 'pad' cells of op's identity on each side.
+// NaN values are replaced with the identity as well.
+template<typename Op>
+std::vector<double> padRaster(const std::vector<double>& data, size_t rows,
+    size_t cols, size_t pad)
+{
+    Op op;
+    const size_t prows = rows + 2 * pad;
+    std::vector<double> out(prows * (cols + 2 * pad), Op::init());
+    for (size_t c = 0; c < cols; ++c)
+    {
+        const double *x = data.data() + c * rows;
+        double *o = out.data() + (c + pad) * prows + pad;
+        for (size_t r = 0; r < rows; ++r)
+            o[r] = op(Op::init(), x[r]);
     }
+    return out;
 }
 
-void erodeDiamond(std::vector<double>& data, size_t rows, size_t cols,
-    int iterations)
+// Apply 'op' over a diamond (cells within a city-block distance of
+// 'radius').  The cells at distance radius - 1, radius - 3, ... from the
+// center form a square rotated by 45 degrees, which is separated into runs
+// along the two diagonals.  Adding the four neighbors of each cell to that
+// fills in the remaining cells of the diamond.
+template<typename Op>
+void diamond(std::vector<double>& data, size_t rows, size_t cols,
+    int radius, int threads)
 {
-    std::vector<double> out(data.size(), (std::numeric_limits<double>::max)());
-    std::array<size_t, 5> idx;
+    if (radius <= 0 || data.empty())
+        return;
+
+    Op op;
+    const size_t pad = radius;
+    const size_t prows = rows + 2 * pad;
+    const size_t pcols = cols + 2 * pad;
+    const size_t w = radius;
 
-    for (int iter = 0; iter < iterations; ++iter)
+    std::vector<double> a = padRaster<Op>(data, rows, cols, pad);
+    if (w > 1)
     {
-        for (size_t col = 0; col < cols; ++col)
+        std::vector<double> b(a.size());
+        columnPass<Op>(a, b, prows, pcols, w, 1, threads);
+        columnPass<Op>(b, a, prows, pcols, w, -1, threads);
+    }
+
+    // The rotated square centered on padded column c is held in column
+    // c - (w - 1) of 'a'.
+    parallelFor(cols, threads, [&](size_t begin, size_t end)
+    {
+        for (size_t col = begin; col < end; ++col)
         {
-            size_t index = col*rows;
-            for (size_t row = 0; row < rows; ++row)
+            const double *q = a.data() + (col + pad + 1 - w) * prows + pad;
+            double *o = data.data() + col * rows;
+            for (size_t r = 0; r < rows; ++r)
+                o[r] = op(q[r], o[r]);
+            for (size_t r = 1; r < rows; ++r)
+                o[r] = op(o[r], q[r - 1]);
+            for (size_t r = 0; r + 1 < rows; ++r)
+                o[r] = op(o[r], q[r + 1]);
+            if (col > 0)
             {
-                size_t j = 0;
-                idx[j++] = index+row;
-                if (row > 0)
-                    idx[j++] = idx[0]-1;
-                if (row < rows-1)
-                    idx[j++] = idx[0]+1;
-                if (col > 0)
-                    idx[j++] = idx[0]-rows;
-                if (col < cols-1)
-                    idx[j++] = idx[0]+rows;
-                for (size_t i = 0; i < j; ++i)
-                {
-                    if (data[idx[i]] < out[index+row])
-                        out[index+row] = data[idx[i]];
-                }
+                const double *left = q - prows;
+                for (size_t r = 0; r < rows; ++r)
+                    o[r] = op(o[r], left[r]);
+            }
+            if (col + 1 < cols)
+            {
+                const double *right = q + prows;
+                for (size_t r = 0; r < rows; ++r)
+                    o[r] = op(o[r], right[r]);
             }
         }
-        data.swap(out);
+    });
+}
+
+// Apply 'op' over a square of (2 * radius + 1) cells on a side.
+template<typename Op>
+void square(std::vector<double>& data, size_t rows, size_t cols,
+    int radius, int threads)
+{
+    if (radius <= 0 || data.empty())
+        return;
+
+    const size_t pad = radius;
+    const size_t prows = rows + 2 * pad;
+    const size_t pcols = cols + 2 * pad;
+    const size_t w = 2 * radius + 1;
+
+    std::vector<double> a = padRaster<Op>(data, rows, cols, pad);
+    std::vector<double> b(a.size());
+    rowPass<Op>(a, b, prows, pcols, w, threads);
+    columnPass<Op>(b, a, prows, pcols, w, 0, threads);
+
+    // The window centered on padded cell (c, r) starts at (c - pad, r - pad).
+    for (size_t col = 0; col < cols; ++col)
+    {
+        const double *x = a.data() + col * prows;
+        std::copy(x, x + rows, data.data() + col * rows);
     }
 }
 
+} // unnamed namespace
+
+void dilateDiamond(std::vector<double>& data, size_t rows, size_t cols,
+    int iterations, int threads)
+{
+    diamond<MaxOp>(data, rows, cols, iterations, threads);
+}
+
+void erodeDiamond(std::vector<double>& data, size_t rows, size_t cols,
+    int iterations, int threads)
+{
+    diamond<MinOp>(data, rows, cols, iterations, threads);
+}
+
+void dilateSquare(std::vector<double>& data, size_t rows, size_t cols,
+    int radius, int threads)
+{
+    square<MaxOp>(data, rows, cols, radius, threads);
+}
+
+void erodeSquare(std::vector<double>& data, size_t rows, size_t cols,
+    int radius, int threads)
+{
+    square<MinOp>(data, rows, cols, radius, threads);
+}
+
 Eigen::MatrixXd pointViewToEigen(const PointView& view)
 {
     Eigen::MatrixXd matrix(view.size(), 3);
@@ -189,35 +189,75 @@ Eigen::MatrixXd extendedLocalMinimum(const PointView& view, int rows,
   Perform a morphological dilation of the input raster.
 
   Performs a morphological dilation of the input raster using a diamond
-  structuring element. Larger structuring elements are approximated by applying
-  multiple iterations of the opening operation. The input and output rasters are
-  stored in column major order.
+  structuring element. The result is that of applying a 4-neighbor dilation
+  `iterations` times, but the cost doesn't depend on the number of iterations.
+  NaN cells are ignored. The input and output rasters are stored in column
+  major order.
 
   \param data the input raster.
   \param rows the number of rows.
   \param cols the number of cols.
   \param iterations the number of iterations used to approximate a larger
-         structuring element.
+         structuring element (the radius of the diamond).
+  \param threads the number of threads over which to split the work.
   \return the morphological dilation of the input raster.
 */
-void dilateDiamond(std::vector<double>& data, size_t rows, size_t cols, int iterations);
+void dilateDiamond(std::vector<double>& data, size_t rows, size_t cols, int iterations,
+    int threads = 1);
 
 /**
   Perform a morphological erosion of the input raster.
 
   Performs a morphological erosion of the input raster using a diamond
-  structuring element. Larger structuring elements are approximated by applying
-  multiple iterations of the opening operation. The input and output rasters are
-  stored in column major order.
+  structuring element. The result is that of applying a 4-neighbor erosion
+  `iterations` times, but the cost doesn't depend on the number of iterations.
+  NaN cells are ignored. The input and output rasters are stored in column
+  major order.
 
   \param data the input raster.
   \param rows the number of rows.
   \param cols the number of cols.
   \param iterations the number of iterations used to approximate a larger
-         structuring element.
+         structuring element (the radius of the diamond).
+  \param threads the number of threads over which to split the work.
   \return the morphological erosion of the input raster.
 */
-void erodeDiamond(std::vector<double>& data, size_t rows, size_t cols, int iterations);
+void erodeDiamond(std::vector<double>& data, size_t rows, size_t cols, int iterations,
+    int threads = 1);
+
+/**
+  Perform a morphological dilation of the input raster.
+
+  Performs a morphological dilation of the input raster using a square
+  structuring element of (2 * radius + 1) cells on a side. NaN cells are
+  ignored. The input and output rasters are stored in column major order.
+
+  \param data the input raster.
+  \param rows the number of rows.
+  \param cols the number of cols.
+  \param radius the number of cells on each side of the center cell.
+  \param threads the number of threads over which to split the work.
+  \return the morphological dilation of the input raster.
+*/
+void dilateSquare(std::vector<double>& data, size_t rows, size_t cols, int radius,
+    int threads = 1);
+
+/**
+  Perform a morphological erosion of the input raster.
+
+  Performs a morphological erosion of the input raster using a square
+  structuring element of (2 * radius + 1) cells on a side. NaN cells are
+  ignored. The input and output rasters are stored in column major order.
+
+  \param data the input raster.
+  \param rows the number of rows.
+  \param cols the number of cols.
+  \param radius the number of cells on each side of the center cell.
+  \param threads the number of threads over which to split the work.
+  \return the morphological erosion of the input raster.
+*/
+void erodeSquare(std::vector<double>& data, size_t rows, size_t cols, int radius,
+    int threads = 1);
 
 /**
   Converts a PointView into an Eigen::MatrixXd.
@@ -0,0 +1,173 @@
+/******************************************************************************
+* Copyright (c) 2026, Hobu Inc. (info@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#include "Parallel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <thread>
+
+#include <pdal/util/ThreadPool.hpp>
+
+namespace pdal
+{
+
+namespace
+{
+
+// State of a parallelFor() call.  Pool tasks hold a reference to it, so it
+// stays valid for tasks that only start once all ranges have been run.
+struct Ranges
+{
+    Ranges(size_t count, size_t grain,
+            const std::function<void(size_t, size_t)>& f) :
+        m_count(count), m_grain(grain),
+        m_size((count + grain - 1) / grain), m_next(0), m_failed(false),
+        m_done(0), m_f(f)
+    {}
+
+    // Run ranges until none are left to start.  'm_f' is only used once a
+    // range has been claimed, while the caller is still waiting.
+    void run()
+    {
+        while (true)
+        {
+            const size_t r = m_next++;
+            if (r >= m_size)
+                return;
+
+            std::exception_ptr err;
+            if (!m_failed)
+            {
+                try
+                {
+                    const size_t begin = r * m_grain;
+                    m_f(begin, (std::min)(m_count, begin + m_grain));
+                }
+                catch (...)
+                {
+                    err = std::current_exception();
+                }
+            }
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (err && !m_error)
+            {
+                m_error = err;
+                m_failed = true;
+            }
+            if (++m_done == m_size)
+                m_cv.notify_all();
+        }
+    }
+
+    size_t m_count;
+    size_t m_grain;
+    size_t m_size;
+    std::atomic<size_t> m_next;
+    std::atomic<bool> m_failed;
+    size_t m_done;
+    std::exception_ptr m_error;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    const std::function<void(size_t, size_t)>& m_f;
+};
+
+} // unnamed namespace
+
+
+ThreadPool& sharedThreadPool()
+{
+    static ThreadPool pool((std::max)(std::thread::hardware_concurrency(),
+        1u));
+    return pool;
+}
+
+
+void parallelFor(size_t count, int threads,
+    const std::function<void(size_t, size_t)>& f, size_t grain)
+{
+    if (count == 0)
+        return;
+    threads = (std::max)(threads, 1);
+    if (grain == 0)
+        grain = (count + threads - 1) / threads;
+
+    const size_t numRanges = (count + grain - 1) / grain;
+    if (threads == 1 || numRanges == 1)
+    {
+        for (size_t begin = 0; begin < count; begin += grain)
+            f(begin, (std::min)(count, begin + grain));
+        return;
+    }
+
+    // The calling thread runs ranges too, so it never waits on tasks that
+    // haven't started.  This allows parallelFor() to be called from a pool
+    // task.
+    auto ranges = std::make_shared<Ranges>(count, grain, f);
+    ThreadPool& pool = sharedThreadPool();
+    const size_t tasks = (std::min)({ (size_t)threads - 1, numRanges - 1,
+        pool.size() });
+    for (size_t i = 0; i < tasks; ++i)
+        pool.add([ranges](){ ranges->run(); });
+    ranges->run();
+
+    std::unique_lock<std::mutex> lock(ranges->m_mutex);
+    ranges->m_cv.wait(lock, [&ranges]()
+        { return ranges->m_done == ranges->m_size; });
+    if (ranges->m_error)
+        std::rethrow_exception(ranges->m_error);
+}
+
+
+void forEachBlock(point_count_t count,
+    const std::function<void(const PointIdList&)>& f,
+    point_count_t blockSize)
+{
+    PointIdList ids;
+    for (PointId start = 0; start < count; start += blockSize)
+    {
+        PointId end = (std::min)(count, start + blockSize);
+        ids.resize(end - start);
+        std::iota(ids.begin(), ids.end(), start);
+        f(ids);
+    }
+}
+
+} // namespace pdal
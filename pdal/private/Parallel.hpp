@@ -0,0 +1,68 @@
+/******************************************************************************
+* Copyright (c) 2026, Hobu Inc. (info@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+#include <pdal/pdal_internal.hpp>
+
+namespace pdal
+{
+
+class ThreadPool;
+
+// Pool of worker threads shared by stages that split work among threads.
+// It has a thread for each hardware thread and is created on first use.
+PDAL_EXPORT ThreadPool& sharedThreadPool();
+
+// Call f(begin, end) for consecutive ranges of at most 'grain' items that
+// cover [0, count).  The ranges are run by up to 'threads' threads: the
+// calling thread and tasks on the shared pool.  If 'grain' is zero, the
+// items are split evenly among the threads.  Returns once every range has
+// been run.  The first exception thrown by 'f' is rethrown and ranges that
+// haven't started when it's thrown are skipped.
+PDAL_EXPORT void parallelFor(size_t count, int threads,
+    const std::function<void(size_t, size_t)>& f, size_t grain = 0);
+
+// Call f(ids) for consecutive blocks of at most 'blockSize' point IDs that
+// cover [0, count).  Blocks are passed in order on the calling thread.
+// Stages that query a KD index for all points use this to bound the memory
+// held by the results of one query.
+PDAL_EXPORT void forEachBlock(point_count_t count,
+    const std::function<void(const PointIdList&)>& f,
+    point_count_t blockSize = 65536);
+
+} // namespace pdal
@@ -31,6 +31,8 @@
 #include "SrsTransform.hpp"
 #include <pdal/SpatialReference.hpp>
 
+#include <algorithm>
+
 #include <ogr_spatialref.h>
 
 namespace pdal
@@ -41,8 +43,14 @@ SrsTransform::SrsTransform()
 
 SrsTransform::SrsTransform(const SrsTransform& src)
 {
-    if (src.valid())
-        set(*(src.m_transform->GetSourceCS()), *(src.m_transform->GetTargetCS()));
+    if (!src.valid())
+        return;
+#if GDAL_VERSION_NUM >= GDAL_COMPUTE_VERSION(3,1,0)
+    // Cloning keeps any axis mapping and epochs of the source transform.
+    m_transform.reset(src.m_transform->Clone());
+#else
+    set(*(src.m_transform->GetSourceCS()), *(src.m_transform->GetTargetCS()));
+#endif
 }
 
 
@@ -158,11 +166,27 @@ bool SrsTransform::transform(double& x, double& y, double& z) const
 bool SrsTransform::transform(std::vector<double>& x, std::vector<double>& y,
     std::vector<double>& z) const
 {
-    if (x.size() != y.size() && y.size() != z.size())
+    if (x.size() != y.size() || y.size() != z.size())
         throw pdal_error("SrsTransform::called with vectors of different "
             "sizes.");
-    int err = m_transform->Transform(x.size(), x.data(), y.data(), z.data());
-    return (err == OGRERR_NONE);
+    return transform(x.data(), y.data(), z.data(), x.size());
+}
+
+
+bool SrsTransform::transform(double *x, double *y, double *z, size_t count,
+    int *success) const
+{
+    if (!m_transform)
+        return false;
+    if (count == 0)
+        return true;
+
+    // OGR returns TRUE (not OGRERR_NONE) on success.
+    bool ok = m_transform->Transform(count, x, y, z, success);
+    if (success)
+        ok = std::all_of(success, success + count,
+            [](int i){ return i != 0; });
+    return ok;
 }
 
 } // namespace pdal
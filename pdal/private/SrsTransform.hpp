@@ -80,6 +80,18 @@ public:
     bool transform(std::vector<double>& x, std::vector<double>& y,
         std::vector<double>& z) const;
 
+    /// Transform arrays of points in place with a single call to PROJ.
+    /// \param x  X coordinates
+    /// \param y  Y coordinates
+    /// \param z  Z coordinates
+    /// \param count  Number of points
+    /// \param success  If not null, set to non-zero for each point that was
+    ///   transformed successfully.  OGR sets the coordinates of points
+    ///   that fail to HUGE_VAL.
+    /// \return  True if all the points were transformed successfully
+    bool transform(double *x, double *y, double *z, size_t count,
+        int *success = nullptr) const;
+
     /// Determine if this represents a valid transform.
     /// \return  Whether the transform is valid or not.
     bool valid() const
@@ -44,6 +44,7 @@
 #pragma warning(pop)
 #endif
 
+#include <pdal/PointView.hpp>
 #include <pdal/util/Algorithm.hpp>
 
 #include "Raster.hpp"
@@ -191,6 +192,12 @@ Raster::Raster(const std::string& filename, const std::string& drivername)
     , m_numBands(0)
     , m_drivername(drivername)
     , m_ds(0)
+    , m_blockWidth(0)
+    , m_blockHeight(0)
+    , m_nativeBlockWidth(0)
+    , m_nativeBlockHeight(0)
+    , m_cacheLimit(DefaultCacheSize)
+    , m_cacheBytes(0)
 {
     m_forwardTransform.fill(0);
     m_forwardTransform[1] = 1;
@@ -217,6 +224,12 @@ Raster::Raster(const std::string& filename, const std::string& drivername,
     , m_forwardTransform(pixelToPos)
     , m_srs(srs)
     , m_ds(0)
+    , m_blockWidth(0)
+    , m_blockHeight(0)
+    , m_nativeBlockWidth(0)
+    , m_nativeBlockHeight(0)
+    , m_cacheLimit(DefaultCacheSize)
+    , m_cacheBytes(0)
 {}
 
 
@@ -393,6 +406,21 @@ GDALError Raster::wake()
     m_height = m_ds->GetRasterYSize();
     m_numBands = m_ds->GetRasterCount();
 
+    // Points are sampled a block at a time using the block size of the
+    // first band.
+    clearCache();
+    m_nativeBlockWidth = 0;
+    m_nativeBlockHeight = 0;
+    if (m_numBands)
+        m_ds->GetRasterBand(1)->GetBlockSize(&m_nativeBlockWidth,
+            &m_nativeBlockHeight);
+    if (m_nativeBlockWidth <= 0 || m_nativeBlockHeight <= 0)
+    {
+        m_nativeBlockWidth = m_width;
+        m_nativeBlockHeight = 1;
+    }
+    setBlockWindow();
+
     if (computePDALDimensionTypes() == GDALError::InvalidBand)
         error = GDALError::InvalidBand;
     return error;
@@ -537,10 +565,7 @@ GDALError Raster::computePDALDimensionTypes()
   \param[out] data  Vector of raster data associated with the provided point.
   \return  Error code or GDALError::None.
 */
-GDALError Raster::read(double x,
-        double y,
-        std::vector<double>& data,
-        std::array<double, 2>& pix)
+GDALError Raster::read(double x, double y, std::vector<double>& data)
 {
     if (!m_ds)
     {
@@ -552,8 +577,6 @@ GDALError Raster::read(double x,
     int32_t line(0);
     data.resize(m_numBands);
 
-//     std::array<double, 2> pix = { {0.0, 0.0} };
-
     // No data at this x,y if we can't compute a pixel/line location
     // for it.
     if (!getPixelAndLinePosition(x, y, pixel, line))
@@ -561,21 +584,248 @@ GDALError Raster::read(double x,
         m_errorMsg = "Requested location is not in the raster.";
         return GDALError::NoData;
     }
+    if (m_numBands == 0)
+        return GDALError::None;
+
+    const Block *block = fetchBlock(pixel, line);
+    if (!block)
+        return GDALError::CantReadBlock;
+    sample(*block, pixel, line, data.data());
+    return GDALError::None;
+}
+
+
+/**
+  Fetch the raster data associated with a list of positions.
+  \param x  X positions of points to fetch raster data for.
+  \param y  Y positions of points to fetch raster data for.
+  \param[out] data  Raster data for each position, stored one position
+    after another.
+  \param[out] found  Whether each position is in the raster.
+  \return  Error code or GDALError::None.
+*/
+GDALError Raster::read(const std::vector<double>& x,
+    const std::vector<double>& y, std::vector<double>& data,
+    std::vector<uint8_t>& found)
+{
+    struct Position
+    {
+        uint64_t key;
+        int32_t pixel;
+        int32_t line;
+        size_t idx;
+    };
+
+    if (!m_ds)
+    {
+        m_errorMsg = "Raster not open.";
+        return GDALError::NotOpen;
+    }
 
-    for (int i=0; i < m_numBands; ++i)
+    size_t count = (std::min)(x.size(), y.size());
+    data.resize(count * m_numBands);
+    found.assign(count, 0);
+
+    std::vector<Position> positions;
+    positions.reserve(count);
+    for (size_t i = 0; i < count; ++i)
     {
-        GDALRasterBandH b = GDALGetRasterBand(m_ds, i + 1);
-        if (GDALRasterIO(b, GF_Read, pixel, line, 1, 1,
-            &pix[0], 1, 1, GDT_Float64, 0, 0) == CE_None)
+        int32_t pixel;
+        int32_t line;
+        if (getPixelAndLinePosition(x[i], y[i], pixel, line))
         {
-            // we read a pixel put its values in our vector
-            data[i] = pix[0];
+            if (m_numBands)
+                positions.push_back({ blockKey(pixel, line), pixel, line, i });
+            found[i] = 1;
         }
     }
 
+    // Group the positions by block so that each block is fetched once.
+    std::sort(positions.begin(), positions.end(),
+        [](const Position& a, const Position& b){ return a.key < b.key; });
+
+    const Block *block = nullptr;
+    for (const Position& p : positions)
+    {
+        if (!block || block->key != p.key)
+        {
+            block = fetchBlock(p.pixel, p.line);
+            if (!block)
+                return GDALError::CantReadBlock;
+        }
+        sample(*block, p.pixel, p.line, data.data() + p.idx * m_numBands);
+    }
     return GDALError::None;
 }
 
+
+GDALError Raster::openForSampling(size_t cacheSize, int band, LogPtr log)
+{
+    GDALError error = open();
+    if (error == GDALError::NoTransform || error == GDALError::NotInvertible)
+    {
+        log->get(LogLevel::Warning) << m_errorMsg << std::endl;
+        error = GDALError::None;
+    }
+    if (error != GDALError::None)
+        return error;
+
+    if (band > m_numBands)
+    {
+        m_errorMsg = "Band " + std::to_string(band) + " is not in raster '" +
+            m_filename + "'.";
+        return GDALError::InvalidBand;
+    }
+    setCacheSize(cacheSize);
+    return GDALError::None;
+}
+
+
+GDALError Raster::sampleView(const PointView& view, const PointFilter& include,
+    const SampleFunc& f)
+{
+    const PointId BatchSize = 65536;
+
+    std::vector<PointId> ids;
+    std::vector<double> xs;
+    std::vector<double> ys;
+    std::vector<double> data;
+    std::vector<uint8_t> found;
+    for (PointId start = 0; start < view.size(); start += BatchSize)
+    {
+        PointId end = (std::min)(start + BatchSize, view.size());
+        ids.clear();
+        xs.clear();
+        ys.clear();
+        for (PointId idx = start; idx < end; ++idx)
+        {
+            if (include && !include(idx))
+                continue;
+            ids.push_back(idx);
+            xs.push_back(view.getFieldAs<double>(Dimension::Id::X, idx));
+            ys.push_back(view.getFieldAs<double>(Dimension::Id::Y, idx));
+        }
+
+        GDALError error = read(xs, ys, data, found);
+        if (error != GDALError::None)
+            return error;
+        for (size_t i = 0; i < ids.size(); ++i)
+            if (found[i])
+                f(ids[i], data.data() + i * m_numBands);
+    }
+    return GDALError::None;
+}
+
+
+void Raster::setCacheSize(size_t bytes)
+{
+    m_cacheLimit = bytes;
+    if (m_nativeBlockWidth > 0)
+    {
+        int width = m_blockWidth;
+        int height = m_blockHeight;
+        setBlockWindow();
+        // Cached blocks are keyed by the window, so drop them if it changed.
+        if (width != m_blockWidth || height != m_blockHeight)
+            clearCache();
+    }
+    while (m_blocks.size() > 1 && m_cacheBytes > m_cacheLimit)
+    {
+        m_cacheBytes -= m_blocks.back().data.size() * sizeof(double);
+        m_blockIndex.erase(m_blocks.back().key);
+        m_blocks.pop_back();
+    }
+}
+
+
+// Set the area read at once when sampling.  This is the native block
+// unless the block doesn't fit in the cache, in which case it is read in
+// bands of rows (or parts of rows, for very wide blocks).
+void Raster::setBlockWindow()
+{
+    size_t pixelBytes = (std::max)(m_numBands, 1) * sizeof(double);
+    size_t maxPixels = (std::max)(m_cacheLimit / pixelBytes, (size_t)1);
+    m_blockWidth = (int)(std::min)((size_t)m_nativeBlockWidth, maxPixels);
+    m_blockHeight = (int)(std::min)((size_t)m_nativeBlockHeight,
+        (std::max)(maxPixels / m_blockWidth, (size_t)1));
+}
+
+
+uint64_t Raster::blockKey(int pixel, int line) const
+{
+    uint64_t col = (uint64_t)(pixel / m_blockWidth);
+    uint64_t row = (uint64_t)(line / m_blockHeight);
+    return (row << 32) | col;
+}
+
+
+/**
+  Find the block containing a pixel in the cache, reading it if necessary.
+  All bands of the block are read at once.
+  \param pixel  Raster pixel (column) position.
+  \param line  Raster line (row) position.
+  \return  Pointer to the block, or nullptr if it couldn't be read.  The
+    pointer is valid until the next block is fetched.
+*/
+const Raster::Block *Raster::fetchBlock(int pixel, int line)
+{
+    uint64_t key = blockKey(pixel, line);
+    auto it = m_blockIndex.find(key);
+    if (it != m_blockIndex.end())
+    {
+        m_blocks.splice(m_blocks.begin(), m_blocks, it->second);
+        return &m_blocks.front();
+    }
+
+    int x = (pixel / m_blockWidth) * m_blockWidth;
+    int y = (line / m_blockHeight) * m_blockHeight;
+    int width = (std::min)(m_blockWidth, m_width - x);
+    int height = (std::min)(m_blockHeight, m_height - y);
+
+    Block block { key, width, std::vector<double>() };
+    block.data.resize((size_t)width * height * m_numBands);
+    if (GDALDatasetRasterIO(m_ds, GF_Read, x, y, width, height,
+        block.data.data(), width, height, GDT_Float64, m_numBands, nullptr,
+        0, 0, 0) != CE_None)
+    {
+        m_errorMsg = "Unable to read block for raster '" + m_filename + "'.";
+        return nullptr;
+    }
+
+    // Evict least recently used blocks to make room.
+    size_t bytes = block.data.size() * sizeof(double);
+    while (m_blocks.size() && m_cacheBytes + bytes > m_cacheLimit)
+    {
+        m_cacheBytes -= m_blocks.back().data.size() * sizeof(double);
+        m_blockIndex.erase(m_blocks.back().key);
+        m_blocks.pop_back();
+    }
+    m_blocks.push_front(std::move(block));
+    m_blockIndex[key] = m_blocks.begin();
+    m_cacheBytes += bytes;
+    return &m_blocks.front();
+}
+
+
+// Copy the value of each band at a pixel in a block to 'out'.
+void Raster::sample(const Block& block, int pixel, int line, double *out) const
+{
+    size_t bandSize = block.data.size() / m_numBands;
+    size_t pos = (size_t)(line % m_blockHeight) * block.width +
+        (pixel % m_blockWidth);
+    for (int i = 0; i < m_numBands; ++i)
+        out[i] = block.data[i * bandSize + pos];
+}
+
+
+void Raster::clearCache()
+{
+    m_blocks.clear();
+    m_blockIndex.clear();
+    m_cacheBytes = 0;
+}
+
+
 GDALError Raster::read(int band, int x, int y, int width, int height, std::vector<double>& data) {
     if (!m_ds)
     {
@@ -636,6 +886,7 @@ void Raster::close()
     GDALClose(m_ds);
     m_ds = nullptr;
     m_types.clear();
+    clearCache();
 }
 
 
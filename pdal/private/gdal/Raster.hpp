@@ -35,8 +35,13 @@
 #pragma once
 
 #include <array>
+#include <functional>
+#include <list>
+#include <unordered_map>
+#include <vector>
 
 #include <pdal/DimUtil.hpp>
+#include <pdal/Log.hpp>
 #include <pdal/pdal_types.hpp>
 #include <pdal/SpatialReference.hpp>
 #include <pdal/util/Bounds.hpp>
@@ -50,6 +55,9 @@ class GDALRasterBand;
 
 namespace pdal
 {
+
+class PointView;
+
 namespace gdal
 {
 
@@ -311,7 +319,10 @@ public:
       \param pixelToPos  Transformation matrix to convert raster positions to
         geolocations.
     */
-    Raster(GDALDataset *ds) : m_ds (ds) {};
+    Raster(GDALDataset *ds) : m_ds (ds), m_blockWidth(0), m_blockHeight(0),
+        m_nativeBlockWidth(0), m_nativeBlockHeight(0),
+        m_cacheLimit(DefaultCacheSize), m_cacheBytes(0)
+    {};
 
     /**
       Return a GDAL MEM driver copy of the raster
@@ -323,6 +334,19 @@ public:
     */
     GDALError open(StringList options = StringList());
 
+    /**
+      Open raster file for sampling at points and set the size of the
+      block cache.  A raster without a usable transform can still be
+      sampled, so that error is logged as a warning.
+
+      \param cacheSize  Size of the block cache in bytes.
+      \param band  Band that will be sampled (1-indexed), or 0 if no
+        particular band is needed.
+      \param log  Log for warnings.
+      \return  Error code or GDALError::None.
+    */
+    GDALError openForSampling(size_t cacheSize, int band, LogPtr log);
+
     /**
       Open a raster for writing.
 
@@ -463,12 +487,56 @@ public:
     /**
       Read the data for each band at x/y into a vector of doubles.  x and y
       are transformed to the basis of the raster before the data is fetched.
+      The raster block that contains the position is read for all bands
+      and cached.
 
       \param x  X position to read
       \param y  Y position to read
       \param data  Vector in which to store data.
     */
-    GDALError read(double x, double y, std::vector<double>& data, std::array<double, 2>& pix);
+    GDALError read(double x, double y, std::vector<double>& data);
+
+    /**
+      Read the data for each band at a list of positions.  Positions are
+      grouped by raster block so that each block is fetched once.
+
+      \param x  X positions to read.
+      \param y  Y positions to read.  Must be the same size as \c x.
+      \param[out] data  Band values.  Values for position N are stored at
+        offset N * bandCount().
+      \param[out] found  Set to 1 for each position in the raster and 0 for
+        each position outside of the raster.
+      \return  Error code or GDALError::None.
+    */
+    GDALError read(const std::vector<double>& x, const std::vector<double>& y,
+        std::vector<double>& data, std::vector<uint8_t>& found);
+
+    using PointFilter = std::function<bool(PointId)>;
+    using SampleFunc = std::function<void(PointId, const double *)>;
+
+    /**
+      Sample the raster at the points of a view.  Points are read in
+      batches so that memory use is bounded, and the points of a batch are
+      grouped by block so that each block is fetched once.
+
+      \param view  View whose points are sampled.
+      \param include  Returns whether a point should be sampled.  If empty,
+        every point is sampled.
+      \param f  Called in point order for each sampled point that is in
+        the raster, with the point's ID and its bandCount() values.
+      \return  Error code or GDALError::None.
+    */
+    GDALError sampleView(const PointView& view, const PointFilter& include,
+        const SampleFunc& f);
+
+    /**
+      Set the maximum number of bytes used to cache blocks read by the
+      point-sampling read functions.  At least one block is always cached.
+      Blocks larger than the cache are read in bands of rows.
+
+      \param bytes  Size of the cache in bytes.
+    */
+    void setCacheSize(size_t bytes);
 
     /**
      Read a block of data for a band into a vector of bytes.
@@ -546,7 +614,19 @@ public:
 
     void getBlockSize(int band, int &xSize, int &ySize) const;
 
+    // Default size of the block cache (64MB).
+    static const size_t DefaultCacheSize = 64 * 1024 * 1024;
+
 private:
+    // Values of all bands for a block of the raster, stored band by band.
+    struct Block
+    {
+        uint64_t key;
+        int width;
+        std::vector<double> data;
+    };
+    using BlockList = std::list<Block>;
+
     std::string m_filename;
 
     int m_width;
@@ -565,6 +645,24 @@ private:
     mutable std::string m_errorMsg;
     mutable std::vector<pdal::Dimension::Type> m_types;
 
+    // LRU cache of blocks used when sampling the raster at points.  The
+    // most recently used block is at the front of the list.  Blocks are
+    // the raster's native blocks unless those don't fit in the cache.
+    int m_blockWidth;
+    int m_blockHeight;
+    int m_nativeBlockWidth;
+    int m_nativeBlockHeight;
+    size_t m_cacheLimit;
+    size_t m_cacheBytes;
+    BlockList m_blocks;
+    std::unordered_map<uint64_t, BlockList::iterator> m_blockIndex;
+
+    void setBlockWindow();
+    uint64_t blockKey(int pixel, int line) const;
+    const Block *fetchBlock(int pixel, int line);
+    void sample(const Block& block, int pixel, int line, double *out) const;
+    void clearCache();
+
     GDALError validateType(Dimension::Type& type, GDALDriver *driver);
     bool getPixelAndLinePosition(double x, double y,
         int32_t& pixel, int32_t& line);
@@ -615,6 +615,24 @@ MapContext unmapFile(MapContext ctx)
     return ctx;
 }
 
+void adviseMap(const MapContext& ctx, MapAdvice advice, uintmax_t pos,
+    uintmax_t size)
+{
+    if (!ctx.m_addr || pos >= ctx.m_size)
+        return;
+    if (size == 0 || size > ctx.m_size - pos)
+        size = ctx.m_size - pos;
+#ifndef _WIN32
+    // The address passed to madvise() must be page-aligned.
+    const uintmax_t pageSize = (uintmax_t)::sysconf(_SC_PAGESIZE);
+    const uintmax_t start = pos - pos % pageSize;
+    ::madvise((char *)ctx.m_addr + start, (size_t)(size + pos - start),
+        advice == MapAdvice::Sequential ? MADV_SEQUENTIAL : MADV_WILLNEED);
+#else
+    (void)advice;
+#endif
+}
+
 } // namespace FileUtils
 } // namespace pdal
 
@@ -331,5 +331,26 @@ namespace FileUtils
     */
     PDAL_EXPORT MapContext unmapFile(MapContext ctx);
 
+    /**
+      How a range of a mapped file is going to be accessed.
+    */
+    enum class MapAdvice
+    {
+        Sequential,  ///< The range will be read in order.
+        WillNeed     ///< The range will be read soon.
+    };
+
+    /**
+      Advise the system how a range of a mapped file will be accessed.
+      This is only a hint and does nothing where it isn't supported.
+      \param ctx  Previously returned MapContext
+      \param advice  How the range will be accessed.
+      \param pos  Start of the range, relative to the start of the mapping.
+      \param size  Number of bytes in the range.  0 means the range extends
+         to the end of the mapping.
+    */
+    PDAL_EXPORT void adviseMap(const MapContext& ctx, MapAdvice advice,
+        uintmax_t pos = 0, uintmax_t size = 0);
+
 } // namespace FileUtils
 } // namespace pdal
@@ -32,6 +32,8 @@
 * OF SUCH DAMAGE.
 ****************************************************************************/
 
+#include <algorithm>
+#include <array>
 #include <memory>
 #include <vector>
 
@@ -68,6 +70,66 @@ static PluginInfo const s_info
 
 CREATE_SHARED_STAGE(ArrowWriter, s_info)
 
+// Call f(data, n, offset) for each run of consecutive values of the 'count'
+// points starting at 'start' in a list of column spans.  'offset' is the
+// position of the run's first point relative to 'start'.
+template<typename T, typename F>
+void forColumnRuns(const std::vector<ColumnSpan<T>>& spans, PointId start,
+    point_count_t count, F f)
+{
+    PointId pos = 0;
+    point_count_t done = 0;
+    for (const ColumnSpan<T>& span : spans)
+    {
+        if (done == count)
+            break;
+        if (start < pos + span.size)
+        {
+            point_count_t offset = start - pos;
+            point_count_t n = (std::min)(count - done, span.size - offset);
+            f(span.data + offset, n, done);
+            start += n;
+            done += n;
+        }
+        pos += span.size;
+    }
+}
+
+// Direct access to the X, Y and Z values of a view.
+class XyzColumns
+{
+public:
+    // Returns false if the view doesn't support direct access to all of X,
+    // Y and Z as doubles.
+    bool set(const PointView& view)
+    {
+        using namespace Dimension;
+
+        m_spans[0] = view.column<const double>(Id::X);
+        m_spans[1] = view.column<const double>(Id::Y);
+        m_spans[2] = view.column<const double>(Id::Z);
+        return m_spans[0].size() && m_spans[1].size() && m_spans[2].size();
+    }
+
+    // Copy X, Y and Z of 'count' points starting at 'start' to 'out', one
+    // point after another.
+    void copy(PointId start, point_count_t count, double *out) const
+    {
+        for (size_t i = 0; i < 3; ++i)
+            forColumnRuns(m_spans[i], start, count,
+                [out, i](const double *data, point_count_t n,
+                    point_count_t offset)
+                {
+                    double *o = out + offset * 3 + i;
+                    for (point_count_t k = 0; k < n; ++k, o += 3)
+                        *o = data[k];
+                });
+    }
+
+private:
+    std::array<std::vector<ColumnSpan<const double>>, 3> m_spans;
+};
+
 class BaseDimHandler
 {
 public:
@@ -78,6 +140,14 @@ public:
     virtual std::shared_ptr<arrow::Field> field() = 0;
     // Append a the dimension data from a point to an array builder.
     virtual Utils::StatusWithReason append(const PointRef& point) = 0;
+    // Prepare to append dimension data directly from the memory of a view.
+    // Returns false if that isn't possible.
+    virtual bool setColumn(const PointView& view)
+        { return false; }
+    // Append the dimension data for 'count' points of the view passed to
+    // setColumn(), starting at point 'start'.
+    virtual Utils::StatusWithReason appendColumn(PointId start, point_count_t count)
+        { return { -1, "Direct dimension access isn't supported." }; }
     // Finish building of point data for a builder. The builder is reused for the next
     // data block.
     virtual Utils::StatusWithReason finish(std::shared_ptr<arrow::Array>& array)
@@ -125,6 +195,26 @@ public:
         return true;
     }
 
+    bool setColumn(const PointView& view) override
+    {
+        m_spans = view.column<const DT>(m_id);
+        return m_spans.size();
+    }
+
+    Utils::StatusWithReason appendColumn(PointId start, point_count_t count) override
+    {
+        arrow::Status status;
+        forColumnRuns(m_spans, start, count,
+            [this, &status](const DT *data, point_count_t n, point_count_t)
+            {
+                if (status.ok())
+                    status = m_builder.AppendValues(data, (int64_t)n);
+            });
+        if (!status.ok())
+            return { -1, status.message() };
+        return true;
+    }
+
 private:
     arrow::ArrayBuilder& builder() override
     { return m_builder; }
@@ -133,6 +223,7 @@ private:
     arrow::NumericBuilder<typename TypeTraits<DT>::TypeClass> m_builder;
     Dimension::Id m_id;
     std::string m_name;
+    std::vector<ColumnSpan<const DT>> m_spans;
 };
 
 // Handler for packed XYZ data.
@@ -179,6 +270,21 @@ public:
         return true;
     }
 
+    bool setColumn(const PointView& view) override
+        { return m_columns.set(view); }
+
+    Utils::StatusWithReason appendColumn(PointId start, point_count_t count) override
+    {
+        m_xyz.resize(count * 3);
+        m_columns.copy(start, count, m_xyz.data());
+
+        arrow::Status status = m_builder.AppendValues((int64_t)count) &
+            m_doubleBuilder->AppendValues(m_xyz.data(), (int64_t)m_xyz.size());
+        if (!status.ok())
+            return { -1, status.message() };
+        return true;
+    }
+
 private:
     arrow::ArrayBuilder& builder() override
     { return m_builder; }
@@ -188,6 +294,8 @@ private:
     std::string m_pipelineMetadata;
     std::shared_ptr<arrow::DoubleBuilder> m_doubleBuilder;
     arrow::FixedSizeListBuilder m_builder;
+    XyzColumns m_columns;
+    std::vector<double> m_xyz;
 };
 
 // Handler for WKB-encoded XYZ data per GeoParquet specification.
@@ -214,8 +322,36 @@ public:
         return arrow::field("wkb", arrow::binary(), kvMetadata);
     }
 
-    // Write XYZ as little-endian encoded well-known binary.
     Utils::StatusWithReason append(const PointRef& point) override
+    {
+        return appendWkb(point.getFieldAs<double>(Dimension::Id::X),
+            point.getFieldAs<double>(Dimension::Id::Y),
+            point.getFieldAs<double>(Dimension::Id::Z));
+    }
+
+    bool setColumn(const PointView& view) override
+        { return m_columns.set(view); }
+
+    Utils::StatusWithReason appendColumn(PointId start, point_count_t count) override
+    {
+        m_xyz.resize(count * 3);
+        m_columns.copy(start, count, m_xyz.data());
+
+        for (auto it = m_xyz.begin(); it != m_xyz.end(); it += 3)
+        {
+            auto ok = appendWkb(*it, *(it + 1), *(it + 2));
+            if (!ok)
+                return ok;
+        }
+        return true;
+    }
+
+    arrow::ArrayBuilder& builder() override
+    { return m_builder; }
+
+private:
+    // Write XYZ as little-endian encoded well-known binary.
+    Utils::StatusWithReason appendWkb(double x, double y, double z)
     {
         auto tole = [](double d)
         {
@@ -225,9 +361,9 @@ public:
             return d;
         };
 
-        double x = tole(point.getFieldAs<double>(Dimension::Id::X));
-        double y = tole(point.getFieldAs<double>(Dimension::Id::Y));
-        double z = tole(point.getFieldAs<double>(Dimension::Id::Z));
+        x = tole(x);
+        y = tole(y);
+        z = tole(z);
 
         // The first five bytes in the buffer is the magic code for a
         // little-endian encoded XYZ 2.5d point. The first byte is the little-endian
@@ -249,11 +385,9 @@ public:
         return true;
     }
 
-    arrow::ArrayBuilder& builder() override
-    { return m_builder; }
-
-private:
     arrow::BinaryBuilder m_builder;
+    XyzColumns m_columns;
+    std::vector<double> m_xyz;
 };
 
 
@@ -406,8 +540,45 @@ void ArrowWriter::ready(PointTableRef table)
 
 void ArrowWriter::write(const PointViewPtr view)
 {
-    for (PointRef point : *view)
-        processOne(point);
+    // Append the dimension data directly from the view's memory for the
+    // handlers that support it.  The others get the data point by point.
+    std::vector<BaseDimHandler *> columnHandlers;
+    std::vector<BaseDimHandler *> pointHandlers;
+    for (auto& handler : m_dimHandlers)
+        if (handler->setColumn(*view))
+            columnHandlers.push_back(handler.get());
+        else
+            pointHandlers.push_back(handler.get());
+
+    PointRef point(*view, 0);
+    PointId idx = 0;
+    while (idx < view->size())
+    {
+        point_count_t count = (std::min)(view->size() - idx,
+            (point_count_t)m_batchSize - m_batchIndex);
+        for (BaseDimHandler *handler : columnHandlers)
+        {
+            auto ok = handler->appendColumn(idx, count);
+            if (!ok)
+                throwError("Unable to append point data to arrow array: " + ok.what() + ".");
+        }
+        if (pointHandlers.size())
+            for (PointId i = idx; i < idx + count; ++i)
+            {
+                point.setPointId(i);
+                for (BaseDimHandler *handler : pointHandlers)
+                {
+                    auto ok = handler->append(point);
+                    if (!ok)
+                        throwError("Unable to append point data to arrow "
+                            "array: " + ok.what() + ".");
+                }
+            }
+        idx += count;
+        m_batchIndex += count;
+        if (m_batchIndex == (point_count_t)m_batchSize)
+            flushBatch();
+    }
 }
 
 void ArrowWriter::gatherParquetGeoMetadata(std::shared_ptr<arrow::KeyValueMetadata>& input,
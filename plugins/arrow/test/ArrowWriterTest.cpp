@@ -35,6 +35,7 @@
 #include <pdal/pdal_test_main.hpp>
 
 #include "Support.hpp"
+#include <pdal/util/FileUtils.hpp>
 #include <io/LasReader.hpp>
 #include <io/FauxReader.hpp>
 #include "../io/ArrowWriter.hpp"
@@ -86,6 +87,59 @@ TEST(ArrowWriterTest, write_array_parquet)
     PointViewSet viewSet = writer.execute(table);
 }
 
+namespace
+{
+
+// Write autzen and return the name of the output file.  'columns' tells
+// whether the table gives the writer column spans.
+std::string writeAutzen(PointTableRef table, const std::string& name,
+    const std::string& format, bool columns)
+{
+    std::string filename(Support::temppath(name));
+    FileUtils::deleteFile(filename);
+
+    Options readerOps;
+    readerOps.add("filename", Support::datapath("las/autzen_trim.las"));
+    LasReader reader;
+    reader.setOptions(readerOps);
+
+    // The batches don't line up with the blocks of a column table.
+    Options writerOps;
+    writerOps.add("filename", filename);
+    writerOps.add("format", format);
+    writerOps.add("batch_size", 10000);
+    writerOps.add("write_pipeline_metadata", false);
+    ArrowWriter writer;
+    writer.setInput(reader);
+    writer.setOptions(writerOps);
+
+    writer.prepare(table);
+    PointViewSet viewSet = writer.execute(table);
+    EXPECT_EQ(viewSet.size(), 1u);
+    PointViewPtr view = *viewSet.begin();
+    EXPECT_EQ(view->column<const double>(Dimension::Id::X).empty(), !columns);
+    EXPECT_EQ(view->column<const uint16_t>(Dimension::Id::Intensity).empty(),
+        !columns);
+    return filename;
+}
+
+} // unnamed namespace
+
+// Data written from the column spans of a column table must match data
+// written point by point from a row table.
+TEST(ArrowWriterTest, column_table)
+{
+    for (std::string format : { "feather", "parquet" })
+    {
+        PointTable table;
+        std::string rows = writeAutzen(table, "rows." + format, format, false);
+        ColumnPointTable columnTable;
+        std::string columns = writeAutzen(columnTable, "columns." + format,
+            format, true);
+        EXPECT_TRUE(Support::compare_files(rows, columns)) << format;
+    }
+}
+
 } // namespace arrow
 } // namespace pdal
 
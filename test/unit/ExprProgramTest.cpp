@@ -0,0 +1,246 @@
+/******************************************************************************
+* Copyright (c) 2026, Hobu Inc. (info@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <pdal/pdal_test_main.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <numeric>
+
+#include <pdal/PointTable.hpp>
+#include <pdal/PointView.hpp>
+
+#include <filters/private/expr/ConditionalExpression.hpp>
+#include <filters/private/expr/MathExpression.hpp>
+#include <filters/private/expr/MathParser.hpp>
+
+using namespace pdal;
+
+namespace
+{
+
+void fillView(PointView& view, point_count_t count)
+{
+    using namespace Dimension;
+
+    for (PointId idx = 0; idx < count; ++idx)
+    {
+        view.setField(Id::X, idx, idx * .01);
+        view.setField(Id::Y, idx, (idx % 1000) * .1);
+        view.setField(Id::Z, idx, (double)(idx % 37) - 18);
+        view.setField(Id::Classification, idx, idx % 7);
+    }
+}
+
+void parse(const std::string& s, expr::ConditionalExpression& e,
+    PointLayoutPtr layout)
+{
+    auto status = Utils::fromString(s, e);
+    ASSERT_TRUE((bool)status) << status.what();
+    status = e.prepare(layout);
+    ASSERT_TRUE((bool)status) << status.what();
+}
+
+void parse(const std::string& s, expr::MathExpression& e,
+    PointLayoutPtr layout)
+{
+    expr::Lexer lexer(s);
+    expr::MathParser parser(lexer);
+    ASSERT_TRUE(parser.expression(e) && parser.checkEnd()) << parser.error();
+    auto status = e.prepare(layout);
+    ASSERT_TRUE((bool)status) << status.what();
+}
+
+} // unnamed namespace
+
+// The compiled program should give the same results as evaluating the
+// expression tree.
+TEST(ExprProgramTest, conditional)
+{
+    PointTable table;
+    table.layout()->registerDims({ Dimension::Id::X, Dimension::Id::Y,
+        Dimension::Id::Z, Dimension::Id::Classification });
+    PointView view(table);
+    fillView(view, 1000);
+
+    std::vector<PointId> ids(view.size());
+    std::iota(ids.begin(), ids.end(), 0);
+
+    for (std::string s : { "X > 5", "X > 2 && Y <= 50 || Classification == 2",
+        "!(Z < 0) && Classification != 3", "X * 2 + 1 > Y / (Z + 18)",
+        "-X < -3 && (Y >= 10 + 2 * 3)", "isnan(Y / Classification)",
+        "abs(Z) > 10 && sqrt(X) < 2" })
+    {
+        expr::ConditionalExpression e;
+        parse(s, e, table.layout());
+
+        std::vector<uint8_t> out(ids.size());
+        PointRef point(view, 0);
+        e.eval(point, ids.data(), ids.size(), out.data());
+        for (PointId idx = 0; idx < view.size(); ++idx)
+        {
+            point.setPointId(idx);
+            EXPECT_EQ((bool)out[idx], e.eval(point)) << s << " at " << idx;
+        }
+    }
+}
+
+TEST(ExprProgramTest, math)
+{
+    PointTable table;
+    table.layout()->registerDims({ Dimension::Id::X, Dimension::Id::Y,
+        Dimension::Id::Z, Dimension::Id::Classification });
+    PointView view(table);
+    fillView(view, 1000);
+
+    std::vector<PointId> ids(view.size());
+    std::iota(ids.begin(), ids.end(), 0);
+
+    for (std::string s : { "X", "X * 2 + Y", "Z / Classification",
+        "-(Z - 3) * (2 + 4)", "floor(X) * 2 + sqrt(Y)", "7 * 6" })
+    {
+        expr::MathExpression e;
+        parse(s, e, table.layout());
+
+        std::vector<double> out(ids.size());
+        PointRef point(view, 0);
+        e.eval(point, ids.data(), ids.size(), out.data());
+        for (PointId idx = 0; idx < view.size(); ++idx)
+        {
+            point.setPointId(idx);
+            double d = e.eval(point);
+            if (std::isnan(d))
+                EXPECT_TRUE(std::isnan(out[idx])) << s << " at " << idx;
+            else
+                EXPECT_DOUBLE_EQ(out[idx], d) << s << " at " << idx;
+        }
+    }
+}
+
+TEST(ExprProgramTest, folding)
+{
+    expr::Program prog;
+    int a = prog.constant(2);
+    int b = prog.constant(3);
+    int c = prog.binary(expr::NodeType::Multiply, a, b);
+    EXPECT_TRUE(prog.isConstant(c));
+    EXPECT_EQ(prog.constantValue(c), 6);
+
+    int x = prog.load(Dimension::Id::X);
+    EXPECT_EQ(prog.load(Dimension::Id::X), x);
+    int d = prog.binary(expr::NodeType::Greater, x, c);
+    EXPECT_FALSE(prog.isConstant(d));
+    int e = prog.unary(expr::NodeType::Not, prog.binary(expr::NodeType::Less,
+        a, b));
+    EXPECT_TRUE(prog.isConstant(e));
+    EXPECT_EQ(prog.constantValue(e), 0);
+}
+
+// Micro-benchmark of the tree and compiled evaluators.  Run with
+// --gtest_also_run_disabled_tests.
+TEST(ExprProgramTest, DISABLED_benchmark)
+{
+    using Clock = std::chrono::steady_clock;
+
+    PointTable table;
+    table.layout()->registerDims({ Dimension::Id::X, Dimension::Id::Y,
+        Dimension::Id::Z, Dimension::Id::Classification });
+    PointView view(table);
+    const point_count_t count = 2000000;
+    fillView(view, count);
+
+    std::vector<PointId> ids(count);
+    std::iota(ids.begin(), ids.end(), 0);
+
+    auto report = [](const std::string& s, Clock::duration tree,
+        Clock::duration prog)
+    {
+        using namespace std::chrono;
+        std::cout << s << ": tree " <<
+            duration_cast<milliseconds>(tree).count() << "ms, program " <<
+            duration_cast<milliseconds>(prog).count() << "ms" << std::endl;
+    };
+
+    for (std::string s : { "Classification == 2",
+        "X >= 10 && X < 100 && Y > 20 && Classification != 7",
+        "Z * 2 + 1 > Y / 3 || !(Classification == 1)" })
+    {
+        expr::ConditionalExpression e;
+        parse(s, e, table.layout());
+        PointRef point(view, 0);
+
+        size_t treeCount = 0;
+        auto start = Clock::now();
+        for (PointId idx = 0; idx < count; ++idx)
+        {
+            point.setPointId(idx);
+            treeCount += e.eval(point);
+        }
+        auto tree = Clock::now() - start;
+
+        std::vector<uint8_t> out(count);
+        start = Clock::now();
+        e.eval(point, ids.data(), ids.size(), out.data());
+        size_t progCount = std::accumulate(out.begin(), out.end(), (size_t)0);
+        auto prog = Clock::now() - start;
+
+        EXPECT_EQ(treeCount, progCount);
+        report(s, tree, prog);
+    }
+
+    for (std::string s : { "Z * 2 + 1", "X * 0.5 + Y * 0.25 + Z" })
+    {
+        expr::MathExpression e;
+        parse(s, e, table.layout());
+        PointRef point(view, 0);
+
+        double treeSum = 0;
+        auto start = Clock::now();
+        for (PointId idx = 0; idx < count; ++idx)
+        {
+            point.setPointId(idx);
+            treeSum += e.eval(point);
+        }
+        auto tree = Clock::now() - start;
+
+        std::vector<double> out(count);
+        start = Clock::now();
+        e.eval(point, ids.data(), ids.size(), out.data());
+        double progSum = std::accumulate(out.begin(), out.end(), 0.0);
+        auto prog = Clock::now() - start;
+
+        EXPECT_DOUBLE_EQ(treeSum, progSum);
+        report(s, tree, prog);
+    }
+}
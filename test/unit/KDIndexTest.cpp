@@ -35,6 +35,9 @@
 
 #include <pdal/KDIndex.hpp>
 
+#include <algorithm>
+#include <random>
+
 using namespace pdal;
 
 TEST(KDIndex, neighbors2D)
@@ -378,3 +381,148 @@ TEST(KDIndex, radius3D)
     EXPECT_EQ(ids[2], 2u);
 }
 
+
+// The index searches over a copy of the coordinates made when it was built.
+TEST(KDIndex, snapshot)
+{
+    PointTable table;
+    PointLayoutPtr layout = table.layout();
+    PointView view(table);
+
+    layout->registerDim(Dimension::Id::X);
+    layout->registerDim(Dimension::Id::Y);
+    layout->registerDim(Dimension::Id::Z);
+
+    for (PointId idx = 0; idx < 100; ++idx)
+    {
+        view.setField(Dimension::Id::X, idx, idx);
+        view.setField(Dimension::Id::Y, idx, idx);
+        view.setField(Dimension::Id::Z, idx, idx);
+    }
+
+    KD3Index index(view);
+    index.build();
+    EXPECT_GE(index.memoryUsed(), 100 * 3 * sizeof(double));
+
+    view.setField(Dimension::Id::X, 50, 1000);
+    EXPECT_EQ(index.neighbor(50, 50, 50), 50u);
+
+    Dimension::IdList dims { Dimension::Id::X, Dimension::Id::Y };
+    KDFlexIndex flex(view, dims);
+    flex.build();
+    EXPECT_GE(flex.memoryUsed(), 100 * 2 * sizeof(double));
+    PointIdList ids = flex.radius(50, 1.0);
+    ASSERT_EQ(ids.size(), 1u);
+    EXPECT_EQ(ids[0], 50u);
+}
+
+// Batch queries on an index built with several threads should match
+// single queries on an index built serially.
+TEST(KDIndex, batch)
+{
+    PointTable table;
+    PointLayoutPtr layout = table.layout();
+    PointView view(table);
+
+    layout->registerDim(Dimension::Id::X);
+    layout->registerDim(Dimension::Id::Y);
+    layout->registerDim(Dimension::Id::Z);
+
+    // Points on a 20 x 20 x 20 lattice.
+    for (PointId idx = 0; idx < 8000; ++idx)
+    {
+        view.setField(Dimension::Id::X, idx, idx % 20);
+        view.setField(Dimension::Id::Y, idx, (idx / 20) % 20);
+        view.setField(Dimension::Id::Z, idx, idx / 400);
+    }
+
+    KD3Index serial(view);
+    serial.build();
+    KD3Index parallel(view);
+    parallel.build(4);
+
+    PointIdList ids;
+    for (PointId idx = 0; idx < view.size(); idx += 7)
+        ids.push_back(idx);
+
+    PointIdList indices;
+    std::vector<double> sqr_dists;
+    point_count_t k = parallel.knnSearch(ids, 5, indices, sqr_dists, 4);
+    ASSERT_EQ(k, 5u);
+    ASSERT_EQ(indices.size(), ids.size() * k);
+    for (size_t i = 0; i < ids.size(); ++i)
+    {
+        PointIdList expIndices(k);
+        std::vector<double> expDists(k);
+        serial.knnSearch(ids[i], k, &expIndices, &expDists);
+        for (size_t j = 0; j < k; ++j)
+            EXPECT_DOUBLE_EQ(sqr_dists[i * k + j], expDists[j]);
+        EXPECT_EQ(indices[i * k], ids[i]);
+    }
+
+    std::vector<PointIdList> radii = parallel.radius(ids, 1.5, 4);
+    ASSERT_EQ(radii.size(), ids.size());
+    for (size_t i = 0; i < ids.size(); ++i)
+    {
+        PointIdList exp = serial.radius(ids[i], 1.5);
+        std::sort(exp.begin(), exp.end());
+        std::sort(radii[i].begin(), radii[i].end());
+        EXPECT_EQ(radii[i], exp);
+    }
+}
+
+// An index built with several threads from the column spans of a column
+// table should find the same neighbors as one built from a row table.
+TEST(KDIndex, columnTable)
+{
+    using namespace Dimension;
+
+    PointTable table;
+    ColumnPointTable columnTable;
+    table.layout()->registerDims({ Id::X, Id::Y, Id::Z });
+    columnTable.layout()->registerDims({ Id::X, Id::Y, Id::Z });
+
+    // Enough points to span several blocks of the column table.
+    PointView view(table);
+    PointView columnView(columnTable);
+    std::mt19937 gen(1);
+    std::uniform_real_distribution<double> dist(0, 100);
+    for (PointId idx = 0; idx < 40000; ++idx)
+        for (Id dim : { Id::X, Id::Y, Id::Z })
+        {
+            double d = dist(gen);
+            view.setField(dim, idx, d);
+            columnView.setField(dim, idx, d);
+        }
+    ASSERT_GT(columnView.column<const double>(Id::X).size(), 1u);
+    ASSERT_TRUE(view.column<const double>(Id::X).empty());
+
+    KD2Index index2(view);
+    index2.build();
+    KD2Index columnIndex2(columnView);
+    columnIndex2.build(4);
+    KD3Index index3(view);
+    index3.build();
+    KD3Index columnIndex3(columnView);
+    columnIndex3.build(4);
+    IdList dims { Id::Z, Id::X };
+    KDFlexIndex flex(view, dims);
+    flex.build();
+    KDFlexIndex columnFlex(columnView, dims);
+    columnFlex.build(4);
+
+    for (PointId idx = 0; idx < view.size(); idx += 97)
+    {
+        EXPECT_EQ(columnIndex2.neighbors(idx, 8), index2.neighbors(idx, 8));
+        EXPECT_EQ(columnIndex3.neighbors(idx, 8), index3.neighbors(idx, 8));
+
+        PointRef point(columnView, idx);
+        EXPECT_EQ(columnFlex.neighbors(point, 8), flex.neighbors(point, 8));
+
+        PointIdList exp = flex.radius(idx, 2.0);
+        PointIdList ids = columnFlex.radius(idx, 2.0);
+        std::sort(exp.begin(), exp.end());
+        std::sort(ids.begin(), ids.end());
+        EXPECT_EQ(ids, exp);
+    }
+}
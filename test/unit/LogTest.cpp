@@ -33,6 +33,10 @@
 ****************************************************************************/
 
 #include <pdal/pdal_test_main.hpp>
+
+#include <sstream>
+#include <thread>
+
 #include <pdal/Log.hpp>
 #include <pdal/util/FileUtils.hpp>
 #include "Support.hpp"
@@ -86,4 +90,40 @@ TEST(Log, t2)
     FileUtils::deleteFile(out);
 }
 
+
+// Make sure that threads writing through a buffer don't interleave their
+// output and that threads without a leader use the root leader.
+TEST(Log, buffer)
+{
+    std::ostringstream ss;
+    LogPtr l(Log::makeLog("root", &ss));
+    l->setLevel(LogLevel::Debug);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t)
+        threads.emplace_back([l, t]()
+        {
+            l->startBuffer();
+            for (int i = 0; i < 100; ++i)
+                l->get(LogLevel::Debug) << "thread " << t << " line " << i <<
+                    std::endl;
+            l->flushBuffer();
+        });
+    for (auto& t : threads)
+        t.join();
+
+    std::istringstream in(ss.str());
+    std::string line;
+    std::vector<int> next(4, 0);
+    int lines = 0;
+    while (std::getline(in, line))
+    {
+        ASSERT_EQ(line.find("(root Debug) thread "), 0u) << line;
+        int t = std::stoi(line.substr(20, 1));
+        EXPECT_EQ(line.substr(21), " line " + std::to_string(next[t]++));
+        lines++;
+    }
+    EXPECT_EQ(lines, 400);
+}
+
 }
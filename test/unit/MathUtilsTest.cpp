@@ -32,6 +32,10 @@
 * OF SUCH DAMAGE.
 ****************************************************************************/
 
+#include <array>
+#include <limits>
+#include <random>
+
 #include <pdal/pdal_test_main.hpp>
 #include <pdal/private/MathUtils.hpp>
 
@@ -40,6 +44,116 @@
 namespace pdal
 {
 
+namespace
+{
+
+// Reference implementations of the morphological operations.  The diamond
+// versions apply a 4-neighbor operation 'iterations' times.
+template<typename Compare>
+void refDiamond(std::vector<double>& data, size_t rows, size_t cols,
+    int iterations, double init, Compare cmp)
+{
+    std::vector<double> out(data.size(), init);
+
+    for (int iter = 0; iter < iterations; ++iter)
+    {
+        for (size_t col = 0; col < cols; ++col)
+        {
+            std::array<size_t, 5> idx;
+            size_t index = col*rows;
+            for (size_t row = 0; row < rows; ++row)
+            {
+                size_t j = 0;
+                idx[j++] = index+row;
+                if (row > 0)
+                    idx[j++] = idx[0]-1;
+                if (row < rows-1)
+                    idx[j++] = idx[0]+1;
+                if (col > 0)
+                    idx[j++] = idx[0]-rows;
+                if (col < cols-1)
+                    idx[j++] = idx[0]+rows;
+                for (size_t i = 0; i < j; ++i)
+                    if (cmp(data[idx[i]], out[index+row]))
+                        out[index+row] = data[idx[i]];
+            }
+        }
+        data.swap(out);
+    }
+}
+
+template<typename Compare>
+void refSquare(std::vector<double>& data, size_t rows, size_t cols,
+    int radius, double init, Compare cmp)
+{
+    std::vector<double> out(data.size(), init);
+
+    for (int col = 0; col < (int)cols; ++col)
+        for (int row = 0; row < (int)rows; ++row)
+        {
+            double& o = out[col * rows + row];
+            for (int c = (std::max)(col - radius, 0);
+                    c <= (std::min)(col + radius, (int)cols - 1); ++c)
+                for (int r = (std::max)(row - radius, 0);
+                        r <= (std::min)(row + radius, (int)rows - 1); ++r)
+                    if (cmp(data[c * rows + r], o))
+                        o = data[c * rows + r];
+        }
+    data.swap(out);
+}
+
+} // unnamed namespace
+
+TEST(MathUtilsTest, morphology)
+{
+    using namespace math;
+
+    const double lowest = std::numeric_limits<double>::lowest();
+    const double highest = (std::numeric_limits<double>::max)();
+    auto greater = [](double a, double b) { return a > b; };
+    auto less = [](double a, double b) { return a < b; };
+
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> dist(0, 100);
+    for (size_t rows : { 1, 2, 7, 30 })
+    for (size_t cols : { 1, 3, 16, 41 })
+    for (int radius : { 0, 1, 2, 3, 6, 11, 40 })
+    for (int threads : { 1, 3 })
+    {
+        std::vector<double> data(rows * cols);
+        for (double& d : data)
+            d = dist(gen);
+
+        std::vector<double> expected(data);
+        std::vector<double> actual(data);
+        refDiamond(expected, rows, cols, radius, lowest, greater);
+        dilateDiamond(actual, rows, cols, radius, threads);
+        EXPECT_EQ(expected, actual) << "dilateDiamond " << rows << "x" <<
+            cols << " radius " << radius;
+
+        expected = data;
+        actual = data;
+        refDiamond(expected, rows, cols, radius, highest, less);
+        erodeDiamond(actual, rows, cols, radius, threads);
+        EXPECT_EQ(expected, actual) << "erodeDiamond " << rows << "x" <<
+            cols << " radius " << radius;
+
+        expected = data;
+        actual = data;
+        refSquare(expected, rows, cols, radius, lowest, greater);
+        dilateSquare(actual, rows, cols, radius, threads);
+        EXPECT_EQ(expected, actual) << "dilateSquare " << rows << "x" <<
+            cols << " radius " << radius;
+
+        expected = data;
+        actual = data;
+        refSquare(expected, rows, cols, radius, highest, less);
+        erodeSquare(actual, rows, cols, radius, threads);
+        EXPECT_EQ(expected, actual) << "erodeSquare " << rows << "x" <<
+            cols << " radius " << radius;
+    }
+}
+
 TEST(MathUtilsTest, barycentric)
 {
     using namespace math;
@@ -0,0 +1,100 @@
+/******************************************************************************
+* Copyright (c) 2026, Hobu Inc. (info@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+
+#include <pdal/pdal_test_main.hpp>
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+#include <pdal/private/Parallel.hpp>
+
+using namespace pdal;
+
+TEST(ParallelTest, ranges)
+{
+    for (int threads : { 1, 3, 8 })
+        for (size_t grain : { 0, 1, 7, 1000 })
+        {
+            std::vector<int> hits(100);
+            parallelFor(hits.size(), threads, [&hits](size_t begin, size_t end)
+            {
+                EXPECT_LT(begin, end);
+                for (size_t i = begin; i < end; ++i)
+                    hits[i]++;
+            }, grain);
+            for (int h : hits)
+                EXPECT_EQ(h, 1);
+        }
+}
+
+TEST(ParallelTest, nested)
+{
+    std::atomic<size_t> total(0);
+    parallelFor(16, 4, [&total](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
+            parallelFor(100, 4, [&total](size_t b, size_t e)
+                { total += e - b; }, 10);
+    }, 1);
+    EXPECT_EQ(total, 1600u);
+}
+
+TEST(ParallelTest, error)
+{
+    auto f = [](size_t begin, size_t)
+    {
+        if (begin == 5)
+            throw std::runtime_error("range 5");
+    };
+    EXPECT_THROW(parallelFor(10, 4, f, 1), std::runtime_error);
+    EXPECT_THROW(parallelFor(10, 1, f, 1), std::runtime_error);
+}
+
+TEST(ParallelTest, blocks)
+{
+    std::vector<size_t> sizes;
+    PointId next = 0;
+    forEachBlock(25, [&](const PointIdList& ids)
+    {
+        sizes.push_back(ids.size());
+        for (PointId id : ids)
+            EXPECT_EQ(id, next++);
+    }, 10);
+    EXPECT_EQ(sizes, std::vector<size_t>({ 10, 10, 5 }));
+    EXPECT_EQ(next, 25u);
+
+    forEachBlock(0, [](const PointIdList&) { FAIL(); });
+}
@@ -238,3 +238,104 @@ TEST(PipelineManagerTest, replace)
     EXPECT_EQ(w2->getInputs().size(), 1U);
     EXPECT_EQ(w2->getInputs().front(), f2);
 }
+
+// Make sure that running independent branches concurrently produces the same
+// output as running them serially.
+TEST(PipelineManagerTest, threads)
+{
+    auto run = [](int threads)
+    {
+        PipelineManager mgr;
+        mgr.setThreads(threads);
+
+        Stage& merge = mgr.makeFilter("filters.merge");
+        for (int i = 0; i < 8; ++i)
+        {
+            Options ro;
+            ro.add("bounds", BOX3D(i * 100, i * 100, i * 100,
+                i * 100 + 99, i * 100 + 99, i * 100 + 99));
+            ro.add("mode", "ramp");
+            ro.add("count", 1000);
+            Stage& r = mgr.addReader("readers.faux");
+            r.setOptions(ro);
+
+            // Give every other branch a filter so that branches finish
+            // out of order.
+            if (i % 2)
+            {
+                Options so;
+                so.add("dimension", "X");
+                so.add("order", "DESC");
+                Stage& sort = mgr.makeFilter("filters.sort", r, so);
+                merge.setInput(sort);
+            }
+            else
+                merge.setInput(r);
+        }
+
+        EXPECT_EQ(mgr.execute(), 8000u);
+        EXPECT_EQ(mgr.views().size(), 1u);
+        std::vector<double> xs;
+        PointViewPtr v = *mgr.views().begin();
+        for (PointId idx = 0; idx < v->size(); ++idx)
+            xs.push_back(v->getFieldAs<double>(Dimension::Id::X, idx));
+        return xs;
+    };
+
+    std::vector<double> serial = run(1);
+    std::vector<double> parallel = run(4);
+    EXPECT_EQ(serial, parallel);
+
+    PipelineManager mgr;
+    EXPECT_THROW(mgr.setThreads(0), pdal_error);
+}
+
+// Views passed to a view-parallel stage should come out in the same order
+// and with the same values as when run serially.
+TEST(PipelineManagerTest, threadsViews)
+{
+    auto run = [](int threads)
+    {
+        PipelineManager mgr;
+        mgr.setThreads(threads);
+
+        Options ro;
+        ro.add("bounds", BOX3D(0, 0, 0, 999, 499, 99));
+        ro.add("mode", "ramp");
+        ro.add("count", 1000);
+        Stage& r = mgr.addReader("readers.faux");
+        r.setOptions(ro);
+
+        Options co;
+        co.add("capacity", 100);
+        Stage& chipper = mgr.makeFilter("filters.chipper", r, co);
+
+        // Points not matching the where clause end up in separate views.
+        Options no;
+        no.add("k", 4);
+        no.add("where", "X < 500");
+        no.add("where_merge", "false");
+        Stage& nn = mgr.makeFilter("filters.nndistance", chipper, no);
+        EXPECT_TRUE(nn.viewParallelSafe());
+
+        EXPECT_EQ(mgr.execute(), 1000u);
+        std::vector<std::vector<double>> out;
+        for (PointViewPtr v : mgr.views())
+        {
+            std::vector<double> vals;
+            for (PointId idx = 0; idx < v->size(); ++idx)
+            {
+                vals.push_back(v->getFieldAs<double>(Dimension::Id::X, idx));
+                vals.push_back(
+                    v->getFieldAs<double>(Dimension::Id::NNDistance, idx));
+            }
+            out.push_back(vals);
+        }
+        return out;
+    };
+
+    auto serial = run(1);
+    auto parallel = run(4);
+    EXPECT_GT(serial.size(), 10u);
+    EXPECT_EQ(serial, parallel);
+}
@@ -36,6 +36,7 @@
 
 #include <array>
 #include <random>
+#include <type_traits>
 
 #include <pdal/PointView.hpp>
 #include <pdal/PDALUtils.hpp>
@@ -290,6 +291,163 @@ TEST(PointViewTest, getFloatNan)
     EXPECT_NO_THROW(view->getFieldAs<float>(Dimension::Id::ScanAngleRank, 0));
 }
 
+TEST(PointViewTest, index)
+{
+    PointIndex index;
+    for (PointId id = 10; id < 20; ++id)
+        index.push_back(id);
+    EXPECT_TRUE(index.contiguous());
+    EXPECT_EQ(index.size(), 10u);
+    EXPECT_EQ(index[3], 13u);
+
+    // Setting an entry to its current value keeps the range.
+    index.set(4, 14);
+    EXPECT_TRUE(index.contiguous());
+
+    // Appending a following range keeps the range.
+    PointIndex next;
+    for (PointId id = 20; id < 25; ++id)
+        next.push_back(id);
+    index.append(next, next.size());
+    EXPECT_TRUE(index.contiguous());
+    EXPECT_EQ(index.size(), 15u);
+    EXPECT_EQ(index[14], 24u);
+
+    index.swap(0, 14);
+    EXPECT_FALSE(index.contiguous());
+    EXPECT_EQ(index[0], 24u);
+    EXPECT_EQ(index[14], 10u);
+    for (PointId idx = 1; idx < 14; ++idx)
+        EXPECT_EQ(index[idx], idx + 10);
+    EXPECT_THROW(index.at(15), std::out_of_range);
+
+    index.push_back(100);
+    EXPECT_EQ(index.size(), 16u);
+    EXPECT_EQ(index[15], 100u);
+}
+
+TEST(PointViewTest, indexViews)
+{
+    PointTable table;
+    PointViewPtr view = makeTestView(table, 100);
+
+    // Views of consecutive points can be appended without copying the index.
+    PointViewPtr first = view->makeNew();
+    PointViewPtr second = view->makeNew();
+    for (PointId idx = 0; idx < view->size(); ++idx)
+        (idx < 60 ? first : second)->appendPoint(*view, idx);
+    PointViewPtr all = view->makeNew();
+    all->append(*first);
+    all->append(*second);
+    ASSERT_EQ(all->size(), 100u);
+    verifyTestView(*all, 100);
+
+    // Filtered views.
+    PointViewPtr odd = view->makeNew();
+    for (PointId idx = 1; idx < view->size(); idx += 2)
+        odd->appendPoint(*view, idx);
+    ASSERT_EQ(odd->size(), 50u);
+    for (PointId idx = 0; idx < odd->size(); ++idx)
+        EXPECT_EQ(odd->getFieldAs<int>(Dimension::Id::X, idx),
+            view->getFieldAs<int>(Dimension::Id::X, idx * 2 + 1));
+
+    // Reversing a view swaps the index entries.
+    std::reverse(view->begin(), view->end());
+    for (PointId idx = 0; idx < view->size(); ++idx)
+        EXPECT_EQ(view->getFieldAs<uint8_t>(Dimension::Id::Classification, idx),
+            (uint8_t)(100 - idx));
+
+    // Adding a point to a reordered view.
+    view->setField(Dimension::Id::X, 100, 42);
+    EXPECT_EQ(view->size(), 101u);
+    EXPECT_EQ(view->getFieldAs<int>(Dimension::Id::X, 100), 42);
+}
+
+TEST(PointViewTest, column)
+{
+    using namespace Dimension;
+
+    ColumnPointTable table;
+    table.layout()->registerDims({ Id::X, Id::Y, Id::Z });
+    table.layout()->registerDim(Id::Classification, Type::Unsigned8);
+    table.finalize();
+
+    // Make sure the points span several table blocks.
+    const point_count_t count = 40000;
+    PointViewPtr view(new PointView(table));
+    for (PointId idx = 0; idx < count; ++idx)
+    {
+        view->setField(Id::X, idx, idx);
+        view->setField(Id::Y, idx, 2 * idx);
+        view->setField(Id::Z, idx, -(double)idx);
+        view->setField(Id::Classification, idx, idx % 32);
+    }
+
+    // Values of a const view are read-only.
+    const PointView& cview = *view;
+    auto xs = cview.column<double>(Id::X);
+    auto ys = view->column<double>(Id::Y);
+    auto cs = cview.column<uint8_t>(Id::Classification);
+    static_assert(std::is_same_v<decltype(xs),
+        std::vector<ColumnSpan<const double>>>);
+    static_assert(std::is_same_v<decltype(ys),
+        std::vector<ColumnSpan<double>>>);
+    ASSERT_GT(xs.size(), 1u);
+    ASSERT_EQ(xs.size(), ys.size());
+    ASSERT_EQ(xs.size(), cs.size());
+
+    PointId idx = 0;
+    for (size_t span = 0; span < xs.size(); ++span)
+    {
+        EXPECT_EQ(xs[span].size, ys[span].size);
+        EXPECT_EQ(xs[span].size, cs[span].size);
+        for (point_count_t i = 0; i < xs[span].size; ++i, ++idx)
+        {
+            EXPECT_EQ(xs[span].data[i], (double)idx);
+            EXPECT_EQ(ys[span].data[i], (double)(2 * idx));
+            EXPECT_EQ(cs[span].data[i], idx % 32);
+        }
+    }
+    EXPECT_EQ(idx, count);
+
+    // Values can be written through the spans of a non-const view.
+    ys[0].data[0] = 42;
+    EXPECT_EQ(view->getFieldAs<double>(Id::Y, 0), 42);
+    ys[0].data[0] = 0;
+
+    BOX3D bounds;
+    view->calculateBounds(bounds);
+    EXPECT_EQ(bounds, BOX3D(0, 0, -(double)(count - 1),
+        count - 1, 2 * (count - 1), 0));
+
+    // Spans start at the view's first point.
+    PointViewPtr slice = view->makeNew();
+    for (PointId i = 1000; i < 20000; ++i)
+        slice->appendPoint(*view, i);
+    auto ss = slice->column<const double>(Id::X);
+    ASSERT_FALSE(ss.empty());
+    EXPECT_EQ(ss[0].data[0], 1000.0);
+    point_count_t total = 0;
+    for (auto& span : ss)
+        total += span.size;
+    EXPECT_EQ(total, slice->size());
+
+    // Wrong type.
+    EXPECT_TRUE(view->column<float>(Id::X).empty());
+
+    // Points not consecutive in the table.
+    std::iter_swap(slice->begin(), slice->begin() + 1);
+    EXPECT_TRUE(slice->column<const double>(Id::X).empty());
+    BOX2D box;
+    slice->calculateBounds(box);
+    EXPECT_EQ(box, BOX2D(1000, 2000, 19999, 39998));
+
+    // Tables that store rows don't support direct access.
+    PointTable rowTable;
+    PointViewPtr rowView = makeTestView(rowTable);
+    EXPECT_TRUE(rowView->column<const double>(Id::Y).empty());
+}
+
 // Per discussions with @abellgithub (https://github.com/gadomski/PDAL/commit/c1d54e56e2de841d37f2a1b1c218ed723053f6a9#commitcomment-14415138)
 // we only do bounds checking on `PointView`s when in debug mode.
 #ifndef NDEBUG
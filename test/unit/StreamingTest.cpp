@@ -528,3 +528,83 @@ R"(
         EXPECT_NE(output.find("DBDCA"), std::string::npos);
     }
 }
+
+// Make sure that stages implementing processBatch() see only the points
+// that weren't filtered out upstream and that pass their 'where' clause,
+// and that skips set in a batch are honored downstream.
+TEST(Streaming, batch)
+{
+    class BatchFilter : public Filter, public Streamable
+    {
+    public:
+        BatchFilter() : m_active(0)
+        {}
+
+        std::string getName() const { return "filters.batch"; }
+
+        point_count_t m_active;
+
+    private:
+        virtual bool processOne(PointRef&)
+        {
+            ADD_FAILURE() << "processOne() called on batch filter.";
+            return true;
+        }
+
+        virtual void processBatch(StreamPointTable& table,
+            const std::vector<uint8_t>& active, point_count_t count)
+        {
+            PointRef point(table, 0);
+            for (PointId idx = 0; idx < count; ++idx)
+            {
+                if (!active[idx])
+                    continue;
+                m_active++;
+                point.setPointId(idx);
+                EXPECT_LT(point.getFieldAs<int>(Dimension::Id::X), 50);
+                EXPECT_GE(point.getFieldAs<int>(Dimension::Id::X), 40);
+                // Drop every other point.
+                if (point.getFieldAs<int>(Dimension::Id::X) % 2)
+                    table.setSkip(idx);
+            }
+        }
+    };
+
+    StageFactory f;
+
+    Stage *r = f.createStage("readers.faux");
+    Options ro;
+    ro.add("bounds", BOX3D(0, 0, 0, 99, 99, 99));
+    ro.add("mode", "ramp");
+    ro.add("count", 100);
+    r->setOptions(ro);
+
+    Stage *range = f.createStage("filters.range");
+    Options rangeOpts;
+    rangeOpts.add("limits", "X[0:49]");
+    range->setOptions(rangeOpts);
+    range->setInput(*r);
+
+    BatchFilter b;
+    Options bo;
+    bo.add("where", "X >= 40");
+    b.setOptions(bo);
+    b.setInput(*range);
+
+    StreamCallbackFilter cb;
+    int cnt = 0;
+    cb.setCallback([&cnt](PointRef& point)
+        {
+            int x = point.getFieldAs<int>(Dimension::Id::X);
+            EXPECT_TRUE(x < 40 || x % 2 == 0);
+            cnt++;
+            return true;
+        });
+    cb.setInput(b);
+
+    FixedPointTable t(16);
+    cb.prepare(t);
+    cb.execute(t);
+    EXPECT_EQ(b.m_active, 10u);
+    EXPECT_EQ(cnt, 45);
+}
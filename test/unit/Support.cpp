@@ -40,6 +40,7 @@
 #include <string>
 
 #include <stdio.h>
+#include <string.h>
 
 #include <pdal/Options.hpp>
 #include <pdal/PDALUtils.hpp>
@@ -335,6 +336,36 @@ void checkXYZ(const std::string& file1, const std::string& file2)
 }
 
 
+void compareReaders(Stage& reader1, Stage& reader2)
+{
+    PointTable t1;
+    reader1.prepare(t1);
+    PointViewSet s1 = reader1.execute(t1);
+    ASSERT_EQ(s1.size(), 1u);
+    PointViewPtr v1 = *s1.begin();
+
+    PointTable t2;
+    reader2.prepare(t2);
+    PointViewSet s2 = reader2.execute(t2);
+    ASSERT_EQ(s2.size(), 1u);
+    PointViewPtr v2 = *s2.begin();
+
+    ASSERT_EQ(v1->size(), v2->size());
+    EXPECT_GT(v1->size(), 0u);
+    DimTypeList dims = v1->dimTypes();
+    ASSERT_EQ(dims.size(), v2->dimTypes().size());
+    std::vector<char> buf1(v1->pointSize());
+    std::vector<char> buf2(v1->pointSize());
+    for (PointId idx = 0; idx < v1->size(); ++idx)
+    {
+        v1->getPackedPoint(dims, idx, buf1.data());
+        v2->getPackedPoint(dims, idx, buf2.data());
+        ASSERT_EQ(memcmp(buf1.data(), buf2.data(), buf1.size()), 0) <<
+            "Index = " << idx;
+    }
+}
+
+
 void check_pN(const PointView& data, PointId index, double xref, double yref, double zref)
 {
     float x0 = data.getFieldAs<float>(Dimension::Id::X, index);
@@ -107,6 +107,9 @@ bool compare_text_files(std::istream& str1, std::istream& str2);
 
 void checkXYZ(const std::string& file1, const std::string& file2);
 
+// Execute two readers and check that they produce the same points.
+void compareReaders(Stage& reader1, Stage& reader2);
+
 // validate a point's XYZ values
 void check_pN(const pdal::PointView& data, pdal::PointId index,
     double xref, double yref, double zref);
@@ -0,0 +1,99 @@
+/******************************************************************************
+* Copyright (c) 2026, Hobu Inc. (info@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <string>
+
+#include <pdal/pdal_test_main.hpp>
+#include <pdal/util/FileUtils.hpp>
+#include <pdal/util/Utils.hpp>
+
+#include "Support.hpp"
+
+using namespace pdal;
+
+namespace
+{
+
+std::string benchCmd()
+{
+    return Support::binpath(Support::exename("pdal")) + " bench";
+}
+
+} // unnamed namespace
+
+TEST(Bench, list)
+{
+    std::string output;
+    EXPECT_EQ(Utils::run_shell_command(benchCmd() + " --list", output), 0);
+    EXPECT_NE(output.find("las_write"), std::string::npos);
+    EXPECT_NE(output.find("kd3_knn"), std::string::npos);
+}
+
+TEST(Bench, run)
+{
+    std::string output;
+    const std::string cmd = benchCmd() +
+        " faux las_read las_read_stream laz_read --count 1000 --repeat 1";
+
+    EXPECT_EQ(Utils::run_shell_command(cmd, output), 0);
+    EXPECT_NE(output.find("\"name\": \"faux\""), std::string::npos);
+    EXPECT_NE(output.find("\"name\": \"laz_read\""), std::string::npos);
+    EXPECT_NE(output.find("\"name\": \"las_read_stream\""), std::string::npos);
+    EXPECT_EQ(output.find("\"name\": \"kd3_build\""), std::string::npos);
+    EXPECT_NE(output.find("\"points\": 1000"), std::string::npos);
+    EXPECT_NE(output.find("\"points_per_second\""), std::string::npos);
+    EXPECT_NE(output.find("\"peak_rss\""), std::string::npos);
+}
+
+TEST(Bench, output)
+{
+    std::string filename = Support::temppath("bench.json");
+    FileUtils::deleteFile(filename);
+
+    std::string output;
+    const std::string cmd = benchCmd() + " get_field --count 1000 "
+        "--repeat 1 --output " + filename;
+    EXPECT_EQ(Utils::run_shell_command(cmd, output), 0);
+    EXPECT_NE(FileUtils::readFileIntoString(filename).find("get_field"),
+        std::string::npos);
+    FileUtils::deleteFile(filename);
+}
+
+TEST(Bench, badName)
+{
+    std::string output;
+    EXPECT_NE(Utils::run_shell_command(benchCmd() + " nosuchbench 2>&1",
+        output), 0);
+    EXPECT_NE(output.find("Unknown benchmark"), std::string::npos);
+}
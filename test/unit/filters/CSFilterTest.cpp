@@ -31,6 +31,9 @@
 * OF SUCH DAMAGE.
 ****************************************************************************/
 
+#include <algorithm>
+#include <cstddef>
+
 #include <pdal/pdal_test_main.hpp>
 
 #include <io/BufferReader.hpp>
@@ -66,3 +69,51 @@ TEST(CSFilterTest, emptyView)
     PointViewPtr v = *s.begin();
     EXPECT_EQ(v->size(), 0u);
 }
+
+TEST(CSFilterTest, threads)
+{
+    auto run = [](int threads)
+    {
+        StageFactory factory;
+
+        Stage *r = factory.createStage("readers.las");
+        Options rOptions;
+        rOptions.add("filename", Support::datapath("las/autzen_trim.las"));
+        r->setOptions(rOptions);
+
+        Stage *f = factory.createStage("filters.csf");
+        Options fOptions;
+        fOptions.add("threads", threads);
+        f->setOptions(fOptions);
+        f->setInput(*r);
+
+        PointTable t;
+        f->prepare(t);
+        PointViewSet s = f->execute(t);
+        PointViewPtr v = *s.begin();
+
+        std::vector<uint8_t> classes;
+        for (PointId idx = 0; idx < v->size(); ++idx)
+            classes.push_back(v->getFieldAs<uint8_t>(
+                Dimension::Id::Classification, idx));
+        return classes;
+    };
+
+    // A single thread relaxes the cloth in the original order.  Any other
+    // number of threads gives the same result as any other.
+    std::vector<uint8_t> single = run(1);
+    std::vector<uint8_t> multi = run(2);
+    EXPECT_EQ(multi, run(4));
+    ASSERT_EQ(single.size(), multi.size());
+
+    // Both orders must find ground without calling everything ground, and
+    // they may only differ for the few points close to the class threshold.
+    auto ground = std::count(single.begin(), single.end(), ClassLabel::Ground);
+    EXPECT_GT(ground, 0);
+    EXPECT_LT(ground, (std::ptrdiff_t)single.size());
+    size_t differ = 0;
+    for (size_t i = 0; i < single.size(); ++i)
+        if (single[i] != multi[i])
+            differ++;
+    EXPECT_LT(differ, single.size() / 50);
+}
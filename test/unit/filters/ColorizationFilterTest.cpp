@@ -35,6 +35,9 @@
 #include <pdal/pdal_test_main.hpp>
 
 #include <pdal/PointView.hpp>
+#include <pdal/private/gdal/Raster.hpp>
+#include <pdal/util/FileUtils.hpp>
+#include <io/BufferReader.hpp>
 #include <io/LasReader.hpp>
 #include <filters/ColorizationFilter.hpp>
 #include <filters/StreamCallbackFilter.hpp>
@@ -125,6 +128,32 @@ void testFileStreamed(const Options& filterOps, StringList dimNames,
     f2.execute(table);
 }
 
+// Write a raster of 300 x 300 pixels with three bands of doubles, stored as
+// a single strip so that its native block doesn't fit in a 1 MB cache.
+// The bands hold the column, the row and their sum.
+void writeStripRaster(const std::string& filename)
+{
+    const int size = 300;
+
+    FileUtils::deleteFile(filename);
+    gdal::Raster raster(filename, "GTiff", SpatialReference(),
+        { 0, 1, 0, size, 0, -1 });
+    gdal::GDALError err = raster.open(size, size, 3, Dimension::Type::Double,
+        -9999, { "BLOCKYSIZE=" + std::to_string(size) });
+    ASSERT_EQ(err, gdal::GDALError::None) << raster.errorMsg();
+
+    std::vector<double> data(size * size);
+    for (int band = 1; band <= 3; ++band)
+    {
+        for (int row = 0; row < size; ++row)
+            for (int col = 0; col < size; ++col)
+                data[row * size + col] = band == 1 ? col :
+                    band == 2 ? row : col + row;
+        err = raster.writeBand(data.begin(), -9999.0, band);
+        ASSERT_EQ(err, gdal::GDALError::None) << raster.errorMsg();
+    }
+}
+
 } // unnamed namespace
 
 // Test using the standard dimensions.
@@ -232,4 +261,109 @@ TEST(ColorizationFilterTest, test5)
     // expect input points that were translated out of the raster image area are not filtered out.
     EXPECT_NE(pointCount, 23u);
     EXPECT_EQ(pointCount, 106u);
-}
\ No newline at end of file
+}
+
+// Check that points colored in standard mode, which samples the raster in
+// batches, match points colored one at a time in stream mode.
+TEST(ColorizationFilterTest, batch)
+{
+    Options readerOps;
+    readerOps.add("filename",
+        Support::datapath("autzen/autzen-point-format-3.las"));
+    // Move some of the points outside of the raster.
+    Options transformOps;
+    transformOps.add("matrix", "1 0 0 1600 0 1 0 2200 0 0 1 0 0 0 0 1");
+    Options colorOps;
+    colorOps.add("raster", Support::datapath("autzen/autzen.jpg"));
+
+    LasReader r1;
+    r1.setOptions(readerOps);
+    TransformationFilter t1;
+    t1.setOptions(transformOps);
+    t1.setInput(r1);
+    ColorizationFilter c1;
+    c1.setOptions(colorOps);
+    c1.setInput(t1);
+
+    PointTable table;
+    c1.prepare(table);
+    PointViewSet viewSet = c1.execute(table);
+    PointViewPtr view = *viewSet.begin();
+
+    LasReader r2;
+    r2.setOptions(readerOps);
+    TransformationFilter t2;
+    t2.setOptions(transformOps);
+    t2.setInput(r2);
+    ColorizationFilter c2;
+    c2.setOptions(colorOps);
+    c2.setInput(t2);
+
+    PointId idx = 0;
+    StreamCallbackFilter f;
+    f.setCallback([&view, &idx](PointRef& point)
+    {
+        for (Dimension::Id dim : { Dimension::Id::Red, Dimension::Id::Green,
+                Dimension::Id::Blue })
+            EXPECT_EQ(point.getFieldAs<uint16_t>(dim),
+                view->getFieldAs<uint16_t>(dim, idx));
+        idx++;
+        return true;
+    });
+    f.setInput(c2);
+
+    FixedPointTable streamTable(50);
+    f.prepare(streamTable);
+    f.execute(streamTable);
+    EXPECT_EQ(idx, view->size());
+}
+
+// With a 1 MB cache, the single-strip raster is read in bands of rows.
+// Points that visit the bands out of order must get their own pixels.
+TEST(ColorizationFilterTest, cacheWindow)
+{
+    using namespace Dimension;
+
+    std::string filename = Support::temppath("colorize_strip.tif");
+    writeStripRaster(filename);
+
+    Options options;
+    options.add("raster", filename);
+    options.add("cache_size", 1);
+
+    PointTable table;
+    table.layout()->registerDims({ Id::X, Id::Y, Id::Z });
+    BufferReader reader;
+    ColorizationFilter filter;
+    filter.setOptions(options);
+    filter.setInput(reader);
+    filter.prepare(table);
+
+    const PointId count = 3000;
+    PointViewPtr view(new PointView(table));
+    for (PointId i = 0; i < count; ++i)
+    {
+        view->setField(Id::X, i, (i * 37) % 300 + .5);
+        view->setField(Id::Y, i, 300 - (i * 101) % 300 - .5);
+        view->setField(Id::Z, i, 0);
+    }
+    // This point is outside of the raster.
+    view->setField(Id::X, count, -10);
+    view->setField(Id::Y, count, 10);
+    view->setField(Id::Z, count, 0);
+    reader.addView(view);
+
+    PointViewSet viewSet = filter.execute(table);
+    PointViewPtr v = *viewSet.begin();
+    ASSERT_EQ(v->size(), count + 1);
+    for (PointId i = 0; i < count; ++i)
+    {
+        uint16_t col = (uint16_t)((i * 37) % 300);
+        uint16_t row = (uint16_t)((i * 101) % 300);
+        EXPECT_EQ(v->getFieldAs<uint16_t>(Id::Red, i), col);
+        EXPECT_EQ(v->getFieldAs<uint16_t>(Id::Green, i), row);
+        EXPECT_EQ(v->getFieldAs<uint16_t>(Id::Blue, i), col + row);
+    }
+    EXPECT_EQ(v->getFieldAs<uint16_t>(Id::Red, count), 0);
+    FileUtils::deleteFile(filename);
+}
@@ -0,0 +1,140 @@
+/******************************************************************************
+* Copyright (c) 2024, Hobu Inc. (info@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <pdal/pdal_test_main.hpp>
+
+#include <pdal/StageFactory.hpp>
+#include <io/BufferReader.hpp>
+
+#include <algorithm>
+#include <random>
+
+#include "Support.hpp"
+
+namespace pdal
+{
+
+namespace
+{
+
+PointViewPtr clusterView(PointTableRef table)
+{
+    using namespace Dimension;
+
+    table.layout()->registerDims({ Id::X, Id::Y, Id::Z });
+    PointViewPtr view(new PointView(table));
+
+    // Clumps of points plus scattered noise.
+    std::mt19937 gen(2718);
+    std::uniform_real_distribution<double> pos(0, 50);
+    std::normal_distribution<double> spread(0, 1.5);
+    PointId id = 0;
+    for (int c = 0; c < 15; ++c)
+    {
+        double x = pos(gen);
+        double y = pos(gen);
+        double z = pos(gen) / 5;
+        for (int i = 0; i < 150; ++i)
+        {
+            view->setField(Id::X, id, x + spread(gen));
+            view->setField(Id::Y, id, y + spread(gen));
+            view->setField(Id::Z, id, z + spread(gen));
+            id++;
+        }
+    }
+    for (int i = 0; i < 800; ++i)
+    {
+        view->setField(Id::X, id, pos(gen));
+        view->setField(Id::Y, id, pos(gen));
+        view->setField(Id::Z, id, pos(gen) / 5);
+        id++;
+    }
+    return view;
+}
+
+std::vector<int64_t> cluster(Options opts)
+{
+    PointTable table;
+    BufferReader reader;
+    reader.addView(clusterView(table));
+
+    StageFactory factory;
+    Stage& f = *(factory.createStage("filters.dbscan"));
+    f.setInput(reader);
+    f.setOptions(opts);
+    f.prepare(table);
+    PointViewSet s = f.execute(table);
+    PointViewPtr v = *s.begin();
+
+    std::vector<int64_t> ids;
+    for (PointId i = 0; i < v->size(); ++i)
+        ids.push_back(v->getFieldAs<int64_t>(Dimension::Id::ClusterID, i));
+    return ids;
+}
+
+} // unnamed namespace
+
+TEST(DBSCANFilterTest, grid)
+{
+    auto test = [](const std::string& dims, double eps, int minPoints)
+    {
+        Options opts;
+        opts.add("dimensions", dims);
+        opts.add("eps", eps);
+        opts.add("min_points", minPoints);
+        std::vector<int64_t> classic = cluster(opts);
+
+        opts.add("algorithm", "grid");
+        opts.add("threads", 3);
+        std::vector<int64_t> grid = cluster(opts);
+
+        ASSERT_EQ(classic.size(), grid.size());
+        EXPECT_GT(*std::max_element(grid.begin(), grid.end()), 0);
+        for (size_t i = 0; i < classic.size(); ++i)
+            EXPECT_EQ(classic[i], grid[i]) << "Bad cluster for point " << i;
+    };
+
+    test("X,Y,Z", .8, 3);
+    test("X,Y,Z", 1.2, 6);
+    test("X,Y", 1.0, 4);
+}
+
+TEST(DBSCANFilterTest, badAlgorithm)
+{
+    Options opts;
+    opts.add("algorithm", "foo");
+    EXPECT_THROW(cluster(opts), pdal_error);
+}
+
+} // namespace pdal
@@ -0,0 +1,169 @@
+/******************************************************************************
+* Copyright (c) 2026, Hobu Inc. (info@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <pdal/pdal_test_main.hpp>
+
+#include <pdal/PointView.hpp>
+#include <pdal/StageFactory.hpp>
+#include <pdal/private/gdal/Raster.hpp>
+#include <pdal/util/FileUtils.hpp>
+#include <io/BufferReader.hpp>
+
+#include "Support.hpp"
+
+namespace pdal
+{
+
+namespace
+{
+
+const int RasterSize = 300;
+const PointId PointCount = 3000;
+
+// Write a raster of 300 x 300 pixels with three bands of doubles, stored as
+// a single strip so that its native block doesn't fit in a 1 MB cache.
+// The bands hold the column, the row and their sum.
+void writeStripRaster(const std::string& filename)
+{
+    FileUtils::deleteFile(filename);
+    gdal::Raster raster(filename, "GTiff", SpatialReference(),
+        { 0, 1, 0, RasterSize, 0, -1 });
+    gdal::GDALError err = raster.open(RasterSize, RasterSize, 3,
+        Dimension::Type::Double, -9999,
+        { "BLOCKYSIZE=" + std::to_string(RasterSize) });
+    ASSERT_EQ(err, gdal::GDALError::None) << raster.errorMsg();
+
+    std::vector<double> data(RasterSize * RasterSize);
+    for (int band = 1; band <= 3; ++band)
+    {
+        for (int row = 0; row < RasterSize; ++row)
+            for (int col = 0; col < RasterSize; ++col)
+                data[row * RasterSize + col] = band == 1 ? col :
+                    band == 2 ? row : col + row;
+        err = raster.writeBand(data.begin(), -9999.0, band);
+        ASSERT_EQ(err, gdal::GDALError::None) << raster.errorMsg();
+    }
+}
+
+int column(PointId i)
+{
+    return (int)((i * 37) % RasterSize);
+}
+
+int row(PointId i)
+{
+    return (int)((i * 101) % RasterSize);
+}
+
+// Run a filter over points at the centers of pixels, visited out of order.
+// Odd points are 5 above the sum of their column and row, even points are
+// at the sum.
+PointViewPtr run(const std::string& name, Options options, PointTable& table)
+{
+    using namespace Dimension;
+
+    std::string filename = Support::temppath(name + "_strip.tif");
+    writeStripRaster(filename);
+    options.add("raster", filename);
+    options.add("cache_size", 1);
+
+    table.layout()->registerDims({ Id::X, Id::Y, Id::Z, Id::Classification });
+    BufferReader reader;
+    StageFactory factory;
+    Stage& filter = *factory.createStage(name);
+    filter.setOptions(options);
+    filter.setInput(reader);
+    filter.prepare(table);
+
+    PointViewPtr view(new PointView(table));
+    for (PointId i = 0; i < PointCount; ++i)
+    {
+        view->setField(Id::X, i, column(i) + .5);
+        view->setField(Id::Y, i, RasterSize - row(i) - .5);
+        view->setField(Id::Z, i, column(i) + row(i) + (i % 2 ? 5 : 0));
+    }
+    reader.addView(view);
+
+    PointViewSet viewSet = filter.execute(table);
+    FileUtils::deleteFile(filename);
+    return *viewSet.begin();
+}
+
+} // unnamed namespace
+
+// Only points within the limits of the raster value of their pixel are
+// kept.
+TEST(DEMFilterTest, dem)
+{
+    Options options;
+    options.add("limits", "Z[1:1]");
+    options.add("band", 3);
+
+    PointTable table;
+    PointViewPtr v = run("filters.dem", options, table);
+    ASSERT_EQ(v->size(), PointCount / 2);
+    for (PointId i = 0; i < v->size(); ++i)
+    {
+        // The points that remain are the even ones, in order.
+        PointId src = 2 * i;
+        EXPECT_DOUBLE_EQ(v->getFieldAs<double>(Dimension::Id::X, i),
+            column(src) + .5);
+        EXPECT_DOUBLE_EQ(v->getFieldAs<double>(Dimension::Id::Z, i),
+            column(src) + row(src));
+    }
+}
+
+// The height above ground is the height above the raster value of the
+// point's pixel.
+TEST(DEMFilterTest, hagDem)
+{
+    for (int band : { 1, 3 })
+    {
+        Options options;
+        options.add("band", band);
+
+        PointTable table;
+        PointViewPtr v = run("filters.hag_dem", options, table);
+        ASSERT_EQ(v->size(), PointCount);
+        for (PointId i = 0; i < v->size(); ++i)
+        {
+            double ground = band == 1 ? column(i) : column(i) + row(i);
+            double z = column(i) + row(i) + (i % 2 ? 5 : 0);
+            EXPECT_DOUBLE_EQ(v->getFieldAs<double>(
+                Dimension::Id::HeightAboveGround, i), z - ground);
+        }
+    }
+}
+
+} // namespace pdal
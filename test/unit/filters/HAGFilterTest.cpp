@@ -35,6 +35,9 @@
 #include <pdal/pdal_test_main.hpp>
 
 #include <pdal/StageFactory.hpp>
+#include <io/BufferReader.hpp>
+
+#include <random>
 
 #include "Support.hpp"
 
@@ -191,6 +194,125 @@ TEST(HAGFilterTest, closest)
     }
 }
 
+TEST(HAGFilterTest, delaunayGlobal)
+{
+    Options ro;
+    ro.add("filename", Support::datapath("filters/hagtest.txt"));
+
+    StageFactory factory;
+    Stage& r = *(factory.createStage("readers.text"));
+    r.setOptions(ro);
+
+    // There are only six ground points, so the global triangulation is the
+    // same as the local one.
+    Options fo;
+    fo.add("triangulation", "global");
+    fo.add("threads", 2);
+    Stage& f = *(factory.createStage("filters.hag_delaunay"));
+    f.setInput(r);
+    f.setOptions(fo);
+
+    PointTable t1;
+    f.prepare(t1);
+    PointViewSet s = f.execute(t1);
+    PointViewPtr v = *s.begin();
+
+    ASSERT_EQ(v->size(), 10u);
+    EXPECT_EQ(v->getFieldAs<double>(Dimension::Id::HeightAboveGround, 0), 10);
+    EXPECT_EQ(v->getFieldAs<double>(Dimension::Id::HeightAboveGround, 1), 11);
+    EXPECT_EQ(v->getFieldAs<double>(Dimension::Id::HeightAboveGround, 2), 14);
+    EXPECT_EQ(v->getFieldAs<double>(Dimension::Id::HeightAboveGround, 3), 16);
+    for (PointId i = 4; i < v->size(); ++i)
+        EXPECT_EQ(v->getFieldAs<double>(Dimension::Id::HeightAboveGround, i),
+            0);
+}
+
+TEST(HAGFilterTest, delaunayThreads)
+{
+    Options ro;
+    ro.add("filename", Support::datapath("filters/hagtest.txt"));
+
+    StageFactory factory;
+    Stage& r = *(factory.createStage("readers.text"));
+    r.setOptions(ro);
+
+    Options fo;
+    fo.add("threads", 0);
+    Stage& f = *(factory.createStage("filters.hag_delaunay"));
+    f.setInput(r);
+    f.setOptions(fo);
+
+    PointTable t;
+    EXPECT_THROW(f.prepare(t), pdal_error);
+}
+
+// Ground points on a plane.  Interpolation on any triangulation of the
+// plane recovers the height of points inside the ground points.
+TEST(HAGFilterTest, delaunayGlobalPlane)
+{
+    using namespace Dimension;
+
+    auto plane = [](double x, double y) { return 5 + .1 * x - .2 * y; };
+
+    PointTable table;
+    table.layout()->registerDims({ Id::X, Id::Y, Id::Z, Id::Classification });
+    PointViewPtr view(new PointView(table));
+
+    std::mt19937 gen(12345);
+    std::uniform_real_distribution<double> jitter(-.25, .25);
+    std::uniform_real_distribution<double> pos(2, 98);
+    std::uniform_real_distribution<double> height(0, 30);
+
+    PointId id = 0;
+    for (int x = 0; x <= 100; ++x)
+        for (int y = 0; y <= 100; ++y)
+        {
+            double gx = x + jitter(gen);
+            double gy = y + jitter(gen);
+            view->setField(Id::X, id, gx);
+            view->setField(Id::Y, id, gy);
+            view->setField(Id::Z, id, plane(gx, gy));
+            view->setField(Id::Classification, id, ClassLabel::Ground);
+            id++;
+        }
+
+    std::vector<double> heights;
+    for (int i = 0; i < 20000; ++i)
+    {
+        double x = pos(gen);
+        double y = pos(gen);
+        double h = height(gen);
+        view->setField(Id::X, id, x);
+        view->setField(Id::Y, id, y);
+        view->setField(Id::Z, id, plane(x, y) + h);
+        view->setField(Id::Classification, id, ClassLabel::HighVegetation);
+        heights.push_back(h);
+        id++;
+    }
+
+    BufferReader reader;
+    reader.addView(view);
+
+    StageFactory factory;
+    Stage& f = *(factory.createStage("filters.hag_delaunay"));
+    Options fo;
+    fo.add("triangulation", "global");
+    fo.add("threads", 4);
+    f.setInput(reader);
+    f.setOptions(fo);
+    f.prepare(table);
+    PointViewSet s = f.execute(table);
+    PointViewPtr v = *s.begin();
+
+    PointId first = 101 * 101;
+    ASSERT_EQ(v->size(), first + heights.size());
+    for (PointId i = 0; i < first; ++i)
+        EXPECT_EQ(v->getFieldAs<double>(Id::HeightAboveGround, i), 0);
+    for (PointId i = 0; i < heights.size(); ++i)
+        EXPECT_NEAR(v->getFieldAs<double>(Id::HeightAboveGround, first + i),
+            heights[i], 1e-8);
+}
+
 // Should add tests for exact match in neighbors case and for
 // max_distance in neighbors case.
 
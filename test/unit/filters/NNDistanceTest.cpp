@@ -122,3 +122,24 @@ TEST(NNDistanceTest, kdist)
     }
 }
 
+
+TEST(NNDistanceTest, threads)
+{
+    StageFactory f;
+    Stage *reader(f.createStage("readers.faux"));
+    Stage *filter(f.createStage("filters.nndistance"));
+
+    Options rOpts;
+    rOpts.add("mode", "grid");
+    rOpts.add("bounds", "([0, 10],[0,10],[0,10])");
+    rOpts.add("count", 1000);
+    reader->setOptions(rOpts);
+
+    Options fOpts;
+    fOpts.add("threads", 0);
+    filter->setOptions(fOpts);
+    filter->setInput(*reader);
+
+    PointTable t;
+    EXPECT_THROW(filter->prepare(t), pdal_error);
+}
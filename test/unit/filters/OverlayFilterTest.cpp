@@ -41,7 +41,7 @@
 
 using namespace pdal;
 
-void testOverlay(int numReaders, bool stream)
+void testOverlay(int numReaders, bool stream, int threads = 1)
 {
     Options ro;
     ro.add("filename", Support::datapath("autzen/autzen-dd.las"));
@@ -53,6 +53,7 @@ void testOverlay(int numReaders, bool stream)
     fo.add("column", "cls");
     fo.add("bounds", "([-123.072145, -123.062904],[44.054331, 44.062296])");
     fo.add("datasource", Support::datapath("autzen/attributes.shp"));
+    fo.add("threads", threads);
 
     LogPtr l(Log::makeLog("readers.las", "stderr"));
     Stage& f = *(factory.createStage("filters.overlay"));
@@ -163,3 +164,8 @@ TEST(OverlayFilterTest, stream)
 {
     testOverlay(10, true);
 }
+
+TEST(OverlayFilterTest, threads)
+{
+    testOverlay(10, false, 4);
+}
@@ -39,6 +39,7 @@
 #include <io/LasReader.hpp>
 #include <filters/ReprojectionFilter.hpp>
 #include <filters/StreamCallbackFilter.hpp>
+#include <pdal/private/SrsTransform.hpp>
 
 #include "Support.hpp"
 
@@ -227,3 +228,74 @@ TEST(ReprojectionFilterTest, stream_test_2)
     f.prepare(table3);
     f.execute(table3);
 }
+
+// Transforming in blocks on several threads should match transforming
+// each point on its own.
+TEST(ReprojectionFilterTest, threads)
+{
+    auto run = [](int threads)
+    {
+        Options ops1;
+        ops1.add("filename", Support::datapath("las/autzen_trim.las"));
+        LasReader reader;
+        reader.setOptions(ops1);
+
+        Options options;
+        options.add("out_srs", "EPSG:4326");
+        options.add("threads", threads);
+
+        ReprojectionFilter reprojectionFilter;
+        reprojectionFilter.setOptions(options);
+        reprojectionFilter.setInput(reader);
+
+        PointTable table;
+        reprojectionFilter.prepare(table);
+        PointViewSet viewSet = reprojectionFilter.execute(table);
+        EXPECT_EQ(viewSet.size(), 1u);
+        return *viewSet.begin();
+    };
+
+    PointViewPtr v1 = run(1);
+    PointViewPtr v4 = run(4);
+
+    Options ops1;
+    ops1.add("filename", Support::datapath("las/autzen_trim.las"));
+    LasReader reader;
+    reader.setOptions(ops1);
+    PointTable table;
+    reader.prepare(table);
+    PointViewPtr src = *reader.execute(table).begin();
+    SrsTransform xform(src->spatialReference(), SpatialReference("EPSG:4326"));
+
+    ASSERT_EQ(v1->size(), src->size());
+    ASSERT_EQ(v4->size(), src->size());
+    for (PointId i = 0; i < src->size(); ++i)
+    {
+        double x = src->getFieldAs<double>(Dimension::Id::X, i);
+        double y = src->getFieldAs<double>(Dimension::Id::Y, i);
+        double z = src->getFieldAs<double>(Dimension::Id::Z, i);
+        ASSERT_TRUE(xform.transform(x, y, z));
+        EXPECT_DOUBLE_EQ(v1->getFieldAs<double>(Dimension::Id::X, i), x);
+        EXPECT_DOUBLE_EQ(v1->getFieldAs<double>(Dimension::Id::Y, i), y);
+        EXPECT_DOUBLE_EQ(v1->getFieldAs<double>(Dimension::Id::Z, i), z);
+        EXPECT_DOUBLE_EQ(v4->getFieldAs<double>(Dimension::Id::X, i), x);
+        EXPECT_DOUBLE_EQ(v4->getFieldAs<double>(Dimension::Id::Y, i), y);
+        EXPECT_DOUBLE_EQ(v4->getFieldAs<double>(Dimension::Id::Z, i), z);
+    }
+}
+
+TEST(ReprojectionFilterTest, arrayTransform)
+{
+    SrsTransform xform(SpatialReference("EPSG:32615"),
+        SpatialReference("EPSG:4326"));
+
+    std::vector<double> x { 470692.405659, 470692.405659 };
+    std::vector<double> y { 4602888.856527, 4602888.856527 };
+    std::vector<double> z { 16, 16 };
+    EXPECT_TRUE(xform.transform(x, y, z));
+    EXPECT_NEAR(x[0], -93.351563, .000001);
+    EXPECT_NEAR(y[1], 41.577148, .000001);
+
+    std::vector<double> bad(1);
+    EXPECT_THROW(xform.transform(x, y, bad), pdal_error);
+}
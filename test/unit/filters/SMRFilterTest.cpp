@@ -94,3 +94,54 @@ TEST(SMRFFilterTest, noreturns)
     EXPECT_EQ(classCount.size(), 1U);
     EXPECT_EQ(classCount[ClassLabel::Ground], 10);
 }
+
+TEST(SMRFilterTest, tiles)
+{
+    auto run = [](double tileSize, int threads)
+    {
+        StageFactory factory;
+
+        Stage *r = factory.createStage("readers.las");
+        Options rOptions;
+        rOptions.add("filename", Support::datapath("las/autzen_trim.las"));
+        r->setOptions(rOptions);
+
+        Stage *f = factory.createStage("filters.smrf");
+        Options fOptions;
+        fOptions.add("tile_size", tileSize);
+        fOptions.add("threads", threads);
+        f->setOptions(fOptions);
+        f->setInput(*r);
+
+        PointTable t;
+        f->prepare(t);
+        PointViewSet s = f->execute(t);
+        PointViewPtr v = *s.begin();
+
+        std::vector<uint8_t> classes;
+        for (PointId idx = 0; idx < v->size(); ++idx)
+            classes.push_back(v->getFieldAs<uint8_t>(
+                Dimension::Id::Classification, idx));
+        return classes;
+    };
+
+    std::vector<uint8_t> whole = run(0, 1);
+
+    // A single tile covers the same area as the whole.
+    EXPECT_EQ(whole, run(5000, 2));
+
+    // Tiles with buffers should mostly agree with the whole.
+    std::vector<uint8_t> tiled = run(300, 4);
+    ASSERT_EQ(whole.size(), tiled.size());
+    size_t same = 0;
+    size_t ground = 0;
+    for (size_t i = 0; i < whole.size(); ++i)
+    {
+        if (whole[i] == tiled[i])
+            same++;
+        if (tiled[i] == ClassLabel::Ground)
+            ground++;
+    }
+    EXPECT_GT(ground, 0u);
+    EXPECT_GT(same, whole.size() * 97 / 100);
+}
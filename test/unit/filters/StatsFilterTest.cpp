@@ -438,6 +438,106 @@ TEST(Stats, global)
 
 }
 
+TEST(Stats, quantiles)
+{
+    BOX3D bounds(1.0, 0.0, 0.0, 10.0, 100.0, 1000.0);
+    Options ops;
+    ops.add("bounds", bounds);
+    ops.add("count", 10);
+    ops.add("mode", "ramp");
+
+    auto run = [&ops](bool sketch)
+    {
+        FauxReader reader;
+        reader.setOptions(ops);
+
+        Options filterOps;
+        filterOps.add("dimensions", "Z");
+        filterOps.add("global", "Z");
+        filterOps.add("quantiles", "0, .25, 1");
+        filterOps.add("sketch", sketch);
+
+        StatsFilter filter;
+        filter.setInput(reader);
+        filter.setOptions(filterOps);
+
+        PointTable table;
+        filter.prepare(table);
+        filter.execute(table);
+
+        const stats::Summary& statsZ = filter.getStats(Dimension::Id::Z);
+        EXPECT_EQ(statsZ.sketched(), sketch);
+        EXPECT_DOUBLE_EQ(statsZ.median(), 555.55555555555554);
+        EXPECT_DOUBLE_EQ(statsZ.mad(), 333.33333333333331);
+        ASSERT_EQ(statsZ.quantiles().size(), 3u);
+        EXPECT_DOUBLE_EQ(statsZ.quantiles()[0], 0.0);
+        EXPECT_DOUBLE_EQ(statsZ.quantiles()[1], 222.22222222222223);
+        EXPECT_DOUBLE_EQ(statsZ.quantiles()[2], 1000.0);
+
+        MetadataNode m = filter.getMetadata().findChild("statistic");
+        EXPECT_DOUBLE_EQ(m.findChild("quantiles:0.25").value<double>(),
+            222.22222222222223);
+    };
+
+    // With few points, the sketch holds every value and matches.
+    run(false);
+    run(true);
+}
+
+TEST(Stats, sketch)
+{
+    std::mt19937 gen(314159);
+    std::normal_distribution<double> dis(100, 15);
+
+    using SummaryPtr = std::unique_ptr<stats::Summary>;
+    std::array<SummaryPtr, 4> parts;
+    for (SummaryPtr& part : parts)
+    {
+        part.reset(new stats::Summary("test", stats::Summary::Global, false));
+        part->useSketch(200);
+        part->setQuantiles({ .05, .95 });
+    }
+    stats::Summary whole("test", stats::Summary::Global, false);
+    whole.setQuantiles({ .05, .95 });
+
+    for (size_t i = 0; i < 400000; ++i)
+    {
+        double d = dis(gen);
+        whole.insert(d);
+        parts[i % 4]->insert(d);
+    }
+
+    stats::Summary exact("test", stats::Summary::Global, false);
+    EXPECT_FALSE(parts[0]->merge(exact));
+    for (size_t i = 1; i < 4; ++i)
+        EXPECT_TRUE(parts[0]->merge(*parts[i]));
+
+    stats::Summary& p = *parts[0];
+    whole.computeGlobalStats();
+    p.computeGlobalStats();
+
+    EXPECT_EQ(whole.count(), p.count());
+    EXPECT_NEAR(whole.median(), p.median(), .5);
+    EXPECT_NEAR(whole.mad(), p.mad(), .5);
+    ASSERT_EQ(p.quantiles().size(), 2u);
+    EXPECT_NEAR(whole.quantiles()[0], p.quantiles()[0], 1.0);
+    EXPECT_NEAR(whole.quantiles()[1], p.quantiles()[1], 1.0);
+}
+
+// A sketched global summary doesn't keep a map of the distinct values.
+TEST(Stats, sketchValues)
+{
+    stats::Summary summary("test", stats::Summary::Global, false);
+    summary.useSketch(200);
+    for (size_t i = 0; i < 100000; ++i)
+        summary.insert(i * .5);
+    EXPECT_EQ(summary.count(), 100000u);
+    EXPECT_TRUE(summary.values().empty());
+
+    summary.computeGlobalStats();
+    EXPECT_NEAR(summary.median(), 25000, 1000);
+}
+
 TEST(Stats, merge)
 {
     std::mt19937 gen(314159);
@@ -564,3 +664,59 @@ TEST(Stats, counts)
         }
     }
 }
+
+// Statistics from a column table, which are computed from the dimension
+// memory, should match those from a row table.
+TEST(Stats, columns)
+{
+    using namespace Dimension;
+
+    auto run = [](BasePointTable& table)
+    {
+        table.layout()->registerDims({ Id::X, Id::Y });
+        table.layout()->registerDim(Id::Classification, Type::Unsigned8);
+        table.layout()->registerDim(Id::Intensity, Type::Unsigned16);
+        table.finalize();
+
+        PointViewPtr view(new PointView(table));
+        std::mt19937 gen(1234);
+        std::uniform_real_distribution<double> dist(-1000, 1000);
+        for (PointId idx = 0; idx < 50000; ++idx)
+        {
+            view->setField(Id::X, idx, dist(gen));
+            view->setField(Id::Y, idx, dist(gen));
+            view->setField(Id::Classification, idx, idx % 20);
+            view->setField(Id::Intensity, idx, gen() % 65536);
+        }
+
+        BufferReader reader;
+        reader.addView(view);
+
+        Options o;
+        o.add("advanced", true);
+        std::unique_ptr<StatsFilter> filter(new StatsFilter);
+        filter->setInput(reader);
+        filter->setOptions(o);
+        filter->prepare(table);
+        filter->execute(table);
+        return filter;
+    };
+
+    PointTable rowTable;
+    ColumnPointTable columnTable;
+    auto rowStats = run(rowTable);
+    auto columnStats = run(columnTable);
+
+    for (Id id : { Id::X, Id::Y, Id::Classification, Id::Intensity })
+    {
+        const stats::Summary& r = rowStats->getStats(id);
+        const stats::Summary& c = columnStats->getStats(id);
+        EXPECT_EQ(r.count(), 50000u);
+        EXPECT_EQ(r.count(), c.count());
+        EXPECT_EQ(r.minimum(), c.minimum());
+        EXPECT_EQ(r.maximum(), c.maximum());
+        EXPECT_DOUBLE_EQ(r.average(), c.average());
+        EXPECT_DOUBLE_EQ(r.populationVariance(), c.populationVariance());
+        EXPECT_DOUBLE_EQ(r.populationKurtosis(), c.populationKurtosis());
+    }
+}
@@ -32,8 +32,12 @@
 * OF SUCH DAMAGE.
 ****************************************************************************/
 
+#include <cstring>
+
 #include <pdal/pdal_test_main.hpp>
 
+#include <filters/StreamCallbackFilter.hpp>
+
 #include "Support.hpp"
 #include "io/BpfSupport.hpp"
 
@@ -57,6 +61,97 @@ TEST(BpfTestBase, test_byte_major)
         Support::datapath("bpf/autzen-utm-chipped-25-v3-segregated.bpf"));
 }
 
+// Reading from a mapping of the file should match reading from a stream.
+TEST(BpfTestBase, mmap)
+{
+    auto check = [](const std::string& filename, const std::string& message)
+    {
+        Options ops;
+        ops.add("filename", filename);
+
+        BpfReader r1;
+        r1.setOptions(ops);
+
+        std::ostringstream out;
+        LogPtr log(Log::makeLog("readers.bpf", &out));
+        log->setLevel(LogLevel::Debug);
+
+        ops.add("use_mmap", true);
+        BpfReader r2;
+        r2.setOptions(ops);
+        r2.setLog(log);
+
+        Support::compareReaders(r1, r2);
+
+        // The reader falls back to the stream if the file can't be mapped.
+        EXPECT_NE(out.str().find(message), std::string::npos);
+    };
+
+    for (std::string name : { "bpf/autzen-utm-chipped-25-v3-interleaved.bpf",
+            "bpf/autzen-utm-chipped-25-v3.bpf",
+            "bpf/autzen-utm-chipped-25-v3-segregated.bpf" })
+    {
+        std::string filename = Support::datapath(name);
+        check(filename, "mapping of '" + filename + "'");
+    }
+
+#ifdef PDAL_HAVE_ZLIB
+    // Compressed data is inflated into memory and decoded from there.
+    for (std::string name : { "bpf/autzen-utm-chipped-25-v3-deflate-interleaved.bpf",
+            "bpf/autzen-utm-chipped-25-v3-deflate.bpf",
+            "bpf/autzen-utm-chipped-25-v3-deflate-segregated.bpf" })
+        check(Support::datapath(name), "inflated point data");
+#endif
+}
+
+// Points read one at a time from a mapping should match those read from a
+// stream.
+TEST(BpfTestBase, mmapStream)
+{
+    for (std::string name : { "bpf/autzen-utm-chipped-25-v3-interleaved.bpf",
+            "bpf/autzen-utm-chipped-25-v3.bpf",
+            "bpf/autzen-utm-chipped-25-v3-segregated.bpf" })
+    {
+        Options ops;
+        ops.add("filename", Support::datapath(name));
+
+        BpfReader r1;
+        r1.setOptions(ops);
+        PointTable t1;
+        r1.prepare(t1);
+        PointViewSet s = r1.execute(t1);
+        PointViewPtr v = *s.begin();
+        DimTypeList dims = v->dimTypes();
+
+        ops.add("use_mmap", true);
+        BpfReader r2;
+        r2.setOptions(ops);
+
+        std::vector<char> buf1(v->pointSize());
+        std::vector<char> buf2(v->pointSize());
+        PointId idx = 0;
+        StreamCallbackFilter f;
+        f.setCallback([&](PointRef& p)
+        {
+            if (idx < v->size())
+            {
+                v->getPackedPoint(dims, idx, buf1.data());
+                p.getPackedData(dims, buf2.data());
+                EXPECT_EQ(memcmp(buf1.data(), buf2.data(), buf1.size()), 0) <<
+                    name << ": Index = " << idx;
+            }
+            idx++;
+            return true;
+        });
+        f.setInput(r2);
+
+        FixedPointTable t2(100);
+        f.prepare(t2);
+        f.execute(t2);
+        EXPECT_EQ(idx, v->size()) << name;
+    }
+}
+
 TEST(BpfTestBase, roundtrip_byte)
 {
     Options ops;
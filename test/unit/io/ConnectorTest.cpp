@@ -0,0 +1,273 @@
+/******************************************************************************
+* Copyright (c) 2026, Hobu Inc. (info@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+#include <pdal/pdal_test_main.hpp>
+
+#include <io/private/connector/Connector.hpp>
+#include <io/private/connector/DiskCache.hpp>
+#include <pdal/util/FileUtils.hpp>
+
+#include "Support.hpp"
+#include "HttpServer.hpp"
+
+namespace pdal
+{
+
+using namespace connector;
+
+namespace
+{
+
+size_t cacheEntries(const std::string& dir)
+{
+    size_t count = 0;
+    for (const std::string& f : FileUtils::directoryList(dir))
+        if (FileUtils::extension(f) == ".pdalcache")
+            count++;
+    return count;
+}
+
+// Write 'size' bytes to 'filename', starting from the letter 'first'.  The
+// modification time is moved forward so that a rewritten file always has a
+// new ETag.
+void writeSource(const std::string& filename, size_t size, char first)
+{
+    namespace fs = std::filesystem;
+
+    std::ofstream out(filename, std::ios::binary);
+    for (size_t i = 0; i < size; ++i)
+        out << (char)(first + i % 26);
+    out.close();
+
+    static int offset = 0;
+    fs::last_write_time(filename,
+        fs::file_time_type::clock::now() + std::chrono::hours(++offset));
+}
+
+std::string str(const std::vector<char>& data)
+{
+    return std::string(data.begin(), data.end());
+}
+
+} // unnamed namespace
+
+TEST(ConnectorTest, diskCache)
+{
+    const std::string dir(Support::temppath("disk_cache"));
+    FileUtils::deleteDirectory(dir);
+
+    DiskCache cache(dir, 1000);
+    std::vector<char> data;
+    EXPECT_FALSE(cache.get("a", data));
+    cache.put("a", std::vector<char>(100, 'a'));
+    EXPECT_TRUE(cache.get("a", data));
+    EXPECT_EQ(data, std::vector<char>(100, 'a'));
+    EXPECT_EQ(cache.size(), 100u);
+
+    // Replacing an entry counts only the new data.
+    cache.put("a", std::vector<char>(300, 'a'));
+    EXPECT_EQ(cache.size(), 300u);
+    cache.put("a", std::vector<char>(100, 'a'));
+    EXPECT_EQ(cache.size(), 100u);
+
+    // Threads that store the same key count it once.
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 8; ++i)
+        threads.emplace_back([&cache]()
+        {
+            for (int j = 0; j < 20; ++j)
+                cache.put("a", std::vector<char>(100, 'a'));
+        });
+    for (std::thread& t : threads)
+        t.join();
+    EXPECT_EQ(cache.size(), 100u);
+
+    // Data larger than the cache isn't stored.
+    cache.put("big", std::vector<char>(1001, 'b'));
+    EXPECT_FALSE(cache.get("big", data));
+
+    // A full cache is trimmed to 90% of its maximum size and keeps the
+    // newest entry.
+    for (int i = 0; i < 10; ++i)
+        cache.put(std::to_string(i), std::vector<char>(150, 'c'));
+    EXPECT_LE(cache.size(), 900u);
+    EXPECT_TRUE(cache.get("9", data));
+    EXPECT_EQ(cacheEntries(dir) * 150, cache.size());
+
+    // Temporary files left by a failed writer are removed once they're
+    // old.  Those that may still be written are kept.
+    namespace fs = std::filesystem;
+    const std::string stale(dir + "/stale.pdalcache.tmp1-0");
+    const std::string fresh(dir + "/fresh.pdalcache.tmp1-1");
+    std::ofstream(stale) << "stale";
+    std::ofstream(fresh) << "fresh";
+    fs::last_write_time(stale,
+        fs::file_time_type::clock::now() - std::chrono::hours(2));
+
+    // The cache persists.
+    DiskCache cache2(dir, 1000);
+    EXPECT_EQ(cache2.size(), cache.size());
+    EXPECT_TRUE(cache2.get("9", data));
+    EXPECT_FALSE(FileUtils::fileExists(stale));
+    EXPECT_TRUE(FileUtils::fileExists(fresh));
+
+    FileUtils::deleteDirectory(dir);
+}
+
+TEST(ConnectorTest, cache)
+{
+    const std::string root(Support::temppath("connector_root"));
+    const std::string cacheDir(Support::temppath("connector_cache"));
+    FileUtils::deleteDirectory(root);
+    FileUtils::deleteDirectory(cacheDir);
+    FileUtils::createDirectories(root);
+    writeSource(root + "/source.bin", 1000, 'a');
+
+    test::HttpServer server(root);
+    const std::string url(server.url("source.bin"));
+
+    // The first read fetches the data and stores it.
+    {
+        Connector c(url, {}, {});
+        c.setCache(cacheDir, 1 << 20);
+        EXPECT_EQ(str(c.getBinary(10, 5)), "klmno");
+        EXPECT_EQ(str(c.getBinary(url)).size(), 1000u);
+        EXPECT_EQ(c.cacheRequests(), 2u);
+        EXPECT_EQ(c.cacheHits(), 0u);
+        EXPECT_EQ(server.dataResponses(), 2u);
+        EXPECT_EQ(cacheEntries(cacheDir), 2u);
+    }
+
+    // A new reader checks the source once, and uses the cache for the rest
+    // of the data once the source is known to be unchanged.
+    {
+        Connector c(url, {}, {});
+        c.setCache(cacheDir, 1 << 20);
+        EXPECT_EQ(str(c.getBinary(10, 5)), "klmno");
+        EXPECT_EQ(server.requests(), 3u);
+        EXPECT_EQ(str(c.getBinary(url)).size(), 1000u);
+        EXPECT_EQ(str(c.getBinary(10, 5)), "klmno");
+        EXPECT_EQ(server.requests(), 3u);
+        EXPECT_EQ(c.cacheRequests(), 3u);
+        EXPECT_EQ(c.cacheHits(), 3u);
+        EXPECT_EQ(server.dataResponses(), 2u);
+    }
+
+    // A changed source is fetched again.
+    writeSource(root + "/source.bin", 1000, 'A');
+    {
+        Connector c(url, {}, {});
+        c.setCache(cacheDir, 1 << 20);
+        EXPECT_EQ(str(c.getBinary(10, 5)), "KLMNO");
+        EXPECT_EQ(str(c.getBinary(10, 5)), "KLMNO");
+        EXPECT_EQ(c.cacheRequests(), 2u);
+        EXPECT_EQ(c.cacheHits(), 1u);
+        EXPECT_EQ(server.dataResponses(), 3u);
+    }
+
+    // Without validation, cached data is used without asking the source,
+    // even though it has changed.
+    writeSource(root + "/source.bin", 1000, 'b');
+    {
+        const size_t requests = server.requests();
+        Connector c(url, {}, {});
+        c.setCache(cacheDir, 1 << 20, false);
+        EXPECT_EQ(str(c.getBinary(10, 5)), "KLMNO");
+        EXPECT_EQ(str(c.getBinary(10, 5)), "KLMNO");
+        EXPECT_EQ(c.cacheRequests(), 2u);
+        EXPECT_EQ(c.cacheHits(), 2u);
+        EXPECT_EQ(server.requests(), requests);
+    }
+
+    FileUtils::deleteDirectory(root);
+    FileUtils::deleteDirectory(cacheDir);
+}
+
+TEST(ConnectorTest, uncacheable)
+{
+    const std::string root(Support::temppath("connector_root"));
+    const std::string cacheDir(Support::temppath("connector_cache"));
+    FileUtils::deleteDirectory(root);
+    FileUtils::deleteDirectory(cacheDir);
+    FileUtils::createDirectories(root);
+    writeSource(root + "/source.bin", 1000, 'a');
+
+    test::HttpServer server(root);
+    const std::string url(server.url("source.bin"));
+
+    // Local files are read directly.
+    Connector local(root + "/source.bin", {}, {});
+    local.setCache(cacheDir, 1 << 20);
+    EXPECT_EQ(str(local.getBinary(10, 5)), "klmno");
+    EXPECT_EQ(local.cacheRequests(), 0u);
+
+    // Data without an ETag isn't stored.
+    server.setEtags(false);
+    Connector noEtag(url, {}, {});
+    noEtag.setCache(cacheDir, 1 << 20);
+    EXPECT_EQ(str(noEtag.getBinary(10, 5)), "klmno");
+    EXPECT_EQ(cacheEntries(cacheDir), 0u);
+
+    // The whole file, sent in answer to a range request, isn't stored.
+    server.setEtags(true);
+    server.setIgnoreRanges(true);
+    Connector noRange(url, {}, {});
+    noRange.setCache(cacheDir, 1 << 20);
+    EXPECT_EQ(noRange.getBinary(10, 5).size(), 1000u);
+    EXPECT_EQ(cacheEntries(cacheDir), 0u);
+
+    // Errors carry the HTTP status.
+    Connector missing(server.url("missing.bin"), {}, {});
+    missing.setCache(cacheDir, 1 << 20);
+    try
+    {
+        missing.getBinary(0, 4);
+        FAIL() << "Expected an error reading a missing file.";
+    }
+    catch (const arbiter::ArbiterError& err)
+    {
+        EXPECT_NE(std::string(err.what()).find("404"), std::string::npos);
+    }
+
+    FileUtils::deleteDirectory(root);
+    FileUtils::deleteDirectory(cacheDir);
+}
+
+} // namespace pdal
@@ -33,6 +33,8 @@
  ****************************************************************************/
 
 #include <algorithm>
+#include <filesystem>
+#include <regex>
 
 #include <nlohmann/json.hpp>
 
@@ -49,6 +51,9 @@
 #include <pdal/private/gdal/GDALUtils.hpp>
 
 #include "Support.hpp"
+#ifndef _WIN32
+#include "HttpServer.hpp"
+#endif
 
 namespace pdal
 {
@@ -133,6 +138,119 @@ TEST(CopcReaderTest, fullRead)
     EXPECT_EQ(np, numPoints);
 }
 
+#ifndef _WIN32
+TEST(CopcReaderTest, cache)
+{
+    namespace fs = std::filesystem;
+
+    const std::string root(Support::temppath("copc_root"));
+    const std::string cacheDir(Support::temppath("copc_cache"));
+    const std::string filename(root + "/lone-star.copc.laz");
+    FileUtils::deleteDirectory(root);
+    FileUtils::deleteDirectory(cacheDir);
+    FileUtils::createDirectories(root);
+    fs::copy_file(copcPath, filename);
+
+    test::HttpServer server(root);
+
+    // Read the file and return the sum of its positions, along with the
+    // number of cacheable requests and cache hits reported in the log.
+    struct Result
+    {
+        double sum;
+        uint64_t requests;
+        uint64_t hits;
+    };
+    auto read = [&cacheDir, &server]()
+    {
+        Options options;
+        options.add("filename", server.url("lone-star.copc.laz"));
+        options.add("cache_dir", cacheDir);
+
+        std::ostringstream oss;
+        LogPtr log(Log::makeLog("readers.copc", &oss));
+        log->setLevel(LogLevel::Debug);
+
+        PointTable table;
+        CopcReader reader;
+        reader.setOptions(options);
+        reader.setLog(log);
+        reader.prepare(table);
+
+        Result result { 0, 0, 0 };
+        point_count_t np = 0;
+        for (const PointViewPtr& view : reader.execute(table))
+            for (PointId i = 0; i < view->size(); ++i)
+            {
+                result.sum += view->getFieldAs<double>(Dimension::Id::X, i) +
+                    view->getFieldAs<double>(Dimension::Id::Y, i) +
+                    view->getFieldAs<double>(Dimension::Id::Z, i);
+                np++;
+            }
+        EXPECT_EQ(np, numPoints);
+
+        std::smatch match;
+        const std::string s = oss.str();
+        EXPECT_TRUE(std::regex_search(s, match,
+            std::regex("Read (\\d+) of (\\d+) cacheable requests")));
+        if (match.size() == 3)
+        {
+            result.hits = std::stoull(match[1]);
+            result.requests = std::stoull(match[2]);
+        }
+        return result;
+    };
+
+    auto entries = [&cacheDir]()
+    {
+        size_t count = 0;
+        for (const std::string& f : FileUtils::directoryList(cacheDir))
+            if (FileUtils::extension(f) == ".pdalcache")
+                count++;
+        return count;
+    };
+
+    // The first read fills the cache and the second is served from it
+    // without data being sent.
+    Result first = read();
+    size_t count = entries();
+    size_t responses = server.dataResponses();
+    EXPECT_GT(count, 1u);
+    EXPECT_LT(first.hits, first.requests);
+
+    Result second = read();
+    EXPECT_DOUBLE_EQ(second.sum, first.sum);
+    EXPECT_EQ(second.requests, first.requests);
+    EXPECT_EQ(second.hits, second.requests);
+    EXPECT_EQ(server.dataResponses(), responses);
+    EXPECT_EQ(entries(), count);
+
+    // A changed source isn't served from the cache.
+    fs::last_write_time(filename,
+        fs::last_write_time(filename) + std::chrono::hours(1));
+    Result changed = read();
+    EXPECT_DOUBLE_EQ(changed.sum, first.sum);
+    EXPECT_EQ(changed.hits, first.hits);
+    EXPECT_GT(server.dataResponses(), responses);
+
+    FileUtils::deleteDirectory(root);
+    FileUtils::deleteDirectory(cacheDir);
+}
+#endif
+
+TEST(CopcReaderTest, cacheSize)
+{
+    Options options;
+    options.add("filename", copcPath);
+    options.add("cache_dir", Support::temppath("copc_cache"));
+    options.add("cache_size", 0);
+
+    PointTable table;
+    CopcReader reader;
+    reader.setOptions(options);
+    EXPECT_THROW(reader.prepare(table), pdal_error);
+}
+
 TEST(CopcReaderTest, resolutionLimit)
 {
     Options options;
@@ -33,6 +33,7 @@
  ****************************************************************************/
 
 #include <algorithm>
+#include <array>
 
 #include <pdal/pdal_test_main.hpp>
 
@@ -42,6 +43,8 @@
 #include <io/CopcWriter.hpp>
 #include <io/LasReader.hpp>
 #include <filters/FerryFilter.hpp>
+#include <filters/RangeFilter.hpp>
+#include <io/private/copcwriter/Spill.hpp>
 
 #include <pdal/PDALUtils.hpp>
 
@@ -328,4 +331,214 @@ TEST(CopcWriterTest, extradim)
     EXPECT_THROW(createFile("Z=int32"), pdal_error);      // Unknown dimension.
 }
 
+// Stream mode writes points to temporary files. Make sure all the points make
+// it to the output.
+TEST(CopcWriterTest, stream)
+{
+    std::string outFilename(Support::temppath("copcstream.copc.laz"));
+    FileUtils::deleteFile(outFilename);
+
+    {
+        LasReader r;
+        Options ro;
+        ro.add("filename", Support::datapath("las/autzen_trim.las"));
+        r.setOptions(ro);
+
+        FerryFilter f;
+        Options fo;
+        fo.add("dimensions", "Intensity=>Q");
+        f.setOptions(fo);
+        f.setInput(r);
+
+        CopcWriter w;
+        Options wo;
+        wo.add("filename", outFilename);
+        wo.add("extra_dims", "all");
+        wo.add("memory_budget", 1);
+        wo.add("temp_dir", Support::temppath());
+        w.setOptions(wo);
+        w.setInput(f);
+
+        FixedPointTable t(1000);
+        w.prepare(t);
+        w.execute(t);
+    }
+
+    auto read = [](const std::string& filename)
+    {
+        LasReader r;
+        Options ro;
+        ro.add("filename", filename);
+        r.setOptions(ro);
+
+        PointTable t;
+        r.prepare(t);
+        PointViewSet s = r.execute(t);
+        PointViewPtr v = *s.begin();
+
+        Dimension::Id q = t.layout()->findDim("Q");
+        std::vector<std::array<double, 4>> points;
+        for (PointRef p : *v)
+        {
+            double intensity = q == Dimension::Id::Unknown ?
+                p.getFieldAs<double>(Dimension::Id::Intensity) :
+                p.getFieldAs<double>(q);
+            points.push_back({ p.getFieldAs<double>(Dimension::Id::X),
+                p.getFieldAs<double>(Dimension::Id::Y),
+                p.getFieldAs<double>(Dimension::Id::Z), intensity });
+        }
+        std::sort(points.begin(), points.end());
+        return points;
+    };
+
+    auto expected = read(Support::datapath("las/autzen_trim.las"));
+    auto points = read(outFilename);
+    ASSERT_EQ(points.size(), expected.size());
+    for (size_t i = 0; i < points.size(); ++i)
+        for (size_t j = 0; j < 4; ++j)
+            EXPECT_NEAR(points[i][j], expected[i][j], .0001);
+    FileUtils::deleteFile(outFilename);
+}
+
+// Points that arrive ordered by tile start the lattice of stream mode over
+// a small part of the data.  The lattice must grow coarser rather than give
+// every later point a cell of its own or put it in the wrong voxel.
+TEST(CopcWriterTest, sortedSpill)
+{
+    using namespace copcwriter;
+
+    // Points of the first tile, which fill the first megabyte of the budget,
+    // then those of the other tiles of a 40 x 40 km area.
+    std::vector<std::array<double, 3>> tiled;
+    for (int i = 0; i < 213; ++i)
+        for (int j = 0; j < 213; ++j)
+            tiled.push_back({ i * 1000 / 213.0, j * 1000 / 213.0, double((i + j) % 10) });
+    for (int ty = 0; ty < 40; ++ty)
+        for (int tx = 0; tx < 40; ++tx)
+            if (tx || ty)
+                for (int i = 0; i < 8; ++i)
+                    for (int j = 0; j < 8; ++j)
+                        tiled.push_back({ tx * 1000 + 62.5 + 125 * i,
+                            ty * 1000 + 62.5 + 125 * j, double((i + j) % 10) });
+
+    // The same number of points at one spot, then points hundreds of km away.
+    std::vector<std::array<double, 3>> cluster(43700, { 100, 100, 100 });
+    for (int i = 0; i < 1000; ++i)
+        cluster.push_back({ 100 + i * 100000.0, 100 - i * 50000.0, 100.0 + i });
+
+    for (auto& points : { tiled, cluster })
+    {
+        BaseInfo b;
+        b.opts.memoryBudget = 1;
+        b.opts.tempDir = Support::temppath();
+        b.spillPrefix = "copcsortedspill";
+        for (Dimension::Id id : { Dimension::Id::X, Dimension::Id::Y, Dimension::Id::Z })
+            b.spillDims.emplace_back(id, Dimension::Type::Double);
+        b.spillPointSize = 3 * sizeof(double);
+
+        PointTable table;
+        table.layout()->registerDims({ Dimension::Id::X, Dimension::Id::Y,
+            Dimension::Id::Z });
+        table.finalize();
+
+        CellFiles cells(b);
+        BOX3D bounds;
+        for (auto& p : points)
+        {
+            cells.add(reinterpret_cast<const char *>(p.data()));
+            bounds.grow(p[0], p[1], p[2]);
+        }
+        Grid grid = cells.finish(bounds);
+
+        // Each occupied cell of a lattice as fine as the one the first points
+        // start would have its own file: some 80,000 of them for 'tiled'.
+        size_t files = FileUtils::glob(Support::temppath("copcsortedspill-*")).size();
+        EXPECT_LT(files, 20000u);
+
+        // Every point must be within the bounds of its voxel.
+        const BOX3D cube = grid.processingBounds();
+        point_count_t count = 0;
+        for (OctantInfo& o : cells.releaseAll())
+        {
+            const VoxelKey& k = o.key();
+            const double size = (cube.maxx - cube.minx) / (1 << k.level());
+            const double eps = size / 1e6;
+            BOX3D voxel(cube.minx + k.x() * size, cube.miny + k.y() * size,
+                cube.minz + k.z() * size, cube.minx + (k.x() + 1) * size,
+                cube.miny + (k.y() + 1) * size, cube.minz + (k.z() + 1) * size);
+
+            PointView view(table);
+            readSpill(b, o, view, b.spillDims);
+            for (PointRef p : view)
+            {
+                EXPECT_GE(p.getFieldAs<double>(Dimension::Id::X), voxel.minx - eps);
+                EXPECT_LE(p.getFieldAs<double>(Dimension::Id::X), voxel.maxx + eps);
+                EXPECT_GE(p.getFieldAs<double>(Dimension::Id::Y), voxel.miny - eps);
+                EXPECT_LE(p.getFieldAs<double>(Dimension::Id::Y), voxel.maxy + eps);
+                EXPECT_GE(p.getFieldAs<double>(Dimension::Id::Z), voxel.minz - eps);
+                EXPECT_LE(p.getFieldAs<double>(Dimension::Id::Z), voxel.maxz + eps);
+            }
+            count += view.size();
+        }
+        EXPECT_EQ(count, points.size());
+        EXPECT_TRUE(FileUtils::glob(Support::temppath("copcsortedspill-*")).empty());
+    }
+}
+
+// A file is written even when no points arrive, in either mode.
+TEST(CopcWriterTest, empty)
+{
+    std::string outFilename(Support::temppath("copcempty.copc.laz"));
+
+    for (bool stream : { false, true })
+    {
+        FileUtils::deleteFile(outFilename);
+        {
+            LasReader r;
+            Options ro;
+            ro.add("filename", Support::datapath("las/autzen_trim.las"));
+            r.setOptions(ro);
+
+            RangeFilter f;
+            Options fo;
+            fo.add("limits", "Z[100000:]");
+            f.setOptions(fo);
+            f.setInput(r);
+
+            CopcWriter w;
+            Options wo;
+            wo.add("filename", outFilename);
+            wo.add("temp_dir", Support::temppath());
+            w.setOptions(wo);
+            w.setInput(f);
+
+            if (stream)
+            {
+                FixedPointTable t(1000);
+                w.prepare(t);
+                w.execute(t);
+            }
+            else
+            {
+                PointTable t;
+                w.prepare(t);
+                w.execute(t);
+            }
+        }
+        EXPECT_TRUE(FileUtils::fileExists(outFilename));
+
+        CopcReader r;
+        Options ro;
+        ro.add("filename", outFilename);
+        r.setOptions(ro);
+
+        PointTable t;
+        r.prepare(t);
+        PointViewSet s = r.execute(t);
+        ASSERT_EQ(s.size(), 1u);
+        EXPECT_EQ((*s.begin())->size(), 0u);
+    }
+    FileUtils::deleteFile(outFilename);
+}
+
 } // namespace pdal
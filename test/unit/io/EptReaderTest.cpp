@@ -33,6 +33,7 @@
  ****************************************************************************/
 
 #include <algorithm>
+#include <regex>
 
 #include <nlohmann/json.hpp>
 
@@ -49,6 +50,9 @@
 #include <pdal/private/gdal/GDALUtils.hpp>
 
 #include "Support.hpp"
+#ifndef _WIN32
+#include "HttpServer.hpp"
+#endif
 
 namespace pdal
 {
@@ -191,6 +195,109 @@ TEST(EptReaderTest, fullReadBinary)
     EXPECT_EQ(np, ellipsoidNumPoints);
 }
 
+#ifndef _WIN32
+namespace
+{
+
+// Count the entries in a cache directory.
+size_t cacheEntries(const std::string& dir)
+{
+    size_t count = 0;
+    for (const std::string& f : FileUtils::directoryList(dir))
+        if (FileUtils::extension(f) == ".pdalcache")
+            count++;
+    return count;
+}
+
+} // unnamed namespace
+
+TEST(EptReaderTest, cache)
+{
+    const std::string cacheDir(Support::temppath("ept_cache"));
+    FileUtils::deleteDirectory(cacheDir);
+
+    test::HttpServer server(Support::datapath("ept"));
+
+    // Read the dataset and return the sum of its positions, along with the
+    // number of cacheable requests and cache hits reported in the log.
+    struct Result
+    {
+        double sum;
+        uint64_t requests;
+        uint64_t hits;
+    };
+    auto read = [&cacheDir, &server]()
+    {
+        Options options;
+        options.add("filename", server.url("ellipsoid-binary/ept.json"));
+        options.add("cache_dir", cacheDir);
+
+        std::ostringstream oss;
+        LogPtr log(Log::makeLog("readers.ept", &oss));
+        log->setLevel(LogLevel::Debug);
+
+        PointTable table;
+        EptReader reader;
+        reader.setOptions(options);
+        reader.setLog(log);
+        reader.prepare(table);
+
+        Result result { 0, 0, 0 };
+        point_count_t np = 0;
+        for (const PointViewPtr& view : reader.execute(table))
+            for (PointId i = 0; i < view->size(); ++i)
+            {
+                result.sum += view->getFieldAs<double>(Dimension::Id::X, i) +
+                    view->getFieldAs<double>(Dimension::Id::Y, i) +
+                    view->getFieldAs<double>(Dimension::Id::Z, i);
+                np++;
+            }
+        EXPECT_EQ(np, ellipsoidNumPoints);
+
+        std::smatch match;
+        const std::string s = oss.str();
+        EXPECT_TRUE(std::regex_search(s, match,
+            std::regex("Read (\\d+) of (\\d+) cacheable requests")));
+        if (match.size() == 3)
+        {
+            result.hits = std::stoull(match[1]);
+            result.requests = std::stoull(match[2]);
+        }
+        return result;
+    };
+
+    // The first read fills the cache and the second is served from it
+    // without data being sent.
+    Result first = read();
+    size_t entries = cacheEntries(cacheDir);
+    size_t responses = server.dataResponses();
+    EXPECT_GT(entries, 1u);
+    EXPECT_LT(first.hits, first.requests);
+
+    Result second = read();
+    EXPECT_DOUBLE_EQ(second.sum, first.sum);
+    EXPECT_EQ(second.requests, first.requests);
+    EXPECT_EQ(second.hits, second.requests);
+    EXPECT_EQ(server.dataResponses(), responses);
+    EXPECT_EQ(cacheEntries(cacheDir), entries);
+
+    FileUtils::deleteDirectory(cacheDir);
+}
+#endif
+
+TEST(EptReaderTest, cacheSize)
+{
+    Options options;
+    options.add("filename", ellipsoidEptBinaryPath);
+    options.add("cache_dir", Support::temppath("ept_cache"));
+    options.add("cache_size", 0);
+
+    PointTable table;
+    EptReader reader;
+    reader.setOptions(options);
+    EXPECT_THROW(reader.prepare(table), pdal_error);
+}
+
 TEST(EptReaderTest, unreadableDataFailure)
 {
     Options options;
@@ -940,4 +940,147 @@ TEST(GDALWriterTest, testMetadata)
 
 }
 
+// Points far apart only touch a few tiles of the grid.  Make sure that
+// the cells between them are written as nodata.
+TEST(GDALWriterTest, sparse)
+{
+    std::string outfile(Support::temppath("sparse.tif"));
+    FileUtils::deleteFile(outfile);
+
+    PointTable t;
+    t.layout()->registerDim(Dimension::Id::X);
+    t.layout()->registerDim(Dimension::Id::Y);
+    t.layout()->registerDim(Dimension::Id::Z);
+
+    PointViewPtr v(new PointView(t));
+    v->setField(Dimension::Id::X, 0, 0.5);
+    v->setField(Dimension::Id::Y, 0, 0.5);
+    v->setField(Dimension::Id::Z, 0, 10);
+    v->setField(Dimension::Id::X, 1, 1000.5);
+    v->setField(Dimension::Id::Y, 1, 2000.5);
+    v->setField(Dimension::Id::Z, 1, 20);
+
+    BufferReader r;
+    r.addView(v);
+
+    GDALWriter w;
+    Options wo;
+    wo.add("resolution", 1);
+    wo.add("output_type", "min");
+    wo.add("filename", outfile);
+    w.setOptions(wo);
+    w.setInput(r);
+
+    w.prepare(t);
+    w.execute(t);
+
+    gdal::Raster raster(outfile, "GTiff");
+    ASSERT_EQ(raster.open(), gdal::GDALError::None);
+    EXPECT_EQ(raster.width(), 1001);
+    EXPECT_EQ(raster.height(), 2001);
+
+    std::vector<double> data;
+    raster.readBand(data, 1);
+    size_t valid = 0;
+    for (double d : data)
+        if (!std::isnan(d))
+            valid++;
+    EXPECT_EQ(valid, 2u);
+    EXPECT_EQ(data[1000], 20);
+    EXPECT_EQ(data[2000 * 1001], 10);
+
+    // Only the tiles holding the two points are allocated.
+    GDALGrid grid(0, 0, 1001, 2001, 1, std::sqrt(2.0), GDALGrid::statMin, 0,
+        1.0, true);
+    grid.addPoint(0.5, 0.5, 10);
+    grid.addPoint(1000.5, 2000.5, 20);
+    grid.finalize();
+    EXPECT_EQ(grid.tileCount(), 2u);
+}
+
+namespace
+{
+
+// Write autzen with a window and return the values of all bands.
+// 'columns' tells whether the table gives the writer column spans.
+std::vector<std::vector<double>> autzenBands(PointTableRef t, int threads,
+    bool columns = false)
+{
+    std::string outfile(Support::temppath("threads.tif"));
+    FileUtils::deleteFile(outfile);
+
+    Options ro;
+    ro.add("filename", Support::datapath("las/autzen_trim.las"));
+    LasReader r;
+    r.setOptions(ro);
+
+    Options wo;
+    wo.add("resolution", 10);
+    wo.add("window_size", 5);
+    wo.add("threads", threads);
+    wo.add("filename", outfile);
+    GDALWriter w;
+    w.setOptions(wo);
+    w.setInput(r);
+
+    w.prepare(t);
+    PointViewSet s = w.execute(t);
+    EXPECT_EQ(s.size(), 1u);
+    PointViewPtr view = *s.begin();
+    EXPECT_EQ(view->column<const double>(Dimension::Id::X).empty(), !columns);
+    EXPECT_EQ(view->column<const double>(Dimension::Id::Z).empty(), !columns);
+
+    gdal::Raster raster(outfile, "GTiff");
+    EXPECT_EQ(raster.open(), gdal::GDALError::None);
+    std::vector<std::vector<double>> bands(6);
+    for (int i = 0; i < 6; ++i)
+        raster.readBand(bands[i], i + 1);
+    return bands;
+}
+
+void expectSameBands(const std::vector<std::vector<double>>& expected,
+    const std::vector<std::vector<double>>& actual)
+{
+    ASSERT_EQ(expected.size(), actual.size());
+    for (size_t i = 0; i < expected.size(); ++i)
+    {
+        ASSERT_EQ(expected[i].size(), actual[i].size());
+        EXPECT_GT(expected[i].size(), 0u);
+        for (size_t k = 0; k < expected[i].size(); ++k)
+        {
+            double a = expected[i][k];
+            double b = actual[i][k];
+            if (std::isnan(a))
+                EXPECT_TRUE(std::isnan(b));
+            else
+                EXPECT_EQ(a, b);
+        }
+    }
+}
+
+} // unnamed namespace
+
+TEST(GDALWriterTest, threads)
+{
+    PointTable t1;
+    std::vector<std::vector<double>> single = autzenBands(t1, 1);
+    PointTable t2;
+    std::vector<std::vector<double>> multi = autzenBands(t2, 4);
+    expectSameBands(single, multi);
+}
+
+// A column table is gridded from the column spans, on one thread and on
+// several.  The rasters must match those written from a row table.
+TEST(GDALWriterTest, columnTable)
+{
+    PointTable t;
+    std::vector<std::vector<double>> expected = autzenBands(t, 1);
+
+    for (int threads : { 1, 4 })
+    {
+        ColumnPointTable ct;
+        expectSameBands(expected, autzenBands(ct, threads, true));
+    }
+}
+
 } // namespace pdal
@@ -0,0 +1,235 @@
+/******************************************************************************
+* Copyright (c) 2026, Hobu Inc. (info@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+
+#pragma once
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include <pdal/pdal_types.hpp>
+#include <pdal/util/Utils.hpp>
+
+namespace pdal
+{
+namespace test
+{
+
+// A minimal HTTP server on the loopback interface that serves the files in
+// a directory.  It answers GET requests, one connection at a time, with byte
+// ranges and ETags made from the size and modification time of the file,
+// so that tests can read remote data without network access.
+class HttpServer
+{
+public:
+    HttpServer(const std::string& root) : m_root(root)
+    {
+        m_socket = ::socket(AF_INET, SOCK_STREAM, 0);
+        if (m_socket < 0)
+            throw pdal_error("Unable to create test HTTP server socket.");
+        sockaddr_in addr {};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t len = sizeof(addr);
+        if (::bind(m_socket, (sockaddr *)&addr, len) ||
+                ::listen(m_socket, 64) ||
+                ::getsockname(m_socket, (sockaddr *)&addr, &len))
+        {
+            ::close(m_socket);
+            throw pdal_error("Unable to start test HTTP server.");
+        }
+        m_port = ntohs(addr.sin_port);
+        m_thread = std::thread([this](){ run(); });
+    }
+
+    ~HttpServer()
+    {
+        m_stop = true;
+        m_thread.join();
+        ::close(m_socket);
+    }
+
+    // URL of a file in the root directory.
+    std::string url(const std::string& file) const
+    {
+        return "http://127.0.0.1:" + std::to_string(m_port) + "/" + file;
+    }
+
+    // Ignore Range headers and answer with the whole file.
+    void setIgnoreRanges(bool ignore)
+        { m_ignoreRanges = ignore; }
+    // Send ETags with responses.
+    void setEtags(bool etags)
+        { m_etags = etags; }
+
+    // Number of requests answered.
+    size_t requests() const
+        { return m_requests; }
+    // Number of requests answered with data.
+    size_t dataResponses() const
+        { return m_dataResponses; }
+
+private:
+    void run()
+    {
+        pollfd p { m_socket, POLLIN, 0 };
+        while (!m_stop)
+        {
+            if (::poll(&p, 1, 50) <= 0)
+                continue;
+            int fd = ::accept(m_socket, nullptr, nullptr);
+            if (fd < 0)
+                continue;
+            std::string request;
+            char buf[4096];
+            while (request.find("\r\n\r\n") == std::string::npos)
+            {
+                ssize_t cnt = ::recv(fd, buf, sizeof(buf), 0);
+                if (cnt <= 0)
+                    break;
+                request.append(buf, cnt);
+            }
+            std::string response = respond(request);
+            for (size_t pos = 0; pos < response.size();)
+            {
+                ssize_t cnt = ::send(fd, response.data() + pos,
+                    response.size() - pos, MSG_NOSIGNAL);
+                if (cnt <= 0)
+                    break;
+                pos += cnt;
+            }
+            ::close(fd);
+            m_requests++;
+        }
+    }
+
+    std::string respond(const std::string& request)
+    {
+        namespace fs = std::filesystem;
+
+        std::istringstream in(request);
+        std::string method, target, line;
+        in >> method >> target;
+        std::getline(in, line);
+
+        std::string range;
+        std::string ifNoneMatch;
+        while (std::getline(in, line) && line != "\r")
+        {
+            size_t colon = line.find(':');
+            if (colon == std::string::npos)
+                continue;
+            std::string name = line.substr(0, colon);
+            std::string value = line.substr(colon + 1);
+            Utils::trim(value);
+            if (Utils::iequals(name, "range"))
+                range = value;
+            else if (Utils::iequals(name, "if-none-match"))
+                ifNoneMatch = value;
+        }
+
+        fs::path path = fs::path(m_root) / target.substr(1);
+        std::error_code ec;
+        uintmax_t size = fs::file_size(path, ec);
+        if (method != "GET" || ec)
+            return header("404 Not Found", 0);
+
+        std::string etag = "\"" + std::to_string(size) + "-" +
+            std::to_string(fs::last_write_time(path).
+                time_since_epoch().count()) + "\"";
+        std::string extra;
+        if (m_etags)
+        {
+            extra = "ETag: " + etag + "\r\n";
+            if (ifNoneMatch == etag)
+                return header("304 Not Modified", 0, extra);
+        }
+
+        if (size == 0)
+            return header("200 OK", 0, extra);
+
+        uintmax_t begin = 0;
+        uintmax_t end = size - 1;
+        std::string status = "200 OK";
+        if (range.size() && !m_ignoreRanges)
+        {
+            if (std::sscanf(range.c_str(), "bytes=%ju-%ju", &begin, &end) != 2)
+                return header("400 Bad Request", 0);
+            end = (std::min)(end, size - 1);
+            status = "206 Partial Content";
+            extra += "Content-Range: bytes " + std::to_string(begin) + "-" +
+                std::to_string(end) + "/" + std::to_string(size) + "\r\n";
+        }
+
+        std::string data(end - begin + 1, 0);
+        std::ifstream file(path, std::ios::binary);
+        file.seekg(begin);
+        file.read(&data[0], data.size());
+        m_dataResponses++;
+        return header(status, data.size(), extra) + data;
+    }
+
+    std::string header(const std::string& status, size_t size,
+        const std::string& extra = std::string())
+    {
+        return "HTTP/1.1 " + status + "\r\n" + extra +
+            "Content-Length: " + std::to_string(size) + "\r\n" +
+            "Connection: close\r\n\r\n";
+    }
+
+    std::string m_root;
+    int m_socket;
+    int m_port;
+    std::thread m_thread;
+    std::atomic<bool> m_stop { false };
+    std::atomic<bool> m_ignoreRanges { false };
+    std::atomic<bool> m_etags { true };
+    std::atomic<size_t> m_requests { 0 };
+    std::atomic<size_t> m_dataResponses { 0 };
+};
+
+} // namespace test
+} // namespace pdal
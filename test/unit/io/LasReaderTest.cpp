@@ -470,6 +470,9 @@ TEST(LasReaderTest, lazperf)
     }
 }
 
+// Compare points loaded in bulk into a table of type TABLE with points
+// streamed one at a time.
+template<typename TABLE>
 void streamTest(const std::string src)
 {
     Options ops1;
@@ -478,7 +481,7 @@ void streamTest(const std::string src)
     LasReader lasReader;
     lasReader.setOptions(ops1);
 
-    PointTable t;
+    TABLE t;
     lasReader.prepare(t);
     PointViewSet s = lasReader.execute(t);
 
@@ -535,10 +538,83 @@ void streamTest(const std::string src)
 TEST(LasReaderTest, stream)
 {
     // Compression option is ignored for non-compressed file.
-    streamTest(Support::datapath("las/autzen_trim.las"));
-    streamTest(Support::datapath("laz/autzen_trim.laz"));
+    streamTest<PointTable>(Support::datapath("las/autzen_trim.las"));
+    streamTest<PointTable>(Support::datapath("laz/autzen_trim.laz"));
+    streamTest<ColumnPointTable>(Support::datapath("las/autzen_trim.las"));
+    streamTest<ColumnPointTable>(Support::datapath("laz/autzen_trim.laz"));
+}
+
+
+// Points in row tables and column tables are loaded a tile at a time by
+// different code. Make sure they match.
+TEST(LasReaderTest, bulkLoad)
+{
+    auto check = [](const std::string& filename)
+    {
+        Options ops;
+        ops.add("filename", filename);
+
+        LasReader r1;
+        r1.setOptions(ops);
+        PointTable t1;
+        r1.prepare(t1);
+        PointViewPtr v1 = *r1.execute(t1).begin();
+
+        LasReader r2;
+        r2.setOptions(ops);
+        ColumnPointTable t2;
+        r2.prepare(t2);
+        PointViewPtr v2 = *r2.execute(t2).begin();
+
+        ASSERT_EQ(v1->size(), v2->size());
+        DimTypeList dims = v1->dimTypes();
+        std::vector<char> buf1(v1->pointSize());
+        std::vector<char> buf2(v1->pointSize());
+        for (PointId i = 0; i < v1->size(); ++i)
+        {
+            v1->getPackedPoint(dims, i, buf1.data());
+            v2->getPackedPoint(dims, i, buf2.data());
+            EXPECT_EQ(memcmp(buf1.data(), buf2.data(), buf1.size()), 0);
+        }
+    };
+
+    check(Support::datapath("las/1.2-with-color.las"));
+    check(Support::datapath("las/autzen_trim_7.las"));
+    check(Support::datapath("las/extrabytes.las"));
+    check(Support::datapath("las/test1_4.las"));
+    check(Support::datapath("laz/autzen_trim.laz"));
 }
 
+// Reading from a mapping of the file should match reading from a stream.
+TEST(LasReaderTest, mmap)
+{
+    auto check = [](const std::string& filename)
+    {
+        Options ops;
+        ops.add("filename", filename);
+
+        LasReader r1;
+        r1.setOptions(ops);
+
+        std::ostringstream out;
+        LogPtr log(Log::makeLog("readers.las", &out));
+        log->setLevel(LogLevel::Debug);
+
+        ops.add("use_mmap", true);
+        LasReader r2;
+        r2.setOptions(ops);
+        r2.setLog(log);
+
+        Support::compareReaders(r1, r2);
+
+        // The reader falls back to the stream if the file can't be mapped.
+        EXPECT_NE(out.str().find("mapping of '" + filename + "'"), std::string::npos);
+    };
+
+    check(Support::datapath("las/autzen_trim.las"));
+    check(Support::datapath("las/test1_4.las"));
+    check(Support::datapath("laz/autzen_trim.laz"));
+}
 
 // The header of 1.2-with-color-clipped says that it has 1065 points,
 // but it really only has 1064.
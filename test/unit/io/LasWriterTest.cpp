@@ -979,6 +979,61 @@ TEST(LasWriterTest, compressed1_4)
     }
 }
 
+// Chunks compressed in parallel should produce the same file as serial
+// compression.
+TEST(LasWriterTest, compressThreads)
+{
+    auto write = [](const std::string& filename, int threads)
+    {
+        Options readerOps;
+        readerOps.add("filename", Support::datapath("las/autzen_trim_7.las"));
+
+        LasReader reader;
+        reader.setOptions(readerOps);
+
+        FileUtils::deleteFile(filename);
+
+        Options writerOps;
+        writerOps.add("filename", filename);
+        writerOps.add("forward", "all");
+        writerOps.add("threads", threads);
+
+        LasWriter writer;
+        writer.setOptions(writerOps);
+        writer.setInput(reader);
+
+        PointTable t;
+        writer.prepare(t);
+        writer.execute(t);
+    };
+
+    std::string serial(Support::temppath("serial.laz"));
+    std::string parallel(Support::temppath("parallel.laz"));
+    write(serial, 1);
+    write(parallel, 4);
+    EXPECT_TRUE(Support::compare_files(serial, parallel));
+
+    Options ops;
+    ops.add("filename", parallel);
+
+    LasReader r;
+    r.setOptions(ops);
+
+    PointTable t;
+    r.prepare(t);
+    PointViewSet s = r.execute(t);
+    EXPECT_EQ((*s.begin())->size(), (point_count_t)110000);
+
+    Options badOps;
+    badOps.add("filename", parallel);
+    badOps.add("threads", 0);
+
+    LasWriter writer;
+    writer.setOptions(badOps);
+    PointTable badTable;
+    EXPECT_THROW(writer.prepare(badTable), pdal_error);
+}
+
 TEST(LasWriterTest, flex_vlr)
 {
     std::array<std::string, 3> outname =